@@ -0,0 +1,574 @@
+#ifndef __PARTICLE_CHECKPOINT_H_
+#define __PARTICLE_CHECKPOINT_H_
+
+#include <cstdint>
+#include <functional>
+#include <hdf5.h>
+#include <map>
+#include <memory>
+#include <mpi.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nektar_interface/cell_id_translation.hpp>
+#include <neso_particles.hpp>
+
+using namespace NESO::Particles;
+
+namespace NESO::IO {
+
+/**
+ * Helper to check the return code of a HDF5 call.
+ *
+ * @param flag Return code of the HDF5 call.
+ */
+inline void pc_H5CHK(const herr_t flag) {
+  NESOASSERT(flag >= 0, "HDF5 ERROR");
+}
+
+/**
+ * Layout of a particle checkpoint file:
+ *  - "particles": one dataset per particle property, of shape (number of
+ *    particles, number of components), holding the particles of all ranks
+ *    concatenated in rank order.
+ *  - "values": scalar values replicated over all ranks, e.g. counters.
+ *  - "rank_values": one value per rank of the writing run.
+ *  - "rng": the state of random number generators, one text row per rank of
+ *    the writing run.
+ * Particle data is written and read collectively with hyperslab selections
+ * through the MPI-IO driver of HDF5.
+ */
+class ParticleCheckpointBase {
+protected:
+  MPI_Comm comm;
+  int rank;
+  int size;
+  hid_t file;
+  hid_t plist_xfer;
+
+  template <typename T> static inline hid_t get_type();
+
+  inline void init_comm(MPI_Comm comm) {
+    this->comm = comm;
+    MPICHK(MPI_Comm_rank(comm, &this->rank));
+    MPICHK(MPI_Comm_size(comm, &this->size));
+    this->plist_xfer = H5Pcreate(H5P_DATASET_XFER);
+    pc_H5CHK(H5Pset_dxpl_mpio(this->plist_xfer, H5FD_MPIO_COLLECTIVE));
+  }
+
+  inline hid_t get_plist_file_access() {
+    hid_t plist = H5Pcreate(H5P_FILE_ACCESS);
+    pc_H5CHK(H5Pset_fapl_mpio(plist, this->comm, MPI_INFO_NULL));
+    return plist;
+  }
+
+  /**
+   * Select rows [row_start, row_start + num_rows) of a two dimensional
+   * dataspace. An empty selection is made if num_rows is zero.
+   */
+  static inline void select_rows(hid_t space, const hsize_t row_start,
+                                 const hsize_t num_rows, const hsize_t ncomp) {
+    if (num_rows == 0) {
+      pc_H5CHK(H5Sselect_none(space));
+    } else {
+      hsize_t start[2] = {row_start, 0};
+      hsize_t count[2] = {num_rows, ncomp};
+      pc_H5CHK(H5Sselect_hyperslab(space, H5S_SELECT_SET, start, NULL, count,
+                                   NULL));
+    }
+  }
+
+public:
+  /**
+   * Close the checkpoint file. Must be called collectively.
+   */
+  inline void close() {
+    if (this->file != H5I_INVALID_HID) {
+      pc_H5CHK(H5Pclose(this->plist_xfer));
+      pc_H5CHK(H5Fclose(this->file));
+      this->file = H5I_INVALID_HID;
+    }
+  }
+};
+
+template <> inline hid_t ParticleCheckpointBase::get_type<REAL>() {
+  return H5T_NATIVE_DOUBLE;
+}
+template <> inline hid_t ParticleCheckpointBase::get_type<INT>() {
+  return H5T_NATIVE_INT64;
+}
+template <> inline hid_t ParticleCheckpointBase::get_type<std::uint64_t>() {
+  return H5T_NATIVE_UINT64;
+}
+template <> inline hid_t ParticleCheckpointBase::get_type<char>() {
+  return H5T_NATIVE_CHAR;
+}
+
+/**
+ * Collectively write the particles, counters and random number generator
+ * states that make up the kinetic state of a simulation to a HDF5 file, see
+ * ParticleCheckpointBase for the layout.
+ */
+class ParticleCheckpointWriter : public ParticleCheckpointBase {
+protected:
+  hid_t group_particles;
+  hid_t group_values;
+  hid_t group_rank_values;
+  hid_t group_rng;
+
+  /**
+   * Collectively create a dataset of shape (num_rows_global, ncomp) and write
+   * num_rows local rows to it starting at row_start.
+   */
+  template <typename T>
+  inline void write_rows(hid_t group, const std::string &key,
+                         const hsize_t num_rows_global, const hsize_t ncomp,
+                         const hsize_t row_start, const hsize_t num_rows,
+                         const T *data) {
+    hsize_t dims[2] = {num_rows_global, ncomp};
+    hid_t filespace = H5Screate_simple(2, dims, NULL);
+    hid_t dataset = H5Dcreate2(group, key.c_str(), get_type<T>(), filespace,
+                               H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    select_rows(filespace, row_start, num_rows, ncomp);
+    hsize_t dims_local[2] = {num_rows, ncomp};
+    hid_t memspace = H5Screate_simple(2, dims_local, NULL);
+    if (num_rows == 0) {
+      pc_H5CHK(H5Sselect_none(memspace));
+    }
+    pc_H5CHK(H5Dwrite(dataset, get_type<T>(), memspace, filespace,
+                      this->plist_xfer, data));
+    pc_H5CHK(H5Sclose(memspace));
+    pc_H5CHK(H5Sclose(filespace));
+    pc_H5CHK(H5Dclose(dataset));
+  }
+
+  template <typename T>
+  inline void write_dat(ParticleGroupSharedPtr particle_group, Sym<T> sym,
+                        const int ncomp, const INT npart_global,
+                        const INT row_start) {
+    const int cell_count = particle_group->domain->mesh->get_cell_count();
+    const INT npart_local = particle_group->get_npart_local();
+    std::vector<T> data(npart_local * ncomp);
+    auto dat = particle_group->get_dat(sym);
+    INT index = 0;
+    for (int cellx = 0; cellx < cell_count; cellx++) {
+      auto cell_data = dat->cell_dat.get_cell(cellx);
+      for (int rowx = 0; rowx < cell_data->nrow; rowx++) {
+        for (int colx = 0; colx < ncomp; colx++) {
+          data[index++] = cell_data->at(rowx, colx);
+        }
+      }
+    }
+    this->write_rows(this->group_particles, sym.name, npart_global, ncomp,
+                     row_start, npart_local, data.data());
+  }
+
+public:
+  /**
+   * Create a new checkpoint file, truncating any existing file. Must be
+   * called collectively.
+   *
+   * @param filename Name of the checkpoint file.
+   * @param comm MPI communicator of the particle system.
+   */
+  ParticleCheckpointWriter(const std::string &filename, MPI_Comm comm) {
+    this->init_comm(comm);
+    hid_t plist = this->get_plist_file_access();
+    this->file =
+        H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, plist);
+    NESOASSERT(this->file != H5I_INVALID_HID,
+               "Could not create checkpoint file " + filename);
+    pc_H5CHK(H5Pclose(plist));
+    this->group_particles = H5Gcreate(this->file, "particles", H5P_DEFAULT,
+                                      H5P_DEFAULT, H5P_DEFAULT);
+    this->group_values =
+        H5Gcreate(this->file, "values", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    this->group_rank_values = H5Gcreate(this->file, "rank_values", H5P_DEFAULT,
+                                        H5P_DEFAULT, H5P_DEFAULT);
+    this->group_rng =
+        H5Gcreate(this->file, "rng", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    const INT num_ranks = this->size;
+    this->write_value("num_ranks", num_ranks);
+  }
+
+  ~ParticleCheckpointWriter() { this->close(); }
+
+  /**
+   * Write all properties of all particles in a ParticleGroup, except the cell
+   * and MPI rank properties which are recomputed on read. Must be called
+   * collectively.
+   *
+   * @param particle_group ParticleGroup to write.
+   */
+  inline void write_particles(ParticleGroupSharedPtr particle_group) {
+    const INT npart_local = particle_group->get_npart_local();
+    INT npart_global, row_start = 0;
+    MPICHK(MPI_Allreduce(&npart_local, &npart_global, 1, MPI_INT64_T, MPI_SUM,
+                         this->comm));
+    MPICHK(MPI_Exscan(&npart_local, &row_start, 1, MPI_INT64_T, MPI_SUM,
+                      this->comm));
+    if (this->rank == 0) {
+      row_start = 0;
+    }
+    this->write_value("num_particles", npart_global);
+
+    const auto sym_cell = particle_group->cell_id_dat->sym;
+    const auto sym_rank = particle_group->mpi_rank_dat->sym;
+    auto spec = particle_group->get_particle_spec();
+    for (auto &prop : spec.properties_real) {
+      this->write_dat(particle_group, prop.sym, prop.ncomp, npart_global,
+                      row_start);
+    }
+    for (auto &prop : spec.properties_int) {
+      if ((prop.sym.name != sym_cell.name) &&
+          (prop.sym.name != sym_rank.name)) {
+        this->write_dat(particle_group, prop.sym, prop.ncomp, npart_global,
+                        row_start);
+      }
+    }
+  }
+
+  /**
+   * Write a value which is identical on all ranks, e.g. a global counter or
+   * the simulation time. The value on rank 0 is written. Must be called
+   * collectively.
+   *
+   * @param key Name of the value.
+   * @param value Value to write.
+   */
+  template <typename T>
+  inline void write_value(const std::string &key, const T value) {
+    this->write_rows(this->group_values, key, 1, 1, 0,
+                     (this->rank == 0) ? 1 : 0, &value);
+  }
+
+  /**
+   * Write a value which differs between ranks, e.g. a counter local to each
+   * rank. Must be called collectively.
+   *
+   * @param key Name of the value.
+   * @param value Value on this rank.
+   */
+  template <typename T>
+  inline void write_rank_value(const std::string &key, const T value) {
+    this->write_rows(this->group_rank_values, key, this->size, 1, this->rank,
+                     1, &value);
+  }
+
+  /**
+   * Write the state of a random number generator on each rank. Must be called
+   * collectively.
+   *
+   * @param key Name of the generator.
+   * @param rng Generator on this rank.
+   */
+  inline void write_rng(const std::string &key, const std::mt19937 &rng) {
+    std::stringstream ss;
+    ss << rng;
+    const std::string state = ss.str();
+    const int length_local = state.size() + 1;
+    int length;
+    MPICHK(
+        MPI_Allreduce(&length_local, &length, 1, MPI_INT, MPI_MAX, this->comm));
+    std::vector<char> row(length, '\0');
+    std::copy(state.begin(), state.end(), row.begin());
+    this->write_rows(this->group_rng, key, this->size, length, this->rank, 1,
+                     row.data());
+  }
+
+  /**
+   * Close the checkpoint file. Must be called collectively.
+   */
+  inline void close() {
+    if (this->file != H5I_INVALID_HID) {
+      pc_H5CHK(H5Gclose(this->group_rng));
+      pc_H5CHK(H5Gclose(this->group_rank_values));
+      pc_H5CHK(H5Gclose(this->group_values));
+      pc_H5CHK(H5Gclose(this->group_particles));
+      ParticleCheckpointBase::close();
+    }
+  }
+};
+
+/**
+ * Collectively read a checkpoint written by ParticleCheckpointWriter. The
+ * number of ranks may differ from the run which wrote the checkpoint: the
+ * particles are read in contiguous blocks of rows and then moved to the ranks
+ * and cells which own their positions.
+ */
+class ParticleCheckpointReader : public ParticleCheckpointBase {
+protected:
+  /// Number of ranks of the run which wrote the checkpoint.
+  int num_ranks_written;
+
+  /**
+   * Read the shape of a dataset. Returns false if the dataset does not
+   * exist.
+   */
+  inline bool get_shape(const std::string &path, hsize_t &num_rows,
+                        hsize_t &ncomp) {
+    if (H5Lexists(this->file, path.c_str(), H5P_DEFAULT) <= 0) {
+      return false;
+    }
+    hid_t dataset = H5Dopen2(this->file, path.c_str(), H5P_DEFAULT);
+    hid_t filespace = H5Dget_space(dataset);
+    hsize_t dims[2];
+    H5Sget_simple_extent_dims(filespace, dims, NULL);
+    num_rows = dims[0];
+    ncomp = dims[1];
+    pc_H5CHK(H5Sclose(filespace));
+    pc_H5CHK(H5Dclose(dataset));
+    return true;
+  }
+
+  /**
+   * Collectively read num_rows rows starting at row_start of a two
+   * dimensional dataset.
+   */
+  template <typename T>
+  inline void read_rows(const std::string &path, const hsize_t ncomp,
+                        const hsize_t row_start, const hsize_t num_rows,
+                        T *data) {
+    hid_t dataset = H5Dopen2(this->file, path.c_str(), H5P_DEFAULT);
+    hid_t filespace = H5Dget_space(dataset);
+    select_rows(filespace, row_start, num_rows, ncomp);
+    hsize_t dims_local[2] = {num_rows, ncomp};
+    hid_t memspace = H5Screate_simple(2, dims_local, NULL);
+    if (num_rows == 0) {
+      pc_H5CHK(H5Sselect_none(memspace));
+    }
+    pc_H5CHK(H5Dread(dataset, get_type<T>(), memspace, filespace,
+                     this->plist_xfer, data));
+    pc_H5CHK(H5Sclose(memspace));
+    pc_H5CHK(H5Sclose(filespace));
+    pc_H5CHK(H5Dclose(dataset));
+  }
+
+  template <typename T>
+  inline void read_dat(ParticleSet &particle_set, Sym<T> sym, const int ncomp,
+                       const INT row_start, const INT num_rows) {
+    const std::string path = "particles/" + sym.name;
+    hsize_t num_rows_file, ncomp_file;
+    if (!this->get_shape(path, num_rows_file, ncomp_file)) {
+      nprint("ParticleCheckpointReader: no data for", sym.name,
+             "in checkpoint, values are left as zero.");
+      return;
+    }
+    NESOASSERT(ncomp_file == static_cast<hsize_t>(ncomp),
+               "Number of components of " + sym.name +
+                   " differs from the checkpoint.");
+    std::vector<T> data(num_rows * ncomp);
+    this->read_rows(path, ncomp, row_start, num_rows, data.data());
+    for (INT rowx = 0; rowx < num_rows; rowx++) {
+      for (int colx = 0; colx < ncomp; colx++) {
+        particle_set[sym][rowx][colx] = data[rowx * ncomp + colx];
+      }
+    }
+  }
+
+public:
+  /**
+   * Open an existing checkpoint file. Must be called collectively.
+   *
+   * @param filename Name of the checkpoint file.
+   * @param comm MPI communicator of the particle system.
+   */
+  ParticleCheckpointReader(const std::string &filename, MPI_Comm comm) {
+    this->init_comm(comm);
+    hid_t plist = this->get_plist_file_access();
+    this->file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, plist);
+    NESOASSERT(this->file != H5I_INVALID_HID,
+               "Could not open checkpoint file " + filename);
+    pc_H5CHK(H5Pclose(plist));
+    INT num_ranks;
+    this->read_value("num_ranks", num_ranks);
+    this->num_ranks_written = num_ranks;
+  }
+
+  ~ParticleCheckpointReader() { this->close(); }
+
+  /**
+   * @returns True if the checkpoint was written with the same number of
+   * ranks as the communicator it is read on.
+   */
+  inline bool same_num_ranks() const {
+    return this->num_ranks_written == this->size;
+  }
+
+  /**
+   * Read the particles of the checkpoint, add them to a ParticleGroup and
+   * move them to the ranks and cells which own their positions. Properties
+   * not present in the checkpoint are set to zero. Must be called
+   * collectively.
+   *
+   * @param particle_group ParticleGroup to add the particles to.
+   * @returns Global number of particles read.
+   */
+  inline INT read_particles(ParticleGroupSharedPtr particle_group) {
+    INT npart_global;
+    this->read_value("num_particles", npart_global);
+
+    // Rows are read by the ranks that own at least one cell, as the
+    // particles are initially placed in a local cell.
+    const int cell_count = particle_group->domain->mesh->get_cell_count();
+    const int has_cells = (cell_count > 0) ? 1 : 0;
+    int num_readers = 0;
+    int reader_index = 0;
+    MPICHK(MPI_Allreduce(&has_cells, &num_readers, 1, MPI_INT, MPI_SUM,
+                         this->comm));
+    MPICHK(MPI_Exscan(&has_cells, &reader_index, 1, MPI_INT, MPI_SUM,
+                      this->comm));
+    if (this->rank == 0) {
+      reader_index = 0;
+    }
+    NESOASSERT((num_readers > 0) || (npart_global == 0),
+               "No rank owns a cell to place checkpoint particles in.");
+    INT row_start = 0;
+    INT row_end = 0;
+    if (has_cells) {
+      get_decomp_1d(static_cast<INT>(num_readers), npart_global,
+                    static_cast<INT>(reader_index), &row_start, &row_end);
+    }
+    const INT num_rows = row_end - row_start;
+
+    const auto sym_cell = particle_group->cell_id_dat->sym;
+    const auto sym_rank = particle_group->mpi_rank_dat->sym;
+    auto spec = particle_group->get_particle_spec();
+    ParticleSet particle_set(num_rows, spec);
+    for (auto &prop : spec.properties_real) {
+      this->read_dat(particle_set, prop.sym, prop.ncomp, row_start, num_rows);
+    }
+    for (auto &prop : spec.properties_int) {
+      if ((prop.sym.name != sym_cell.name) &&
+          (prop.sym.name != sym_rank.name)) {
+        this->read_dat(particle_set, prop.sym, prop.ncomp, row_start,
+                       num_rows);
+      }
+    }
+
+    // Place the particles in any local cell then let the global move find
+    // the owning rank of each position.
+    for (INT rowx = 0; rowx < num_rows; rowx++) {
+      particle_set[sym_cell][rowx][0] = rowx % cell_count;
+    }
+    if (num_rows > 0) {
+      particle_group->add_particles_local(particle_set);
+    }
+    reset_mpi_ranks(particle_group->mpi_rank_dat);
+    particle_group->hybrid_move();
+    particle_group->cell_move();
+    return npart_global;
+  }
+
+  /**
+   * Read a value written with ParticleCheckpointWriter::write_value. Must be
+   * called collectively.
+   *
+   * @param key Name of the value.
+   * @param[out] value Value read.
+   * @returns True if the value exists in the checkpoint, otherwise value is
+   * not modified.
+   */
+  template <typename T>
+  inline bool read_value(const std::string &key, T &value) {
+    const std::string path = "values/" + key;
+    hsize_t num_rows, ncomp;
+    if (!this->get_shape(path, num_rows, ncomp)) {
+      return false;
+    }
+    this->read_rows(path, 1, 0, 1, &value);
+    return true;
+  }
+
+  /**
+   * Read a value written with ParticleCheckpointWriter::write_rank_value.
+   * With the same number of ranks each rank reads its own value. Otherwise
+   * rank 0 reads the sum over the ranks of the writing run and other ranks
+   * read zero, such that the global sum is preserved. Must be called
+   * collectively.
+   *
+   * @param key Name of the value.
+   * @param[out] value Value read.
+   * @returns True if the value exists in the checkpoint, otherwise value is
+   * not modified.
+   */
+  template <typename T>
+  inline bool read_rank_value(const std::string &key, T &value) {
+    const std::string path = "rank_values/" + key;
+    hsize_t num_rows, ncomp;
+    if (!this->get_shape(path, num_rows, ncomp)) {
+      return false;
+    }
+    if (this->same_num_ranks()) {
+      this->read_rows(path, 1, this->rank, 1, &value);
+    } else {
+      std::vector<T> values(num_rows);
+      this->read_rows(path, 1, 0, num_rows, values.data());
+      value = 0;
+      if (this->rank == 0) {
+        for (auto &vx : values) {
+          value += vx;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Restore the state of a random number generator written with
+   * ParticleCheckpointWriter::write_rng. With the same number of ranks each
+   * rank restores its own state. Otherwise, if the state was identical on all
+   * ranks it is restored on all ranks, else each rank reseeds the generator
+   * from the stored states and its rank such that the streams of different
+   * ranks remain distinct. Must be called collectively.
+   *
+   * @param key Name of the generator.
+   * @param[in, out] rng Generator to restore.
+   * @returns True if the stored state was restored exactly, false if the
+   * generator was reseeded or no state exists in the checkpoint.
+   */
+  inline bool read_rng(const std::string &key, std::mt19937 &rng) {
+    const std::string path = "rng/" + key;
+    hsize_t num_rows, length;
+    if (!this->get_shape(path, num_rows, length)) {
+      return false;
+    }
+    if (this->same_num_ranks()) {
+      std::vector<char> row(length);
+      this->read_rows(path, length, this->rank, 1, row.data());
+      std::stringstream ss(std::string(row.data()));
+      ss >> rng;
+      return true;
+    }
+
+    std::vector<char> rows(num_rows * length);
+    this->read_rows(path, length, 0, num_rows, rows.data());
+    std::vector<std::string> states(num_rows);
+    bool replicated = true;
+    for (hsize_t rx = 0; rx < num_rows; rx++) {
+      states[rx] = std::string(rows.data() + rx * length);
+      replicated = replicated && (states[rx] == states[0]);
+    }
+    if (replicated) {
+      std::stringstream ss(states[0]);
+      ss >> rng;
+      return true;
+    }
+    std::vector<std::uint32_t> seeds;
+    for (auto &state : states) {
+      const std::uint64_t hash = std::hash<std::string>{}(state);
+      seeds.push_back(static_cast<std::uint32_t>(hash));
+      seeds.push_back(static_cast<std::uint32_t>(hash >> 32));
+    }
+    seeds.push_back(static_cast<std::uint32_t>(this->rank));
+    std::seed_seq seq(seeds.begin(), seeds.end());
+    rng.seed(seq);
+    return false;
+  }
+};
+
+} // namespace NESO::IO
+
+#endif
@@ -162,6 +162,28 @@ void eval_modes(const LibUtilities::ShapeType shape_type, const int P,
                 const double eta0, const double eta1, const double eta2,
                 std::vector<double> &b);
 
+/**
+ *  Evaluate all the basis function modes for a geometry object with P0, P1
+ *  and P2 modes in the first, second and third coordinate directions. Only
+ *  quadrilaterals and hexahedrons may have differing numbers of modes in each
+ *  direction, for all other shape types this is equivalent to calling
+ *  eval_modes with P0 modes.
+ *
+ *  @param[in] shape_type Geometry shape type to compute modes for, e.g.
+ * eHexahedron.
+ *  @param[in] P0 Number of modes in the first dimension.
+ *  @param[in] P1 Number of modes in the second dimension.
+ *  @param[in] P2 Number of modes in the third dimension, ignored for 2D shape
+ * types.
+ *  @param[in] eta0 Evaluation point, first dimension.
+ *  @param[in] eta1 Evaluation point, second dimension.
+ *  @param[in] eta2 Evaluation point, third dimension.
+ *  @param[in, out] b Output vector of mode evaluations.
+ */
+void eval_modes(const LibUtilities::ShapeType shape_type, const int P0,
+                const int P1, const int P2, const double eta0,
+                const double eta1, const double eta2, std::vector<double> &b);
+
 } // namespace NESO::BasisReference
 
 #endif
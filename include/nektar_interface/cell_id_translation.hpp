@@ -27,20 +27,17 @@ namespace NESO {
 
 /**
  *  Class to convert Nektar++ global ids of geometry objects to ids that can be
- *  used by NESO-Particles.
+ *  used by NESO-Particles. The cell of an element is the index of the element
+ *  in the map returned by get_all_elements_2d or get_all_elements_3d.
  */
 class CellIDTranslation {
 private:
   ParticleDatSharedPtr<INT> cell_id_dat;
   ParticleMeshInterfaceSharedPtr particle_mesh_interface;
-  BufferDeviceHost<int> id_map;
-  int shift;
 
   template <typename T>
   inline void construct_maps(std::map<int, std::shared_ptr<T>> &geoms) {
     const int nelements = geoms.size();
-    int id_min = std::numeric_limits<int>::max();
-    int id_max = std::numeric_limits<int>::lowest();
 
     this->map_to_nektar.resize(nelements);
     this->dh_map_to_geom_type.realloc_no_copy(nelements);
@@ -52,8 +49,6 @@ private:
     for (auto &geom : geoms) {
       const int id = geom.second->GetGlobalID();
       NESOASSERT(geom.first == id, "Expected these ids to match");
-      id_min = std::min(id_min, id);
-      id_max = std::max(id_max, id);
       this->map_to_nektar[index] = id;
       // record the type of this cell.
       this->dh_map_to_geom_type.h_buffer.ptr[index] =
@@ -62,15 +57,6 @@ private:
     }
 
     NESOASSERT(index == nelements, "element count missmatch");
-    this->shift = id_min;
-    const int shifted_max = id_max - id_min;
-    id_map.realloc_no_copy(shifted_max + 1);
-
-    for (int ex = 0; ex < nelements; ex++) {
-      const int lookup_index = this->map_to_nektar[ex] - this->shift;
-      this->id_map.h_buffer.ptr[lookup_index] = ex;
-    }
-    this->id_map.host_to_device();
     this->dh_map_to_geom_type.host_to_device();
   }
 
@@ -103,7 +89,7 @@ public:
                     ParticleMeshInterfaceSharedPtr particle_mesh_interface)
       : sycl_target(sycl_target), cell_id_dat(cell_id_dat),
         particle_mesh_interface(particle_mesh_interface),
-        id_map(sycl_target, 1), dh_map_to_geom_type(sycl_target, 1) {
+        dh_map_to_geom_type(sycl_target, 1) {
 
     auto graph = this->particle_mesh_interface->graph;
     const int ndim = particle_mesh_interface->ndim;
@@ -123,26 +109,16 @@ public:
   };
 
   /**
-   *  Loop over all particles and map cell ids from Nektar++ cell ids to
-   *  NESO-Particle cells ids.
+   *  The NektarGraphLocalMapper writes NESO-Particles cells, rather than
+   *  Nektar++ geometry ids, into the cell ids of the particles it maps, see
+   *  ParticleMeshInterface::get_geom_to_cell_map. Hence no translation is
+   *  required and this method does not iterate the particles. It is retained
+   *  such that existing code compiles, calls should be removed, i.e.
+   *  hybrid_move is followed directly by cell_move.
    */
-  inline void execute() {
-    auto t0 = profile_timestamp();
-    const auto k_lookup_map = this->id_map.d_buffer.ptr;
-    const INT k_shift = this->shift;
-    particle_loop(
-        "CellIDTranslation::execute", this->cell_id_dat,
-        [=](auto k_cell_id_dat) {
-          const INT nektar_cell = k_cell_id_dat.at(0);
-          const INT shifted_nektar_cell = nektar_cell - k_shift;
-          const INT neso_cell = k_lookup_map[shifted_nektar_cell];
-          k_cell_id_dat.at(0) = neso_cell;
-        },
-        Access::write(this->cell_id_dat))
-        ->execute();
-    sycl_target->profile_map.inc("CellIDTranslation", "execute", 1,
-                                 profile_elapsed(t0, profile_timestamp()));
-  };
+  [[deprecated("The local mappers write NESO-Particles cells, remove calls to "
+               "CellIDTranslation::execute.")]] inline void
+  execute(){};
 };
 
 typedef std::shared_ptr<CellIDTranslation> CellIDTranslationSharedPtr;
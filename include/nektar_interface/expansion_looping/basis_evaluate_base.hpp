@@ -2,6 +2,8 @@
 #define __BASIS_EVALUATE_BASE_H_
 
 #include "geom_to_expansion_builder.hpp"
+#include "nektar_interface/particle_shape.hpp"
+#include "nektar_interface/reduced_precision.hpp"
 
 namespace NESO {
 
@@ -12,6 +14,7 @@ namespace NESO {
 namespace PrivateBasisEvaluateBaseKernel {
 
 struct LoopData {
+  /// Number of modes in each of the three directions for each cell.
   const int *nummodes;
   const int *coeffs_offsets;
   REAL *global_coeffs;
@@ -29,7 +32,7 @@ template <typename DAT_TYPE>
 inline void extract_ref_positions_dat(const int ndim, DAT_TYPE &ref_positions,
                                       REAL *xi) {
   for (int dx = 0; dx < ndim; dx++) {
-    xi[dx] = ref_positions.at(dx);
+    xi[dx] = ReducedPrecision::get(ref_positions, dx);
   }
   for (int dx = ndim; dx < 3; dx++) {
     xi[dx] = 0.0;
@@ -41,7 +44,7 @@ inline void
 extract_ref_positions_ptr(const int ndim, const DAT_TYPE &ref_positions,
                           const INT cellx, const INT layerx, REAL *xi) {
   for (int dx = 0; dx < ndim; dx++) {
-    xi[dx] = ref_positions[cellx][dx][layerx];
+    xi[dx] = ReducedPrecision::read(ref_positions, cellx, dx, layerx);
   }
   for (int dx = ndim; dx < 3; dx++) {
     xi[dx] = 0.0;
@@ -54,7 +57,8 @@ inline int sum_max_modes(const LoopData &loop_data) {
 }
 
 template <typename LOOP_TYPE>
-inline void prepare_per_dim_basis(const int nummodes, const LoopData &loop_data,
+inline void prepare_per_dim_basis(const int *nummodes,
+                                  const LoopData &loop_data,
                                   LOOP_TYPE &loop_type, const REAL *xi,
                                   REAL *local_mem, REAL **local_space_0,
                                   REAL **local_space_1, REAL **local_space_2) {
@@ -68,13 +72,13 @@ inline void prepare_per_dim_basis(const int nummodes, const LoopData &loop_data,
                                        &eta2);
 
   // Compute the basis functions in dim0 and dim1
-  loop_type.evaluate_basis_0(nummodes, eta0, loop_data.stride_n,
+  loop_type.evaluate_basis_0(nummodes[0], eta0, loop_data.stride_n,
                              loop_data.coeffs_pnm10, loop_data.coeffs_pnm11,
                              loop_data.coeffs_pnm2, *local_space_0);
-  loop_type.evaluate_basis_1(nummodes, eta1, loop_data.stride_n,
+  loop_type.evaluate_basis_1(nummodes[1], eta1, loop_data.stride_n,
                              loop_data.coeffs_pnm10, loop_data.coeffs_pnm11,
                              loop_data.coeffs_pnm2, *local_space_1);
-  loop_type.evaluate_basis_2(nummodes, eta2, loop_data.stride_n,
+  loop_type.evaluate_basis_2(nummodes[2], eta2, loop_data.stride_n,
                              loop_data.coeffs_pnm10, loop_data.coeffs_pnm11,
                              loop_data.coeffs_pnm2, *local_space_2);
 }
@@ -106,6 +110,22 @@ protected:
   BufferDeviceHost<REAL> dh_coeffs_pnm2;
   int stride_n;
   std::map<ShapeType, std::array<int, 3>> map_total_nummodes;
+  ParticleShapeFilterSharedPtr particle_shape_filter;
+
+  /**
+   * Apply the particle shape, if one is set, to coefficients in device
+   * memory.
+   *
+   * @param[in, out] d_coeffs Device pointer to num_coeffs coefficients.
+   * @param num_coeffs Number of coefficients.
+   */
+  inline void apply_particle_shape(REAL *d_coeffs, const int num_coeffs) {
+    if (this->particle_shape_filter) {
+      NESOASSERT(num_coeffs == this->particle_shape_filter->num_coeffs,
+                 "Number of coefficients does not match the particle shape.");
+      this->particle_shape_filter->apply_device(d_coeffs).wait_and_throw();
+    }
+  }
 
   template <typename PROJECT_TYPE>
   inline PrivateBasisEvaluateBaseKernel::LoopData
@@ -140,6 +160,28 @@ public:
   /// Disable (implicit) copies.
   BasisEvaluateBase &operator=(BasisEvaluateBase const &a) = delete;
 
+  /**
+   * Set the shape of the particles. The default shape is a point particle.
+   *
+   * @param shape New particle shape.
+   */
+  inline void set_particle_shape(const ParticleShape shape) {
+    if (shape.type == ParticleShapeType::Delta) {
+      this->particle_shape_filter = nullptr;
+    } else {
+      this->particle_shape_filter = std::make_shared<ParticleShapeFilter>(
+          this->sycl_target, this->field, shape);
+    }
+  }
+
+  /**
+   * @returns The filter implementing the particle shape or nullptr for point
+   * particles.
+   */
+  inline ParticleShapeFilterSharedPtr get_particle_shape_filter() const {
+    return this->particle_shape_filter;
+  }
+
   /**
    * Create new instance. Expected to be called by a derived class - not a user.
    *
@@ -164,7 +206,7 @@ public:
 
     const int neso_cell_count = mesh->get_cell_count();
 
-    this->dh_nummodes.realloc_no_copy(neso_cell_count);
+    this->dh_nummodes.realloc_no_copy(3 * neso_cell_count);
     this->dh_coeffs_offsets.realloc_no_copy(neso_cell_count);
 
     int max_n = 1;
@@ -194,29 +236,36 @@ public:
       auto shape_type = expansion->DetShapeType();
       this->map_shape_to_cells[shape_type].push_back(neso_cellx);
 
+      // Tensor product expansions may have a different number of modes in
+      // each direction, the collapsed expansions are indexed assuming the same
+      // number of modes in each direction.
+      const bool anisotropic =
+          (shape_type == eQuadrilateral) || (shape_type == eHexahedron);
+      int *cell_nummodes = this->dh_nummodes.h_buffer.ptr + 3 * neso_cellx;
+      int max_nummodes = 1;
       for (int dimx = 0; dimx < expansion_ndim; dimx++) {
         const int basis_nummodes = basis[dimx]->GetNumModes();
         const int basis_total_nummodes = basis[dimx]->GetTotNumModes();
         max_n = std::max(max_n, basis_nummodes - 1);
-        if (dimx == 0) {
-          this->dh_nummodes.h_buffer.ptr[neso_cellx] = basis_nummodes;
-        } else {
-          NESOASSERT(this->dh_nummodes.h_buffer.ptr[neso_cellx] ==
-                         basis_nummodes,
-                     "Differing numbers of modes in coordinate directions.");
-        }
+        max_nummodes = std::max(max_nummodes, basis_nummodes);
+        cell_nummodes[dimx] = basis_nummodes;
+        NESOASSERT(anisotropic || (cell_nummodes[0] == basis_nummodes),
+                   "Differing numbers of modes in coordinate directions are "
+                   "only supported for quadrilaterals and hexahedrons.");
         this->map_total_nummodes.at(shape_type).at(dimx) =
             std::max(this->map_total_nummodes.at(shape_type).at(dimx),
                      basis_total_nummodes);
       }
+      for (int dimx = expansion_ndim; dimx < 3; dimx++) {
+        cell_nummodes[dimx] = 1;
+      }
 
       // determine the maximum Jacobi order and alpha value required to
       // evaluate the basis functions for this expansion
       int alpha_tmp = 0;
       int n_tmp = 0;
-      BasisReference::get_total_num_modes(
-          shape_type, this->dh_nummodes.h_buffer.ptr[neso_cellx], &n_tmp,
-          &alpha_tmp);
+      BasisReference::get_total_num_modes(shape_type, max_nummodes, &n_tmp,
+                                          &alpha_tmp);
       max_alpha = std::max(max_alpha, alpha_tmp);
       max_n = std::max(max_n, n_tmp);
 
@@ -45,18 +45,19 @@ struct Hexahedron : JacobiExpansionLoopingInterface<Hexahedron> {
                                      coeffs_pnm11, coeffs_pnm2, output);
   }
 
-  inline void loop_evaluate_v(const int nummodes, const REAL *const dofs,
+  inline void loop_evaluate_v(const int nummodes0, const int nummodes1,
+                              const int nummodes2, const REAL *const dofs,
                               const REAL *const local_space_0,
                               const REAL *const local_space_1,
                               const REAL *const local_space_2, REAL *output) {
     REAL evaluation = 0.0;
-    for (int rx = 0; rx < nummodes; rx++) {
-      const int mode_r = rx * nummodes * nummodes;
+    for (int rx = 0; rx < nummodes2; rx++) {
+      const int mode_r = rx * nummodes0 * nummodes1;
       const REAL etmp2 = local_space_2[rx];
-      for (int qx = 0; qx < nummodes; qx++) {
-        const int mode_q = qx * nummodes + mode_r;
+      for (int qx = 0; qx < nummodes1; qx++) {
+        const int mode_q = qx * nummodes0 + mode_r;
         const REAL etmp1 = local_space_1[qx] * etmp2;
-        for (int px = 0; px < nummodes; px++) {
+        for (int px = 0; px < nummodes0; px++) {
           const int mode = px + mode_q;
           const REAL coeff = dofs[mode];
           const REAL etmp0 = local_space_0[px];
@@ -67,18 +68,19 @@ struct Hexahedron : JacobiExpansionLoopingInterface<Hexahedron> {
     *output = evaluation;
   }
 
-  inline void loop_project_v(const int nummodes, const REAL value,
+  inline void loop_project_v(const int nummodes0, const int nummodes1,
+                             const int nummodes2, const REAL value,
                              const REAL *const local_space_0,
                              const REAL *const local_space_1,
                              const REAL *const local_space_2, REAL *dofs) {
 
-    for (int rx = 0; rx < nummodes; rx++) {
-      const int mode_r = rx * nummodes * nummodes;
+    for (int rx = 0; rx < nummodes2; rx++) {
+      const int mode_r = rx * nummodes0 * nummodes1;
       const REAL etmp2 = local_space_2[rx] * value;
-      for (int qx = 0; qx < nummodes; qx++) {
-        const int mode_q = qx * nummodes + mode_r;
+      for (int qx = 0; qx < nummodes1; qx++) {
+        const int mode_q = qx * nummodes0 + mode_r;
         const REAL etmp1 = local_space_1[qx] * etmp2;
-        for (int px = 0; px < nummodes; px++) {
+        for (int px = 0; px < nummodes0; px++) {
           const int mode = px + mode_q;
           const REAL evaluation = local_space_0[px] * etmp1;
           sycl::atomic_ref<REAL, sycl::memory_order::relaxed,
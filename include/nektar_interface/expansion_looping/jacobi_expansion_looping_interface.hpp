@@ -145,9 +145,36 @@ template <typename SPECIALISATION> struct JacobiExpansionLoopingInterface {
                             const REAL *local_space_0,
                             const REAL *local_space_1,
                             const REAL *local_space_2, REAL *output) {
+    this->loop_evaluate(nummodes, nummodes, nummodes, dofs, local_space_0,
+                        local_space_1, local_space_2, output);
+  }
+
+  /**
+   * As `loop_evaluate` for an expansion which may have a different number of
+   * modes in each direction of the reference element. Only the tensor product
+   * elements (quadrilaterals and hexahedrons) support differing numbers of
+   * modes, all other element types use nummodes0 for all directions.
+   *
+   * @param[in] nummodes0 Number of modes in the x direction.
+   * @param[in] nummodes1 Number of modes in the y direction.
+   * @param[in] nummodes2 Number of modes in the z direction.
+   * @param[in] dofs Pointer to degrees of freedom (\f$\alpha_i\f$) to use when
+   * evaluating the expansion.
+   * @param[in] local_space_0 Output of `evaluate_basis_0`.
+   * @param[in] local_space_1 Output of `evaluate_basis_1`.
+   * @param[in] local_space_2 Output of `evaluate_basis_2`.
+   * @param[output] output Output space for the evaluation (pointer to a single
+   * REAL).
+   */
+  inline void loop_evaluate(const int nummodes0, const int nummodes1,
+                            const int nummodes2, const REAL *dofs,
+                            const REAL *local_space_0,
+                            const REAL *local_space_1,
+                            const REAL *local_space_2, REAL *output) {
     auto &underlying = static_cast<SPECIALISATION &>(*this);
-    underlying.loop_evaluate_v(nummodes, dofs, local_space_0, local_space_1,
-                               local_space_2, output);
+    underlying.loop_evaluate_v(nummodes0, nummodes1, nummodes2, dofs,
+                               local_space_0, local_space_1, local_space_2,
+                               output);
   }
 
   /**
@@ -179,9 +206,33 @@ template <typename SPECIALISATION> struct JacobiExpansionLoopingInterface {
   inline void loop_project(const int nummodes, const REAL value,
                            const REAL *local_space_0, const REAL *local_space_1,
                            const REAL *local_space_2, REAL *dofs) {
+    this->loop_project(nummodes, nummodes, nummodes, value, local_space_0,
+                       local_space_1, local_space_2, dofs);
+  }
+
+  /**
+   * As `loop_project` for an expansion which may have a different number of
+   * modes in each direction of the reference element. See the anisotropic
+   * `loop_evaluate` for the element types which support this.
+   *
+   * @param[in] nummodes0 Number of modes in the x direction.
+   * @param[in] nummodes1 Number of modes in the y direction.
+   * @param[in] nummodes2 Number of modes in the z direction.
+   * @param[in] value Quantity of interest on the particle.
+   * @param[in] local_space_0 Output of `evaluate_basis_0`.
+   * @param[in] local_space_1 Output of `evaluate_basis_1`.
+   * @param[in] local_space_2 Output of `evaluate_basis_2`.
+   * @param[output] dofs Output space for the evaluation of each basis
+   * function times quantity of interest.
+   */
+  inline void loop_project(const int nummodes0, const int nummodes1,
+                           const int nummodes2, const REAL value,
+                           const REAL *local_space_0, const REAL *local_space_1,
+                           const REAL *local_space_2, REAL *dofs) {
     auto &underlying = static_cast<SPECIALISATION &>(*this);
-    underlying.loop_project_v(nummodes, value, local_space_0, local_space_1,
-                              local_space_2, dofs);
+    underlying.loop_project_v(nummodes0, nummodes1, nummodes2, value,
+                              local_space_0, local_space_1, local_space_2,
+                              dofs);
   }
 
   /**
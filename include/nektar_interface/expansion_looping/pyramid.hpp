@@ -46,7 +46,8 @@ struct Pyramid : JacobiExpansionLoopingInterface<Pyramid> {
                                         output);
   }
 
-  inline void loop_evaluate_v(const int nummodes, const REAL *const dofs,
+  inline void loop_evaluate_v(const int nummodes, const int, const int,
+                              const REAL *const dofs,
                               const REAL *const local_space_0,
                               const REAL *const local_space_1,
                               const REAL *const local_space_2, REAL *output) {
@@ -72,7 +73,8 @@ struct Pyramid : JacobiExpansionLoopingInterface<Pyramid> {
     *output = evaluation;
   }
 
-  inline void loop_project_v(const int nummodes, const REAL value,
+  inline void loop_project_v(const int nummodes, const int, const int,
+                             const REAL value,
                              const REAL *const local_space_0,
                              const REAL *const local_space_1,
                              const REAL *const local_space_2, REAL *dofs) {
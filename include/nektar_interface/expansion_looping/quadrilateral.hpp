@@ -42,14 +42,15 @@ struct Quadrilateral : JacobiExpansionLoopingInterface<Quadrilateral> {
                                  const REAL *coeffs_pnm11,
                                  const REAL *coeffs_pnm2, REAL *output) {}
 
-  inline void loop_evaluate_v(const int nummodes, const REAL *const dofs,
+  inline void loop_evaluate_v(const int nummodes0, const int nummodes1,
+                              const int, const REAL *const dofs,
                               const REAL *const local_space_0,
                               const REAL *const local_space_1,
                               const REAL *const local_space_2, REAL *output) {
     REAL evaluation = 0.0;
-    for (int qx = 0; qx < nummodes; qx++) {
-      for (int px = 0; px < nummodes; px++) {
-        const int mode = qx * nummodes + px;
+    for (int qx = 0; qx < nummodes1; qx++) {
+      for (int px = 0; px < nummodes0; px++) {
+        const int mode = qx * nummodes0 + px;
         const REAL coeff = dofs[mode];
         const REAL etmp0 = local_space_0[px];
         const REAL etmp1 = local_space_1[qx];
@@ -59,14 +60,15 @@ struct Quadrilateral : JacobiExpansionLoopingInterface<Quadrilateral> {
     *output = evaluation;
   }
 
-  inline void loop_project_v(const int nummodes, const REAL value,
+  inline void loop_project_v(const int nummodes0, const int nummodes1,
+                             const int, const REAL value,
                              const REAL *const local_space_0,
                              const REAL *const local_space_1,
                              const REAL *const local_space_2, REAL *dofs) {
 
-    for (int qx = 0; qx < nummodes; qx++) {
-      for (int px = 0; px < nummodes; px++) {
-        const int mode = qx * nummodes + px;
+    for (int qx = 0; qx < nummodes1; qx++) {
+      for (int px = 0; px < nummodes0; px++) {
+        const int mode = qx * nummodes0 + px;
         const REAL etmp0 = local_space_0[px];
         const REAL etmp1 = local_space_1[qx];
 
@@ -45,7 +45,8 @@ struct Tetrahedron : JacobiExpansionLoopingInterface<Tetrahedron> {
                                      coeffs_pnm11, coeffs_pnm2, output);
   }
 
-  inline void loop_evaluate_v(const int nummodes, const REAL *const dofs,
+  inline void loop_evaluate_v(const int nummodes, const int, const int,
+                              const REAL *const dofs,
                               const REAL *const local_space_0,
                               const REAL *const local_space_1,
                               const REAL *const local_space_2, REAL *output) {
@@ -74,7 +75,8 @@ struct Tetrahedron : JacobiExpansionLoopingInterface<Tetrahedron> {
     *output = evaluation;
   }
 
-  inline void loop_project_v(const int nummodes, const REAL value,
+  inline void loop_project_v(const int nummodes, const int, const int,
+                             const REAL value,
                              const REAL *const local_space_0,
                              const REAL *const local_space_1,
                              const REAL *const local_space_2, REAL *dofs) {
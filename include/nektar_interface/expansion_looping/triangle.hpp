@@ -42,7 +42,8 @@ struct Triangle : JacobiExpansionLoopingInterface<Triangle> {
                                  const REAL *coeffs_pnm11,
                                  const REAL *coeffs_pnm2, REAL *output) {}
 
-  inline void loop_evaluate_v(const int nummodes, const REAL *const dofs,
+  inline void loop_evaluate_v(const int nummodes, const int, const int,
+                              const REAL *const dofs,
                               const REAL *const local_space_0,
                               const REAL *const local_space_1,
                               const REAL *const local_space_2, REAL *output) {
@@ -62,7 +63,8 @@ struct Triangle : JacobiExpansionLoopingInterface<Triangle> {
     *output = evaluation;
   }
 
-  inline void loop_project_v(const int nummodes, const REAL value,
+  inline void loop_project_v(const int nummodes, const int, const int,
+                             const REAL value,
                              const REAL *const local_space_0,
                              const REAL *const local_space_1,
                              const REAL *const local_space_2, REAL *dofs) {
@@ -0,0 +1,191 @@
+#ifndef __FIELD_HEALTH_CHECK_H_
+#define __FIELD_HEALTH_CHECK_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <MultiRegions/ExpList.h>
+#include <neso_particles.hpp>
+
+using namespace NESO::Particles;
+namespace LU = Nektar::LibUtilities;
+namespace MR = Nektar::MultiRegions;
+
+namespace NESO {
+
+/**
+ * Find the first value in an array which is not finite, i.e. NaN or inf.
+ *
+ * The scan is branch free within blocks of values: x - x is zero for finite x
+ * and NaN otherwise, hence the sums of x - x over several independent lanes,
+ * which the compiler vectorises, are non-zero only if a block contains a
+ * non-finite value. Only that block is then searched element by element.
+ *
+ * @param data Values to scan.
+ * @param n Number of values.
+ * @returns Index of the first non-finite value or -1 if all values are finite.
+ */
+inline std::int64_t find_non_finite(const double *data, const std::size_t n) {
+  constexpr std::size_t block_size = 1024;
+  constexpr std::size_t num_lanes = 8;
+  for (std::size_t start = 0; start < n; start += block_size) {
+    const std::size_t end = std::min(n, start + block_size);
+    double lanes[num_lanes] = {0.0};
+    std::size_t ix = start;
+    for (; ix + num_lanes <= end; ix += num_lanes) {
+      for (std::size_t lx = 0; lx < num_lanes; lx++) {
+        lanes[lx] += data[ix + lx] - data[ix + lx];
+      }
+    }
+    double total = 0.0;
+    for (; ix < end; ix++) {
+      total += data[ix] - data[ix];
+    }
+    for (std::size_t lx = 0; lx < num_lanes; lx++) {
+      total += lanes[lx];
+    }
+    if (total != 0.0) {
+      for (ix = start; ix < end; ix++) {
+        if (!std::isfinite(data[ix])) {
+          return static_cast<std::int64_t>(ix);
+        }
+      }
+    }
+  }
+  return -1;
+}
+
+/**
+ * Abort if an array of field values contains a non-finite value. The
+ * diagnostic message, which names the caller, the field, the index of the
+ * value and, if the field is passed, the Nektar++ element which holds it, is
+ * only built if the check fails.
+ *
+ * @param where Name of the calling method or stage.
+ * @param name Name of the field.
+ * @param data Values to check.
+ * @param n Number of values.
+ * @param field Optional field the values belong to, used to locate the
+ * element of a non-finite value.
+ * @param coeffs True if the values are coefficients of the field rather than
+ * values at the quadrature points.
+ */
+inline void assert_finite(const std::string &where, const std::string &name,
+                          const double *data, const std::size_t n,
+                          MR::ExpListSharedPtr field = nullptr,
+                          const bool coeffs = false) {
+  const std::int64_t index = find_non_finite(data, n);
+  if (index < 0) {
+    return;
+  }
+  std::stringstream msg;
+  msg << where << ": found non-finite value " << data[index] << " in field "
+      << name << " at " << (coeffs ? "coefficient " : "point ") << index
+      << " of " << n;
+  if (field) {
+    const int num_elements = field->GetExpSize();
+    for (int ex = num_elements - 1; ex >= 0; ex--) {
+      const int offset =
+          coeffs ? field->GetCoeff_Offset(ex) : field->GetPhys_Offset(ex);
+      if (offset <= index) {
+        msg << ", element " << ex << " (geometry id "
+            << field->GetExp(ex)->GetGeom()->GetGlobalID() << ")";
+        break;
+      }
+    }
+  }
+  msg << ".";
+  NESOASSERT(false, msg.str().c_str());
+}
+
+/**
+ * Periodic checks that the values of fields are finite, intended for the
+ * right hand side evaluations of time integrators. Each evaluation is a stage
+ * and the fields are checked on every interval-th stage with assert_finite,
+ * hence the checks can be left enabled in production runs.
+ *
+ * Configurable with the following session parameter (see create):
+ *  * field_health_check_interval: Check every nth stage, zero disables the
+ *    checks (default 1).
+ */
+class FieldHealthCheck {
+protected:
+  std::int64_t stage;
+  bool check_stage;
+
+public:
+  /// Number of stages between checks, checks are disabled if zero.
+  const int interval;
+
+  /**
+   * @param interval Check the fields on every interval-th stage, zero
+   * disables the checks.
+   */
+  FieldHealthCheck(const int interval = 1)
+      : stage(-1), check_stage(false), interval(interval) {
+    NESOASSERT(interval >= 0, "Field health check interval is negative.");
+  }
+
+  /**
+   * Create a health check configured from the session parameter
+   * field_health_check_interval.
+   *
+   * @param session Nektar++ session to read parameters from.
+   * @returns New health check instance.
+   */
+  static inline std::shared_ptr<FieldHealthCheck>
+  create(LU::SessionReaderSharedPtr session) {
+    int interval = 1;
+    session->LoadParameter("field_health_check_interval", interval, 1);
+    NESOASSERT(interval >= 0,
+               "field_health_check_interval must not be negative.");
+    return std::make_shared<FieldHealthCheck>(interval);
+  }
+
+  /**
+   * Start the next stage.
+   *
+   * @returns True if the fields are checked in this stage.
+   */
+  inline bool begin_stage() {
+    this->stage++;
+    this->check_stage =
+        (this->interval > 0) && (this->stage % this->interval == 0);
+    return this->check_stage;
+  }
+
+  /**
+   * @returns Index of the current stage, starting from zero.
+   */
+  inline std::int64_t get_stage() const { return this->stage; }
+
+  /**
+   * Check the values of a field if the current stage is checked.
+   *
+   * @param where Name of the calling method.
+   * @param name Name of the field.
+   * @param data Values at the quadrature points of the field.
+   * @param n Number of values.
+   * @param field Optional field, used to locate a non-finite value.
+   */
+  inline void check(const std::string &where, const std::string &name,
+                    const double *data, const std::size_t n,
+                    MR::ExpListSharedPtr field = nullptr) const {
+    if (this->check_stage && (find_non_finite(data, n) > -1)) {
+      assert_finite(where + " (stage " + std::to_string(this->stage) + ")",
+                    name, data, n, field);
+    }
+  }
+};
+
+typedef std::shared_ptr<FieldHealthCheck> FieldHealthCheckSharedPtr;
+
+} // namespace NESO
+
+#endif
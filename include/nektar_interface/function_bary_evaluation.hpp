@@ -13,6 +13,7 @@
 #include "bary_interpolation/bary_evaluation.hpp"
 #include "expansion_looping/geom_to_expansion_builder.hpp"
 #include "geometry_transport/shape_mapping.hpp"
+#include "reduced_precision.hpp"
 #include "utility_sycl.hpp"
 
 using namespace NESO::Particles;
@@ -52,14 +53,14 @@ protected:
   /// types.
   std::size_t max_num_phys;
 
-  template <typename GROUP_TYPE, typename U>
+  template <typename GROUP_TYPE, typename U, typename R>
   static inline void
   dispatch_2d(std::shared_ptr<GROUP_TYPE> particle_sub_group,
               const std::size_t num_functions, const int k_max_num_phys,
               const NekDouble *const RESTRICT k_global_physvals_interlaced,
               const CellInfo *const RESTRICT k_cell_info,
-              ParticleDatImplGetConstT<REAL> k_ref_positions,
-              ParticleDatImplGetT<U> *k_syms_ptrs, int *k_components) {
+              R k_ref_positions, ParticleDatImplGetT<U> *k_syms_ptrs,
+              int *k_components) {
     constexpr int ndim = 2;
     const std::size_t local_num_reals =
         static_cast<std::size_t>(ndim * k_max_num_phys) + num_functions;
@@ -76,8 +77,10 @@ protected:
 
           const auto cell_info = k_cell_info[cell];
 
-          const REAL xi0 = k_ref_positions[cell][0][layer];
-          const REAL xi1 = k_ref_positions[cell][1][layer];
+          const REAL xi0 =
+              ReducedPrecision::read(k_ref_positions, cell, 0, layer);
+          const REAL xi1 =
+              ReducedPrecision::read(k_ref_positions, cell, 1, layer);
           // If this cell is a triangle then we need to map to the
           // collapsed coordinates.
           REAL eta0, eta1;
@@ -110,7 +113,8 @@ protected:
           for (std::size_t fx = 0; fx < num_functions; fx++) {
             auto ptr = k_syms_ptrs[fx];
             auto component = k_components[fx];
-            ptr[cell][component][layer] = LOCAL_MEMORY.at(fx);
+            ReducedPrecision::write(ptr, cell, component, layer,
+                                    LOCAL_MEMORY.at(fx));
           }
         },
         Access::read(ParticleLoopIndex{}),
@@ -119,14 +123,14 @@ protected:
         ->execute();
   }
 
-  template <typename GROUP_TYPE, typename U>
+  template <typename GROUP_TYPE, typename U, typename R>
   static inline void
   dispatch_3d(std::shared_ptr<GROUP_TYPE> particle_sub_group,
               const std::size_t num_functions, const int k_max_num_phys,
               const NekDouble *const RESTRICT k_global_physvals_interlaced,
               const CellInfo *const RESTRICT k_cell_info,
-              ParticleDatImplGetConstT<REAL> k_ref_positions,
-              ParticleDatImplGetT<U> *k_syms_ptrs, int *k_components) {
+              R k_ref_positions, ParticleDatImplGetT<U> *k_syms_ptrs,
+              int *k_components) {
     constexpr int ndim = 3;
     const std::size_t local_num_reals =
         static_cast<std::size_t>(ndim * k_max_num_phys) + num_functions;
@@ -145,9 +149,12 @@ protected:
 
           const auto cell_info = k_cell_info[cell];
 
-          const REAL xi0 = k_ref_positions[cell][0][layer];
-          const REAL xi1 = k_ref_positions[cell][1][layer];
-          const REAL xi2 = k_ref_positions[cell][2][layer];
+          const REAL xi0 =
+              ReducedPrecision::read(k_ref_positions, cell, 0, layer);
+          const REAL xi1 =
+              ReducedPrecision::read(k_ref_positions, cell, 1, layer);
+          const REAL xi2 =
+              ReducedPrecision::read(k_ref_positions, cell, 2, layer);
           REAL eta0, eta1, eta2;
 
           GeometryInterface::loc_coord_to_loc_collapsed_3d(
@@ -183,7 +190,8 @@ protected:
           for (std::size_t fx = 0; fx < num_functions; fx++) {
             auto ptr = k_syms_ptrs[fx];
             auto component = k_components[fx];
-            ptr[cell][component][layer] = LOCAL_MEMORY.at(fx);
+            ReducedPrecision::write(ptr, cell, component, layer,
+                                    LOCAL_MEMORY.at(fx));
           }
         },
         Access::read(ParticleLoopIndex{}),
@@ -192,15 +200,15 @@ protected:
         ->execute();
   }
 
-  template <typename U>
+  template <typename U, typename R>
   static inline void
   dispatch_3d_cpu(SYCLTargetSharedPtr sycl_target, EventStack &es,
                   const std::size_t num_functions, const int k_max_num_phys,
                   const NekDouble *const RESTRICT k_global_physvals_interlaced,
                   const CellInfo *const RESTRICT k_cell_info,
                   ParticleDatSharedPtr<INT> mpi_rank_dat,
-                  ParticleDatImplGetConstT<REAL> k_ref_positions,
-                  ParticleDatImplGetT<U> *k_syms_ptrs, int *k_components) {
+                  R k_ref_positions, ParticleDatImplGetT<U> *k_syms_ptrs,
+                  int *k_components) {
     constexpr int ndim = 3;
     ParticleLoopImplementation::ParticleLoopBlockIterationSet ish{mpi_rank_dat};
     const std::size_t local_size =
@@ -270,9 +278,12 @@ protected:
 
                 for (std::size_t blockx = 0; blockx < local_bound; blockx++) {
                   const std::size_t px = particle_start + blockx;
-                  xi0[blockx] = k_ref_positions[cell][0][px];
-                  xi1[blockx] = k_ref_positions[cell][1][px];
-                  xi2[blockx] = k_ref_positions[cell][2][px];
+                  xi0[blockx] =
+                      ReducedPrecision::read(k_ref_positions, cell, 0, px);
+                  xi1[blockx] =
+                      ReducedPrecision::read(k_ref_positions, cell, 1, px);
+                  xi2[blockx] =
+                      ReducedPrecision::read(k_ref_positions, cell, 2, px);
                 }
 
                 for (std::size_t blockx = 0; blockx < NESO_VECTOR_BLOCK_SIZE;
@@ -298,8 +309,9 @@ protected:
                     const std::size_t px = particle_start + blockx;
                     auto ptr = k_syms_ptrs[fx];
                     auto component = k_components[fx];
-                    ptr[cell][component][px] =
-                        evaluations[fx * NESO_VECTOR_BLOCK_SIZE + blockx];
+                    ReducedPrecision::write(
+                        ptr, cell, component, px,
+                        evaluations[fx * NESO_VECTOR_BLOCK_SIZE + blockx]);
                   }
                 }
               }
@@ -308,19 +320,18 @@ protected:
     }
   }
 
-  template <typename GROUP_TYPE, typename U>
-  inline void
-  evaluate_inner(std::shared_ptr<GROUP_TYPE> particle_sub_group,
-                 std::vector<Sym<U>> syms, const std::vector<int> components,
-                 std::vector<Array<OneD, NekDouble> *> &global_physvals) {
-
-    auto particle_group = get_particle_group(particle_sub_group);
-
+  /**
+   * Copy the quadrature point values of the functions to the device and
+   * interlace them such that the values of all functions at a quadrature
+   * point are contiguous.
+   *
+   * @param global_physvals Phys values for each function.
+   * @returns Device pointer to the interlaced values.
+   */
+  inline NekDouble *copy_physvals_to_device(
+      std::vector<Array<OneD, NekDouble> *> &global_physvals) {
     EventStack es;
-    NESOASSERT(syms.size() == components.size(), "Input size missmatch");
-    NESOASSERT(global_physvals.size() == components.size(),
-               "Input size missmatch");
-    const std::size_t num_functions = static_cast<int>(syms.size());
+    const std::size_t num_functions = global_physvals.size();
     const std::size_t num_physvals_per_function = global_physvals.at(0)->size();
 
     // copy the quadrature point values over to the device
@@ -356,6 +367,28 @@ protected:
                        k_global_physvals_interlaced)
           .wait_and_throw();
     }
+    return k_global_physvals_interlaced;
+  }
+
+  template <typename GROUP_TYPE, typename U>
+  inline void
+  evaluate_inner(std::shared_ptr<GROUP_TYPE> particle_sub_group,
+                 std::vector<Sym<U>> syms, const std::vector<int> components,
+                 std::vector<Array<OneD, NekDouble> *> &global_physvals) {
+
+    auto particle_group = get_particle_group(particle_sub_group);
+
+    EventStack es;
+    NESOASSERT(syms.size() == components.size(), "Input size missmatch");
+    NESOASSERT(global_physvals.size() == components.size(),
+               "Input size missmatch");
+    const std::size_t num_functions = static_cast<int>(syms.size());
+    const std::size_t num_physvals_per_function = global_physvals.at(0)->size();
+
+    const std::size_t num_global_physvals =
+        num_functions * num_physvals_per_function;
+    NekDouble *k_global_physvals_interlaced =
+        this->copy_physvals_to_device(global_physvals);
 
     std::vector<ParticleDatImplGetT<U>> h_sym_ptrs(num_functions);
     for (std::size_t fx = 0; fx < num_functions; fx++) {
@@ -366,30 +399,47 @@ protected:
                                                      h_sym_ptrs);
     BufferDevice<int> d_components(this->sycl_target, components);
 
-    auto k_ref_positions = Access::direct_get(Access::read(
-        particle_group->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))));
+    // The mapper stores the reference positions in either precision, the
+    // evaluation itself is in double precision.
+    const bool reduced_precision = particle_group->contains_dat(
+        ReducedPrecision::get_reference_positions_sym());
+    const std::size_t ref_position_bytes =
+        reduced_precision ? sizeof(float) : sizeof(REAL);
+    const std::size_t output_bytes =
+        std::is_same_v<U, INT> ? sizeof(float) : sizeof(REAL);
 
     ProfileRegion pr("BaryEvaluateBase", "evaluate_" +
                                              std::to_string(this->ndim) + "d_" +
                                              std::to_string(num_functions));
-    if (this->ndim == 2) {
-      this->dispatch_2d(particle_sub_group, num_functions, this->max_num_phys,
-                        k_global_physvals_interlaced, this->d_cell_info->ptr,
-                        k_ref_positions, d_syms_ptrs.ptr, d_components.ptr);
-    } else {
-      if (this->sycl_target->device.is_gpu() ||
-          is_particle_sub_group(particle_sub_group)) {
-        this->dispatch_3d(particle_sub_group, num_functions, this->max_num_phys,
-                          k_global_physvals_interlaced, this->d_cell_info->ptr,
-                          k_ref_positions, d_syms_ptrs.ptr, d_components.ptr);
+    auto lambda_dispatch = [&](auto k_ref_positions) {
+      if (this->ndim == 2) {
+        this->dispatch_2d(particle_sub_group, num_functions,
+                          this->max_num_phys, k_global_physvals_interlaced,
+                          this->d_cell_info->ptr, k_ref_positions,
+                          d_syms_ptrs.ptr, d_components.ptr);
       } else {
-        this->dispatch_3d_cpu(this->sycl_target, es, num_functions,
-                              this->max_num_phys, k_global_physvals_interlaced,
-                              this->d_cell_info->ptr,
-                              particle_group->mpi_rank_dat, k_ref_positions,
-                              d_syms_ptrs.ptr, d_components.ptr);
+        if (this->sycl_target->device.is_gpu() ||
+            is_particle_sub_group(particle_sub_group)) {
+          this->dispatch_3d(particle_sub_group, num_functions,
+                            this->max_num_phys, k_global_physvals_interlaced,
+                            this->d_cell_info->ptr, k_ref_positions,
+                            d_syms_ptrs.ptr, d_components.ptr);
+        } else {
+          this->dispatch_3d_cpu(
+              this->sycl_target, es, num_functions, this->max_num_phys,
+              k_global_physvals_interlaced, this->d_cell_info->ptr,
+              particle_group->mpi_rank_dat, k_ref_positions, d_syms_ptrs.ptr,
+              d_components.ptr);
+        }
       }
-    }
+      // wait for the loop to complete before the pointers are restored
+      es.wait();
+    };
+    ReducedPrecision::visit_reference_positions(*particle_group, [&](auto dat) {
+      auto k_ref_positions = Access::direct_get(Access::read(dat));
+      lambda_dispatch(k_ref_positions);
+      Access::direct_restore(Access::read(dat), k_ref_positions);
+    });
 
     const auto nphys = this->max_num_phys;
     const auto npart = particle_sub_group->get_npart_local();
@@ -399,18 +449,14 @@ protected:
             ? nphys * nphys * (1 + num_functions * 2)
             : nphys * nphys + nphys * nphys * nphys * (1 + num_functions * 2);
     pr.num_flops = (nflop_loop + nflop_prepare) * npart;
-    pr.num_bytes = sizeof(REAL) * (npart * ((this->ndim + num_functions)) +
-                                   num_global_physvals);
-    // wait for the loop to complete
-    es.wait();
+    pr.num_bytes = npart * (ref_position_bytes * this->ndim +
+                            output_bytes * num_functions) +
+                   sizeof(REAL) * num_global_physvals;
     for (std::size_t fx = 0; fx < num_functions; fx++) {
       Access::direct_restore(
           Access::write(particle_group->get_dat(syms.at(fx))),
           h_sym_ptrs.at(fx));
     }
-    Access::direct_restore(Access::read(particle_group->get_dat(
-                               Sym<REAL>("NESO_REFERENCE_POSITIONS"))),
-                           k_ref_positions);
     pr.end();
     this->sycl_target->profile_map.add_region(pr);
   }
@@ -561,7 +607,9 @@ public:
    *
    *  @param particle_sub_group ParticleGroup or ParticleSubGroup containing the
    * particles.
-   *  @param syms Vector of Syms in which to place evaluations.
+   *  @param syms Vector of Syms in which to place evaluations. Evaluations
+   * placed in INT ParticleDats are stored in reduced precision, see
+   * ReducedPrecision.
    *  @param components Vector of components in which to place evaluations.
    *  @param global_physvals Phys values for each function to evaluate.
    */
@@ -577,6 +625,105 @@ public:
       NESOASSERT(false, "Not implemented in this number of dimensions.");
     }
   }
+
+  /**
+   *  Evaluate Nektar++ fields at a fixed set of points which are not stored
+   *  in a ParticleGroup, e.g. diagnostic probes. The points are described by
+   *  the NESO cell which contains them and the reference position within that
+   *  cell.
+   *
+   *  @param num_points Number of points to evaluate at.
+   *  @param d_cells Device pointer to the NESO cell of each point.
+   *  @param d_ref_positions Device pointer to the reference positions of the
+   *  points, ndim values per point.
+   *  @param global_physvals Phys values for each function to evaluate.
+   *  @param[out] d_output Device pointer to the evaluations, the evaluations
+   *  of all functions at a point are contiguous.
+   *  @returns Event for the evaluation kernel.
+   */
+  inline sycl::event
+  evaluate_points(const int num_points, const int *const d_cells,
+                  const REAL *const d_ref_positions,
+                  std::vector<Array<OneD, NekDouble> *> &global_physvals,
+                  REAL *d_output) {
+    NESOASSERT((this->ndim == 2) || (this->ndim == 3),
+               "Not implemented in this number of dimensions.");
+    if (num_points == 0) {
+      return sycl::event{};
+    }
+    const int num_functions = static_cast<int>(global_physvals.size());
+    const NekDouble *k_global_physvals_interlaced =
+        this->copy_physvals_to_device(global_physvals);
+    const CellInfo *k_cell_info = this->d_cell_info->ptr;
+    const int k_ndim = this->ndim;
+    const int k_max_num_phys = static_cast<int>(this->max_num_phys);
+    const std::size_t k_num_points = static_cast<std::size_t>(num_points);
+
+    const std::size_t local_num_reals =
+        static_cast<std::size_t>(k_ndim * k_max_num_phys);
+    const std::size_t default_local_size =
+        this->sycl_target->parameters
+            ->template get<SizeTParameter>("LOOP_LOCAL_SIZE")
+            ->value;
+    const std::size_t local_size = this->sycl_target->get_num_local_work_items(
+        local_num_reals * sizeof(REAL), default_local_size);
+    const std::size_t global_size = get_global_size(k_num_points, local_size);
+
+    return this->sycl_target->queue.submit([&](sycl::handler &cgh) {
+      sycl::local_accessor<REAL, 1> local_mem(
+          sycl::range<1>(local_num_reals * local_size), cgh);
+      cgh.parallel_for<>(
+          this->sycl_target->device_limits.validate_nd_range(sycl::nd_range<1>(
+              sycl::range<1>(global_size), sycl::range<1>(local_size))),
+          [=](sycl::nd_item<1> idx) {
+            const std::size_t px = idx.get_global_id(0);
+            if (px < k_num_points) {
+              REAL *div_space0 =
+                  &local_mem[0] + idx.get_local_id(0) * local_num_reals;
+              REAL *div_space1 = div_space0 + k_max_num_phys;
+              REAL *div_space2 = div_space1 + k_max_num_phys;
+              const auto cell_info = k_cell_info[d_cells[px]];
+              const REAL *xi = d_ref_positions + px * k_ndim;
+              const auto physvals =
+                  &k_global_physvals_interlaced[cell_info.phys_offset *
+                                                num_functions];
+              REAL *output = d_output + px * num_functions;
+              REAL eta0, eta1, eta2;
+              if (k_ndim == 2) {
+                GeometryInterface::loc_coord_to_loc_collapsed_2d(
+                    cell_info.shape_type_int, xi[0], xi[1], &eta0, &eta1);
+                Bary::preprocess_weights(cell_info.num_phys[0], eta0,
+                                         cell_info.d_z[0], cell_info.d_bw[0],
+                                         div_space0);
+                Bary::preprocess_weights(cell_info.num_phys[1], eta1,
+                                         cell_info.d_z[1], cell_info.d_bw[1],
+                                         div_space1);
+                Bary::compute_dir_10_interlaced(
+                    num_functions, cell_info.num_phys[0],
+                    cell_info.num_phys[1], physvals, div_space0, div_space1,
+                    output);
+              } else {
+                GeometryInterface::loc_coord_to_loc_collapsed_3d(
+                    cell_info.shape_type_int, xi[0], xi[1], xi[2], &eta0,
+                    &eta1, &eta2);
+                Bary::preprocess_weights(cell_info.num_phys[0], eta0,
+                                         cell_info.d_z[0], cell_info.d_bw[0],
+                                         div_space0);
+                Bary::preprocess_weights(cell_info.num_phys[1], eta1,
+                                         cell_info.d_z[1], cell_info.d_bw[1],
+                                         div_space1);
+                Bary::preprocess_weights(cell_info.num_phys[2], eta2,
+                                         cell_info.d_z[2], cell_info.d_bw[2],
+                                         div_space2);
+                Bary::compute_dir_210_interlaced(
+                    num_functions, cell_info.num_phys[0],
+                    cell_info.num_phys[1], cell_info.num_phys[2], physvals,
+                    div_space0, div_space1, div_space2, output);
+              }
+            }
+          });
+    });
+  }
 };
 
 } // namespace NESO
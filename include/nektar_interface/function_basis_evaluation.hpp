@@ -36,13 +36,14 @@ protected:
   /**
    *  Templated evaluation function for CRTP.
    */
-  template <typename EVALUATE_TYPE, typename COMPONENT_TYPE>
+  template <typename EVALUATE_TYPE, typename COMPONENT_TYPE,
+            typename REF_POSITIONS_TYPE>
   inline void evaluate_inner(
       [[maybe_unused]] EventStack &event_stack,
       ExpansionLooping::JacobiExpansionLoopingInterface<EVALUATE_TYPE>
           evaluation_type,
       ParticleGroupSharedPtr particle_group,
-      [[maybe_unused]] ParticleDatImplGetConstT<REAL> k_ref_positions,
+      [[maybe_unused]] REF_POSITIONS_TYPE k_ref_positions,
       [[maybe_unused]] ParticleDatImplGetT<COMPONENT_TYPE> k_output,
       [[maybe_unused]] Sym<COMPONENT_TYPE> sym, const int component) {
 
@@ -99,8 +100,8 @@ protected:
                                   idx_local * max_total_nummodes_sum;
 
             if (layerx < d_npart_cell[cellx]) {
-              // Get the number of modes in x and y
-              const int nummodes = loop_data.nummodes[cellx];
+              // Get the number of modes in each direction
+              const int *nummodes = loop_data.nummodes + 3 * cellx;
               REAL *dofs =
                   &loop_data.global_coeffs[loop_data.coeffs_offsets[cellx]];
               REAL *local_space_0, *local_space_1, *local_space_2;
@@ -113,11 +114,12 @@ protected:
                   &local_space_0, &local_space_1, &local_space_2);
 
               REAL evaluation = 0.0;
-              loop_type.loop_evaluate(nummodes, dofs, local_space_0,
-                                      local_space_1, local_space_2,
-                                      &evaluation);
+              loop_type.loop_evaluate(nummodes[0], nummodes[1], nummodes[2],
+                                      dofs, local_space_0, local_space_1,
+                                      local_space_2, &evaluation);
 
-              k_output[cellx][k_component][layerx] = evaluation;
+              ReducedPrecision::write(k_output, cellx, k_component, layerx,
+                                      evaluation);
             }
           });
     }));
@@ -128,13 +130,14 @@ protected:
   /**
    *  Templated evaluation function for CRTP for ParticleSubGroup.
    */
-  template <typename EVALUATE_TYPE, typename COMPONENT_TYPE>
+  template <typename EVALUATE_TYPE, typename COMPONENT_TYPE,
+            typename REF_POSITIONS_TYPE>
   inline void evaluate_inner(
       [[maybe_unused]] EventStack &event_stack,
       ExpansionLooping::JacobiExpansionLoopingInterface<EVALUATE_TYPE>
           evaluation_type,
       ParticleSubGroupSharedPtr particle_sub_group,
-      [[maybe_unused]] ParticleDatImplGetConstT<REAL> k_ref_positions,
+      [[maybe_unused]] REF_POSITIONS_TYPE k_ref_positions,
       [[maybe_unused]] ParticleDatImplGetT<COMPONENT_TYPE> k_output,
       [[maybe_unused]] Sym<COMPONENT_TYPE> sym, const int component) {
 
@@ -168,8 +171,8 @@ protected:
             ExpansionLooping::JacobiExpansionLoopingInterface<EVALUATE_TYPE>
                 loop_type{};
 
-            // Get the number of modes in x and y
-            const int nummodes = loop_data.nummodes[cellx];
+            // Get the number of modes in each direction
+            const int *nummodes = loop_data.nummodes + 3 * cellx;
             REAL *dofs =
                 &loop_data.global_coeffs[loop_data.coeffs_offsets[cellx]];
             REAL *local_space_0, *local_space_1, *local_space_2;
@@ -182,13 +185,15 @@ protected:
                 &local_space_0, &local_space_1, &local_space_2);
 
             REAL evaluation = 0.0;
-            loop_type.loop_evaluate(nummodes, dofs, local_space_0,
-                                    local_space_1, local_space_2, &evaluation);
+            loop_type.loop_evaluate(nummodes[0], nummodes[1], nummodes[2],
+                                    dofs, local_space_0, local_space_1,
+                                    local_space_2, &evaluation);
 
-            OUTPUT.at(k_component) = evaluation;
+            ReducedPrecision::set(OUTPUT, k_component, evaluation);
           },
           Access::write(local_space),
-          Access::read(Sym<REAL>("NESO_REFERENCE_POSITIONS")),
+          Access::read(
+              ReducedPrecision::get_reference_positions_sym(k_ref_positions)),
           Access::write(sym))
           ->execute(cellx);
     }
@@ -221,7 +226,9 @@ public:
    * Evaluate nektar++ function at particle locations.
    *
    * @param particle_group Source container of particles.
-   * @param sym Symbol of ParticleDat within the ParticleGroup.
+   * @param sym Symbol of ParticleDat within the ParticleGroup. Evaluations
+   * placed in an INT ParticleDat are stored in reduced precision, see
+   * ReducedPrecision.
    * @param component Determine which component of the ParticleDat is
    * the output for function evaluations.
    * @param global_coeffs source DOFs which are evaluated.
@@ -239,39 +246,46 @@ public:
       this->dh_global_coeffs.h_buffer.ptr[px] = global_coeffs[px];
     }
     this->dh_global_coeffs.host_to_device();
+    this->apply_particle_shape(this->dh_global_coeffs.d_buffer.ptr,
+                               num_global_coeffs);
 
-    auto k_ref_positions = Access::direct_get(
-        Access::read(get_particle_group(particle_group)
-                         ->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))));
     auto k_output = Access::direct_get(
         Access::write(get_particle_group(particle_group)->get_dat(sym)));
 
-    EventStack event_stack{};
-    if (this->mesh->get_ndim() == 2) {
-      evaluate_inner(event_stack, ExpansionLooping::Quadrilateral{},
-                     particle_group, k_ref_positions, k_output, sym, component);
-
-      evaluate_inner(event_stack, ExpansionLooping::Triangle{}, particle_group,
-                     k_ref_positions, k_output, sym, component);
-    } else {
-      evaluate_inner(event_stack, ExpansionLooping::Hexahedron{},
-                     particle_group, k_ref_positions, k_output, sym, component);
-      evaluate_inner(event_stack, ExpansionLooping::Pyramid{}, particle_group,
-                     k_ref_positions, k_output, sym, component);
-      evaluate_inner(event_stack, ExpansionLooping::Prism{}, particle_group,
-                     k_ref_positions, k_output, sym, component);
-      evaluate_inner(event_stack, ExpansionLooping::Tetrahedron{},
-                     particle_group, k_ref_positions, k_output, sym, component);
-    }
-    event_stack.wait();
-
-    Access::direct_restore(
-        Access::write(get_particle_group(particle_group)->get_dat(sym)),
-        k_output);
-    Access::direct_restore(
-        Access::read(get_particle_group(particle_group)
-                         ->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))),
-        k_ref_positions);
+    // The mapper stores the reference positions in either precision, the
+    // evaluation itself is in double precision.
+    auto lambda_dispatch = [&](auto k_ref_positions) {
+      EventStack event_stack{};
+      if (this->mesh->get_ndim() == 2) {
+        evaluate_inner(event_stack, ExpansionLooping::Quadrilateral{},
+                       particle_group, k_ref_positions, k_output, sym,
+                       component);
+        evaluate_inner(event_stack, ExpansionLooping::Triangle{},
+                       particle_group, k_ref_positions, k_output, sym,
+                       component);
+      } else {
+        evaluate_inner(event_stack, ExpansionLooping::Hexahedron{},
+                       particle_group, k_ref_positions, k_output, sym,
+                       component);
+        evaluate_inner(event_stack, ExpansionLooping::Pyramid{},
+                       particle_group, k_ref_positions, k_output, sym,
+                       component);
+        evaluate_inner(event_stack, ExpansionLooping::Prism{}, particle_group,
+                       k_ref_positions, k_output, sym, component);
+        evaluate_inner(event_stack, ExpansionLooping::Tetrahedron{},
+                       particle_group, k_ref_positions, k_output, sym,
+                       component);
+      }
+      event_stack.wait();
+    };
+    auto group = get_particle_group(particle_group);
+    ReducedPrecision::visit_reference_positions(*group, [&](auto dat) {
+      auto k_ref_positions = Access::direct_get(Access::read(dat));
+      lambda_dispatch(k_ref_positions);
+      Access::direct_restore(Access::read(dat), k_ref_positions);
+    });
+
+    Access::direct_restore(Access::write(group->get_dat(sym)), k_output);
   }
 };
 
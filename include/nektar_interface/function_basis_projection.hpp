@@ -35,13 +35,14 @@ protected:
   /**
    *  Templated projection function for CRTP.
    */
-  template <typename PROJECT_TYPE, typename COMPONENT_TYPE>
+  template <typename PROJECT_TYPE, typename COMPONENT_TYPE,
+            typename REF_POSITIONS_TYPE>
   inline void project_inner(
       [[maybe_unused]] EventStack &event_stack,
       ExpansionLooping::JacobiExpansionLoopingInterface<PROJECT_TYPE>
           project_type,
       ParticleGroupSharedPtr particle_group,
-      [[maybe_unused]] ParticleDatImplGetConstT<REAL> k_ref_positions,
+      [[maybe_unused]] REF_POSITIONS_TYPE k_ref_positions,
       [[maybe_unused]] ParticleDatImplGetConstT<COMPONENT_TYPE> k_input,
       [[maybe_unused]] Sym<COMPONENT_TYPE> sym, const int component) {
 
@@ -96,8 +97,8 @@ protected:
                                   idx_local * max_total_nummodes_sum;
 
             if (layerx < d_npart_cell[cellx]) {
-              // Get the number of modes in x and y
-              const int nummodes = loop_data.nummodes[cellx];
+              // Get the number of modes in each direction
+              const int *nummodes = loop_data.nummodes + 3 * cellx;
               REAL *dofs =
                   &loop_data.global_coeffs[loop_data.coeffs_offsets[cellx]];
               REAL *local_space_0, *local_space_1, *local_space_2;
@@ -110,8 +111,9 @@ protected:
                   &local_space_0, &local_space_1, &local_space_2);
 
               const double value = k_input[cellx][k_component][layerx];
-              loop_type.loop_project(nummodes, value, local_space_0,
-                                     local_space_1, local_space_2, dofs);
+              loop_type.loop_project(nummodes[0], nummodes[1], nummodes[2],
+                                     value, local_space_0, local_space_1,
+                                     local_space_2, dofs);
             }
           });
     }));
@@ -120,13 +122,14 @@ protected:
   /**
    *  Templated projection function for CRTP for ParticleSubGroup.
    */
-  template <typename PROJECT_TYPE, typename COMPONENT_TYPE>
+  template <typename PROJECT_TYPE, typename COMPONENT_TYPE,
+            typename REF_POSITIONS_TYPE>
   inline void project_inner(
       [[maybe_unused]] EventStack &event_stack,
       ExpansionLooping::JacobiExpansionLoopingInterface<PROJECT_TYPE>
           project_type,
       ParticleSubGroupSharedPtr particle_sub_group,
-      [[maybe_unused]] ParticleDatImplGetConstT<REAL> k_ref_positions,
+      [[maybe_unused]] REF_POSITIONS_TYPE k_ref_positions,
       [[maybe_unused]] ParticleDatImplGetConstT<COMPONENT_TYPE> k_input,
       [[maybe_unused]] Sym<COMPONENT_TYPE> sym, const int component) {
 
@@ -160,8 +163,8 @@ protected:
             ExpansionLooping::JacobiExpansionLoopingInterface<PROJECT_TYPE>
                 loop_type{};
 
-            // Get the number of modes in x and y
-            const int nummodes = loop_data.nummodes[cellx];
+            // Get the number of modes in each direction
+            const int *nummodes = loop_data.nummodes + 3 * cellx;
             REAL *dofs =
                 &loop_data.global_coeffs[loop_data.coeffs_offsets[cellx]];
             REAL *local_space_0, *local_space_1, *local_space_2;
@@ -174,11 +177,13 @@ protected:
                 &local_space_0, &local_space_1, &local_space_2);
 
             const auto value = VALUE.at(k_component);
-            loop_type.loop_project(nummodes, value, local_space_0,
-                                   local_space_1, local_space_2, dofs);
+            loop_type.loop_project(nummodes[0], nummodes[1], nummodes[2],
+                                   value, local_space_0, local_space_1,
+                                   local_space_2, dofs);
           },
           Access::write(local_space),
-          Access::read(Sym<REAL>("NESO_REFERENCE_POSITIONS")),
+          Access::read(
+              ReducedPrecision::get_reference_positions_sym(k_ref_positions)),
           Access::read(sym))
           ->execute(cellx);
     }
@@ -206,61 +211,91 @@ public:
       : BasisEvaluateBase<T>(field, mesh, cell_id_translation) {}
 
   /**
-   * Project particle data onto a function.
+   * Project particle data onto a function and leave the resulting RHS values
+   * in device memory. The returned pointer is owned by this instance and is
+   * valid until the next call to project or project_device.
    *
    * @param particle_group Source container of particles.
    * @param sym Symbol of ParticleDat within the ParticleGroup.
    * @param component Determine which component of the ParticleDat is
    * projected.
-   * @param global_coeffs[in,out] RHS in the Ax=b L2 projection system.
+   * @param num_global_coeffs Number of coefficients in the RHS of the Ax=b L2
+   * projection system.
+   * @returns Device pointer to the num_global_coeffs RHS values.
    */
-  template <typename GROUP_TYPE, typename U, typename V>
-  inline void project(std::shared_ptr<GROUP_TYPE> particle_group, Sym<U> sym,
-                      const int component, V &global_coeffs) {
+  template <typename GROUP_TYPE, typename U>
+  inline REAL *project_device(std::shared_ptr<GROUP_TYPE> particle_group,
+                              Sym<U> sym, const int component,
+                              const int num_global_coeffs) {
 
     static_assert((std::is_same_v<GROUP_TYPE, ParticleGroup> ||
                    std::is_same_v<GROUP_TYPE, ParticleSubGroup>),
                   "Expected ParticleGroup or ParticleSubGroup");
 
-    const int num_global_coeffs = global_coeffs.size();
     this->dh_global_coeffs.realloc_no_copy(num_global_coeffs);
     this->sycl_target->queue
         .fill(this->dh_global_coeffs.d_buffer.ptr, static_cast<REAL>(0.0),
               num_global_coeffs)
         .wait_and_throw();
 
-    auto k_ref_positions = Access::direct_get(
-        Access::read(get_particle_group(particle_group)
-                         ->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))));
     auto k_output = Access::direct_get(
         Access::read(get_particle_group(particle_group)->get_dat(sym)));
 
-    EventStack event_stack{};
-    if (this->mesh->get_ndim() == 2) {
-      project_inner(event_stack, ExpansionLooping::Quadrilateral{},
-                    particle_group, k_ref_positions, k_output, sym, component);
-
-      project_inner(event_stack, ExpansionLooping::Triangle{}, particle_group,
-                    k_ref_positions, k_output, sym, component);
-    } else {
-      project_inner(event_stack, ExpansionLooping::Hexahedron{}, particle_group,
-                    k_ref_positions, k_output, sym, component);
-      project_inner(event_stack, ExpansionLooping::Pyramid{}, particle_group,
-                    k_ref_positions, k_output, sym, component);
-      project_inner(event_stack, ExpansionLooping::Prism{}, particle_group,
-                    k_ref_positions, k_output, sym, component);
-      project_inner(event_stack, ExpansionLooping::Tetrahedron{},
-                    particle_group, k_ref_positions, k_output, sym, component);
-    }
+    // The mapper stores the reference positions in either precision, the
+    // projection itself is in double precision.
+    auto lambda_dispatch = [&](auto k_ref_positions) {
+      EventStack event_stack{};
+      if (this->mesh->get_ndim() == 2) {
+        project_inner(event_stack, ExpansionLooping::Quadrilateral{},
+                      particle_group, k_ref_positions, k_output, sym,
+                      component);
+        project_inner(event_stack, ExpansionLooping::Triangle{},
+                      particle_group, k_ref_positions, k_output, sym,
+                      component);
+      } else {
+        project_inner(event_stack, ExpansionLooping::Hexahedron{},
+                      particle_group, k_ref_positions, k_output, sym,
+                      component);
+        project_inner(event_stack, ExpansionLooping::Pyramid{},
+                      particle_group, k_ref_positions, k_output, sym,
+                      component);
+        project_inner(event_stack, ExpansionLooping::Prism{}, particle_group,
+                      k_ref_positions, k_output, sym, component);
+        project_inner(event_stack, ExpansionLooping::Tetrahedron{},
+                      particle_group, k_ref_positions, k_output, sym,
+                      component);
+      }
+      event_stack.wait();
+    };
+    auto group = get_particle_group(particle_group);
+    ReducedPrecision::visit_reference_positions(*group, [&](auto dat) {
+      auto k_ref_positions = Access::direct_get(Access::read(dat));
+      lambda_dispatch(k_ref_positions);
+      Access::direct_restore(Access::read(dat), k_ref_positions);
+    });
+
+    this->apply_particle_shape(this->dh_global_coeffs.d_buffer.ptr,
+                               num_global_coeffs);
+    Access::direct_restore(Access::read(group->get_dat(sym)), k_output);
+
+    return this->dh_global_coeffs.d_buffer.ptr;
+  }
+
+  /**
+   * Project particle data onto a function.
+   *
+   * @param particle_group Source container of particles.
+   * @param sym Symbol of ParticleDat within the ParticleGroup.
+   * @param component Determine which component of the ParticleDat is
+   * projected.
+   * @param global_coeffs[in,out] RHS in the Ax=b L2 projection system.
+   */
+  template <typename GROUP_TYPE, typename U, typename V>
+  inline void project(std::shared_ptr<GROUP_TYPE> particle_group, Sym<U> sym,
+                      const int component, V &global_coeffs) {
 
-    event_stack.wait();
-    Access::direct_restore(
-        Access::read(get_particle_group(particle_group)->get_dat(sym)),
-        k_output);
-    Access::direct_restore(
-        Access::read(get_particle_group(particle_group)
-                         ->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))),
-        k_ref_positions);
+    const int num_global_coeffs = global_coeffs.size();
+    this->project_device(particle_group, sym, component, num_global_coeffs);
 
     this->dh_global_coeffs.device_to_host();
     for (int px = 0; px < num_global_coeffs; px++) {
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include <LibUtilities/BasicUtils/SharedArray.hpp>
 #include <MultiRegions/ContField.h>
@@ -13,6 +14,8 @@
 #include "function_bary_evaluation.hpp"
 #include "function_basis_evaluation.hpp"
 #include "particle_interface.hpp"
+#include "particle_shape.hpp"
+#include "reduced_precision.hpp"
 
 using namespace Nektar::LibUtilities;
 using namespace NESO::Particles;
@@ -40,6 +43,15 @@ private:
   // used for scalar values
   std::shared_ptr<FunctionEvaluateBasis<T>> function_evaluate_basis;
 
+  // quadrature point values of the derivatives, reused between calls
+  std::vector<Array<OneD, NekDouble>> deriv_physvals;
+  std::vector<Array<OneD, NekDouble> *> deriv_physvals_ptrs;
+
+  // particle shape applied before the derivatives are computed
+  ParticleShapeFilterSharedPtr particle_shape_filter;
+  Array<OneD, NekDouble> shape_coeffs;
+  Array<OneD, NekDouble> shape_physvals;
+
 public:
   ~FieldEvaluate(){};
 
@@ -71,6 +83,16 @@ public:
                  "Derivative evaluation supported in 2D and 3D only.");
       this->bary_evaluate_base = std::make_shared<BaryEvaluateBase<T>>(
           field, particle_mesh_interface, cell_id_translation);
+
+      const int ndim = particle_mesh_interface->ndim;
+      const int num_quadrature_points = this->field->GetTotPoints();
+      this->deriv_physvals.resize(ndim);
+      this->deriv_physvals_ptrs.resize(ndim);
+      for (int dx = 0; dx < ndim; dx++) {
+        this->deriv_physvals.at(dx) =
+            Array<OneD, NekDouble>(num_quadrature_points);
+        this->deriv_physvals_ptrs.at(dx) = &this->deriv_physvals.at(dx);
+      }
     } else {
       auto mesh = std::dynamic_pointer_cast<ParticleMeshInterface>(
           particle_group->domain->mesh);
@@ -80,6 +102,30 @@ public:
     }
   };
 
+  /**
+   *  Set the shape of the particles the field is evaluated for. The default
+   *  shape is a point particle. Using the shape set on the FieldProject or
+   *  FunctionProjectBasis which deposits the source of this field gives an
+   *  energy conserving coupling as deposition and evaluation are adjoint.
+   *
+   *  @param shape New particle shape.
+   */
+  inline void set_particle_shape(const ParticleShape shape) {
+    if (this->derivative) {
+      if (shape.type == ParticleShapeType::Delta) {
+        this->particle_shape_filter = nullptr;
+      } else {
+        this->particle_shape_filter = std::make_shared<ParticleShapeFilter>(
+            this->sycl_target, this->field, shape);
+        this->shape_coeffs = Array<OneD, NekDouble>(this->field->GetNcoeffs());
+        this->shape_physvals =
+            Array<OneD, NekDouble>(this->field->GetTotPoints());
+      }
+    } else {
+      this->function_evaluate_basis->set_particle_shape(shape);
+    }
+  }
+
   /**
    *  Evaluate the field at the particle locations and place the result in the
    *  ParticleDat indexed by the passed symbol. This call assumes that the
@@ -91,7 +137,8 @@ public:
    *  @param particle_sub_group ParticleSubGroup created from the ParticleGroup
    *  this evaluation instance was created from or the original ParticleGroup.
    *  @param sym ParticleDat in the ParticleGroup of this object in which to
-   *  place the evaluations.
+   *  place the evaluations. Evaluations placed in an INT ParticleDat are
+   *  stored in reduced precision, see ReducedPrecision.
    */
   template <typename GROUP_TYPE, typename U>
   inline void evaluate(std::shared_ptr<GROUP_TYPE> particle_sub_group,
@@ -100,30 +147,33 @@ public:
     if (this->derivative) {
       const auto ndim = this->particle_group->domain->mesh->get_ndim();
       const auto ncomp = this->particle_group->get_dat(sym)->ncomp;
-      NESOASSERT(ncomp >= ndim, "Output ParticleDat does not have a sufficient "
-                                "number of components.");
+      const int ncomp_required = std::is_same_v<U, INT>
+                                     ? ReducedPrecision::get_ncomp(ndim)
+                                     : ndim;
+      NESOASSERT(ncomp >= ncomp_required,
+                 "Output ParticleDat does not have a sufficient "
+                 "number of components.");
 
       auto global_physvals = this->field->GetPhys();
-      const int num_quadrature_points = this->field->GetTotPoints();
-
-      std::vector<Array<OneD, NekDouble>> deriv_physvals(ndim);
-      for (int dx = 0; dx < ndim; dx++) {
-        deriv_physvals.at(dx) = Array<OneD, NekDouble>(num_quadrature_points);
+      if (this->particle_shape_filter) {
+        this->particle_shape_filter->apply(this->field->GetCoeffs(),
+                                           this->shape_coeffs);
+        this->field->BwdTrans(this->shape_coeffs, this->shape_physvals);
+        global_physvals = this->shape_physvals;
       }
       for (int dx = 0; dx < ndim; dx++) {
-        this->field->PhysDeriv(dx, global_physvals, deriv_physvals.at(dx));
+        this->field->PhysDeriv(dx, global_physvals,
+                               this->deriv_physvals.at(dx));
       }
 
       std::vector<Sym<U>> syms(ndim);
       std::vector<int> components(ndim);
-      std::vector<Array<OneD, NekDouble> *> deriv_physvals_ptrs(ndim);
       for (int dx = 0; dx < ndim; dx++) {
         syms.at(dx) = sym;
         components.at(dx) = dx;
-        deriv_physvals_ptrs.at(dx) = &deriv_physvals.at(dx);
       }
       this->bary_evaluate_base->evaluate(particle_sub_group, syms, components,
-                                         deriv_physvals_ptrs);
+                                         this->deriv_physvals_ptrs);
 
     } else {
       auto global_coeffs = this->field->GetCoeffs();
@@ -0,0 +1,374 @@
+#ifndef __FUNCTION_HOMOGENEOUS_1D_H_
+#define __FUNCTION_HOMOGENEOUS_1D_H_
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <LibUtilities/BasicUtils/Vmath.hpp>
+#include <MultiRegions/ContField.h>
+#include <MultiRegions/DisContField.h>
+#include <MultiRegions/ExpList.h>
+#include <neso_particles.hpp>
+
+#include "function_evaluation.hpp"
+#include "function_projection.hpp"
+#include "reduced_precision.hpp"
+
+using namespace Nektar;
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Helpers for Nektar++ homogeneous 1D (2.5D) expansions, i.e. a 2D expansion
+ * in (x, y) on each of a set of equispaced planes in z with a Fourier
+ * expansion in z. In physical space plane n holds the values at
+ * z_n = n * L / N, where L is the homogeneous length and N the number of
+ * planes. All planes are expected to be stored on each MPI rank.
+ */
+namespace Homogeneous1D {
+
+/**
+ * @param field Nektar++ field with a homogeneous 1D expansion.
+ * @returns True if the field is a homogeneous 1D expansion.
+ */
+inline bool is_homogeneous_1d(MultiRegions::ExpListSharedPtr field) {
+  return field->GetExpType() == MultiRegions::e3DH1D;
+}
+
+/**
+ * Check that a field is a homogeneous 1D expansion with all planes stored on
+ * this MPI rank.
+ *
+ * @param field Nektar++ field to check.
+ * @returns Number of planes of the field.
+ */
+inline int check_field(MultiRegions::ExpListSharedPtr field) {
+  NESOASSERT(is_homogeneous_1d(field),
+             "Expected a homogeneous 1D (3DH1D) expansion.");
+  const int num_planes = field->GetHomogeneousBasis()->GetNumModes();
+  NESOASSERT(static_cast<int>(field->GetZIDs().size()) == num_planes,
+             "The planes of homogeneous 1D expansions must not be distributed "
+             "over MPI ranks.");
+  NESOASSERT(num_planes % 2 == 0, "Expected an even number of planes.");
+  return num_planes;
+}
+
+/**
+ * Weight of the value on a plane in the trigonometric interpolant of the
+ * plane values, for an even number of equispaced planes.
+ *
+ * @param num_planes Number of planes.
+ * @param theta Angle, 2 * pi * (z - z_n) / L, between the point and the
+ * plane.
+ * @returns Weight of the plane value at the point.
+ */
+inline REAL interpolation_weight(const int num_planes, const REAL theta) {
+  // Reduce the angle into [-pi, pi).
+  const REAL two_pi = 2.0 * M_PI;
+  const REAL t = theta - two_pi * sycl::floor((theta + M_PI) / two_pi);
+  const REAL half = 0.5 * t;
+  const REAL tan_half = sycl::tan(half);
+  if (sycl::fabs(tan_half) < 1.0e-12) {
+    return 1.0;
+  }
+  return sycl::sin(num_planes * half) / (num_planes * tan_half);
+}
+
+/**
+ * @param field Nektar++ field with a homogeneous 1D expansion.
+ * @returns Wavenumber, 2 * pi * k / L, of each plane in Fourier space.
+ */
+inline std::vector<REAL> get_wavenumbers(MultiRegions::ExpListSharedPtr field) {
+  const int num_planes = field->GetZIDs().size();
+  const REAL lhom = field->GetHomoLen();
+  auto transposition = field->GetTransposition();
+  std::vector<REAL> wavenumbers(num_planes);
+  for (int nx = 0; nx < num_planes; nx++) {
+    wavenumbers[nx] = 2.0 * M_PI * transposition->GetK(nx) / lhom;
+  }
+  return wavenumbers;
+}
+
+/**
+ * Compute the second derivative in z of values at the quadrature points of a
+ * homogeneous 1D expansion. The derivative is a diagonal multiply in Fourier
+ * space.
+ *
+ * @param field Nektar++ field with a homogeneous 1D expansion.
+ * @param inarray Values at the quadrature points.
+ * @param[out] outarray Second derivative at the quadrature points.
+ */
+inline void deriv_zz(MultiRegions::ExpListSharedPtr field,
+                     const Array<OneD, const NekDouble> &inarray,
+                     Array<OneD, NekDouble> &outarray) {
+  const int npts = field->GetTotPoints();
+  const int num_planes = field->GetZIDs().size();
+  const int plane_npts = npts / num_planes;
+  const auto wavenumbers = get_wavenumbers(field);
+
+  Array<OneD, NekDouble> wave(npts);
+  field->HomogeneousFwdTrans(npts, inarray, wave);
+  for (int nx = 0; nx < num_planes; nx++) {
+    const REAL beta = wavenumbers[nx];
+    NekDouble *plane_wave = wave.data() + nx * plane_npts;
+    Vmath::Smul(plane_npts, -beta * beta, plane_wave, 1, plane_wave, 1);
+  }
+  field->HomogeneousBwdTrans(npts, wave, outarray);
+}
+
+/**
+ * Solve the Helmholtz problem on a continuous homogeneous 1D expansion as a
+ * batch of independent 2D problems, one per Fourier mode. The second
+ * derivative in z of mode k is -beta_k^2, hence the 2D problem of mode k has
+ * the factor lambda + d22 * beta_k^2.
+ *
+ * @param field Nektar++ ContField3DHomogeneous1D to solve on.
+ * @param rhs Right hand side at the quadrature points.
+ * @param[out] outarray Solution coefficients in Fourier space, transform with
+ * field->BwdTrans.
+ * @param factors Factors of the 2D problems.
+ * @param d22 Coefficient of the second derivative in z.
+ */
+inline void helm_solve(MultiRegions::ExpListSharedPtr field,
+                       const Array<OneD, const NekDouble> &rhs,
+                       Array<OneD, NekDouble> &outarray,
+                       const StdRegions::ConstFactorMap &factors,
+                       const NekDouble d22) {
+  const int npts = field->GetTotPoints();
+  const int num_planes = field->GetZIDs().size();
+  const auto wavenumbers = get_wavenumbers(field);
+  auto transposition = field->GetTransposition();
+
+  Array<OneD, NekDouble> wave(npts), tmp_in, tmp_out;
+  field->HomogeneousFwdTrans(npts, rhs, wave);
+  Vmath::Zero(outarray.size(), outarray, 1);
+  int phys_offset = 0;
+  int coeff_offset = 0;
+  for (int nx = 0; nx < num_planes; nx++) {
+    auto plane = field->GetPlane(nx);
+    // Plane 1 holds the (zero) sine of the mean mode.
+    if ((nx != 1) || (transposition->GetK(nx) != 0)) {
+      StdRegions::ConstFactorMap plane_factors = factors;
+      plane_factors[StdRegions::eFactorLambda] +=
+          d22 * wavenumbers[nx] * wavenumbers[nx];
+      plane->HelmSolve(tmp_in = wave + phys_offset,
+                       tmp_out = outarray + coeff_offset, plane_factors);
+    }
+    phys_offset += plane->GetTotPoints();
+    coeff_offset += plane->GetNcoeffs();
+  }
+}
+
+} // namespace Homogeneous1D
+
+/**
+ * Evaluate a Nektar++ homogeneous 1D (2.5D) field at particle locations. The
+ * particles are mapped onto the 2D mesh of the planes by
+ * NektarGraphLocalMapper and hold their z coordinate in an additional
+ * component of the position ParticleDat. Each plane is evaluated at the (x, y)
+ * position of the particles and the plane values are interpolated in z with
+ * the trigonometric interpolant, which is exact for the Fourier expansion.
+ */
+template <typename T> class FieldEvaluateHomogeneous1D {
+protected:
+  MultiRegions::ExpListSharedPtr field;
+  ParticleGroupSharedPtr particle_group;
+  std::shared_ptr<FunctionEvaluateBasis<T>> function_evaluate_basis;
+  int num_planes;
+  int z_component;
+  REAL lhom;
+  Sym<REAL> plane_sym;
+  Array<OneD, NekDouble> plane_coeffs;
+
+public:
+  /**
+   * Create a new evaluation object.
+   *
+   * @param field Nektar++ homogeneous 1D field, the planes must be of type T.
+   * @param particle_group ParticleGroup with positions mapped by
+   * NektarGraphLocalMapper on the 2D mesh of the planes.
+   * @param cell_id_translation CellIDTranslation used to map between NESO
+   * cell ids and Nektar++ geometry object ids.
+   * @param z_component Component of the position ParticleDat which holds the
+   * z coordinate (default 2).
+   */
+  FieldEvaluateHomogeneous1D(MultiRegions::ExpListSharedPtr field,
+                             ParticleGroupSharedPtr particle_group,
+                             CellIDTranslationSharedPtr cell_id_translation,
+                             const int z_component = 2)
+      : field(field), particle_group(particle_group),
+        z_component(z_component),
+        plane_sym(Sym<REAL>("NESO_HOMOGENEOUS_1D_PLANE_EVALS")) {
+    this->num_planes = Homogeneous1D::check_field(field);
+    this->lhom = field->GetHomoLen();
+    NESOASSERT(particle_group->position_dat->ncomp > z_component,
+               "Position ParticleDat has no z component.");
+
+    auto plane = std::dynamic_pointer_cast<T>(field->GetPlane(0));
+    NESOASSERT(plane != nullptr, "Unexpected type of homogeneous plane.");
+    auto mesh = std::dynamic_pointer_cast<ParticleMeshInterface>(
+        particle_group->domain->mesh);
+    this->function_evaluate_basis = std::make_shared<FunctionEvaluateBasis<T>>(
+        plane, mesh, cell_id_translation);
+    this->plane_coeffs = Array<OneD, NekDouble>(plane->GetNcoeffs());
+    if (!particle_group->contains_dat(this->plane_sym)) {
+      particle_group->add_particle_dat(this->plane_sym, this->num_planes);
+    }
+  }
+
+  /**
+   * Evaluate the field at the particle locations and place the result in the
+   * ParticleDat indexed by the passed symbol. Evaluations placed in an INT
+   * ParticleDat are stored in reduced precision, see ReducedPrecision.
+   *
+   * @param sym ParticleDat in the ParticleGroup of this object in which to
+   * place the evaluations.
+   */
+  template <typename U> inline void evaluate(Sym<U> sym) {
+    // Evaluate the physical space values of each plane.
+    int phys_offset = 0;
+    Array<OneD, const NekDouble> tmp;
+    for (int nx = 0; nx < this->num_planes; nx++) {
+      auto plane = this->field->GetPlane(nx);
+      plane->FwdTransLocalElmt(tmp = this->field->GetPhys() + phys_offset,
+                               this->plane_coeffs);
+      this->function_evaluate_basis->evaluate(
+          this->particle_group, this->plane_sym, nx, this->plane_coeffs);
+      phys_offset += plane->GetTotPoints();
+    }
+
+    // Interpolate the plane values in z.
+    const int k_num_planes = this->num_planes;
+    const int k_z = this->z_component;
+    const REAL k_theta_scale = 2.0 * M_PI / this->lhom;
+    const REAL k_plane_theta = 2.0 * M_PI / this->num_planes;
+    particle_loop(
+        "FieldEvaluateHomogeneous1D::evaluate", this->particle_group,
+        [=](auto P, auto PLANES, auto OUT) {
+          const REAL theta = k_theta_scale * P.at(k_z);
+          REAL value = 0.0;
+          for (int nx = 0; nx < k_num_planes; nx++) {
+            value += PLANES.at(nx) * Homogeneous1D::interpolation_weight(
+                                         k_num_planes,
+                                         theta - nx * k_plane_theta);
+          }
+          ReducedPrecision::set(OUT, 0, value);
+        },
+        Access::read(this->particle_group->position_dat),
+        Access::read(this->plane_sym), Access::write(sym))
+        ->execute();
+  }
+};
+
+/**
+ * Project particle data onto a Nektar++ homogeneous 1D (2.5D) field. Each
+ * particle is a Dirac delta in (x, y, z). The projection onto the Fourier
+ * expansion in z of a delta at z_p has the value
+ * (N / L) * w_n(z_p) on plane n, where w_n is the trigonometric interpolation
+ * weight of plane n. The particle data is therefore projected onto all planes
+ * at once, with one 2D projection per plane, using these weights.
+ */
+template <typename T> class FieldProjectHomogeneous1D {
+protected:
+  MultiRegions::ExpListSharedPtr field;
+  ParticleGroupSharedPtr particle_group;
+  std::shared_ptr<FieldProject<T>> field_project;
+  int num_planes;
+  int z_component;
+  REAL lhom;
+  Sym<REAL> plane_sym;
+
+public:
+  /**
+   * Create a new projection object.
+   *
+   * @param field Nektar++ homogeneous 1D field, the planes must be of type T.
+   * @param particle_group ParticleGroup with positions mapped by
+   * NektarGraphLocalMapper on the 2D mesh of the planes.
+   * @param cell_id_translation CellIDTranslation used to map between NESO
+   * cell ids and Nektar++ geometry object ids.
+   * @param z_component Component of the position ParticleDat which holds the
+   * z coordinate (default 2).
+   */
+  FieldProjectHomogeneous1D(MultiRegions::ExpListSharedPtr field,
+                            ParticleGroupSharedPtr particle_group,
+                            CellIDTranslationSharedPtr cell_id_translation,
+                            const int z_component = 2)
+      : field(field), particle_group(particle_group),
+        z_component(z_component),
+        plane_sym(Sym<REAL>("NESO_HOMOGENEOUS_1D_PLANE_WEIGHTS")) {
+    this->num_planes = Homogeneous1D::check_field(field);
+    this->lhom = field->GetHomoLen();
+    NESOASSERT(particle_group->position_dat->ncomp > z_component,
+               "Position ParticleDat has no z component.");
+
+    std::vector<std::shared_ptr<T>> planes(this->num_planes);
+    for (int nx = 0; nx < this->num_planes; nx++) {
+      planes[nx] = std::dynamic_pointer_cast<T>(field->GetPlane(nx));
+      NESOASSERT(planes[nx] != nullptr,
+                 "Unexpected type of homogeneous plane.");
+    }
+    this->field_project = std::make_shared<FieldProject<T>>(
+        planes, particle_group, cell_id_translation);
+    if (!particle_group->contains_dat(this->plane_sym)) {
+      particle_group->add_particle_dat(this->plane_sym, this->num_planes);
+    }
+  }
+
+  /**
+   * Project a particle property onto the field. The physical space values of
+   * the field are set and the coefficients are recomputed from them.
+   *
+   * @param sym ParticleDat to use as the particle weights.
+   * @param component Component of the ParticleDat to project.
+   */
+  inline void project(Sym<REAL> sym, const int component = 0) {
+    const int k_num_planes = this->num_planes;
+    const int k_z = this->z_component;
+    const int k_component = component;
+    const REAL k_theta_scale = 2.0 * M_PI / this->lhom;
+    const REAL k_plane_theta = 2.0 * M_PI / this->num_planes;
+    const REAL k_density_scale = this->num_planes / this->lhom;
+    particle_loop(
+        "FieldProjectHomogeneous1D::project", this->particle_group,
+        [=](auto P, auto Q, auto PLANES) {
+          const REAL theta = k_theta_scale * P.at(k_z);
+          const REAL q = k_density_scale * Q.at(k_component);
+          for (int nx = 0; nx < k_num_planes; nx++) {
+            PLANES.at(nx) = q * Homogeneous1D::interpolation_weight(
+                                    k_num_planes, theta - nx * k_plane_theta);
+          }
+        },
+        Access::read(this->particle_group->position_dat), Access::read(sym),
+        Access::write(this->plane_sym))
+        ->execute();
+
+    std::vector<Sym<REAL>> syms(this->num_planes, this->plane_sym);
+    std::vector<int> components(this->num_planes);
+    for (int nx = 0; nx < this->num_planes; nx++) {
+      components[nx] = nx;
+    }
+    this->field_project->project(syms, components);
+
+    // Gather the plane values into the physical space values of the field,
+    // which the planes usually alias, then recompute the coefficients.
+    int phys_offset = 0;
+    Array<OneD, NekDouble> tmp;
+    for (int nx = 0; nx < this->num_planes; nx++) {
+      auto plane = this->field->GetPlane(nx);
+      const int plane_npts = plane->GetTotPoints();
+      Vmath::Vcopy(plane_npts, plane->GetPhys(), 1,
+                   tmp = this->field->UpdatePhys() + phys_offset, 1);
+      phys_offset += plane_npts;
+    }
+    this->field->FwdTrans(this->field->GetPhys(), this->field->UpdateCoeffs());
+  }
+};
+
+} // namespace NESO
+
+#endif
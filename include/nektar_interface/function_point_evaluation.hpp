@@ -0,0 +1,341 @@
+#ifndef __FUNCTION_POINT_EVALUATION_H_
+#define __FUNCTION_POINT_EVALUATION_H_
+
+#include <memory>
+#include <mpi.h>
+#include <vector>
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <neso_particles.hpp>
+
+#include "function_bary_evaluation.hpp"
+#include "parameter_store.hpp"
+#include "particle_interface.hpp"
+#include "reduced_precision.hpp"
+
+using namespace Nektar::LibUtilities;
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Points located in the local elements of the MPI rank which owns them, see
+ * locate_points.
+ */
+struct LocatedPoints {
+  /// NESO-Particles cell of each point held by this rank.
+  std::vector<int> cells;
+  /// Reference position of each point held by this rank, ndim values each.
+  std::vector<REAL> ref_positions;
+  /// Index of each point held by this rank in the points of the passing rank.
+  std::vector<int> ids;
+  /// The rank which passed each point held by this rank.
+  std::vector<int> ranks;
+  /// Map from the cells to Nektar++ geometry ids.
+  CellIDTranslationSharedPtr cell_id_translation;
+};
+
+/**
+ * Locate points, given in physical coordinates, with the same device cell
+ * mapping used for particles. A temporary ParticleGroup moves each point to
+ * the rank which owns it and computes the reference position, then the
+ * located points are copied out and the ParticleGroup is freed. Must be
+ * called collectively.
+ *
+ * @param sycl_target Compute device to locate the points on.
+ * @param mesh ParticleMeshInterface containing the MeshGraph.
+ * @param points Physical coordinates of the points passed by this rank, ndim
+ * values per point.
+ * @param config ParameterStore to configure the cell mapping, see
+ * NektarGraphLocalMapper.
+ * @returns The points held by this rank after locating.
+ */
+inline LocatedPoints
+locate_points(SYCLTargetSharedPtr sycl_target,
+              ParticleMeshInterfaceSharedPtr mesh,
+              const std::vector<REAL> &points,
+              ParameterStoreSharedPtr config =
+                  std::make_shared<ParameterStore>()) {
+  const int ndim = mesh->get_ndim();
+  const int num_points = points.size() / ndim;
+  auto domain = std::make_shared<Domain>(
+      mesh,
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh, config));
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<INT>("POINT_ID"), 1),
+                             ParticleProp(Sym<INT>("POINT_RANK"), 1)};
+  auto particle_group =
+      std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+
+  LocatedPoints located;
+  located.cell_id_translation = std::make_shared<CellIDTranslation>(
+      sycl_target, particle_group->cell_id_dat, mesh);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  if (num_points > 0) {
+    ParticleSet initial_distribution(num_points,
+                                     particle_group->get_particle_spec());
+    for (int px = 0; px < num_points; px++) {
+      for (int dx = 0; dx < ndim; dx++) {
+        initial_distribution[Sym<REAL>("P")][px][dx] = points[px * ndim + dx];
+      }
+      initial_distribution[Sym<INT>("POINT_ID")][px][0] = px;
+      initial_distribution[Sym<INT>("POINT_RANK")][px][0] = rank;
+    }
+    particle_group->add_particles_local(initial_distribution);
+  }
+  particle_group->hybrid_move();
+  particle_group->cell_move();
+
+  const int cell_count = mesh->get_cell_count();
+  auto id_dat = particle_group->get_dat(Sym<INT>("POINT_ID"));
+  auto rank_dat = particle_group->get_dat(Sym<INT>("POINT_RANK"));
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto ids = id_dat->cell_dat.get_cell(cellx);
+    auto ranks = rank_dat->cell_dat.get_cell(cellx);
+    // The mapper config may store the reference positions in reduced
+    // precision.
+    CellDataT<REAL> ref_positions(sycl_target, ids->nrow, ndim);
+    ReducedPrecision::get_reference_positions_cell(*particle_group, cellx,
+                                                   ref_positions);
+    for (int rowx = 0; rowx < ids->nrow; rowx++) {
+      located.cells.push_back(cellx);
+      located.ids.push_back(static_cast<int>((*ids)[0][rowx]));
+      located.ranks.push_back(static_cast<int>((*ranks)[0][rowx]));
+      for (int dx = 0; dx < ndim; dx++) {
+        located.ref_positions.push_back(ref_positions[dx][rowx]);
+      }
+    }
+  }
+  particle_group->free();
+  return located;
+}
+
+/**
+ * Evaluate a Nektar++ field, or the derivatives of the field, at a batch of
+ * points given in physical coordinates. Each rank may pass any set of points
+ * in the domain. The points are located once on construction with the same
+ * device cell mapping (CoarseLookupMap and Newton iterations) used for
+ * particles, after which each evaluation is a single Bary interpolation
+ * kernel launch and an exchange of the results back to the rank which passed
+ * each point. This replaces loops over evaluate_scalar_2d and similar which
+ * locate and evaluate each point on the host.
+ *
+ * All methods are collective on the communicator of the SYCLTarget.
+ */
+template <typename T> class FieldPointEvaluate {
+protected:
+  std::shared_ptr<T> field;
+  SYCLTargetSharedPtr sycl_target;
+  MPI_Comm comm;
+  int ndim;
+  int num_points;
+  int num_local_points;
+  std::shared_ptr<BaryEvaluateBase<T>> bary_evaluate_base;
+  std::unique_ptr<BufferDevice<int>> d_cells;
+  std::unique_ptr<BufferDevice<REAL>> d_ref_positions;
+  std::unique_ptr<BufferDeviceHost<REAL>> dh_evaluations;
+
+  // Points held by this rank in the order they are sent back to the ranks
+  // which passed them and the index of each received evaluation.
+  std::vector<int> send_order;
+  std::vector<int> send_counts;
+  std::vector<int> recv_counts;
+  std::vector<int> recv_ids;
+  std::vector<REAL> send_buffer;
+  std::vector<REAL> recv_buffer;
+
+  std::vector<Array<OneD, NekDouble>> deriv_physvals;
+  std::vector<Array<OneD, NekDouble> *> deriv_physvals_ptrs;
+
+  static inline void get_displs(const std::vector<int> &counts,
+                                const int factor, std::vector<int> &scaled,
+                                std::vector<int> &displs) {
+    const int size = counts.size();
+    scaled.resize(size);
+    displs.resize(size);
+    int total = 0;
+    for (int rx = 0; rx < size; rx++) {
+      scaled[rx] = counts[rx] * factor;
+      displs[rx] = total;
+      total += scaled[rx];
+    }
+  }
+
+  inline void evaluate_physvals(
+      std::vector<Array<OneD, NekDouble> *> &global_physvals,
+      std::vector<REAL> &output) {
+    const int ncomp = global_physvals.size();
+    if (this->num_local_points > 0) {
+      this->bary_evaluate_base
+          ->evaluate_points(this->num_local_points, this->d_cells->ptr,
+                            this->d_ref_positions->ptr, global_physvals,
+                            this->dh_evaluations->d_buffer.ptr)
+          .wait_and_throw();
+      this->dh_evaluations->device_to_host();
+    }
+
+    const REAL *evaluations = this->dh_evaluations->h_buffer.ptr;
+    this->send_buffer.resize(this->num_local_points * ncomp);
+    for (int sx = 0; sx < this->num_local_points; sx++) {
+      const int px = this->send_order[sx];
+      for (int cx = 0; cx < ncomp; cx++) {
+        this->send_buffer[sx * ncomp + cx] = evaluations[px * ncomp + cx];
+      }
+    }
+    this->recv_buffer.resize(this->num_points * ncomp);
+    std::vector<int> send_counts_comp, send_displs, recv_counts_comp,
+        recv_displs;
+    get_displs(this->send_counts, ncomp, send_counts_comp, send_displs);
+    get_displs(this->recv_counts, ncomp, recv_counts_comp, recv_displs);
+    MPICHK(MPI_Alltoallv(this->send_buffer.data(), send_counts_comp.data(),
+                         send_displs.data(), MPI_DOUBLE,
+                         this->recv_buffer.data(), recv_counts_comp.data(),
+                         recv_displs.data(), MPI_DOUBLE, this->comm));
+
+    output.resize(this->num_points * ncomp);
+    for (int rx = 0; rx < this->num_points; rx++) {
+      const int px = this->recv_ids[rx];
+      for (int cx = 0; cx < ncomp; cx++) {
+        output[px * ncomp + cx] = this->recv_buffer[rx * ncomp + cx];
+      }
+    }
+  }
+
+public:
+  /// Disable (implicit) copies.
+  FieldPointEvaluate(const FieldPointEvaluate &st) = delete;
+  /// Disable (implicit) copies.
+  FieldPointEvaluate &operator=(FieldPointEvaluate const &a) = delete;
+
+  /**
+   * Locate a batch of points for evaluation of a field.
+   *
+   * @param sycl_target Compute device to locate and evaluate the points on.
+   * @param mesh ParticleMeshInterface containing the MeshGraph the field is
+   * defined on.
+   * @param field Nektar++ field to evaluate.
+   * @param points Physical coordinates of the points passed by this rank,
+   * ndim values per point. Every point must lie within the domain.
+   * @param config ParameterStore to configure the cell mapping, see
+   * NektarGraphLocalMapper.
+   */
+  FieldPointEvaluate(
+      SYCLTargetSharedPtr sycl_target, ParticleMeshInterfaceSharedPtr mesh,
+      std::shared_ptr<T> field, const std::vector<REAL> &points,
+      ParameterStoreSharedPtr config = std::make_shared<ParameterStore>())
+      : field(field), sycl_target(sycl_target),
+        comm(sycl_target->comm_pair.comm_parent), ndim(mesh->get_ndim()) {
+
+    NESOASSERT((this->ndim == 2) || (this->ndim == 3),
+               "FieldPointEvaluate: unsupported number of dimensions.");
+    NESOASSERT(points.size() % this->ndim == 0,
+               "FieldPointEvaluate: expected ndim values per point.");
+    this->num_points = points.size() / this->ndim;
+
+    auto located = locate_points(sycl_target, mesh, points, config);
+    this->bary_evaluate_base = std::make_shared<BaryEvaluateBase<T>>(
+        field, mesh, located.cell_id_translation);
+    auto &h_cells = located.cells;
+    auto &h_ref_positions = located.ref_positions;
+    auto &h_ids = located.ids;
+    auto &h_ranks = located.ranks;
+    const int size = sycl_target->comm_pair.size_parent;
+
+    this->num_local_points = h_cells.size();
+    int counts[2] = {this->num_points, this->num_local_points};
+    MPICHK(MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_INT, MPI_SUM,
+                         this->comm));
+    NESOASSERT(counts[0] == counts[1],
+               "FieldPointEvaluate: points were lost in binning, are all "
+               "points within the domain?");
+
+    if (this->num_local_points == 0) {
+      h_cells.push_back(0);
+      h_ref_positions.resize(this->ndim, 0.0);
+    }
+    this->d_cells = std::make_unique<BufferDevice<int>>(sycl_target, h_cells);
+    this->d_ref_positions =
+        std::make_unique<BufferDevice<REAL>>(sycl_target, h_ref_positions);
+    this->dh_evaluations = std::make_unique<BufferDeviceHost<REAL>>(
+        sycl_target, std::max(1, this->num_local_points * this->ndim));
+
+    // Order the points held by this rank by the rank which passed them and
+    // send the point indices to those ranks once.
+    this->send_counts.assign(size, 0);
+    for (const int rx : h_ranks) {
+      this->send_counts[rx]++;
+    }
+    std::vector<int> send_counts_tmp, send_displs;
+    get_displs(this->send_counts, 1, send_counts_tmp, send_displs);
+    this->send_order.resize(this->num_local_points);
+    std::vector<int> send_ids(this->num_local_points);
+    std::vector<int> offsets = send_displs;
+    for (int px = 0; px < this->num_local_points; px++) {
+      const int sx = offsets[h_ranks[px]]++;
+      this->send_order[sx] = px;
+      send_ids[sx] = h_ids[px];
+    }
+
+    this->recv_counts.resize(size);
+    MPICHK(MPI_Alltoall(this->send_counts.data(), 1, MPI_INT,
+                        this->recv_counts.data(), 1, MPI_INT, this->comm));
+    std::vector<int> recv_counts_tmp, recv_displs;
+    get_displs(this->recv_counts, 1, recv_counts_tmp, recv_displs);
+    this->recv_ids.resize(this->num_points);
+    MPICHK(MPI_Alltoallv(send_ids.data(), this->send_counts.data(),
+                         send_displs.data(), MPI_INT, this->recv_ids.data(),
+                         this->recv_counts.data(), recv_displs.data(), MPI_INT,
+                         this->comm));
+
+    const int num_quadrature_points = this->field->GetTotPoints();
+    this->deriv_physvals.resize(this->ndim);
+    this->deriv_physvals_ptrs.resize(this->ndim);
+    for (int dx = 0; dx < this->ndim; dx++) {
+      this->deriv_physvals.at(dx) =
+          Array<OneD, NekDouble>(num_quadrature_points);
+      this->deriv_physvals_ptrs.at(dx) = &this->deriv_physvals.at(dx);
+    }
+  }
+
+  /**
+   * @returns Number of points passed to this rank on construction.
+   */
+  inline int get_num_points() const { return this->num_points; }
+
+  /**
+   * Evaluate the field at the points. Uses the current quadrature point
+   * values of the field.
+   *
+   * @param[out] output Evaluation at each point passed by this rank.
+   */
+  inline void evaluate(std::vector<REAL> &output) {
+    // The values are only read, wrap them without a copy.
+    auto phys = this->field->GetPhys();
+    Array<OneD, NekDouble> global_physvals(
+        phys.size(), const_cast<NekDouble *>(phys.data()), true);
+    std::vector<Array<OneD, NekDouble> *> global_physvals_ptrs = {
+        &global_physvals};
+    this->evaluate_physvals(global_physvals_ptrs, output);
+  }
+
+  /**
+   * Evaluate the derivatives of the field at the points. Uses the current
+   * quadrature point values of the field.
+   *
+   * @param[out] output Derivatives at each point passed by this rank, ndim
+   * values per point.
+   */
+  inline void evaluate_derivative(std::vector<REAL> &output) {
+    auto global_physvals = this->field->GetPhys();
+    for (int dx = 0; dx < this->ndim; dx++) {
+      this->field->PhysDeriv(dx, global_physvals, this->deriv_physvals.at(dx));
+    }
+    this->evaluate_physvals(this->deriv_physvals_ptrs, output);
+  }
+};
+
+} // namespace NESO
+
+#endif
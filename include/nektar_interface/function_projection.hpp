@@ -12,8 +12,10 @@
 #include <neso_particles.hpp>
 
 #include "basis_reference.hpp"
+#include "field_health_check.hpp"
 #include "function_basis_projection.hpp"
 #include "particle_interface.hpp"
+#include "reduced_precision.hpp"
 
 using namespace Nektar::MultiRegions;
 using namespace Nektar::LibUtilities;
@@ -167,6 +169,18 @@ public:
     }
   };
 
+  /**
+   * Set the shape of the particles used for projection. The default shape is
+   * a point particle. The same shape should be set on the FieldEvaluate
+   * instances which evaluate fields derived from the projection to obtain an
+   * energy conserving coupling.
+   *
+   * @param shape New particle shape.
+   */
+  inline void set_particle_shape(const ParticleShape shape) {
+    this->function_project_basis->set_particle_shape(shape);
+  }
+
   /**
    * Enable recording of computed values for testing.
    */
@@ -211,15 +225,12 @@ public:
                "Bad number of components passed. i.e. Does not match number of "
                "fields.");
 
-    auto ref_position_dat =
-        (*this->particle_group)[Sym<REAL>("NESO_REFERENCE_POSITIONS")];
-
     // This is the same for all the ParticleDats
     const int nrow_max =
         this->particle_group->mpi_rank_dat->cell_dat.get_nrow_max();
 
     // space to store the reference positions for each particle
-    const int particle_ndim = ref_position_dat->ncomp;
+    const int particle_ndim = this->particle_group->domain->mesh->get_ndim();
     CellDataT<REAL> ref_positions_tmp(this->sycl_target, nrow_max,
                                       particle_ndim);
 
@@ -280,8 +291,8 @@ public:
             neso_cellx, *input_tmp[fieldx], event_stack);
       }
       // Get the reference positions from the particle in the cell
-      ref_position_dat->cell_dat.get_cell_async(neso_cellx, ref_positions_tmp,
-                                                event_stack);
+      ReducedPrecision::get_reference_positions_cell(
+          *this->particle_group, neso_cellx, ref_positions_tmp);
 
       // Get the nektar++ geometry id that corresponds to this NESO cell id
       const int nektar_geom_id =
@@ -312,11 +323,11 @@ public:
                    "Missmatch in expansion offset.");
       }
 
-      const int num_modes = nektar_expansion_0->GetBasis(0)->GetNumModes();
-      for (int dimx = 0; dimx < particle_ndim; dimx++) {
-        NESOASSERT(nektar_expansion_0->GetBasis(dimx)->GetNumModes() ==
-                       num_modes,
-                   "Missmatch in number of modes across dimensions.");
+      // get the number of modes in each direction, which may differ for
+      // tensor product expansions
+      int num_modes[3] = {1, 1, 1};
+      for (int dimx = 0; dimx < nektar_expansion_0->GetNumBases(); dimx++) {
+        num_modes[dimx] = nektar_expansion_0->GetBasis(dimx)->GetNumModes();
       }
 
       // wait for the copy of particle data to host
@@ -334,7 +345,8 @@ public:
         }
         nektar_expansion_0->LocCoordToLocCollapsed(local_coord,
                                                    local_collapsed);
-        BasisReference::eval_modes(shape_type, num_modes, local_collapsed[0],
+        BasisReference::eval_modes(shape_type, num_modes[0], num_modes[1],
+                                   num_modes[2], local_collapsed[0],
                                    local_collapsed[1], local_collapsed[2],
                                    mode_evaluations);
 
@@ -366,15 +378,20 @@ public:
     Array<OneD, NekDouble> global_coeffs = Array<OneD, NekDouble>(ncoeffs);
     const int tot_points = this->fields[0]->GetTotPoints();
     Array<OneD, NekDouble> global_phys(tot_points);
+    auto particle_shape_filter =
+        this->function_project_basis->get_particle_shape_filter();
     for (int fieldx = 0; fieldx < nfields; fieldx++) {
+      if (particle_shape_filter) {
+        particle_shape_filter->apply(*global_phi[fieldx], *global_phi[fieldx]);
+      }
+      assert_finite("FieldProject::project_host",
+                    "projection RHS " + std::to_string(fieldx),
+                    global_phi[fieldx]->data(), ncoeffs, this->fields[fieldx],
+                    true);
       for (int cx = 0; cx < ncoeffs; cx++) {
-        const double rhs_tmp = (*global_phi[fieldx])[cx];
-        NESOASSERT(std::isfinite(rhs_tmp), "A projection RHS value is nan.");
-
         if (this->is_testing) {
-          this->testing_host_rhs.push_back(rhs_tmp);
+          this->testing_host_rhs.push_back((*global_phi[fieldx])[cx]);
         }
-
         global_coeffs[cx] = 0.0;
       }
 
@@ -382,9 +399,10 @@ public:
       multiply_by_inverse_mass_matrix(this->fields[fieldx], *global_phi[fieldx],
                                       global_coeffs);
 
+      assert_finite("FieldProject::project_host",
+                    "projection LHS " + std::to_string(fieldx),
+                    global_coeffs.data(), ncoeffs, this->fields[fieldx], true);
       for (int cx = 0; cx < ncoeffs; cx++) {
-        NESOASSERT(std::isfinite(global_coeffs[cx]),
-                   "A projection LHS value is nan.");
         // set the coefficients on the function
         this->fields[fieldx]->SetCoeff(cx, global_coeffs[cx]);
       }
@@ -446,8 +464,8 @@ public:
                "Particle(Sub)Group does not have the same domain as the one "
                "this class "
                "instance was created with.");
-    NESOASSERT(get_particle_group(particle_sub_group)
-                   ->contains_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS")),
+    NESOASSERT(ReducedPrecision::contains_reference_positions(
+                   *get_particle_group(particle_sub_group)),
                "Particle(Sub)Group does not contain NESO_REFERENCE_POSITIONS "
                "ParticleDat");
 
@@ -493,15 +511,19 @@ public:
     Array<OneD, NekDouble> global_coeffs = Array<OneD, NekDouble>(ncoeffs);
     const int tot_points = this->fields[0]->GetTotPoints();
     Array<OneD, NekDouble> global_phys(tot_points);
+    auto particle_shape_filter =
+        this->function_project_basis->get_particle_shape_filter();
     for (int fieldx = 0; fieldx < nfields; fieldx++) {
+      if (particle_shape_filter) {
+        particle_shape_filter->apply(*global_phi[fieldx], *global_phi[fieldx]);
+      }
+      assert_finite("FieldProject::project",
+                    "projection RHS " + std::to_string(fieldx),
+                    global_phi[fieldx]->data(), ncoeffs, this->fields[fieldx],
+                    true);
       for (int cx = 0; cx < ncoeffs; cx++) {
-        const double rhs_tmp = (*global_phi[fieldx])[cx];
-        std::string error_message =
-            "A projection RHS value is nan:" + std::to_string(fieldx) + " " +
-            std::to_string(cx);
-        NESOASSERT(std::isfinite(rhs_tmp), error_message.c_str());
         if (this->is_testing) {
-          this->testing_device_rhs.push_back(rhs_tmp);
+          this->testing_device_rhs.push_back((*global_phi[fieldx])[cx]);
         }
         global_coeffs[cx] = 0.0;
       }
@@ -510,9 +532,10 @@ public:
       multiply_by_inverse_mass_matrix(this->fields[fieldx], *global_phi[fieldx],
                                       global_coeffs);
 
+      assert_finite("FieldProject::project",
+                    "projection LHS " + std::to_string(fieldx),
+                    global_coeffs.data(), ncoeffs, this->fields[fieldx], true);
       for (int cx = 0; cx < ncoeffs; cx++) {
-        NESOASSERT(std::isfinite(global_coeffs[cx]),
-                   "A projection LHS value is nan.");
         // set the coefficients on the function
         this->fields[fieldx]->SetCoeff(cx, global_coeffs[cx]);
       }
@@ -362,7 +362,8 @@ inline void halo_unpack_2D_geoms(
  * @param[in] offset Integer offset to apply to MeshHierarchy cells in all
  * coordinate directions.
  * @param[in,out] particle_mesh_interface ParticleMeshInterface to extend the
- * halos of.
+ * halos of. If it holds a SetupCache, the extended halos are read from the
+ * cache when present and written to it otherwise.
  * @param [in] pbc Assume periodic extension of the halos is required, default
  * true.
  */
@@ -5,6 +5,10 @@
 #include "packed_geom_2d.hpp"
 #include <SpatialDomains/MeshGraph.h>
 
+#include <cstring>
+#include <map>
+#include <vector>
+
 using namespace Nektar;
 
 namespace NESO {
@@ -12,13 +16,61 @@ namespace NESO {
 /*
  * Class to pack and unpack a set of 2D Geometry objects.
  *
+ * All the objects are packed together in a structure-of-arrays layout. Each
+ * vertex and each edge is stored once, however many of the packed objects
+ * share it, and the objects refer to edges, and the edges to vertices, by
+ * index. Curves of edges and objects are stored as offsets into a single
+ * array of curve points. The buffer layout is a header of array lengths
+ * followed by the arrays:
+ *
+ *   num_geoms, num_edges, num_vertices, num_curves, num_curve_points,
+ *   num_geom_edges
+ *   geoms:        shape_type, rank, local_id, id, num_edges, curve
+ *                 (num_geoms each), edge indices (num_geom_edges)
+ *   edges:        id, coordim, vertex0, vertex1, curve (num_edges each)
+ *   vertices:     vid, coordim (num_vertices each), xyz (3 * num_vertices)
+ *   curves:       id, points type, points offset (num_curves each)
+ *   curve points: vid, coordim (num_curve_points each), xyz (3 * ...)
+ *
+ * where a curve index of -1 indicates no curve. Unpacking creates each
+ * vertex and edge once, such that the unpacked objects share them as they
+ * would in a MeshGraph.
  */
 class PackedGeoms2D {
 private:
+  static constexpr int num_header = 6;
+
   unsigned char *buf_in;
   int input_length = 0;
   int offset = 0;
 
+  // Arrays of the structure-of-arrays layout.
+  std::vector<int> geom_shape_type;
+  std::vector<int> geom_rank;
+  std::vector<int> geom_local_id;
+  std::vector<int> geom_id;
+  std::vector<int> geom_num_edges;
+  std::vector<int> geom_curve;
+  std::vector<int> geom_edges;
+  std::vector<int> edge_id;
+  std::vector<int> edge_coordim;
+  std::vector<int> edge_vertex0;
+  std::vector<int> edge_vertex1;
+  std::vector<int> edge_curve;
+  std::vector<int> vertex_vid;
+  std::vector<int> vertex_coordim;
+  std::vector<NekDouble> vertex_coords;
+  std::vector<int> curve_id;
+  std::vector<int> curve_ptype;
+  std::vector<int> curve_offset;
+  std::vector<int> curve_point_vid;
+  std::vector<int> curve_point_coordim;
+  std::vector<NekDouble> curve_point_coords;
+
+  // Maps from global ids to indices, used to deduplicate when packing.
+  std::map<int, int> vertex_index;
+  std::map<int, int> edge_index;
+
   int get_packed_count() {
     int packed_count;
     ASSERTL0(input_length >= sizeof(int), "Input buffer has no count.");
@@ -28,6 +80,213 @@ private:
     return packed_count;
   }
 
+  inline void add_point(SpatialDomains::PointGeomSharedPtr point,
+                        std::vector<int> &vids, std::vector<int> &coordims,
+                        std::vector<NekDouble> &coords) {
+    NekDouble x, y, z;
+    point->GetCoords(x, y, z);
+    vids.push_back(point->GetVid());
+    coordims.push_back(point->GetCoordim());
+    coords.push_back(x);
+    coords.push_back(y);
+    coords.push_back(z);
+  }
+
+  inline int add_vertex(SpatialDomains::PointGeomSharedPtr point) {
+    const int vid = point->GetVid();
+    auto it = this->vertex_index.find(vid);
+    if (it != this->vertex_index.end()) {
+      return it->second;
+    }
+    const int index = this->vertex_vid.size();
+    this->vertex_index[vid] = index;
+    add_point(point, this->vertex_vid, this->vertex_coordim,
+              this->vertex_coords);
+    return index;
+  }
+
+  inline int add_curve(SpatialDomains::CurveSharedPtr curve) {
+    if (curve == nullptr) {
+      return -1;
+    }
+    const int index = this->curve_id.size();
+    this->curve_id.push_back(curve->m_curveID);
+    this->curve_ptype.push_back(static_cast<int>(curve->m_ptype));
+    for (auto &point : curve->m_points) {
+      add_point(point, this->curve_point_vid, this->curve_point_coordim,
+                this->curve_point_coords);
+    }
+    this->curve_offset.push_back(this->curve_point_vid.size());
+    return index;
+  }
+
+  inline int add_edge(SpatialDomains::SegGeomSharedPtr seg_geom) {
+    const int id = seg_geom->GetGlobalID();
+    auto it = this->edge_index.find(id);
+    if (it != this->edge_index.end()) {
+      return it->second;
+    }
+    ASSERTL0(seg_geom->GetNumVerts() == 2, "Expected two vertices per edge.");
+    const int index = this->edge_id.size();
+    this->edge_index[id] = index;
+    this->edge_id.push_back(id);
+    this->edge_coordim.push_back(seg_geom->GetCoordim());
+    this->edge_vertex0.push_back(add_vertex(seg_geom->GetVertex(0)));
+    this->edge_vertex1.push_back(add_vertex(seg_geom->GetVertex(1)));
+    auto curve = seg_geom->GetCurve();
+    this->edge_curve.push_back(add_curve(curve));
+    return index;
+  }
+
+  template <typename T>
+  inline void add_geom(const int rank, const int local_id,
+                       std::shared_ptr<T> &geom) {
+    auto extern_geom = std::static_pointer_cast<
+        GeometryTransport::GeomExtern<T>>(geom);
+    const int num_edges = extern_geom->GetNumEdges();
+    this->geom_shape_type.push_back(
+        shape_type_to_int(extern_geom->GetShapeType()));
+    this->geom_rank.push_back(rank);
+    this->geom_local_id.push_back(local_id);
+    this->geom_id.push_back(extern_geom->GetGlobalID());
+    this->geom_num_edges.push_back(num_edges);
+    for (int edgex = 0; edgex < num_edges; edgex++) {
+      this->geom_edges.push_back(add_edge(extern_geom->GetSegGeom(edgex)));
+    }
+    this->geom_curve.push_back(add_curve(extern_geom->GetCurve()));
+  }
+
+  template <typename U> inline void push_array(const std::vector<U> &data) {
+    const std::size_t size = data.size() * sizeof(U);
+    const std::size_t offset_old = this->buf.size();
+    this->buf.resize(offset_old + size);
+    if (size > 0) {
+      std::memcpy(this->buf.data() + offset_old, data.data(), size);
+    }
+  }
+
+  template <typename U>
+  inline void pop_array(std::vector<U> &data, const int num) {
+    const std::size_t size = num * sizeof(U);
+    ASSERTL0(this->offset + size <=
+                 static_cast<std::size_t>(this->input_length),
+             "Unserialiation overflows buffer.");
+    data.resize(num);
+    if (size > 0) {
+      std::memcpy(data.data(), this->buf_in + this->offset, size);
+    }
+    this->offset += size;
+  }
+
+  inline void clear_arrays() {
+    for (auto array :
+         {&geom_shape_type, &geom_rank, &geom_local_id, &geom_id,
+          &geom_num_edges, &geom_curve, &geom_edges, &edge_id, &edge_coordim,
+          &edge_vertex0, &edge_vertex1, &edge_curve, &vertex_vid,
+          &vertex_coordim, &curve_id, &curve_ptype, &curve_offset,
+          &curve_point_vid, &curve_point_coordim}) {
+      std::vector<int>().swap(*array);
+    }
+    std::vector<NekDouble>().swap(vertex_coords);
+    std::vector<NekDouble>().swap(curve_point_coords);
+  }
+
+  inline void finalise_pack() {
+    this->vertex_index.clear();
+    this->edge_index.clear();
+    const int header[num_header] = {static_cast<int>(geom_id.size()),
+                                    static_cast<int>(edge_id.size()),
+                                    static_cast<int>(vertex_vid.size()),
+                                    static_cast<int>(curve_id.size()),
+                                    static_cast<int>(curve_point_vid.size()),
+                                    static_cast<int>(geom_edges.size())};
+    this->buf.resize(num_header * sizeof(int));
+    std::memcpy(this->buf.data(), header, num_header * sizeof(int));
+    push_array(geom_shape_type);
+    push_array(geom_rank);
+    push_array(geom_local_id);
+    push_array(geom_id);
+    push_array(geom_num_edges);
+    push_array(geom_curve);
+    push_array(geom_edges);
+    push_array(edge_id);
+    push_array(edge_coordim);
+    push_array(edge_vertex0);
+    push_array(edge_vertex1);
+    push_array(edge_curve);
+    push_array(vertex_vid);
+    push_array(vertex_coordim);
+    push_array(vertex_coords);
+    push_array(curve_id);
+    push_array(curve_ptype);
+    push_array(curve_offset);
+    push_array(curve_point_vid);
+    push_array(curve_point_coordim);
+    push_array(curve_point_coords);
+    clear_arrays();
+  }
+
+  inline void unpack_arrays() {
+    ASSERTL0(input_length >= num_header * sizeof(int),
+             "Input buffer has no header.");
+    int header[num_header];
+    std::memcpy(header, buf_in, num_header * sizeof(int));
+    for (int hx = 0; hx < num_header; hx++) {
+      ASSERTL0(((header[hx] >= 0) && (header[hx] <= input_length)),
+               "Packed count is either negative or unrealistic.");
+    }
+    const int num_geoms = header[0];
+    const int num_edges = header[1];
+    const int num_vertices = header[2];
+    const int num_curves = header[3];
+    const int num_curve_points = header[4];
+    const int num_geom_edges = header[5];
+
+    this->offset = num_header * sizeof(int);
+    pop_array(geom_shape_type, num_geoms);
+    pop_array(geom_rank, num_geoms);
+    pop_array(geom_local_id, num_geoms);
+    pop_array(geom_id, num_geoms);
+    pop_array(geom_num_edges, num_geoms);
+    pop_array(geom_curve, num_geoms);
+    pop_array(geom_edges, num_geom_edges);
+    pop_array(edge_id, num_edges);
+    pop_array(edge_coordim, num_edges);
+    pop_array(edge_vertex0, num_edges);
+    pop_array(edge_vertex1, num_edges);
+    pop_array(edge_curve, num_edges);
+    pop_array(vertex_vid, num_vertices);
+    pop_array(vertex_coordim, num_vertices);
+    pop_array(vertex_coords, 3 * num_vertices);
+    pop_array(curve_id, num_curves);
+    pop_array(curve_ptype, num_curves);
+    pop_array(curve_offset, num_curves);
+    pop_array(curve_point_vid, num_curve_points);
+    pop_array(curve_point_coordim, num_curve_points);
+    pop_array(curve_point_coords, 3 * num_curve_points);
+  }
+
+  inline SpatialDomains::CurveSharedPtr make_curve(const int curvex) {
+    if (curvex < 0) {
+      return SpatialDomains::CurveSharedPtr();
+    }
+    const int start = (curvex > 0) ? curve_offset.at(curvex - 1) : 0;
+    const int end = curve_offset.at(curvex);
+    std::vector<SpatialDomains::PointGeomSharedPtr> m_points;
+    m_points.reserve(end - start);
+    for (int pointx = start; pointx < end; pointx++) {
+      m_points.push_back(std::make_shared<SpatialDomains::PointGeom>(
+          curve_point_coordim[pointx], curve_point_vid[pointx],
+          curve_point_coords[3 * pointx], curve_point_coords[3 * pointx + 1],
+          curve_point_coords[3 * pointx + 2]));
+    }
+    auto curve = std::make_shared<SpatialDomains::Curve>(
+        curve_id.at(curvex),
+        static_cast<LibUtilities::PointsType>(curve_ptype.at(curvex)));
+    curve->m_points = m_points;
+    return curve;
+  }
+
 public:
   std::vector<unsigned char> buf;
 
@@ -39,38 +298,21 @@ public:
    */
   template <typename T>
   PackedGeoms2D(int rank, std::map<int, std::shared_ptr<T>> &geom_map) {
-    const int num_geoms = geom_map.size();
-    buf.reserve(512 * num_geoms);
-
-    buf.resize(sizeof(int));
-    std::memcpy(buf.data(), &num_geoms, sizeof(int));
-
     for (auto &geom_item : geom_map) {
-      auto geom = geom_item.second;
-      GeometryTransport::PackedGeom2D pg(rank, geom_item.first, geom);
-      buf.insert(buf.end(), pg.buf.begin(), pg.buf.end());
+      add_geom(rank, geom_item.first, geom_item.second);
     }
+    finalise_pack();
   };
 
   /*
-   * Pack a set of geometry objects collected by calling GetAllQuadGeoms or
-   * GetAllTriGeoms on a MeshGraph object.
+   * Pack a set of remote geometry objects.
    */
   template <typename T>
   PackedGeoms2D(std::vector<std::shared_ptr<RemoteGeom2D<T>>> &geoms) {
-    const int num_geoms = geoms.size();
-    buf.reserve(512 * num_geoms);
-
-    buf.resize(sizeof(int));
-    std::memcpy(buf.data(), &num_geoms, sizeof(int));
-
     for (auto &remote_geom : geoms) {
-      auto geom = remote_geom->geom;
-      const int rank = remote_geom->rank;
-      const int gid = remote_geom->id;
-      GeometryTransport::PackedGeom2D pg(rank, gid, geom);
-      buf.insert(buf.end(), pg.buf.begin(), pg.buf.end());
+      add_geom(remote_geom->rank, remote_geom->id, remote_geom->geom);
     }
+    finalise_pack();
   };
 
   /*
@@ -88,16 +330,54 @@ public:
    */
   template <typename T>
   void unpack(std::vector<std::shared_ptr<RemoteGeom2D<T>>> &geoms) {
+    ASSERTL0(offset == 0, "offset != 0 - cannot unpack twice");
+    ASSERTL0(buf_in != nullptr, "source buffer has null pointer");
     const int packed_count = this->get_packed_count();
+    this->unpack_arrays();
+
+    // Create each vertex and edge once.
+    const int num_vertices = vertex_vid.size();
+    std::vector<SpatialDomains::PointGeomSharedPtr> vertices;
+    vertices.reserve(num_vertices);
+    for (int vx = 0; vx < num_vertices; vx++) {
+      vertices.push_back(std::make_shared<SpatialDomains::PointGeom>(
+          vertex_coordim[vx], vertex_vid[vx], vertex_coords[3 * vx],
+          vertex_coords[3 * vx + 1], vertex_coords[3 * vx + 2]));
+    }
+    const int num_edges = edge_id.size();
+    std::vector<SpatialDomains::SegGeomSharedPtr> edges;
+    edges.reserve(num_edges);
+    for (int ex = 0; ex < num_edges; ex++) {
+      SpatialDomains::PointGeomSharedPtr edge_vertices[2] = {
+          vertices.at(edge_vertex0[ex]), vertices.at(edge_vertex1[ex])};
+      edges.push_back(std::make_shared<SpatialDomains::SegGeom>(
+          edge_id[ex], edge_coordim[ex], edge_vertices,
+          make_curve(edge_curve[ex])));
+    }
+
     geoms.reserve(geoms.size() + packed_count);
+    std::vector<SpatialDomains::SegGeomSharedPtr> geom_edge_ptrs;
+    int edge_offset = 0;
     for (int cx = 0; cx < packed_count; cx++) {
-      auto new_packed_geom = GeometryTransport::PackedGeom2D(
-          buf_in + sizeof(int) + offset, input_length);
-      auto new_geom = new_packed_geom.unpack<T>();
-      offset += new_packed_geom.get_offset();
-      geoms.push_back(new_geom);
+      const int num_geom_edges = geom_num_edges[cx];
+      ASSERTL0((num_geom_edges == 4) || (num_geom_edges == 3),
+               "Bad number of edges expected 4 or 3");
+      ASSERTL0(geom_rank[cx] >= 0, "unreasonable rank");
+      geom_edge_ptrs.clear();
+      for (int edgex = 0; edgex < num_geom_edges; edgex++) {
+        geom_edge_ptrs.push_back(edges.at(geom_edges.at(edge_offset + edgex)));
+      }
+      edge_offset += num_geom_edges;
+
+      std::shared_ptr<T> geom = std::make_shared<T>(
+          geom_id[cx], geom_edge_ptrs.data(), make_curve(geom_curve[cx]));
+      geom->GetGeomFactors();
+      geom->Setup();
+      geoms.push_back(std::make_shared<RemoteGeom2D<T>>(
+          geom_rank[cx], geom_local_id[cx], geom));
     }
     ASSERTL0(offset <= input_length, "buffer overflow occured");
+    clear_arrays();
   }
 };
 
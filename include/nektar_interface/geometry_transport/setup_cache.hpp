@@ -0,0 +1,387 @@
+#ifndef __SETUP_CACHE_H__
+#define __SETUP_CACHE_H__
+
+// Nektar++ Includes
+#include <SpatialDomains/MeshGraph.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+#include <neso_particles.hpp>
+
+#include "packed_geoms_2d.hpp"
+#include "remote_geom.hpp"
+#include "remote_geom_2d.hpp"
+#include "remote_geom_3d.hpp"
+
+using namespace Nektar;
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ *  Per-rank file cache of the MeshHierarchy cell ownership and the halo
+ *  geometry objects computed when a ParticleMeshInterface is set up. The
+ *  cache is keyed by a hash of the mesh on all ranks, the number of ranks and
+ *  the setup configuration, such that a later run with the same mesh,
+ *  partition and configuration can skip the claim weight computation and the
+ *  halo exchange. Halos extended after the setup are cached in further files,
+ *  keyed additionally by a stage hash of the extension inputs. Each rank reads
+ *  and writes its own file as a flat binary blob of length-prefixed arrays.
+ *
+ *  Curved 3D halo objects are not cached as the 3D serialisation does not
+ *  support curves; a cache is not written if any are present.
+ */
+class SetupCache {
+protected:
+  static constexpr std::uint64_t magic = 0x4e45534f53455455;
+  static constexpr int version = 2;
+
+  MPI_Comm comm;
+  int comm_rank;
+  int comm_size;
+  std::uint64_t local_hash;
+  std::uint64_t global_hash;
+  std::string directory;
+
+  template <typename T>
+  static inline void write_value(std::ofstream &out, const T &value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static inline void write_array(std::ofstream &out,
+                                 const std::vector<T> &values) {
+    const std::uint64_t num = values.size();
+    write_value(out, num);
+    out.write(reinterpret_cast<const char *>(values.data()),
+              num * sizeof(T));
+  }
+
+  template <typename T>
+  static inline bool read_value(std::ifstream &in, T &value) {
+    in.read(reinterpret_cast<char *>(&value), sizeof(T));
+    return static_cast<bool>(in);
+  }
+
+  template <typename T>
+  static inline bool read_array(std::ifstream &in, std::vector<T> &values) {
+    std::uint64_t num;
+    if (!read_value(in, num)) {
+      return false;
+    }
+    values.resize(num);
+    in.read(reinterpret_cast<char *>(values.data()), num * sizeof(T));
+    return static_cast<bool>(in);
+  }
+
+  template <typename T>
+  static inline void
+  pack_2d(std::vector<std::shared_ptr<RemoteGeom2D<T>>> &geoms,
+          std::vector<unsigned char> &buf) {
+    PackedGeoms2D packed(geoms);
+    buf = std::move(packed.buf);
+  }
+
+  static inline bool
+  is_linear(std::shared_ptr<SpatialDomains::Geometry3D> geom) {
+    const int num_faces = geom->GetNumFaces();
+    for (int fx = 0; fx < num_faces; fx++) {
+      auto face = geom->GetFace(fx);
+      if (face->GetCurve() != nullptr) {
+        return false;
+      }
+      const int num_edges = face->GetNumEdges();
+      for (int ex = 0; ex < num_edges; ex++) {
+        auto edge = std::dynamic_pointer_cast<SpatialDomains::SegGeom>(
+            face->GetEdge(ex));
+        if ((edge == nullptr) || (edge->GetCurve() != nullptr)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+public:
+  /// Path of the cache file for this rank.
+  std::string path;
+
+  /**
+   *  Fold the bytes of a value into a 64-bit FNV-1a hash.
+   *
+   *  @param[in, out] hash Hash to update.
+   *  @param[in] value Value to fold into the hash.
+   */
+  template <typename T>
+  static inline void hash_combine(std::uint64_t &hash, const T &value) {
+    unsigned char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    for (std::size_t bx = 0; bx < sizeof(T); bx++) {
+      hash ^= static_cast<std::uint64_t>(bytes[bx]);
+      hash *= 0x100000001b3ULL;
+    }
+  }
+
+  /**
+   *  Hash the point type and points of a curve.
+   *
+   *  @param[in, out] hash Hash to update.
+   *  @param[in] curve Curve to hash, may be null for a straight edge or a
+   *  planar face.
+   */
+  static inline void hash_curve(std::uint64_t &hash,
+                                SpatialDomains::CurveSharedPtr curve) {
+    const int is_curved = (curve != nullptr) ? 1 : 0;
+    hash_combine(hash, is_curved);
+    if (!is_curved) {
+      return;
+    }
+    hash_combine(hash, static_cast<int>(curve->m_ptype));
+    const int num_points = curve->m_points.size();
+    hash_combine(hash, num_points);
+    for (auto &point : curve->m_points) {
+      NekDouble x, y, z;
+      point->GetCoords(x, y, z);
+      hash_combine(hash, x);
+      hash_combine(hash, y);
+      hash_combine(hash, z);
+    }
+  }
+
+  /**
+   *  Hash the curves of a 2D geometry object and of its edges.
+   *
+   *  @param[in, out] hash Hash to update.
+   *  @param[in] geom 2D geometry object to hash the curves of.
+   */
+  static inline void
+  hash_curves_2d(std::uint64_t &hash,
+                 std::shared_ptr<SpatialDomains::Geometry2D> geom) {
+    hash_curve(hash, geom->GetCurve());
+    const int num_edges = geom->GetNumEdges();
+    for (int ex = 0; ex < num_edges; ex++) {
+      auto edge =
+          std::dynamic_pointer_cast<SpatialDomains::SegGeom>(geom->GetEdge(ex));
+      hash_curve(hash, (edge != nullptr) ? edge->GetCurve() : nullptr);
+    }
+  }
+
+  /**
+   *  Hash the ids, vertex coordinates and curves of a set of geometry objects.
+   *  The curves of 3D objects are those of their faces and edges.
+   *
+   *  @param[in] geoms Map from geometry id to geometry object.
+   *  @param[in, out] hash Hash to update.
+   */
+  template <typename T>
+  static inline void hash_geoms(std::map<int, std::shared_ptr<T>> &geoms,
+                                std::uint64_t &hash) {
+    for (auto &geom_item : geoms) {
+      hash_combine(hash, geom_item.first);
+      auto geom = geom_item.second;
+      const int num_verts = geom->GetNumVerts();
+      for (int vx = 0; vx < num_verts; vx++) {
+        NekDouble x, y, z;
+        geom->GetVertex(vx)->GetCoords(x, y, z);
+        hash_combine(hash, x);
+        hash_combine(hash, y);
+        hash_combine(hash, z);
+      }
+      if constexpr (std::is_base_of_v<SpatialDomains::Geometry3D, T>) {
+        const int num_faces = geom->GetNumFaces();
+        for (int fx = 0; fx < num_faces; fx++) {
+          hash_curves_2d(hash, geom->GetFace(fx));
+        }
+      } else {
+        hash_curves_2d(hash, geom);
+      }
+    }
+  }
+
+  /**
+   *  Get the path of the cache file of this rank for a stage of the setup.
+   *
+   *  @param stage_hash Hash identifying the stage, 0 for the initial setup.
+   *  @returns Path of the cache file.
+   */
+  inline std::string get_path(const std::uint64_t stage_hash = 0) const {
+    std::stringstream name;
+    name << "neso_setup_" << std::hex << this->global_hash;
+    if (stage_hash) {
+      name << "_" << stage_hash;
+    }
+    name << std::dec << "_" << this->comm_size << "_" << this->comm_rank
+         << ".bin";
+    return (std::filesystem::path(this->directory) / name.str()).string();
+  }
+
+  /**
+   *  Create a cache for the ParticleMeshInterface setup on this rank. Must be
+   *  called collectively on the communicator.
+   *
+   *  @param comm MPI communicator the setup is performed on.
+   *  @param directory Directory to read and write cache files in.
+   *  @param local_hash Hash of the local mesh and setup configuration on this
+   *  rank, e.g. computed with hash_geoms and hash_combine.
+   */
+  SetupCache(MPI_Comm comm, const std::string &directory,
+             const std::uint64_t local_hash)
+      : comm(comm), local_hash(local_hash), directory(directory) {
+    MPICHK(MPI_Comm_rank(comm, &this->comm_rank));
+    MPICHK(MPI_Comm_size(comm, &this->comm_size));
+
+    // Mix in the rank such that identical local meshes on different ranks do
+    // not cancel in the reduction.
+    std::uint64_t rank_hash = local_hash;
+    hash_combine(rank_hash, this->comm_rank);
+    MPICHK(MPI_Allreduce(&rank_hash, &this->global_hash, 1, MPI_UINT64_T,
+                         MPI_BXOR, comm));
+    hash_combine(this->global_hash, this->comm_size);
+    hash_combine(this->global_hash, version);
+    this->path = this->get_path();
+  }
+
+  /**
+   *  Read the cached state. Must be called collectively on the communicator.
+   *
+   *  @param[out] owned_mh_cells MeshHierarchy cells owned by this rank.
+   *  @param[out] unowned_mh_cells MeshHierarchy cells claimed by this rank but
+   *  owned by another rank.
+   *  @param[out] remote_triangles Halo triangles.
+   *  @param[out] remote_quads Halo quadrilaterals.
+   *  @param[out] remote_geoms_3d Halo 3D geometry objects.
+   *  @param[in] stage_hash Hash identifying the stage of the setup to read,
+   *  e.g. a halo extension, default 0 for the initial setup.
+   *  @returns True on all ranks if every rank read a valid cache file, false
+   *  on all ranks otherwise, in which case the outputs should be ignored.
+   */
+  inline bool
+  read(std::vector<INT> &owned_mh_cells, std::vector<INT> &unowned_mh_cells,
+       std::vector<std::shared_ptr<RemoteGeom2D<TriGeom>>> &remote_triangles,
+       std::vector<std::shared_ptr<RemoteGeom2D<QuadGeom>>> &remote_quads,
+       std::vector<std::shared_ptr<RemoteGeom3D>> &remote_geoms_3d,
+       const std::uint64_t stage_hash = 0) {
+
+    int valid = 0;
+    std::vector<unsigned char> tri_buf, quad_buf;
+    std::vector<std::vector<std::byte>> bufs_3d;
+    {
+      std::ifstream in(this->get_path(stage_hash), std::ios::binary);
+      std::uint64_t file_magic, file_global_hash, file_local_hash;
+      std::uint64_t file_stage_hash;
+      int file_version;
+      std::uint64_t num_3d;
+      if (in.is_open() && read_value(in, file_magic) &&
+          (file_magic == magic) && read_value(in, file_version) &&
+          (file_version == version) && read_value(in, file_global_hash) &&
+          (file_global_hash == this->global_hash) &&
+          read_value(in, file_local_hash) &&
+          (file_local_hash == this->local_hash) &&
+          read_value(in, file_stage_hash) &&
+          (file_stage_hash == stage_hash) &&
+          read_array(in, owned_mh_cells) && read_array(in, unowned_mh_cells) &&
+          read_array(in, tri_buf) && read_array(in, quad_buf) &&
+          read_value(in, num_3d)) {
+        bufs_3d.resize(num_3d);
+        valid = 1;
+        for (auto &buf : bufs_3d) {
+          if (!read_array(in, buf)) {
+            valid = 0;
+            break;
+          }
+        }
+      }
+    }
+
+    int all_valid;
+    MPICHK(
+        MPI_Allreduce(&valid, &all_valid, 1, MPI_INT, MPI_MIN, this->comm));
+    if (!all_valid) {
+      return false;
+    }
+
+    PackedGeoms2D(tri_buf.data(), tri_buf.size()).unpack(remote_triangles);
+    PackedGeoms2D(quad_buf.data(), quad_buf.size()).unpack(remote_quads);
+    remote_geoms_3d.reserve(bufs_3d.size());
+    for (auto &buf : bufs_3d) {
+      GeometryTransport::RemoteGeom<SpatialDomains::Geometry> remote_geom;
+      remote_geom.deserialise(buf.data(), buf.size());
+      remote_geoms_3d.push_back(std::make_shared<RemoteGeom3D>(
+          remote_geom.rank, remote_geom.id,
+          std::dynamic_pointer_cast<SpatialDomains::Geometry3D>(
+              remote_geom.geom)));
+    }
+    return true;
+  }
+
+  /**
+   *  Write the state to the cache file of this rank.
+   *
+   *  @param[in] owned_mh_cells MeshHierarchy cells owned by this rank.
+   *  @param[in] unowned_mh_cells MeshHierarchy cells claimed by this rank but
+   *  owned by another rank.
+   *  @param[in] remote_triangles Halo triangles.
+   *  @param[in] remote_quads Halo quadrilaterals.
+   *  @param[in] remote_geoms_3d Halo 3D geometry objects.
+   *  @param[in] stage_hash Hash identifying the stage of the setup to write,
+   *  e.g. a halo extension, default 0 for the initial setup.
+   */
+  inline void
+  write(std::vector<INT> &owned_mh_cells, std::vector<INT> &unowned_mh_cells,
+        std::vector<std::shared_ptr<RemoteGeom2D<TriGeom>>> &remote_triangles,
+        std::vector<std::shared_ptr<RemoteGeom2D<QuadGeom>>> &remote_quads,
+        std::vector<std::shared_ptr<RemoteGeom3D>> &remote_geoms_3d,
+        const std::uint64_t stage_hash = 0) {
+    for (auto &remote_geom : remote_geoms_3d) {
+      if (!is_linear(remote_geom->geom)) {
+        return;
+      }
+    }
+
+    std::vector<unsigned char> tri_buf, quad_buf;
+    pack_2d(remote_triangles, tri_buf);
+    pack_2d(remote_quads, quad_buf);
+
+    const std::string stage_path = this->get_path(stage_hash);
+    std::ofstream out(stage_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+      nprint("SetupCache: could not open", stage_path, "for writing.");
+      return;
+    }
+    write_value(out, magic);
+    write_value(out, version);
+    write_value(out, this->global_hash);
+    write_value(out, this->local_hash);
+    write_value(out, stage_hash);
+    write_array(out, owned_mh_cells);
+    write_array(out, unowned_mh_cells);
+    write_array(out, tri_buf);
+    write_array(out, quad_buf);
+    const std::uint64_t num_3d = remote_geoms_3d.size();
+    write_value(out, num_3d);
+    std::vector<std::byte> buf;
+    for (auto &remote_geom : remote_geoms_3d) {
+      GeometryTransport::RemoteGeom<SpatialDomains::Geometry> serial_geom(
+          remote_geom->rank, remote_geom->id,
+          std::dynamic_pointer_cast<SpatialDomains::Geometry>(
+              remote_geom->geom));
+      buf.resize(serial_geom.get_num_bytes());
+      serial_geom.serialise(buf.data(), buf.size());
+      write_array(out, buf);
+    }
+  }
+};
+
+} // namespace NESO
+
+#endif
@@ -0,0 +1,626 @@
+#ifndef __NEIGHBOUR_TRANSFER_H_
+#define __NEIGHBOUR_TRANSFER_H_
+
+#include <mpi.h>
+#include <neso_particles.hpp>
+
+#include "cell_id_translation.hpp"
+#include "particle_mesh_interface.hpp"
+#include "step_profiler.hpp"
+#include "utility_mpi.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Communication statistics of a NeighbourTransfer step. When returned by
+ * NeighbourTransfer::get_stats the values are those of this rank, when
+ * returned by NeighbourTransfer::reduce_stats the counts are summed and the
+ * times are the maximum over all ranks.
+ */
+struct NeighbourTransferStats {
+  /// Number of particles sent directly to neighbour ranks.
+  INT num_sent = 0;
+  /// Number of particles received directly from neighbour ranks.
+  INT num_received = 0;
+  /// Number of bytes of particle data sent to neighbour ranks.
+  INT bytes_sent = 0;
+  /// Number of bytes of particle data received from neighbour ranks.
+  INT bytes_received = 0;
+  /// Number of particles, over all ranks, which left the halo.
+  INT num_global = 0;
+  /// Number of steps which fell back to the MeshHierarchy global move.
+  INT num_global_moves = 0;
+  /// Wall time of the neighbour exchange, i.e. packing, messages and
+  /// unpacking, in seconds.
+  double time_exchange = 0.0;
+  /// Wall time of the whole transfer in seconds.
+  double time_total = 0.0;
+};
+
+/**
+ * Moves particles to the ranks and cells which own their positions, as the
+ * sequence ParticleGroup::hybrid_move and ParticleGroup::cell_move does, but
+ * without the global MeshHierarchy route in the common case.
+ *
+ * The positions are first mapped with the local mapper, which binds each
+ * particle to a local element or to a halo element owned by a neighbour rank.
+ * Particles in halo elements are packed on the device and sent directly to
+ * the owning neighbour, using a fixed set of peer ranks determined once at
+ * construction. The per-step communication is therefore a single exchange of
+ * counts and data with the neighbours, plus one small reduction to detect
+ * particles which were not found in the halo. Only if such particles exist
+ * on some rank does the step fall back to ParticleGroup::hybrid_move, which
+ * then only has to communicate the particles that jumped further than the
+ * halo.
+ *
+ * Each step records its communication volume and latency, see get_stats and
+ * reduce_stats, and reports its regions to the active StepProfiler.
+ */
+class NeighbourTransfer {
+protected:
+  ParticleGroupSharedPtr particle_group;
+  ParticleMeshInterfaceSharedPtr particle_mesh_interface;
+  std::shared_ptr<CellIDTranslation> cell_id_translation;
+  SYCLTargetSharedPtr sycl_target;
+  MPI_Comm comm;
+  int rank;
+
+  /// Ranks particles are exchanged with, the union of the ranks which own
+  /// halo elements of this rank and the ranks this rank owns halo elements
+  /// of.
+  std::vector<int> peers;
+  /// Map from MPI rank to index in peers, -1 for ranks which are not peers.
+  BufferDeviceHost<int> dh_rank_to_peer;
+  /// Per-peer counts of departing particles, the last entry counts the
+  /// particles which were not found in the halo.
+  BufferDeviceHost<int> dh_counts;
+  BufferDevice<int> d_fill;
+  BufferDevice<INT> d_offsets;
+  BufferDevice<INT> d_cells;
+  BufferDevice<INT> d_layers;
+  BufferDeviceHost<REAL> dh_send_real;
+  BufferDeviceHost<INT> dh_send_int;
+  int cell_count;
+
+  std::vector<Sym<REAL>> syms_real;
+  std::vector<Sym<INT>> syms_int;
+  std::vector<int> ncomp_real;
+  std::vector<int> ncomp_int;
+  int num_reals;
+  int num_ints;
+
+  NeighbourTransferStats stats;
+  std::string stats_filename;
+  int step;
+  StepProfilerSharedPtr step_profiler;
+
+  inline void setup_spec() {
+    auto spec = this->particle_group->get_particle_spec();
+    this->syms_real.clear();
+    this->syms_int.clear();
+    this->ncomp_real.clear();
+    this->ncomp_int.clear();
+    this->num_reals = 0;
+    this->num_ints = 0;
+    for (auto &prop : spec.properties_real) {
+      this->syms_real.push_back(prop.sym);
+      this->ncomp_real.push_back(prop.ncomp);
+      this->num_reals += prop.ncomp;
+    }
+    for (auto &prop : spec.properties_int) {
+      this->syms_int.push_back(prop.sym);
+      this->ncomp_int.push_back(prop.ncomp);
+      this->num_ints += prop.ncomp;
+    }
+  }
+
+  /**
+   * Count the departing particles for each peer and the particles which were
+   * not found in the halo.
+   */
+  inline void count_departing() {
+    const int num_peers = this->peers.size();
+    for (int px = 0; px <= num_peers; px++) {
+      this->dh_counts.h_buffer.ptr[px] = 0;
+    }
+    this->dh_counts.host_to_device();
+
+    const int k_rank = this->rank;
+    const int k_num_peers = num_peers;
+    const auto k_rank_to_peer = this->dh_rank_to_peer.d_buffer.ptr;
+    auto k_counts = this->dh_counts.d_buffer.ptr;
+    particle_loop(
+        "NeighbourTransfer::count_departing", this->particle_group,
+        [=](auto MPI_RANK) {
+          const INT owner = MPI_RANK.at(1);
+          if (owner != k_rank) {
+            const int peer = (owner > -1) ? k_rank_to_peer[owner] : -1;
+            const int bucket = (peer > -1) ? peer : k_num_peers;
+            sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                             sycl::memory_scope::device>
+                count_atomic_ref(k_counts[bucket]);
+            count_atomic_ref.fetch_add(1);
+          }
+        },
+        Access::read(this->particle_group->mpi_rank_dat))
+        ->execute();
+    this->dh_counts.device_to_host();
+  }
+
+  /**
+   * Pack the particles which depart to peers into contiguous per-peer blocks
+   * and record their cells and layers for removal.
+   */
+  inline void pack_departing(const std::vector<INT> &offsets,
+                             const INT num_departing) {
+    const int num_peers = this->peers.size();
+    this->d_offsets.realloc_no_copy(std::max(num_peers, 1));
+    this->d_fill.realloc_no_copy(std::max(num_peers, 1));
+    this->d_cells.realloc_no_copy(num_departing);
+    this->d_layers.realloc_no_copy(num_departing);
+    this->dh_send_real.realloc_no_copy(num_departing * this->num_reals);
+    this->dh_send_int.realloc_no_copy(num_departing * this->num_ints);
+    if (num_peers > 0) {
+      this->sycl_target->queue
+          .memcpy(this->d_offsets.ptr, offsets.data(), num_peers * sizeof(INT))
+          .wait_and_throw();
+      this->sycl_target->queue.fill(this->d_fill.ptr, 0, num_peers)
+          .wait_and_throw();
+    }
+
+    const int num_real_dats = this->syms_real.size();
+    const int num_int_dats = this->syms_int.size();
+    std::vector<ParticleDatImplGetConstT<REAL>> h_real_ptrs(num_real_dats);
+    std::vector<ParticleDatImplGetConstT<INT>> h_int_ptrs(num_int_dats);
+    for (int dx = 0; dx < num_real_dats; dx++) {
+      h_real_ptrs.at(dx) = Access::direct_get(
+          Access::read(this->particle_group->get_dat(this->syms_real.at(dx))));
+    }
+    for (int dx = 0; dx < num_int_dats; dx++) {
+      h_int_ptrs.at(dx) = Access::direct_get(
+          Access::read(this->particle_group->get_dat(this->syms_int.at(dx))));
+    }
+    BufferDevice<ParticleDatImplGetConstT<REAL>> d_real_ptrs(this->sycl_target,
+                                                             h_real_ptrs);
+    BufferDevice<ParticleDatImplGetConstT<INT>> d_int_ptrs(this->sycl_target,
+                                                           h_int_ptrs);
+    BufferDevice<int> d_ncomp_real(this->sycl_target, this->ncomp_real);
+    BufferDevice<int> d_ncomp_int(this->sycl_target, this->ncomp_int);
+
+    const int k_rank = this->rank;
+    const int k_num_real_dats = num_real_dats;
+    const int k_num_int_dats = num_int_dats;
+    const int k_num_reals = this->num_reals;
+    const int k_num_ints = this->num_ints;
+    const auto k_rank_to_peer = this->dh_rank_to_peer.d_buffer.ptr;
+    const auto k_offsets = this->d_offsets.ptr;
+    const auto k_real_ptrs = d_real_ptrs.ptr;
+    const auto k_int_ptrs = d_int_ptrs.ptr;
+    const auto k_ncomp_real = d_ncomp_real.ptr;
+    const auto k_ncomp_int = d_ncomp_int.ptr;
+    auto k_fill = this->d_fill.ptr;
+    auto k_cells = this->d_cells.ptr;
+    auto k_layers = this->d_layers.ptr;
+    auto k_send_real = this->dh_send_real.d_buffer.ptr;
+    auto k_send_int = this->dh_send_int.d_buffer.ptr;
+
+    particle_loop(
+        "NeighbourTransfer::pack_departing", this->particle_group,
+        [=](auto INDEX, auto MPI_RANK) {
+          const INT owner = MPI_RANK.at(1);
+          if ((owner > -1) && (owner != k_rank)) {
+            const int peer = k_rank_to_peer[owner];
+            if (peer > -1) {
+              sycl::atomic_ref<int, sycl::memory_order::relaxed,
+                               sycl::memory_scope::device>
+                  fill_atomic_ref(k_fill[peer]);
+              const INT slot = k_offsets[peer] + fill_atomic_ref.fetch_add(1);
+              const auto cell = INDEX.cell;
+              const auto layer = INDEX.layer;
+              k_cells[slot] = cell;
+              k_layers[slot] = layer;
+              REAL *real_row = k_send_real + slot * k_num_reals;
+              int index = 0;
+              for (int dx = 0; dx < k_num_real_dats; dx++) {
+                for (int cx = 0; cx < k_ncomp_real[dx]; cx++) {
+                  real_row[index++] = k_real_ptrs[dx][cell][cx][layer];
+                }
+              }
+              INT *int_row = k_send_int + slot * k_num_ints;
+              index = 0;
+              for (int dx = 0; dx < k_num_int_dats; dx++) {
+                for (int cx = 0; cx < k_ncomp_int[dx]; cx++) {
+                  int_row[index++] = k_int_ptrs[dx][cell][cx][layer];
+                }
+              }
+            }
+          }
+        },
+        Access::read(ParticleLoopIndex{}),
+        Access::read(this->particle_group->mpi_rank_dat))
+        ->execute();
+
+    for (int dx = 0; dx < num_real_dats; dx++) {
+      Access::direct_restore(
+          Access::read(this->particle_group->get_dat(this->syms_real.at(dx))),
+          h_real_ptrs.at(dx));
+    }
+    for (int dx = 0; dx < num_int_dats; dx++) {
+      Access::direct_restore(
+          Access::read(this->particle_group->get_dat(this->syms_int.at(dx))),
+          h_int_ptrs.at(dx));
+    }
+    this->dh_send_real.device_to_host();
+    this->dh_send_int.device_to_host();
+  }
+
+  /**
+   * Exchange the packed particles with the peers.
+   */
+  inline void exchange(const std::vector<INT> &send_counts,
+                       const std::vector<INT> &send_offsets,
+                       std::vector<INT> &recv_counts,
+                       std::vector<REAL> &recv_real,
+                       std::vector<INT> &recv_int) {
+    const int num_peers = this->peers.size();
+    const int tag_count = 0;
+    const int tag_real = 1;
+    const int tag_int = 2;
+
+    recv_counts.assign(num_peers, 0);
+    std::vector<MPI_Request> requests;
+    requests.reserve(4 * num_peers);
+    for (int px = 0; px < num_peers; px++) {
+      requests.emplace_back();
+      MPICHK(MPI_Irecv(recv_counts.data() + px, 1, MPI_INT64_T,
+                       this->peers[px], tag_count, this->comm,
+                       &requests.back()));
+    }
+    for (int px = 0; px < num_peers; px++) {
+      requests.emplace_back();
+      MPICHK(MPI_Isend(send_counts.data() + px, 1, MPI_INT64_T,
+                       this->peers[px], tag_count, this->comm,
+                       &requests.back()));
+    }
+    MPICHK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+    requests.clear();
+
+    INT num_recv = 0;
+    std::vector<INT> recv_offsets(num_peers);
+    for (int px = 0; px < num_peers; px++) {
+      recv_offsets[px] = num_recv;
+      num_recv += recv_counts[px];
+    }
+    recv_real.resize(num_recv * this->num_reals);
+    recv_int.resize(num_recv * this->num_ints);
+
+    for (int px = 0; px < num_peers; px++) {
+      if (recv_counts[px] > 0) {
+        requests.emplace_back();
+        MPICHK(MPI_Irecv(recv_real.data() + recv_offsets[px] * this->num_reals,
+                         recv_counts[px] * this->num_reals, MPI_DOUBLE,
+                         this->peers[px], tag_real, this->comm,
+                         &requests.back()));
+        requests.emplace_back();
+        MPICHK(MPI_Irecv(recv_int.data() + recv_offsets[px] * this->num_ints,
+                         recv_counts[px] * this->num_ints, MPI_INT64_T,
+                         this->peers[px], tag_int, this->comm,
+                         &requests.back()));
+      }
+    }
+    for (int px = 0; px < num_peers; px++) {
+      if (send_counts[px] > 0) {
+        requests.emplace_back();
+        MPICHK(MPI_Isend(this->dh_send_real.h_buffer.ptr +
+                             send_offsets[px] * this->num_reals,
+                         send_counts[px] * this->num_reals, MPI_DOUBLE,
+                         this->peers[px], tag_real, this->comm,
+                         &requests.back()));
+        requests.emplace_back();
+        MPICHK(MPI_Isend(this->dh_send_int.h_buffer.ptr +
+                             send_offsets[px] * this->num_ints,
+                         send_counts[px] * this->num_ints, MPI_INT64_T,
+                         this->peers[px], tag_int, this->comm,
+                         &requests.back()));
+      }
+    }
+    MPICHK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+  }
+
+  /**
+   * Add the received particles to the cells of the elements their senders
+   * mapped them into.
+   */
+  inline void add_received(const INT num_recv,
+                           const std::vector<REAL> &recv_real,
+                           const std::vector<INT> &recv_int) {
+    if (num_recv == 0) {
+      return;
+    }
+    const auto sym_cell = this->particle_group->cell_id_dat->sym;
+    const auto sym_rank = this->particle_group->mpi_rank_dat->sym;
+    ParticleSet particle_set(num_recv,
+                             this->particle_group->get_particle_spec());
+    for (INT px = 0; px < num_recv; px++) {
+      const REAL *real_row = recv_real.data() + px * this->num_reals;
+      int index = 0;
+      const int num_real_dats = this->syms_real.size();
+      for (int dx = 0; dx < num_real_dats; dx++) {
+        for (int cx = 0; cx < this->ncomp_real[dx]; cx++) {
+          particle_set[this->syms_real[dx]][px][cx] = real_row[index++];
+        }
+      }
+      const INT *int_row = recv_int.data() + px * this->num_ints;
+      index = 0;
+      const int num_int_dats = this->syms_int.size();
+      for (int dx = 0; dx < num_int_dats; dx++) {
+        for (int cx = 0; cx < this->ncomp_int[dx]; cx++) {
+          particle_set[this->syms_int[dx]][px][cx] = int_row[index++];
+        }
+      }
+      // The sender mapped the particle into a cell owned by this rank.
+      const INT cell = particle_set[sym_cell][px][0];
+      NESOASSERT((0 <= cell) && (cell < this->cell_count),
+                 "Received a particle in an element this rank does not own.");
+      particle_set[sym_rank][px][0] = this->rank;
+      particle_set[sym_rank][px][1] = this->rank;
+    }
+    this->particle_group->add_particles_local(particle_set);
+  }
+
+  inline void write_stats() {
+    auto global_stats = this->reduce_stats();
+    if (this->rank != 0) {
+      return;
+    }
+    const bool header = (this->step == 0);
+    std::ofstream out(this->stats_filename,
+                      header ? std::ios::trunc : std::ios::app);
+    if (!out.is_open()) {
+      nprint("NeighbourTransfer: could not open", this->stats_filename);
+      return;
+    }
+    if (header) {
+      out << "step,num_sent,bytes_sent,num_global,global_move,"
+             "time_exchange,time_total\n";
+    }
+    out << this->step << "," << global_stats.num_sent << ","
+        << global_stats.bytes_sent << "," << global_stats.num_global << ","
+        << global_stats.num_global_moves << "," << global_stats.time_exchange
+        << "," << global_stats.time_total << "\n";
+  }
+
+public:
+  /// Disable (implicit) copies.
+  NeighbourTransfer(const NeighbourTransfer &st) = delete;
+  /// Disable (implicit) copies.
+  NeighbourTransfer &operator=(NeighbourTransfer const &a) = delete;
+
+  /**
+   * Create a transfer for a ParticleGroup. Must be called collectively, after
+   * any halo extension of the ParticleMeshInterface and after all
+   * ParticleDats are added to the ParticleGroup.
+   *
+   * @param particle_group ParticleGroup to move particles of.
+   * @param particle_mesh_interface Mesh of the ParticleGroup.
+   * @param cell_id_translation Map between Nektar++ geometry ids and cells.
+   * @param stats_filename Optional CSV file which rank 0 writes the reduced
+   * statistics of each step to, adds a reduction per step when set.
+   */
+  NeighbourTransfer(ParticleGroupSharedPtr particle_group,
+                    ParticleMeshInterfaceSharedPtr particle_mesh_interface,
+                    std::shared_ptr<CellIDTranslation> cell_id_translation,
+                    const std::string stats_filename = "")
+      : particle_group(particle_group),
+        particle_mesh_interface(particle_mesh_interface),
+        cell_id_translation(cell_id_translation),
+        sycl_target(particle_group->sycl_target),
+        dh_rank_to_peer(particle_group->sycl_target, 1),
+        dh_counts(particle_group->sycl_target, 1),
+        d_fill(particle_group->sycl_target, 1),
+        d_offsets(particle_group->sycl_target, 1),
+        d_cells(particle_group->sycl_target, 1),
+        d_layers(particle_group->sycl_target, 1),
+        dh_send_real(particle_group->sycl_target, 1),
+        dh_send_int(particle_group->sycl_target, 1),
+        stats_filename(stats_filename), step(0) {
+
+    MPI_Comm comm_parent = this->sycl_target->comm_pair.comm_parent;
+    MPICHK(MPI_Comm_dup(comm_parent, &this->comm));
+    MPICHK(MPI_Comm_rank(this->comm, &this->rank));
+    int size;
+    MPICHK(MPI_Comm_size(this->comm, &size));
+
+    // A rank which owns halo elements of this rank may not hold a halo
+    // element of this rank, hence form the union of both directions such that
+    // the peer relation is symmetric.
+    auto &neighbours =
+        this->particle_mesh_interface->get_local_communication_neighbours();
+    std::vector<int> send_ranks;
+    for (const int rankx : neighbours) {
+      if (rankx != this->rank) {
+        send_ranks.push_back(rankx);
+      }
+    }
+    std::vector<int> send_data(send_ranks.size(), 1);
+    std::vector<int> recv_ranks, recv_data;
+    sparse_exchange_counts(this->comm, send_ranks, send_data, recv_ranks,
+                           recv_data);
+    std::set<int> peer_set(send_ranks.begin(), send_ranks.end());
+    peer_set.insert(recv_ranks.begin(), recv_ranks.end());
+    this->peers.assign(peer_set.begin(), peer_set.end());
+
+    const int num_peers = this->peers.size();
+    this->dh_rank_to_peer.realloc_no_copy(size);
+    for (int rankx = 0; rankx < size; rankx++) {
+      this->dh_rank_to_peer.h_buffer.ptr[rankx] = -1;
+    }
+    for (int px = 0; px < num_peers; px++) {
+      this->dh_rank_to_peer.h_buffer.ptr[this->peers[px]] = px;
+    }
+    this->dh_rank_to_peer.host_to_device();
+    this->dh_counts.realloc_no_copy(num_peers + 1);
+
+    this->cell_count = this->particle_mesh_interface->get_cell_count();
+    this->setup_spec();
+  }
+
+  /**
+   * @returns The ranks particles are exchanged with directly.
+   */
+  inline const std::vector<int> &get_peers() const { return this->peers; }
+
+  /**
+   * Set the profiler which records the time spent in each transfer.
+   *
+   * @param step_profiler Profiler owned by the particle system, may be
+   * nullptr.
+   */
+  inline void set_step_profiler(StepProfilerSharedPtr step_profiler) {
+    this->step_profiler = step_profiler;
+  }
+
+  /**
+   * Move particles to the ranks and cells which own their positions. The
+   * positions must be inside the domain, i.e. boundary conditions must be
+   * applied first. Must be called collectively.
+   */
+  inline void execute() {
+    StepProfilerRegion region(this->step_profiler, StepRegion::Transfer,
+                              "NeighbourTransfer::execute");
+    auto t0 = profile_timestamp();
+    this->stats = NeighbourTransferStats();
+
+    // Bind each particle to a local or halo element.
+    reset_mpi_ranks(this->particle_group->mpi_rank_dat);
+    this->particle_group->domain->local_mapper->map(*this->particle_group);
+    this->count_departing();
+
+    const int num_peers = this->peers.size();
+    std::vector<INT> send_counts(num_peers);
+    std::vector<INT> send_offsets(num_peers);
+    INT num_departing = 0;
+    for (int px = 0; px < num_peers; px++) {
+      send_offsets[px] = num_departing;
+      send_counts[px] = this->dh_counts.h_buffer.ptr[px];
+      num_departing += send_counts[px];
+    }
+    const INT num_global_local = this->dh_counts.h_buffer.ptr[num_peers];
+    MPICHK(MPI_Allreduce(&num_global_local, &this->stats.num_global, 1,
+                         MPI_INT64_T, MPI_SUM, this->comm));
+
+    // Send the particles in halo elements directly to their owners.
+    auto t_exchange = profile_timestamp();
+    StepProfilerRegion region_exchange(this->step_profiler,
+                                       StepRegion::Transfer,
+                                       "NeighbourTransfer::exchange");
+    if (num_departing > 0) {
+      this->pack_departing(send_offsets, num_departing);
+      this->particle_group->remove_particles(num_departing, this->d_cells.ptr,
+                                             this->d_layers.ptr);
+    }
+    std::vector<INT> recv_counts;
+    std::vector<REAL> recv_real;
+    std::vector<INT> recv_int;
+    this->exchange(send_counts, send_offsets, recv_counts, recv_real,
+                   recv_int);
+    INT num_recv = 0;
+    for (const INT cx : recv_counts) {
+      num_recv += cx;
+    }
+    region_exchange.end();
+    this->stats.time_exchange =
+        profile_elapsed(t_exchange, profile_timestamp());
+
+    if (this->stats.num_global == 0) {
+      // The local mapper wrote the cells of the remaining particles.
+      this->add_received(num_recv, recv_real, recv_int);
+    } else {
+      // Some particles left the halo, use the global route which also
+      // remaps the particles bound above.
+      StepProfilerRegion region_global(this->step_profiler,
+                                       StepRegion::Transfer,
+                                       "NeighbourTransfer::hybrid_move");
+      this->add_received(num_recv, recv_real, recv_int);
+      reset_mpi_ranks(this->particle_group->mpi_rank_dat);
+      this->particle_group->hybrid_move();
+      this->stats.num_global_moves = 1;
+    }
+    this->particle_group->cell_move();
+
+    this->stats.num_sent = num_departing;
+    this->stats.num_received = num_recv;
+    const INT bytes_per_particle =
+        this->num_reals * sizeof(REAL) + this->num_ints * sizeof(INT);
+    this->stats.bytes_sent = num_departing * bytes_per_particle;
+    this->stats.bytes_received = num_recv * bytes_per_particle;
+    this->stats.time_total = profile_elapsed(t0, profile_timestamp());
+    this->sycl_target->profile_map.inc("NeighbourTransfer", "execute", 1,
+                                       this->stats.time_total);
+    if (this->stats_filename.size()) {
+      this->write_stats();
+    }
+    this->step++;
+  }
+
+  /**
+   * @returns The statistics of the last step on this rank.
+   */
+  inline NeighbourTransferStats get_stats() const { return this->stats; }
+
+  /**
+   * Reduce the statistics of the last step over all ranks. Must be called
+   * collectively.
+   *
+   * @returns Counts summed over all ranks and the maximum times.
+   */
+  inline NeighbourTransferStats reduce_stats() {
+    NeighbourTransferStats global_stats;
+    INT counts_local[4] = {this->stats.num_sent, this->stats.num_received,
+                           this->stats.bytes_sent, this->stats.bytes_received};
+    INT counts[4];
+    MPICHK(MPI_Allreduce(counts_local, counts, 4, MPI_INT64_T, MPI_SUM,
+                         this->comm));
+    double times_local[2] = {this->stats.time_exchange,
+                             this->stats.time_total};
+    double times[2];
+    MPICHK(MPI_Allreduce(times_local, times, 2, MPI_DOUBLE, MPI_MAX,
+                         this->comm));
+    global_stats.num_sent = counts[0];
+    global_stats.num_received = counts[1];
+    global_stats.bytes_sent = counts[2];
+    global_stats.bytes_received = counts[3];
+    global_stats.num_global = this->stats.num_global;
+    global_stats.num_global_moves = this->stats.num_global_moves;
+    global_stats.time_exchange = times[0];
+    global_stats.time_total = times[1];
+    return global_stats;
+  }
+
+  /**
+   * Free the communicator of the transfer. Must be called collectively before
+   * MPI_Finalize.
+   */
+  inline void free() {
+    if (this->comm != MPI_COMM_NULL) {
+      MPICHK(MPI_Comm_free(&this->comm));
+      this->comm = MPI_COMM_NULL;
+    }
+  }
+};
+
+typedef std::shared_ptr<NeighbourTransfer> NeighbourTransferSharedPtr;
+
+} // namespace NESO
+
+#endif
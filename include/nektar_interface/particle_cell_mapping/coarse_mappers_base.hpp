@@ -12,7 +12,8 @@ protected:
   SYCLTargetSharedPtr sycl_target;
   /// The coarse lookup map used to find geometry objects.
   std::unique_ptr<CoarseLookupMap> coarse_lookup_map;
-  /// The nektar++ cell id for the cells indices pointed to from the map.
+  /// The NESO-Particles cell, on the owning MPI rank, of the geometry objects
+  /// pointed to from the map.
   std::unique_ptr<BufferDeviceHost<int>> dh_cell_ids;
   /// The MPI rank that owns the cell.
   std::unique_ptr<BufferDeviceHost<int>> dh_mpi_ranks;
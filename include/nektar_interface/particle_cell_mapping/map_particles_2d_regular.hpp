@@ -12,6 +12,7 @@
 #include "nektar_interface/geometry_transport/shape_mapping.hpp"
 #include "nektar_interface/parameter_store.hpp"
 #include "nektar_interface/particle_mesh_interface.hpp"
+#include "nektar_interface/reduced_precision.hpp"
 #include "newton_geom_interfaces.hpp"
 #include "particle_cell_mapping_common.hpp"
 
@@ -75,18 +76,29 @@ protected:
     output[index * 6 + 5] = (*v2)[1];
   }
 
+  /**
+   *  Map particles and write the reference positions to a REAL or a reduced
+   *  precision INT ParticleDat.
+   */
+  template <typename T>
+  void map_inner(ParticleGroup &particle_group, const int map_cell,
+                 ParticleDatSharedPtr<T> ref_positions);
+
 public:
   /**
    *  Create new instance for all 2D geometry objects in ParticleMeshInterface.
    *
    *  @param sycl_target SYCLTarget to use for computation.
    *  @param particle_mesh_interface ParticleMeshInterface containing graph.
+   *  @param map_geom_to_cell Map from Nektar++ geometry id to cell on the
+   *  owning rank, see ParticleMeshInterface::get_geom_to_cell_map.
    *  @param config ParameterStore instance to set allowable distance to mesh
    * cell tolerance.
    */
   MapParticles2DRegular(
       SYCLTargetSharedPtr sycl_target,
       ParticleMeshInterfaceSharedPtr particle_mesh_interface,
+      const std::map<int, int> &map_geom_to_cell,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>());
 
   /**
@@ -87,6 +87,15 @@ public:
       ParticleMeshInterfaceSharedPtr particle_mesh_interface,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>());
 
+  /**
+   *  Set the profiler which records the time spent in the host fallback
+   *  mapping.
+   *
+   *  @param step_profiler Profiler owned by the particle system, may be
+   *  nullptr.
+   */
+  void set_step_profiler(StepProfilerSharedPtr step_profiler);
+
   /**
    *  Called internally by NESO-Particles to map positions to Nektar++
    *  3D geometry objects
@@ -12,6 +12,7 @@
 #include "nektar_interface/coordinate_mapping.hpp"
 #include "nektar_interface/geometry_transport/shape_mapping.hpp"
 #include "nektar_interface/particle_mesh_interface.hpp"
+#include "nektar_interface/reduced_precision.hpp"
 #include "particle_cell_mapping_common.hpp"
 
 #include <SpatialDomains/MeshGraph.h>
@@ -77,6 +78,14 @@ protected:
     }
   }
 
+  /**
+   *  Map particles and write the reference positions to a REAL or a reduced
+   *  precision INT ParticleDat.
+   */
+  template <typename T>
+  void map_inner(ParticleGroup &particle_group, const int map_cell,
+                 ParticleDatSharedPtr<T> ref_positions);
+
 public:
   /**
    *  Create new mapper object for all 3D regular geometry objects in a
@@ -85,12 +94,15 @@ public:
    *  @param sycl_target SYCLTarget to use for computation.
    *  @param particle_mesh_interface ParticleMeshInterface containing Nektar++
    *  MeshGraph.
+   *  @param map_geom_to_cell Map from Nektar++ geometry id to cell on the
+   *  owning rank, see ParticleMeshInterface::get_geom_to_cell_map.
    *  @param config ParameterStore instance to set allowable distance to mesh
    * cell tolerance.
    */
   MapParticles3DRegular(
       SYCLTargetSharedPtr sycl_target,
       ParticleMeshInterfaceSharedPtr particle_mesh_interface,
+      const std::map<int, int> &map_geom_to_cell,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>());
 
   /**
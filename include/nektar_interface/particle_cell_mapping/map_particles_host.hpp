@@ -9,6 +9,8 @@
 
 #include "../particle_mesh_interface.hpp"
 #include "nektar_interface/parameter_store.hpp"
+#include "nektar_interface/reduced_precision.hpp"
+#include "nektar_interface/step_profiler.hpp"
 #include "particle_cell_mapping_common.hpp"
 #include <SpatialDomains/MeshGraph.h>
 #include <neso_particles.hpp>
@@ -40,6 +42,10 @@ protected:
 
   SYCLTargetSharedPtr sycl_target;
   ParticleMeshInterfaceSharedPtr particle_mesh_interface;
+  /// Map from Nektar++ geometry id to cell on the owning rank.
+  std::map<int, int> map_geom_to_cell;
+  /// Profiler to record the mapping with, may be nullptr.
+  StepProfilerSharedPtr step_profiler;
 
 public:
   /**
@@ -48,14 +54,25 @@ public:
    *  @param sycl_target SYCLTarget on which to perform mapping.
    *  @param particle_mesh_interface ParticleMeshInterface containing 2D
    * Nektar++ cells.
+   *  @param map_geom_to_cell Map from Nektar++ geometry id to cell on the
+   *  owning rank, see ParticleMeshInterface::get_geom_to_cell_map.
    * @param config ParameterStore instance to pass tolerance to Nektar++
    * ContainsPoint.
    */
   MapParticlesHost(
       SYCLTargetSharedPtr sycl_target,
       ParticleMeshInterfaceSharedPtr particle_mesh_interface,
+      const std::map<int, int> &map_geom_to_cell,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>());
 
+  /**
+   *  Set the profiler which records the time spent mapping.
+   *
+   *  @param step_profiler Profiler owned by the particle system, may be
+   *  nullptr.
+   */
+  void set_step_profiler(StepProfilerSharedPtr step_profiler);
+
   /**
    *  Called internally by NESO-Particles to map positions to Nektar++
    *  triangles and quads.
@@ -10,6 +10,7 @@
 #include "coarse_mappers_base.hpp"
 #include "mapping_newton_iteration_base.hpp"
 #include "nektar_interface/parameter_store.hpp"
+#include "nektar_interface/reduced_precision.hpp"
 #include "newton_geom_interfaces.hpp"
 #include "particle_cell_mapping_common.hpp"
 #include "x_map_newton_kernel.hpp"
@@ -113,6 +114,8 @@ public:
    * newton_type is applicable.
    *  @param geoms_remote Vector of remote Nektar++ geometry objects to which
    * newton_type is applicable.
+   *  @param map_geom_to_cell Map from Nektar++ geometry id to cell on the
+   *  owning rank, see ParticleMeshInterface::get_geom_to_cell_map.
    * @param config ParameterStore instance to configure exit tolerance and
    * iteration counts.
    */
@@ -122,6 +125,7 @@ public:
       SYCLTargetSharedPtr sycl_target,
       std::map<int, std::shared_ptr<TYPE_LOCAL>> &geoms_local,
       std::vector<std::shared_ptr<TYPE_REMOTE>> &geoms_remote,
+      const std::map<int, int> &map_geom_to_cell,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>())
       : CoarseMappersBase(sycl_target), newton_type(newton_type),
         num_bytes_per_map_device(
@@ -193,7 +197,7 @@ public:
                    "Bad cell index from map.");
         NESOASSERT(geom->GetGlobalID() == id, "ID mismatch");
 
-        this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+        this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
         this->dh_mpi_ranks->h_buffer.ptr[cell_index] = rank;
         const int geom_type = shape_type_to_int(geom->GetShapeType());
         NESOASSERT((geom_type == index_tet) || (geom_type == index_pyr) ||
@@ -211,7 +215,7 @@ public:
         const int cell_index = this->coarse_lookup_map->gid_to_lookup_id.at(id);
         NESOASSERT((cell_index < num_geoms) && (0 <= cell_index),
                    "Bad cell index from map.");
-        this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+        this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
         this->dh_mpi_ranks->h_buffer.ptr[cell_index] = geom->rank;
         const int geom_type = shape_type_to_int(geom->geom->GetShapeType());
         NESOASSERT((geom_type == index_tet) || (geom_type == index_pyr) ||
@@ -235,15 +239,15 @@ public:
     }
   }
 
+protected:
   /**
-   *  Called internally by NESO to map positions to Nektar++
-   *  Geometry objects via Newton iteration.
+   *  Map particles with Newton iteration from the centre of each candidate
+   *  geometry object, see map_initial.
    */
-  inline void map_initial(ParticleGroup &particle_group, const int map_cell) {
-
-    if (this->num_geoms == 0) {
-      return;
-    }
+  template <typename U>
+  inline void map_initial_inner(ParticleGroup &particle_group,
+                                const int map_cell,
+                                ParticleDatSharedPtr<U> ref_positions) {
 
     auto &clm = this->coarse_lookup_map;
     // Get kernel pointers to the mesh data.
@@ -270,8 +274,6 @@ public:
     auto position_dat = particle_group.position_dat;
     auto cell_ids = particle_group.cell_id_dat;
     auto mpi_ranks = particle_group.mpi_rank_dat;
-    auto ref_positions =
-        particle_group.get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"));
     auto local_memory =
         LocalMemoryBlock<DataLocal>(this->num_elements_local_memory);
 
@@ -364,12 +366,12 @@ public:
               cell_found = contained && converged;
 
               if (cell_found) {
-                const int geom_id = k_map_cell_ids[geom_map_index];
+                const int cell = k_map_cell_ids[geom_map_index];
                 const int mpi_rank = k_map_mpi_ranks[geom_map_index];
-                k_part_cell_ids.at(0) = geom_id;
+                k_part_cell_ids.at(0) = cell;
                 k_part_mpi_ranks.at(1) = mpi_rank;
                 for (int dx = 0; dx < k_ndim; dx++) {
-                  k_part_ref_positions.at(dx) = xi[dx];
+                  ReducedPrecision::set(k_part_ref_positions, dx, xi[dx]);
                 }
               }
             }
@@ -387,14 +389,13 @@ public:
   }
 
   /**
-   *  Called internally by NESO to map positions to Nektar++
-   *  Geometry objects via Newton iteration.
+   *  Map particles with Newton iteration from a grid of starting points in
+   *  each candidate geometry object, see map_final.
    */
-  inline void map_final(ParticleGroup &particle_group, const int map_cell) {
-    if (this->num_geoms == 0) {
-      return;
-    }
-
+  template <typename U>
+  inline void map_final_inner(ParticleGroup &particle_group,
+                              const int map_cell,
+                              ParticleDatSharedPtr<U> ref_positions) {
     auto &clm = this->coarse_lookup_map;
     // Get kernel pointers to the mesh data.
     const auto &mesh = clm->cartesian_mesh;
@@ -425,8 +426,6 @@ public:
     auto position_dat = particle_group.position_dat;
     auto cell_ids = particle_group.cell_id_dat;
     auto mpi_ranks = particle_group.mpi_rank_dat;
-    auto ref_positions =
-        particle_group.get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"));
     auto local_memory =
         LocalMemoryBlock<DataLocal>(this->num_elements_local_memory);
 
@@ -527,12 +526,13 @@ public:
                     cell_found = contained && converged;
 
                     if (cell_found) {
-                      const int geom_id = k_map_cell_ids[geom_map_index];
+                      const int cell = k_map_cell_ids[geom_map_index];
                       const int mpi_rank = k_map_mpi_ranks[geom_map_index];
-                      k_part_cell_ids.at(0) = geom_id;
+                      k_part_cell_ids.at(0) = cell;
                       k_part_mpi_ranks.at(1) = mpi_rank;
                       for (int dx = 0; dx < k_ndim; dx++) {
-                        k_part_ref_positions.at(dx) = xi[dx];
+                        ReducedPrecision::set(k_part_ref_positions, dx,
+                                              xi[dx]);
                       }
                     }
                   }
@@ -551,6 +551,35 @@ public:
       loop->execute();
     }
   }
+
+public:
+  /**
+   *  Called internally by NESO to map positions to Nektar++
+   *  Geometry objects via Newton iteration.
+   */
+  inline void map_initial(ParticleGroup &particle_group, const int map_cell) {
+    if (this->num_geoms == 0) {
+      return;
+    }
+    ReducedPrecision::visit_reference_positions(
+        particle_group, [&](auto ref_positions) {
+          this->map_initial_inner(particle_group, map_cell, ref_positions);
+        });
+  }
+
+  /**
+   *  Called internally by NESO to map positions to Nektar++
+   *  Geometry objects via Newton iteration.
+   */
+  inline void map_final(ParticleGroup &particle_group, const int map_cell) {
+    if (this->num_geoms == 0) {
+      return;
+    }
+    ReducedPrecision::visit_reference_positions(
+        particle_group, [&](auto ref_positions) {
+          this->map_final_inner(particle_group, map_cell, ref_positions);
+        });
+  }
 };
 
 } // namespace NESO::Newton
@@ -9,6 +9,7 @@
 
 #include "../coordinate_mapping.hpp"
 #include "../particle_mesh_interface.hpp"
+#include "../reduced_precision.hpp"
 #include "coarse_lookup_map.hpp"
 #include "particle_cell_mapping_2d.hpp"
 #include "particle_cell_mapping_3d.hpp"
@@ -31,6 +32,7 @@ private:
   ParticleMeshInterfaceSharedPtr particle_mesh_interface;
   std::unique_ptr<MapParticles2D> map_particles_2d;
   std::unique_ptr<MapParticles3D> map_particles_3d;
+  bool reduced_precision;
 
 public:
   ~NektarGraphLocalMapper(){};
@@ -51,13 +53,24 @@ public:
    * Nektar++ mesh.
    *  @param tol Tolerance to pass to Nektar++ to bin particles into cells.
    *  @param config ParameterStore instance to configure lower level particle to
-   * cell mappers.
+   * cell mappers. If "NektarGraphLocalMapper/reduced_precision" is non-zero
+   * the reference positions are stored in reduced precision, see
+   * ReducedPrecision, instead of in the REAL NESO_REFERENCE_POSITIONS
+   * ParticleDat.
    */
   NektarGraphLocalMapper(
       SYCLTargetSharedPtr sycl_target,
       ParticleMeshInterfaceSharedPtr particle_mesh_interface,
       ParameterStoreSharedPtr config = std::make_shared<ParameterStore>());
 
+  /**
+   *  Set the profiler which records the time spent mapping particles.
+   *
+   *  @param step_profiler Profiler owned by the particle system, may be
+   *  nullptr.
+   */
+  void set_step_profiler(StepProfilerSharedPtr step_profiler);
+
   /**
    *  Called internally by NESO-Particles to map positions to Nektar++
    *  geometry objects.
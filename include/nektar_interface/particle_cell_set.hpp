@@ -0,0 +1,336 @@
+#ifndef __PARTICLE_CELL_SET_H_
+#define __PARTICLE_CELL_SET_H_
+
+#include "particle_mesh_interface.hpp"
+#include "utility_sycl.hpp"
+#include <SpatialDomains/MeshGraph.h>
+#include <neso_particles.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace Nektar::SpatialDomains;
+using namespace NESO::Particles;
+
+namespace NESO {
+
+class ParticleCellSet;
+typedef std::shared_ptr<ParticleCellSet> ParticleCellSetSharedPtr;
+
+/**
+ * A set of NESO-Particles cells, i.e. local Nektar++ elements, which is
+ * resolved once and stored on the host and device. Kernels which only apply
+ * to particles in a known region of the mesh, e.g. the elements adjacent to a
+ * boundary composite, may iterate only the cells in the set with execute
+ * such that the cost scales with the number of particles in those cells
+ * rather than the total number of particles. All cells of the set are
+ * iterated by a single kernel launch. Methods which take a ParticleSubGroup
+ * as an iteration set, e.g. ParticleLoops or boundary conditions, are passed
+ * the particles of the set with get_sub_group.
+ */
+class ParticleCellSet {
+protected:
+  SYCLTargetSharedPtr sycl_target;
+  int cell_count;
+  std::vector<int> cells;
+  BufferDeviceHost<int> dh_cells;
+  BufferDeviceHost<int> dh_mask;
+  INT num_launches;
+
+  static inline void
+  get_local_elements(ParticleMeshInterfaceSharedPtr mesh,
+                     std::vector<std::shared_ptr<Geometry>> &elements) {
+    // The NESO-Particles cell of an element is its index in this map, see
+    // CellIDTranslation.
+    if (mesh->ndim == 2) {
+      std::map<int, std::shared_ptr<Geometry2D>> geoms;
+      get_all_elements_2d(mesh->graph, geoms);
+      for (auto &geom : geoms) {
+        elements.push_back(geom.second);
+      }
+    } else if (mesh->ndim == 3) {
+      std::map<int, std::shared_ptr<Geometry3D>> geoms;
+      get_all_elements_3d(mesh->graph, geoms);
+      for (auto &geom : geoms) {
+        elements.push_back(geom.second);
+      }
+    } else {
+      NESOASSERT(false, "Unsupported spatial dimension.");
+    }
+  }
+
+public:
+  /// Disable (implicit) copies.
+  ParticleCellSet(const ParticleCellSet &st) = delete;
+  /// Disable (implicit) copies.
+  ParticleCellSet &operator=(ParticleCellSet const &a) = delete;
+
+  /**
+   * Create a cell set from the local elements which satisfy a predicate.
+   *
+   * @param sycl_target Compute device to store the set on.
+   * @param mesh Interface between NESO-Particles and Nektar++ meshes.
+   * @param predicate Function which returns true for the elements in the set.
+   * Called with the NESO-Particles cell and the Nektar++ element.
+   */
+  ParticleCellSet(
+      SYCLTargetSharedPtr sycl_target, ParticleMeshInterfaceSharedPtr mesh,
+      std::function<bool(const int, std::shared_ptr<Geometry>)> predicate)
+      : sycl_target(sycl_target), cell_count(mesh->get_cell_count()),
+        dh_cells(sycl_target, 1), dh_mask(sycl_target, 1), num_launches(0) {
+
+    std::vector<std::shared_ptr<Geometry>> elements;
+    get_local_elements(mesh, elements);
+    NESOASSERT(static_cast<int>(elements.size()) == this->cell_count,
+               "Missmatch in number of elements and number of cells.");
+
+    this->dh_mask.realloc_no_copy(std::max(this->cell_count, 1));
+    for (int cellx = 0; cellx < this->cell_count; cellx++) {
+      const bool in_set = predicate(cellx, elements[cellx]);
+      this->dh_mask.h_buffer.ptr[cellx] = in_set ? 1 : 0;
+      if (in_set) {
+        this->cells.push_back(cellx);
+      }
+    }
+    const int num_cells = this->cells.size();
+    this->dh_cells.realloc_no_copy(std::max(num_cells, 1));
+    for (int cx = 0; cx < num_cells; cx++) {
+      this->dh_cells.h_buffer.ptr[cx] = this->cells[cx];
+    }
+    this->dh_cells.host_to_device();
+    this->dh_mask.host_to_device();
+  }
+
+  /**
+   * Create the set of local elements which have an edge (2D) or face (3D) in
+   * one of the given composites, e.g. the elements adjacent to a wall.
+   *
+   * @param sycl_target Compute device to store the set on.
+   * @param mesh Interface between NESO-Particles and Nektar++ meshes.
+   * @param composite_indices Indices of the boundary composites.
+   * @returns The cells adjacent to the composites.
+   */
+  static inline ParticleCellSetSharedPtr
+  adjacent_to_composites(SYCLTargetSharedPtr sycl_target,
+                         ParticleMeshInterfaceSharedPtr mesh,
+                         const std::vector<int> &composite_indices) {
+    std::set<int> boundary_ids;
+    auto &composites = mesh->graph->GetComposites();
+    for (const int index : composite_indices) {
+      auto it = composites.find(index);
+      // A composite may have no geometry objects on this rank.
+      if (it == composites.end()) {
+        continue;
+      }
+      for (auto &geom : it->second->m_geomVec) {
+        boundary_ids.insert(geom->GetGlobalID());
+      }
+    }
+
+    const int ndim = mesh->ndim;
+    return std::make_shared<ParticleCellSet>(
+        sycl_target, mesh,
+        [&](const int, std::shared_ptr<Geometry> element) -> bool {
+          if (ndim == 2) {
+            for (int ex = 0; ex < element->GetNumEdges(); ex++) {
+              if (boundary_ids.count(element->GetEdge(ex)->GetGlobalID())) {
+                return true;
+              }
+            }
+          } else {
+            for (int fx = 0; fx < element->GetNumFaces(); fx++) {
+              if (boundary_ids.count(element->GetFace(fx)->GetGlobalID())) {
+                return true;
+              }
+            }
+          }
+          return false;
+        });
+  }
+
+  /**
+   * Create the set of local elements whose centroid, the average of the
+   * vertices, lies in an axis aligned box.
+   *
+   * @param sycl_target Compute device to store the set on.
+   * @param mesh Interface between NESO-Particles and Nektar++ meshes.
+   * @param lower Lower corner of the box, at least ndim values.
+   * @param upper Upper corner of the box, at least ndim values.
+   * @returns The cells with centroids in the box.
+   */
+  static inline ParticleCellSetSharedPtr
+  centroid_in_box(SYCLTargetSharedPtr sycl_target,
+                  ParticleMeshInterfaceSharedPtr mesh,
+                  const std::vector<REAL> &lower,
+                  const std::vector<REAL> &upper) {
+    const int ndim = mesh->ndim;
+    NESOASSERT((static_cast<int>(lower.size()) >= ndim) &&
+                   (static_cast<int>(upper.size()) >= ndim),
+               "Box corners have too few components.");
+    return std::make_shared<ParticleCellSet>(
+        sycl_target, mesh,
+        [&](const int, std::shared_ptr<Geometry> element) -> bool {
+          REAL centroid[3] = {0.0, 0.0, 0.0};
+          const int num_verts = element->GetNumVerts();
+          for (int vx = 0; vx < num_verts; vx++) {
+            NekDouble x[3];
+            element->GetVertex(vx)->GetCoords(x[0], x[1], x[2]);
+            for (int dimx = 0; dimx < 3; dimx++) {
+              centroid[dimx] += x[dimx] / num_verts;
+            }
+          }
+          for (int dimx = 0; dimx < ndim; dimx++) {
+            if ((centroid[dimx] < lower[dimx]) ||
+                (centroid[dimx] >= upper[dimx])) {
+              return false;
+            }
+          }
+          return true;
+        });
+  }
+
+  /**
+   * @returns Number of cells in the set.
+   */
+  inline int get_num_cells() const { return this->cells.size(); }
+
+  /**
+   * @returns The NESO-Particles cells in the set in ascending order.
+   */
+  inline const std::vector<int> &get_cells() const { return this->cells; }
+
+  /**
+   * @param cell NESO-Particles cell.
+   * @returns True if the cell is in the set.
+   */
+  inline bool contains(const int cell) const {
+    NESOASSERT((0 <= cell) && (cell < this->cell_count), "Bad cell index.");
+    return this->dh_mask.h_buffer.ptr[cell] > 0;
+  }
+
+  /**
+   * @returns Device pointer to the get_num_cells cells in the set.
+   */
+  inline const int *get_device_cells() const {
+    return this->dh_cells.d_buffer.ptr;
+  }
+
+  /**
+   * @returns Device pointer to a mask over all cells which is non-zero for
+   * the cells in the set.
+   */
+  inline const int *get_device_mask() const {
+    return this->dh_mask.d_buffer.ptr;
+  }
+
+  /**
+   * Submit a kernel for the particles in the cells of the set only. The
+   * kernel is launched once, as an nd_range over the (cell, layer) pairs of
+   * the set, and is called with the NESO-Particles cell and layer of each
+   * particle. ParticleDat values are accessed through device pointers, e.g.
+   * from Access::direct_get, indexed as [cell][component][layer].
+   *
+   * @param particle_group ParticleGroup whose particles are iterated.
+   * @param kernel Device callable with signature (const int, const INT).
+   * @returns Event for the kernel.
+   */
+  template <typename KERNEL>
+  inline sycl::event submit(ParticleGroupSharedPtr particle_group,
+                            KERNEL kernel) {
+    const int num_cells = this->cells.size();
+    auto mpi_rank_dat = particle_group->mpi_rank_dat;
+    INT max_occupancy = 0;
+    for (const int cellx : this->cells) {
+      max_occupancy = std::max(
+          max_occupancy, static_cast<INT>(mpi_rank_dat->h_npart_cell[cellx]));
+    }
+    if (max_occupancy == 0) {
+      return sycl::event{};
+    }
+
+    const std::size_t local_size =
+        this->sycl_target->parameters
+            ->template get<SizeTParameter>("LOOP_LOCAL_SIZE")
+            ->value;
+    const std::size_t outer_size = get_global_size(
+        static_cast<std::size_t>(max_occupancy), local_size);
+    sycl::range<2> cell_iterset_range{static_cast<std::size_t>(num_cells),
+                                      outer_size};
+    sycl::range<2> local_iterset{1, local_size};
+    const int *k_cells = this->dh_cells.d_buffer.ptr;
+    const auto k_npart_cell = mpi_rank_dat->d_npart_cell;
+
+    this->num_launches++;
+    return this->sycl_target->queue.submit([&](sycl::handler &cgh) {
+      cgh.parallel_for<>(
+          this->sycl_target->device_limits.validate_nd_range(
+              sycl::nd_range<2>(cell_iterset_range, local_iterset)),
+          [=](sycl::nd_item<2> idx) {
+            const int cellx = k_cells[idx.get_global_id(0)];
+            const INT layerx = idx.get_global_id(1);
+            if (layerx < k_npart_cell[cellx]) {
+              kernel(cellx, layerx);
+            }
+          });
+    });
+  }
+
+  /**
+   * Execute a kernel for the particles in the cells of the set only, see
+   * submit, and wait for it to complete.
+   *
+   * @param particle_group ParticleGroup whose particles are iterated.
+   * @param kernel Device callable with signature (const int, const INT).
+   */
+  template <typename KERNEL>
+  inline void execute(ParticleGroupSharedPtr particle_group, KERNEL kernel) {
+    auto t0 = profile_timestamp();
+    this->submit(particle_group, kernel).wait_and_throw();
+    const auto t1 = profile_timestamp();
+    this->sycl_target->profile_map.inc("ParticleCellSet", "execute", 1,
+                                       profile_elapsed(t0, t1));
+  }
+
+  /**
+   * @returns Number of kernels launched by submit and execute.
+   */
+  inline INT get_num_launches() const { return this->num_launches; }
+
+  /**
+   * Create a ParticleSubGroup of the particles in the cells of the set. The
+   * selection only reads the cell of each particle and looks it up in the
+   * device mask; the sub-group recomputes it when particles are added,
+   * removed or moved between cells. This set must outlive the returned
+   * sub-group.
+   *
+   * @param particle_group ParticleGroup to select particles from.
+   * @returns The particles in the cells of the set.
+   */
+  inline ParticleSubGroupSharedPtr
+  get_sub_group(ParticleGroupSharedPtr particle_group) const {
+    const int *k_mask = this->dh_mask.d_buffer.ptr;
+    return particle_sub_group(
+        particle_group,
+        [=](auto CELL_ID) { return k_mask[CELL_ID.at(0)] > 0; },
+        Access::read(particle_group->cell_id_dat->sym));
+  }
+
+  /**
+   * @param particle_group ParticleGroup to count particles in.
+   * @returns Number of local particles in the cells of the set.
+   */
+  inline INT get_npart_local(ParticleGroupSharedPtr particle_group) const {
+    INT npart = 0;
+    for (const int cellx : this->cells) {
+      npart += particle_group->position_dat->cell_dat.nrow[cellx];
+    }
+    return npart;
+  }
+};
+
+} // namespace NESO
+
+#endif
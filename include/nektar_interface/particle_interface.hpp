@@ -22,8 +22,11 @@
 #include "cell_id_translation.hpp"
 #include "geometry_transport/geometry_transport.hpp"
 #include "geometry_transport/halo_extension.hpp"
+#include "neighbour_transfer.hpp"
 #include "particle_boundary_conditions.hpp"
 #include "particle_cell_mapping/particle_cell_mapping.hpp"
+#include "particle_cell_set.hpp"
+#include "particle_load_metrics.hpp"
 #include "particle_mesh_interface.hpp"
 
 #endif
@@ -0,0 +1,240 @@
+#ifndef __PARTICLE_LOAD_METRICS_H_
+#define __PARTICLE_LOAD_METRICS_H_
+
+#include <SpatialDomains/MeshGraph.h>
+#include <mpi.h>
+#include <neso_particles.hpp>
+
+#include "cell_id_translation.hpp"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Spread of a per-rank quantity over the ranks of a communicator.
+ */
+struct ImbalanceMetrics {
+  /// Minimum value over all ranks.
+  REAL min;
+  /// Mean value over all ranks.
+  REAL mean;
+  /// Maximum value over all ranks.
+  REAL max;
+
+  /**
+   * @returns Ratio of maximum to mean value, 1 for a perfectly balanced
+   * quantity.
+   */
+  inline REAL imbalance() const {
+    return (this->mean > 0.0) ? this->max / this->mean : 1.0;
+  }
+};
+
+/**
+ * Compute the minimum, mean and maximum of a per-rank value. Must be called
+ * collectively on the communicator.
+ *
+ * @param comm MPI communicator.
+ * @param local_value Value on this rank.
+ * @returns Imbalance metrics of the value.
+ */
+inline ImbalanceMetrics get_imbalance_metrics(MPI_Comm comm,
+                                              const REAL local_value) {
+  int size;
+  MPICHK(MPI_Comm_size(comm, &size));
+  ImbalanceMetrics metrics;
+  REAL sum;
+  MPICHK(MPI_Allreduce(&local_value, &metrics.min, 1, MPI_DOUBLE, MPI_MIN,
+                       comm));
+  MPICHK(MPI_Allreduce(&local_value, &metrics.max, 1, MPI_DOUBLE, MPI_MAX,
+                       comm));
+  MPICHK(MPI_Allreduce(&local_value, &sum, 1, MPI_DOUBLE, MPI_SUM, comm));
+  metrics.mean = sum / size;
+  return metrics;
+}
+
+/**
+ * Measures the particle cost of each Nektar++ element owned by this rank and
+ * the resulting load imbalance between ranks. The cost of an element is a
+ * fixed per-element weight plus an exponentially smoothed count of the
+ * particles it contains. Costs are keyed by global geometry id so that they
+ * remain meaningful under a different mesh partition, e.g. when written with
+ * write_element_costs and read back with read_element_costs for analysis.
+ * Only measurement is provided: the mesh partition, the MeshHierarchy
+ * ownership and the particles are not changed.
+ */
+class ParticleLoadMetrics {
+protected:
+  ParticleGroupSharedPtr particle_group;
+  std::shared_ptr<CellIDTranslation> cell_id_translation;
+  MPI_Comm comm;
+  std::vector<REAL> particle_counts;
+  bool measured;
+
+public:
+  /// Smoothing factor in (0, 1], the weight of the latest measurement.
+  const REAL smoothing;
+  /// Cost of an element that contains no particles, in units of particles.
+  const REAL element_weight;
+
+  /**
+   * Create a new instance.
+   *
+   * @param particle_group ParticleGroup whose particles are counted.
+   * @param cell_id_translation Map from cells to Nektar++ geometry ids.
+   * @param smoothing Weight of the latest measurement in the smoothed
+   * particle counts, default 0.5.
+   * @param element_weight Cost of an element in units of particles, default 1.
+   */
+  ParticleLoadMetrics(
+      ParticleGroupSharedPtr particle_group,
+      std::shared_ptr<CellIDTranslation> cell_id_translation,
+      const REAL smoothing = 0.5, const REAL element_weight = 1.0)
+      : particle_group(particle_group),
+        cell_id_translation(cell_id_translation),
+        comm(particle_group->sycl_target->comm_pair.comm_parent),
+        measured(false), smoothing(smoothing), element_weight(element_weight) {
+    NESOASSERT((0.0 < smoothing) && (smoothing <= 1.0),
+               "Smoothing factor must be in (0, 1].");
+    this->particle_counts.resize(
+        this->cell_id_translation->map_to_nektar.size());
+    std::fill(this->particle_counts.begin(), this->particle_counts.end(), 0.0);
+  }
+
+  /**
+   * Measure the number of particles in each cell and fold it into the smoothed
+   * counts. The first call sets the counts directly.
+   */
+  inline void update() {
+    const int cell_count = this->particle_counts.size();
+    const REAL alpha = this->measured ? this->smoothing : 1.0;
+    for (int cellx = 0; cellx < cell_count; cellx++) {
+      const REAL npart = this->particle_group->get_npart_cell(cellx);
+      this->particle_counts[cellx] =
+          alpha * npart + (1.0 - alpha) * this->particle_counts[cellx];
+    }
+    this->measured = true;
+  }
+
+  /**
+   * Get the imbalance of the current number of particles per rank. Must be
+   * called collectively.
+   *
+   * @returns Imbalance metrics of the particle counts.
+   */
+  inline ImbalanceMetrics get_particle_metrics() {
+    const REAL npart = this->particle_group->get_npart_local();
+    return get_imbalance_metrics(this->comm, npart);
+  }
+
+  /**
+   * Get the imbalance of the smoothed element costs summed per rank. Must be
+   * called collectively.
+   *
+   * @returns Imbalance metrics of the per-rank cost.
+   */
+  inline ImbalanceMetrics get_cost_metrics() {
+    REAL local_cost = 0.0;
+    for (const REAL count : this->particle_counts) {
+      local_cost += this->element_weight + count;
+    }
+    return get_imbalance_metrics(this->comm, local_cost);
+  }
+
+  /**
+   * @returns Map from global geometry id to the smoothed cost of each element
+   * owned by this rank.
+   */
+  inline std::map<int, REAL> get_element_costs() {
+    std::map<int, REAL> costs;
+    const int cell_count = this->particle_counts.size();
+    for (int cellx = 0; cellx < cell_count; cellx++) {
+      costs[this->cell_id_translation->map_to_nektar[cellx]] =
+          this->element_weight + this->particle_counts[cellx];
+    }
+    return costs;
+  }
+
+  /**
+   * Write the costs of all elements, gathered over all ranks, to a text file
+   * with one "geometry_id cost" pair per line. Must be called collectively;
+   * rank 0 writes the file.
+   *
+   * @param filename File to write.
+   */
+  inline void write_element_costs(const std::string &filename) {
+    int rank, size;
+    MPICHK(MPI_Comm_rank(this->comm, &rank));
+    MPICHK(MPI_Comm_size(this->comm, &size));
+
+    auto costs = this->get_element_costs();
+    const int num_local = costs.size();
+    std::vector<int> ids;
+    std::vector<REAL> values;
+    ids.reserve(num_local);
+    values.reserve(num_local);
+    for (auto &[id, cost] : costs) {
+      ids.push_back(id);
+      values.push_back(cost);
+    }
+
+    std::vector<int> counts(size);
+    MPICHK(MPI_Gather(&num_local, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+                      this->comm));
+    std::vector<int> displs(size, 0);
+    int num_global = 0;
+    for (int rx = 0; rx < size; rx++) {
+      displs[rx] = num_global;
+      num_global += counts[rx];
+    }
+    std::vector<int> all_ids(num_global);
+    std::vector<REAL> all_values(num_global);
+    MPICHK(MPI_Gatherv(ids.data(), num_local, MPI_INT, all_ids.data(),
+                       counts.data(), displs.data(), MPI_INT, 0, this->comm));
+    MPICHK(MPI_Gatherv(values.data(), num_local, MPI_DOUBLE, all_values.data(),
+                       counts.data(), displs.data(), MPI_DOUBLE, 0,
+                       this->comm));
+
+    if (rank == 0) {
+      std::ofstream out(filename);
+      NESOASSERT(out.is_open(),
+                 "Could not open element cost file " + filename);
+      out.precision(17);
+      for (int ix = 0; ix < num_global; ix++) {
+        out << all_ids[ix] << " " << all_values[ix] << "\n";
+      }
+    }
+  }
+
+  /**
+   * Read element costs written by write_element_costs.
+   *
+   * @param filename File to read.
+   * @returns Map from global geometry id to element cost.
+   */
+  static inline std::map<int, REAL>
+  read_element_costs(const std::string &filename) {
+    std::ifstream in(filename);
+    NESOASSERT(in.is_open(), "Could not open element cost file " + filename);
+    std::map<int, REAL> costs;
+    int id;
+    REAL cost;
+    while (in >> id >> cost) {
+      costs[id] = cost;
+    }
+    return costs;
+  }
+};
+
+typedef std::shared_ptr<ParticleLoadMetrics> ParticleLoadMetricsSharedPtr;
+
+} // namespace NESO
+
+#endif
@@ -21,6 +21,8 @@
 #include "bounding_box_intersection.hpp"
 #include "composite_interaction/composite_utility.hpp"
 #include "geometry_transport/geometry_transport.hpp"
+#include "geometry_transport/setup_cache.hpp"
+#include "utility_mpi.hpp"
 
 using namespace Nektar::SpatialDomains;
 using namespace NESO;
@@ -284,9 +286,6 @@ inline void bounding_box_claim(int element_id, T element,
 class ParticleMeshInterface : public HMesh {
 
 private:
-  MPI_Win recv_win;
-  int *recv_win_data;
-
   /**
    *  Get the MPI remote MPI ranks this rank expects to send geometry objects
    * to.
@@ -320,73 +319,15 @@ private:
   }
 
   /**
-   * Reset the local data structures before call to
-   * exchange_finalise_send_counts.
-   */
-  inline MPI_Request exchange_init_send_counts() {
-    NESOASSERT(this->recv_win_data != nullptr, "recv win is not allocated.");
-    this->recv_win_data[0] = 0;
-    MPI_Request request_barrier;
-    MPICHK(MPI_Ibarrier(this->comm, &request_barrier));
-    return request_barrier;
-  }
-
-  /**
-   * Exchange send counts of geometry objecys between MPI ranks.
+   *  Send the packed sizes to the remote ranks this rank sends to and get the
+   *  ranks, and packed sizes, this rank receives from.
    */
-  inline int exchange_finalise_send_counts(MPI_Request &request_barrier,
-                                           std::vector<int> &send_ranks) {
-
-    NESOASSERT(this->recv_win_data != nullptr, "recv win is not allocated.");
-    MPICHK(MPI_Wait(&request_barrier, MPI_STATUS_IGNORE));
-    // start to setup the communication pattern
-    const int one[1] = {1};
-    int recv[1];
-    for (int rank : send_ranks) {
-      MPICHK(MPI_Win_lock(MPI_LOCK_SHARED, rank, 0, this->recv_win));
-      MPICHK(MPI_Get_accumulate(one, 1, MPI_INT, recv, 1, MPI_INT, rank, 0, 1,
-                                MPI_INT, MPI_SUM, this->recv_win));
-      MPICHK(MPI_Win_unlock(rank, this->recv_win));
-    }
-
-    MPICHK(MPI_Barrier(this->comm));
-    const int num_recv_ranks = this->recv_win_data[0];
-    return num_recv_ranks;
-  }
-
-  /**
-   *  Get the ranks to recv from for exchange operations
-   */
-  inline void exchange_get_recv_ranks(const int num_send_ranks,
-                                      std::vector<int> &send_ranks,
-                                      std::vector<int> &send_sizes,
-                                      const int num_recv_ranks,
-                                      std::vector<int> &recv_ranks,
-                                      std::vector<int> &recv_sizes) {
-    // send the packed sizes to the remote ranks
-    std::vector<MPI_Request> recv_requests(num_recv_ranks);
-    // non-blocking recv packed geom sizes
-    for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
-      MPICHK(MPI_Irecv(recv_sizes.data() + rankx, 1, MPI_INT, MPI_ANY_SOURCE,
-                       45, this->comm, recv_requests.data() + rankx));
-    }
-    // send sizes to remote ranks
-    for (int rankx = 0; rankx < num_send_ranks; rankx++) {
-      const int remote_rank = send_ranks[rankx];
-      MPICHK(MPI_Send(send_sizes.data() + rankx, 1, MPI_INT, remote_rank, 45,
-                      this->comm));
-    }
-
-    // wait for recv sizes to be recvd
-    std::vector<MPI_Status> recv_status(num_recv_ranks);
-
-    MPICHK(
-        MPI_Waitall(num_recv_ranks, recv_requests.data(), recv_status.data()));
-
-    for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
-      const int remote_rank = recv_status[rankx].MPI_SOURCE;
-      recv_ranks[rankx] = remote_rank;
-    }
+  inline int exchange_get_recv_ranks(std::vector<int> &send_ranks,
+                                     std::vector<int> &send_sizes,
+                                     std::vector<int> &recv_ranks,
+                                     std::vector<int> &recv_sizes) {
+    return sparse_exchange_counts(this->comm, send_ranks, send_sizes,
+                                  recv_ranks, recv_sizes);
   }
 
   /**
@@ -399,8 +340,6 @@ private:
       std::vector<int> &send_ranks,
       std::vector<std::shared_ptr<RemoteGeom2D<T>>> &output_container) {
 
-    auto request_barrier = exchange_init_send_counts();
-
     // map from remote MPI ranks to packed geoms
     std::map<int, std::shared_ptr<PackedGeoms2D>> rank_pack_geom_map;
     // pack the local geoms for each remote rank
@@ -413,14 +352,11 @@ private:
           static_cast<int>(rank_pack_geom_map[remote_rank]->buf.size());
     }
 
-    // determine the number of remote ranks that will send geoms to this rank
+    // determine the remote ranks that will send geoms to this rank
+    std::vector<int> recv_sizes;
+    std::vector<int> recv_ranks;
     const int num_recv_ranks =
-        exchange_finalise_send_counts(request_barrier, send_ranks);
-
-    std::vector<int> recv_sizes(num_recv_ranks);
-    std::vector<int> recv_ranks(num_recv_ranks);
-    exchange_get_recv_ranks(num_send_ranks, send_ranks, send_sizes,
-                            num_recv_ranks, recv_ranks, recv_sizes);
+        exchange_get_recv_ranks(send_ranks, send_sizes, recv_ranks, recv_sizes);
 
     // allocate space for the recv'd geometry objects
     const int max_recv_size =
@@ -656,16 +592,10 @@ private:
                               MHGeomMap &mh_geom_map_tri,
                               MHGeomMap &mh_geom_map_quad) {
 
-    MPICHK(MPI_Win_allocate(sizeof(int), sizeof(int), MPI_INFO_NULL, this->comm,
-                            &this->recv_win_data, &this->recv_win));
-
     // exchange geometry objects between ranks
     this->exchange_geometry_2d(triangles, mh_geom_map_tri,
                                this->remote_triangles);
     this->exchange_geometry_2d(quads, mh_geom_map_quad, this->remote_quads);
-
-    MPICHK(MPI_Win_free(&this->recv_win));
-    this->recv_win_data = nullptr;
   }
 
   /**
@@ -725,9 +655,6 @@ private:
         send_sizes, deconstructed_geoms, rank_triangle_map, rank_quad_map);
 
     // send to remote MPI ranks
-    MPICHK(MPI_Win_allocate(sizeof(int), sizeof(int), MPI_INFO_NULL, this->comm,
-                            &this->recv_win_data, &this->recv_win));
-
     exchange_2d_send_wrapper(rank_triangle_map, this->remote_triangles);
     exchange_2d_send_wrapper(rank_quad_map, this->remote_quads);
 
@@ -755,16 +682,11 @@ private:
     }
 
     // exchange the 3D geometry information
-    // determine the number of remote ranks that will send geoms to this rank
-    auto request_barrier = exchange_init_send_counts();
+    // determine the remote ranks that will send geoms to this rank
+    std::vector<int> recv_sizes;
+    std::vector<int> recv_ranks;
     const int num_recv_ranks =
-        exchange_finalise_send_counts(request_barrier, send_ranks);
-    std::vector<int> recv_sizes(num_recv_ranks);
-    std::vector<int> recv_ranks(num_recv_ranks);
-    exchange_get_recv_ranks(num_send_ranks, send_ranks, send_sizes,
-                            num_recv_ranks, recv_ranks, recv_sizes);
-    MPICHK(MPI_Win_free(&this->recv_win));
-    this->recv_win_data = nullptr;
+        exchange_get_recv_ranks(send_ranks, send_sizes, recv_ranks, recv_sizes);
 
     // recv_ranks now contains remote ranks that will send 3D deconstructed
     // objects. recv_sizes now contains how many ints each of these ranks will
@@ -857,6 +779,12 @@ public:
   std::vector<std::shared_ptr<RemoteGeom2D<QuadGeom>>> remote_quads;
   /// Vector of remote 3D geometry objects which have been copied to this rank.
   std::vector<std::shared_ptr<RemoteGeom3D>> remote_geoms_3d;
+  /// True if the MeshHierarchy ownership and halos were read from a cache.
+  bool setup_from_cache = false;
+  /// True if the most recent halo extension was read from the cache.
+  bool halo_extension_from_cache = false;
+  /// Cache of the setup and halo extensions, null if caching is disabled.
+  std::shared_ptr<SetupCache> setup_cache;
 
   ~ParticleMeshInterface() {}
 
@@ -867,10 +795,16 @@ public:
    *  @param subdivision_order_offset Offset to the computed subdivision order.
    *  An offset of 0 will match the order of elements in the MeshGraph.
    *  @param comm MPI Communicator to use.
+   *  @param setup_cache_dir Optional directory of a SetupCache. If passed, the
+   *  MeshHierarchy ownership and halos are read from the cache when it
+   *  matches the mesh, number of ranks and configuration, and written to it
+   *  otherwise. Halos later extended with extend_halos_fixed_offset are cached
+   *  in the same directory.
    */
   ParticleMeshInterface(Nektar::SpatialDomains::MeshGraphSharedPtr graph,
                         const int subdivision_order_offset = 0,
-                        MPI_Comm comm = MPI_COMM_WORLD)
+                        MPI_Comm comm = MPI_COMM_WORLD,
+                        const std::string &setup_cache_dir = "")
       : graph(graph), subdivision_order_offset(subdivision_order_offset),
         comm(comm) {
 
@@ -890,6 +824,29 @@ public:
     // create a mesh hierarchy
     this->create_mesh_hierarchy();
 
+    if (!setup_cache_dir.empty()) {
+      std::uint64_t hash = 0xcbf29ce484222325ULL;
+      SetupCache::hash_combine(hash, this->ndim);
+      SetupCache::hash_combine(hash, this->subdivision_order_offset);
+      SetupCache::hash_geoms(geoms_2d, hash);
+      SetupCache::hash_geoms(geoms_3d, hash);
+      this->setup_cache =
+          std::make_shared<SetupCache>(this->comm, setup_cache_dir, hash);
+      this->setup_from_cache = this->setup_cache->read(
+          this->owned_mh_cells, this->unowned_mh_cells, this->remote_triangles,
+          this->remote_quads, this->remote_geoms_3d);
+    }
+    if (this->setup_from_cache) {
+      // Each cached cell is claimed by its owner alone, which reproduces the
+      // ownership without the claims of the other overlapping ranks.
+      mesh_hierarchy->claim_initialise();
+      for (auto &cellx : this->owned_mh_cells) {
+        mesh_hierarchy->claim_cell(cellx, 1);
+      }
+      mesh_hierarchy->claim_finalise();
+      return;
+    }
+
     // assemble the cell claim weights locally for cells of interest to this
     // rank
     LocalClaim local_claim;
@@ -918,6 +875,12 @@ public:
     } else {
       NESOASSERT(false, "unsupported spatial dimension");
     }
+
+    if (this->setup_cache) {
+      this->setup_cache->write(this->owned_mh_cells, this->unowned_mh_cells,
+                               this->remote_triangles, this->remote_quads,
+                               this->remote_geoms_3d);
+    }
   }
 
   /**
@@ -1017,6 +980,119 @@ public:
     this->collect_neighbour_ranks();
     return this->neighbour_ranks;
   };
+
+  /**
+   *  Get the NESO-Particles cell of each local element and of each remote
+   *  (halo) element, where the cell of a remote element is the cell on the
+   *  rank which owns it. The cell of an element is the index of the element
+   *  in the map returned by get_all_elements_2d or get_all_elements_3d on the
+   *  owning rank. Local mappers write these cells into the CELL_ID of the
+   *  particles they bind such that the cells are valid on the destination
+   *  rank without translating Nektar++ geometry ids. Must be called
+   *  collectively.
+   *
+   *  @param[out] map_geom_to_cell Map from Nektar++ geometry id to cell.
+   */
+  inline void get_geom_to_cell_map(std::map<int, int> &map_geom_to_cell) {
+    map_geom_to_cell.clear();
+    std::vector<int> local_ids;
+    if (this->ndim == 2) {
+      std::map<int, std::shared_ptr<Nektar::SpatialDomains::Geometry2D>> geoms;
+      get_all_elements_2d(this->graph, geoms);
+      for (auto &geom : geoms) {
+        local_ids.push_back(geom.first);
+      }
+    } else if (this->ndim == 3) {
+      std::map<int, std::shared_ptr<Nektar::SpatialDomains::Geometry3D>> geoms;
+      get_all_elements_3d(this->graph, geoms);
+      for (auto &geom : geoms) {
+        local_ids.push_back(geom.first);
+      }
+    } else {
+      NESOASSERT(false, "Unexpected number of dimensions.");
+    }
+    const int num_local = local_ids.size();
+    for (int cellx = 0; cellx < num_local; cellx++) {
+      map_geom_to_cell[local_ids[cellx]] = cellx;
+    }
+
+    // Group the ids of the remote elements by owning rank.
+    std::map<int, std::vector<int>> rank_remote_ids;
+    auto lambda_push_remote = [&](auto &remote_geoms) {
+      for (auto &geom : remote_geoms) {
+        rank_remote_ids[geom->rank].push_back(geom->id);
+      }
+    };
+    if (this->ndim == 2) {
+      lambda_push_remote(this->remote_triangles);
+      lambda_push_remote(this->remote_quads);
+    } else {
+      lambda_push_remote(this->remote_geoms_3d);
+    }
+    std::vector<int> send_ranks;
+    std::vector<int> send_sizes;
+    for (auto &rank_ids : rank_remote_ids) {
+      send_ranks.push_back(rank_ids.first);
+      send_sizes.push_back(rank_ids.second.size());
+    }
+    std::vector<int> recv_ranks;
+    std::vector<int> recv_sizes;
+    const int num_send_ranks = send_ranks.size();
+    const int num_recv_ranks = sparse_exchange_counts(
+        this->comm, send_ranks, send_sizes, recv_ranks, recv_sizes);
+
+    // Receive the ids other ranks hold copies of and send the ids this rank
+    // holds copies of to the owners.
+    std::vector<std::vector<int>> recv_ids(num_recv_ranks);
+    std::vector<MPI_Request> recv_requests(num_recv_ranks);
+    for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
+      recv_ids[rankx].resize(recv_sizes[rankx]);
+      MPICHK(MPI_Irecv(recv_ids[rankx].data(), recv_sizes[rankx], MPI_INT,
+                       recv_ranks[rankx], 48, this->comm,
+                       recv_requests.data() + rankx));
+    }
+    std::vector<MPI_Request> send_requests(num_send_ranks);
+    for (int rankx = 0; rankx < num_send_ranks; rankx++) {
+      const int remote_rank = send_ranks[rankx];
+      MPICHK(MPI_Isend(rank_remote_ids[remote_rank].data(), send_sizes[rankx],
+                       MPI_INT, remote_rank, 48, this->comm,
+                       send_requests.data() + rankx));
+    }
+    MPICHK(MPI_Waitall(num_recv_ranks, recv_requests.data(),
+                       MPI_STATUSES_IGNORE));
+    MPICHK(MPI_Waitall(num_send_ranks, send_requests.data(),
+                       MPI_STATUSES_IGNORE));
+
+    // Reply with the cells of the requested elements.
+    std::vector<std::vector<int>> send_cells(num_send_ranks);
+    for (int rankx = 0; rankx < num_send_ranks; rankx++) {
+      send_cells[rankx].resize(send_sizes[rankx]);
+      MPICHK(MPI_Irecv(send_cells[rankx].data(), send_sizes[rankx], MPI_INT,
+                       send_ranks[rankx], 49, this->comm,
+                       send_requests.data() + rankx));
+    }
+    for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
+      for (int &id : recv_ids[rankx]) {
+        NESOASSERT(map_geom_to_cell.count(id),
+                   "Requested the cell of an element this rank does not own.");
+        id = map_geom_to_cell.at(id);
+      }
+      MPICHK(MPI_Isend(recv_ids[rankx].data(), recv_sizes[rankx], MPI_INT,
+                       recv_ranks[rankx], 49, this->comm,
+                       recv_requests.data() + rankx));
+    }
+    MPICHK(MPI_Waitall(num_send_ranks, send_requests.data(),
+                       MPI_STATUSES_IGNORE));
+    MPICHK(MPI_Waitall(num_recv_ranks, recv_requests.data(),
+                       MPI_STATUSES_IGNORE));
+
+    for (int rankx = 0; rankx < num_send_ranks; rankx++) {
+      const auto &ids = rank_remote_ids[send_ranks[rankx]];
+      for (int ix = 0; ix < send_sizes[rankx]; ix++) {
+        map_geom_to_cell[ids[ix]] = send_cells[rankx][ix];
+      }
+    }
+  }
   /**
    *  Get a point in the domain that should be in, or at least close to, the
    *  sub-domain on this MPI process. Useful for parallel initialisation.
@@ -0,0 +1,256 @@
+#ifndef __PARTICLE_SHAPE_H_
+#define __PARTICLE_SHAPE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <LibUtilities/BasicUtils/SharedArray.hpp>
+#include <MultiRegions/ExpList.h>
+#include <neso_particles.hpp>
+
+using namespace NESO::Particles;
+using namespace Nektar::LibUtilities;
+
+namespace NESO {
+
+/**
+ * Shape of a particle in the reference space of the element that contains it.
+ */
+enum class ParticleShapeType {
+  /// Point particle. Deposition and evaluation use the basis functions
+  /// directly.
+  Delta,
+  /// Gaussian with standard deviation width.
+  Gaussian,
+  /// Central B-spline with support (order + 1) * width.
+  BSpline
+};
+
+/**
+ * Description of a finite width particle shape. A shape is applied as a
+ * filter on the modal coefficients of an element. Each coefficient is scaled
+ * by a factor which depends on the polynomial degree of the mode. This is the
+ * modal analogue of convolving the point particle with the shape function.
+ * Linear (vertex) modes are never scaled, so the deposited charge is
+ * conserved.
+ */
+struct ParticleShape {
+  ParticleShapeType type = ParticleShapeType::Delta;
+  /// Width of the shape in reference space units.
+  REAL width = 0.0;
+  /// Order of the B-spline (1 is linear, 2 is quadratic, ...).
+  int order = 2;
+
+  /**
+   * Get the scaling factor for modes of a polynomial degree.
+   *
+   * @param degree Polynomial degree of the mode, at least one.
+   * @returns Factor applied to the coefficient of the mode.
+   */
+  inline REAL mode_factor(const int degree) const {
+    const REAL n = static_cast<REAL>(std::max(degree, 1));
+    switch (this->type) {
+    case ParticleShapeType::Gaussian:
+      // Heat kernel on the Legendre eigenfunctions relative to the linear
+      // modes.
+      return std::exp(-0.5 * this->width * this->width * (n - 1.0) *
+                      (n + 2.0));
+    case ParticleShapeType::BSpline: {
+      const REAL x = 0.25 * M_PI * (n - 1.0) * this->width;
+      const REAL sinc = (x == 0.0) ? 1.0 : std::sin(x) / x;
+      return std::pow(sinc, this->order + 1);
+    }
+    default:
+      return 1.0;
+    }
+  }
+};
+
+/**
+ * Per coefficient factors which apply a ParticleShape to a Nektar++ field.
+ * The same factors are applied to the projection right hand side and to the
+ * coefficients before evaluation. The filter is diagonal in the modal basis
+ * and hence symmetric, so deposition and evaluation are adjoint. This is the
+ * property required for an energy conserving particle-field coupling.
+ *
+ * For fields with matching polynomial orders the factors of modes shared by
+ * neighbouring elements agree, hence the filter is consistent with the
+ * assembly of continuous fields.
+ */
+class ParticleShapeFilter {
+protected:
+  SYCLTargetSharedPtr sycl_target;
+  ParticleShape shape;
+  BufferDeviceHost<REAL> dh_factors;
+
+  inline REAL tensor_factor(const int p) const {
+    return this->shape.mode_factor(std::max(p, 1));
+  }
+
+  inline REAL simplex_factor(const int sum) const {
+    return this->shape.mode_factor(std::max(sum, 1));
+  }
+
+  // Iterate the modes in the same order as ExpansionLooping. Only the tensor
+  // product shapes may have differing numbers of modes in each direction.
+  inline void fill_expansion_factors(const ShapeType shape_type,
+                                     const int *nummodes_dim,
+                                     REAL *factors) const {
+    const int nummodes = nummodes_dim[0];
+    int mode = 0;
+    switch (shape_type) {
+    case eQuadrilateral:
+      for (int q = 0; q < nummodes_dim[1]; q++) {
+        for (int p = 0; p < nummodes_dim[0]; p++) {
+          factors[mode++] = this->tensor_factor(p) * this->tensor_factor(q);
+        }
+      }
+      break;
+    case eTriangle:
+      for (int p = 0; p < nummodes; p++) {
+        for (int q = 0; q < nummodes - p; q++) {
+          factors[mode++] = this->simplex_factor(p + q);
+        }
+      }
+      break;
+    case eHexahedron:
+      for (int r = 0; r < nummodes_dim[2]; r++) {
+        for (int q = 0; q < nummodes_dim[1]; q++) {
+          for (int p = 0; p < nummodes_dim[0]; p++) {
+            factors[mode++] = this->tensor_factor(p) * this->tensor_factor(q) *
+                              this->tensor_factor(r);
+          }
+        }
+      }
+      break;
+    case ePrism:
+      for (int p = 0; p < nummodes; p++) {
+        for (int q = 0; q < nummodes; q++) {
+          for (int r = 0; r < nummodes - p; r++) {
+            factors[mode++] =
+                this->tensor_factor(q) * this->simplex_factor(p + r);
+          }
+        }
+      }
+      break;
+    case ePyramid:
+      for (int p = 0; p < nummodes; p++) {
+        for (int q = 0; q < nummodes; q++) {
+          const int l = std::max(p, q);
+          for (int r = 0; r < nummodes - l; r++) {
+            factors[mode++] = this->tensor_factor(p) * this->tensor_factor(q) *
+                              this->tensor_factor(r);
+          }
+        }
+      }
+      break;
+    case eTetrahedron:
+      for (int p = 0; p < nummodes; p++) {
+        for (int q = 0; q < nummodes - p; q++) {
+          for (int r = 0; r < nummodes - p - q; r++) {
+            factors[mode++] = this->simplex_factor(p + q + r);
+          }
+        }
+      }
+      break;
+    default:
+      NESOASSERT(false, "Unsupported shape type for particle shape.");
+    }
+  }
+
+public:
+  /// Disable (implicit) copies.
+  ParticleShapeFilter(const ParticleShapeFilter &st) = delete;
+  /// Disable (implicit) copies.
+  ParticleShapeFilter &operator=(ParticleShapeFilter const &a) = delete;
+
+  /// Number of coefficients the filter is defined over.
+  const int num_coeffs;
+
+  /**
+   * Create the filter for a field.
+   *
+   * @param sycl_target Compute device to apply the filter on.
+   * @param field Nektar++ field which defines the function space.
+   * @param shape Shape of the particles.
+   */
+  ParticleShapeFilter(SYCLTargetSharedPtr sycl_target,
+                      std::shared_ptr<Nektar::MultiRegions::ExpList> field,
+                      const ParticleShape shape)
+      : sycl_target(sycl_target), shape(shape),
+        dh_factors(sycl_target, std::max(field->GetNcoeffs(), 1)),
+        num_coeffs(field->GetNcoeffs()) {
+
+    NESOASSERT(shape.width >= 0.0, "Particle shape width must be positive.");
+    NESOASSERT(shape.order >= 0, "B-spline order must not be negative.");
+    const int num_expansions = field->GetExpSize();
+    for (int ex = 0; ex < num_expansions; ex++) {
+      auto expansion = field->GetExp(ex);
+      const int offset = field->GetCoeff_Offset(ex);
+      const ShapeType shape_type = expansion->DetShapeType();
+      const bool anisotropic =
+          (shape_type == eQuadrilateral) || (shape_type == eHexahedron);
+      int nummodes[3] = {1, 1, 1};
+      for (int dx = 0; dx < expansion->GetShapeDimension(); dx++) {
+        nummodes[dx] = expansion->GetBasisNumModes(dx);
+        NESOASSERT(anisotropic || (nummodes[dx] == nummodes[0]),
+                   "Differing numbers of modes in coordinate directions.");
+      }
+      this->fill_expansion_factors(shape_type, nummodes,
+                                   this->dh_factors.h_buffer.ptr + offset);
+    }
+    this->dh_factors.host_to_device();
+  }
+
+  /**
+   * @returns The particle shape this filter implements.
+   */
+  inline ParticleShape get_shape() const { return this->shape; }
+
+  /**
+   * @returns Host pointer to the num_coeffs factors.
+   */
+  inline const REAL *get_factors() const {
+    return this->dh_factors.h_buffer.ptr;
+  }
+
+  /**
+   * Apply the filter to coefficients in device memory.
+   *
+   * @param[in, out] d_coeffs Device pointer to num_coeffs coefficients.
+   * @returns Event for the kernel.
+   */
+  inline sycl::event apply_device(REAL *d_coeffs) {
+    const REAL *k_factors = this->dh_factors.d_buffer.ptr;
+    return this->sycl_target->queue.parallel_for<>(
+        sycl::range<1>(static_cast<size_t>(this->num_coeffs)),
+        [=](sycl::id<1> idx) { d_coeffs[idx] *= k_factors[idx]; });
+  }
+
+  /**
+   * Apply the filter to coefficients in host memory.
+   *
+   * @param[in] coeffs Input num_coeffs coefficients.
+   * @param[out] output Output num_coeffs filtered coefficients, may be the
+   * input.
+   */
+  inline void apply(const Array<OneD, const NekDouble> &coeffs,
+                    Array<OneD, NekDouble> &output) const {
+    NESOASSERT(coeffs.size() >= this->num_coeffs,
+               "Input array too small for particle shape filter.");
+    NESOASSERT(output.size() >= this->num_coeffs,
+               "Output array too small for particle shape filter.");
+    const REAL *factors = this->dh_factors.h_buffer.ptr;
+    for (int cx = 0; cx < this->num_coeffs; cx++) {
+      output[cx] = coeffs[cx] * factors[cx];
+    }
+  }
+};
+
+typedef std::shared_ptr<ParticleShapeFilter> ParticleShapeFilterSharedPtr;
+
+} // namespace NESO
+
+#endif
@@ -0,0 +1,309 @@
+#ifndef __REDUCED_PRECISION_H_
+#define __REDUCED_PRECISION_H_
+
+#include <cstdint>
+#include <neso_particles.hpp>
+#include <string>
+#include <type_traits>
+
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Storage of particle properties in single precision. ParticleDats are either
+ * REAL or INT, hence two single precision values are packed into each
+ * component of an INT ParticleDat. A property with n values is held in
+ * get_ncomp(n) INT components. Values are only rounded when stored, kernels
+ * unpack them and compute in double precision.
+ *
+ * Single precision has a relative rounding error of 6e-8, which for reference
+ * positions in [-1, 1] is well below the error of the polynomial
+ * approximation at the orders in use.
+ */
+namespace ReducedPrecision {
+
+/**
+ * @param nvalues Number of values of the property.
+ * @returns Number of INT components required to store the values.
+ */
+inline constexpr int get_ncomp(const int nvalues) { return (nvalues + 1) / 2; }
+
+/**
+ * @returns Name of the INT ParticleDat holding the reduced precision
+ * reference positions. NektarGraphLocalMapper writes this ParticleDat in place
+ * of the REAL NESO_REFERENCE_POSITIONS ParticleDat when configured to.
+ */
+inline Sym<INT> get_reference_positions_sym() {
+  return Sym<INT>("NESO_REFERENCE_POSITIONS_REDUCED");
+}
+
+/**
+ * @param k_ref_positions Pointer to reference positions obtained with
+ * Access::direct_get.
+ * @returns Name of the reference positions ParticleDat of the pointer type.
+ */
+inline Sym<REAL>
+get_reference_positions_sym(const ParticleDatImplGetConstT<REAL> &) {
+  return Sym<REAL>("NESO_REFERENCE_POSITIONS");
+}
+
+/**
+ * @overload
+ */
+inline Sym<INT>
+get_reference_positions_sym(const ParticleDatImplGetConstT<INT> &) {
+  return get_reference_positions_sym();
+}
+
+/**
+ * @param value Value to round.
+ * @returns Bits of the value rounded to single precision.
+ */
+inline std::uint64_t to_bits(const REAL value) {
+  return static_cast<std::uint64_t>(
+      sycl::bit_cast<std::uint32_t>(static_cast<float>(value)));
+}
+
+/**
+ * @param v0 First value.
+ * @param v1 Second value.
+ * @returns Both values rounded to single precision and packed into an INT.
+ */
+inline INT pack(const REAL v0, const REAL v1) {
+  return static_cast<INT>(to_bits(v0) | (to_bits(v1) << 32));
+}
+
+/**
+ * @param packed Two values packed with pack.
+ * @param index Index, 0 or 1, of the value to unpack.
+ * @returns The value in double precision.
+ */
+inline REAL unpack(const INT packed, const int index) {
+  const std::uint64_t bits = static_cast<std::uint64_t>(packed);
+  const std::uint32_t value_bits =
+      static_cast<std::uint32_t>(bits >> (32 * index));
+  return static_cast<REAL>(sycl::bit_cast<float>(value_bits));
+}
+
+/**
+ * Replace one of the two values packed in an INT.
+ *
+ * @param[in, out] packed Two values packed with pack.
+ * @param index Index, 0 or 1, of the value to replace.
+ * @param value New value.
+ */
+inline void store(INT &packed, const int index, const REAL value) {
+  const int shift = 32 * index;
+  const std::uint64_t mask = static_cast<std::uint64_t>(0xFFFFFFFF) << shift;
+  const std::uint64_t bits = static_cast<std::uint64_t>(packed);
+  packed = static_cast<INT>((bits & ~mask) | (to_bits(value) << shift));
+}
+
+/**
+ * Read a value from a ParticleDat pointer obtained with Access::direct_get.
+ * REAL ParticleDats are read directly, INT ParticleDats are unpacked.
+ *
+ * @param ptr ParticleDat pointer.
+ * @param cell Cell of the particle.
+ * @param index Index of the value.
+ * @param layer Layer of the particle.
+ * @returns The value in double precision.
+ */
+inline REAL read(const ParticleDatImplGetConstT<REAL> &ptr, const INT cell,
+                 const int index, const INT layer) {
+  return ptr[cell][index][layer];
+}
+
+/**
+ * @overload
+ */
+inline REAL read(const ParticleDatImplGetConstT<INT> &ptr, const INT cell,
+                 const int index, const INT layer) {
+  return unpack(ptr[cell][index / 2][layer], index % 2);
+}
+
+/**
+ * Write a value to a ParticleDat pointer obtained with Access::direct_get.
+ * REAL ParticleDats are written directly, INT ParticleDats are packed.
+ *
+ * @param ptr ParticleDat pointer.
+ * @param cell Cell of the particle.
+ * @param index Index of the value.
+ * @param layer Layer of the particle.
+ * @param value Value to write.
+ */
+inline void write(const ParticleDatImplGetT<REAL> &ptr, const INT cell,
+                  const int index, const INT layer, const REAL value) {
+  ptr[cell][index][layer] = value;
+}
+
+/**
+ * @overload
+ */
+inline void write(const ParticleDatImplGetT<INT> &ptr, const INT cell,
+                  const int index, const INT layer, const REAL value) {
+  store(ptr[cell][index / 2][layer], index % 2, value);
+}
+
+/**
+ * Read a value of a particle in a particle_loop kernel, for example
+ * get(E, 1) for the second component of an electric field held in either a
+ * REAL or a reduced precision INT ParticleDat.
+ *
+ * @param dat Kernel argument of a REAL or INT ParticleDat.
+ * @param index Index of the value.
+ * @returns The value in double precision.
+ */
+template <typename T> inline REAL get(const T &dat, const int index) {
+  if constexpr (std::is_same_v<std::decay_t<decltype(dat.at(0))>, INT>) {
+    return unpack(dat.at(index / 2), index % 2);
+  } else {
+    return dat.at(index);
+  }
+}
+
+/**
+ * Write a value of a particle in a particle_loop kernel.
+ *
+ * @param dat Kernel argument of a REAL or INT ParticleDat with write access.
+ * @param index Index of the value.
+ * @param value Value to write.
+ */
+template <typename T>
+inline void set(T &dat, const int index, const REAL value) {
+  if constexpr (std::is_same_v<std::decay_t<decltype(dat.at(0))>, INT>) {
+    store(dat.at(index / 2), index % 2, value);
+  } else {
+    dat.at(index) = value;
+  }
+}
+
+/**
+ * Store the values of a REAL ParticleDat in a reduced precision INT
+ * ParticleDat.
+ *
+ * @param src REAL ParticleDat to read.
+ * @param dst INT ParticleDat with at least get_ncomp(src->ncomp) components.
+ * @param cell Only pack the particles in this cell if non-negative.
+ */
+inline void pack_dat(ParticleDatSharedPtr<REAL> src,
+                     ParticleDatSharedPtr<INT> dst, const int cell = -1) {
+  const int k_ncomp = src->ncomp;
+  NESOASSERT(dst->ncomp >= get_ncomp(k_ncomp),
+             "Reduced precision ParticleDat has too few components.");
+  auto loop = particle_loop(
+      "ReducedPrecision::pack_dat", src,
+      [=](auto SRC, auto DST) {
+        for (int cx = 0; cx < k_ncomp; cx++) {
+          set(DST, cx, SRC.at(cx));
+        }
+      },
+      Access::read(src), Access::write(dst));
+  if (cell > -1) {
+    loop->execute(cell);
+  } else {
+    loop->execute();
+  }
+}
+
+/**
+ * Call a function with the ParticleDat holding the reference positions of a
+ * ParticleGroup. This is the reduced precision INT ParticleDat if the group
+ * holds one, otherwise the REAL NESO_REFERENCE_POSITIONS ParticleDat.
+ *
+ * @param particle_group ParticleGroup mapped by NektarGraphLocalMapper.
+ * @param func Callable with a ParticleDatSharedPtr<REAL> or
+ * ParticleDatSharedPtr<INT> argument.
+ */
+template <typename FUNC>
+inline void visit_reference_positions(ParticleGroup &particle_group,
+                                      FUNC &&func) {
+  const auto reduced_sym = get_reference_positions_sym();
+  if (particle_group.contains_dat(reduced_sym)) {
+    func(particle_group.get_dat(reduced_sym));
+  } else {
+    func(particle_group.get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS")));
+  }
+}
+
+/**
+ * @param particle_group ParticleGroup mapped by NektarGraphLocalMapper.
+ * @returns True if the ParticleGroup holds reference positions in either
+ * precision.
+ */
+inline bool contains_reference_positions(ParticleGroup &particle_group) {
+  return particle_group.contains_dat(get_reference_positions_sym()) ||
+         particle_group.contains_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"));
+}
+
+/**
+ * Copy the reference positions of the particles in a cell to the host in
+ * double precision.
+ *
+ * @param particle_group ParticleGroup mapped by NektarGraphLocalMapper.
+ * @param cell Cell to copy.
+ * @param[in, out] ref_positions Host storage with at least one component per
+ * dimension and a row per particle in the cell.
+ */
+inline void get_reference_positions_cell(ParticleGroup &particle_group,
+                                         const int cell,
+                                         CellDataT<REAL> &ref_positions) {
+  const int ndim = particle_group.domain->mesh->get_ndim();
+  visit_reference_positions(particle_group, [&](auto dat) {
+    if constexpr (std::is_same_v<decltype(dat), ParticleDatSharedPtr<INT>>) {
+      auto packed = dat->cell_dat.get_cell(cell);
+      for (int rowx = 0; rowx < packed->nrow; rowx++) {
+        for (int dx = 0; dx < ndim; dx++) {
+          ref_positions[dx][rowx] = unpack((*packed)[dx / 2][rowx], dx % 2);
+        }
+      }
+    } else {
+      EventStack event_stack;
+      dat->cell_dat.get_cell_async(cell, ref_positions, event_stack);
+      event_stack.wait();
+    }
+  });
+}
+
+/**
+ * Copy reference positions of the particles in a cell from the host to the
+ * ParticleGroup, rounding to single precision if the ParticleGroup holds
+ * reduced precision reference positions.
+ *
+ * @param particle_group ParticleGroup mapped by NektarGraphLocalMapper.
+ * @param cell Cell to copy.
+ * @param ref_positions Host storage with at least one component per
+ * dimension and a row per particle in the cell.
+ */
+inline void set_reference_positions_cell(ParticleGroup &particle_group,
+                                         const int cell,
+                                         CellDataT<REAL> &ref_positions) {
+  const int ndim = particle_group.domain->mesh->get_ndim();
+  visit_reference_positions(particle_group, [&](auto dat) {
+    EventStack event_stack;
+    if constexpr (std::is_same_v<decltype(dat), ParticleDatSharedPtr<INT>>) {
+      const int nrow = dat->cell_dat.nrow[cell];
+      CellDataT<INT> packed(particle_group.sycl_target, nrow, dat->ncomp);
+      for (int rowx = 0; rowx < nrow; rowx++) {
+        for (int cx = 0; cx < dat->ncomp; cx++) {
+          const int d0 = 2 * cx;
+          const int d1 = d0 + 1;
+          packed[cx][rowx] =
+              pack((d0 < ndim) ? ref_positions[d0][rowx] : 0.0,
+                   (d1 < ndim) ? ref_positions[d1][rowx] : 0.0);
+        }
+      }
+      dat->cell_dat.set_cell_async(cell, packed, event_stack);
+      event_stack.wait();
+    } else {
+      dat->cell_dat.set_cell_async(cell, ref_positions, event_stack);
+      event_stack.wait();
+    }
+  });
+}
+
+} // namespace ReducedPrecision
+} // namespace NESO
+
+#endif
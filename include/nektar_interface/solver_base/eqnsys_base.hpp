@@ -6,6 +6,7 @@
 #include <type_traits>
 
 #include "nektar_interface/solver_base/partsys_base.hpp"
+#include "nektar_interface/step_profiler.hpp"
 #include "nektar_interface/utilities.hpp"
 
 namespace LU = Nektar::LibUtilities;
@@ -96,6 +97,10 @@ protected:
   /// List of field names required by the solver
   std::vector<std::string> required_fld_names;
 
+  /// Timeline profiler for the solver steps, enabled by the session parameter
+  /// profile_timeline.
+  StepProfilerSharedPtr step_profiler;
+
   /// Placeholder for subclasses to override; called in v_InitObject()
   virtual void load_params(){};
 
@@ -157,6 +162,7 @@ protected:
    */
   virtual void v_DoSolve() override final {
     NEKEQNSYS::v_DoSolve();
+    this->step_profiler->finalise();
     if (this->particle_sys) {
       this->particle_sys->free();
     }
@@ -164,8 +170,8 @@ protected:
   }
 
   /**
-   * @brief Initialise the equation system, then check required fields are set
-   * and load parameters.
+   * @brief Initialise the equation system, then check required fields are set,
+   * create the step profiler and load parameters.
    */
   virtual void v_InitObject(bool create_fields) override {
     NEKEQNSYS::v_InitObject(create_fields);
@@ -173,6 +179,11 @@ protected:
     this->n_dims = NEKEQNSYS::m_graph->GetMeshDimension();
     this->n_pts = NEKEQNSYS::m_fields[0]->GetNpoints();
 
+    this->step_profiler = StepProfiler::create(this->m_session);
+    if (this->particle_sys) {
+      this->particle_sys->set_step_profiler(this->step_profiler);
+    }
+
     // Ensure that the session file defines all required variables
     validate_fields();
 
@@ -2,10 +2,12 @@
 #define __PARTSYS_BASE_H_
 
 #include <SolverUtils/EquationSystem.h>
+#include <io/particle_checkpoint.hpp>
 #include <mpi.h>
 #include <nektar_interface/geometry_transport/halo_extension.hpp>
 #include <nektar_interface/particle_interface.hpp>
 #include <nektar_interface/solver_base/particle_reader.hpp>
+#include <nektar_interface/step_profiler.hpp>
 #include <neso_particles.hpp>
 #include <type_traits>
 
@@ -40,6 +42,27 @@ public:
   inline static const std::string NUM_PARTS_PER_CELL_STR =
       "num_particles_per_cell";
   inline static const std::string PART_OUTPUT_FREQ_STR = "particle_output_freq";
+  inline static const std::string LOAD_METRICS_FREQ_STR =
+      "particle_load_metrics_freq";
+  /// SOLVERINFO key naming a directory to cache the mesh setup in.
+  inline static const std::string SETUP_CACHE_STR = "ParticleSetupCache";
+  /// Suffix of the element cost file written alongside each checkpoint.
+  inline static const std::string ELEMENT_COSTS_SUFFIX = "_element_costs.txt";
+  inline static const std::string CHECKPOINT_FREQ_STR =
+      "particle_checkpoint_freq";
+  /// SOLVERINFO key naming a particle checkpoint file to restart from.
+  inline static const std::string RESTART_FILE_STR = "ParticleRestartFile";
+  /// Prefix of particle checkpoint files, the step number is appended.
+  inline static const std::string CHECKPOINT_OUTPUT = "particle_checkpoint";
+  inline static const std::string NEIGHBOUR_TRANSFER_STR =
+      "particle_neighbour_transfer";
+  inline static const std::string NEIGHBOUR_TRANSFER_STATS_STR =
+      "particle_neighbour_transfer_stats";
+  /// File that the per-step neighbour transfer statistics are written to.
+  inline static const std::string NEIGHBOUR_TRANSFER_STATS_OUTPUT =
+      "neighbour_transfer_stats.csv";
+  inline static const std::string REDUCED_PRECISION_STR =
+      "particle_reduced_precision";
 
   /// Total number of particles in simulation
   int64_t num_parts_tot;
@@ -59,6 +82,14 @@ public:
   /// @brief Clear up memory related to the particle system
   void free();
 
+  /**
+   * @brief Set the profiler which records the particle work in each step.
+   *
+   * @param step_profiler Step profiler, typically owned by the equation
+   * system.
+   */
+  void set_step_profiler(StepProfilerSharedPtr step_profiler);
+
   /**
    * @brief Check whether particle output is scheduled for \p step.
    *
@@ -68,12 +99,46 @@ public:
    */
   bool is_output_step(int step);
 
+  /**
+   * @brief If \p step is a load measurement step, according to the frequency
+   * read from the config file, measure the particle cost of each element and
+   * report the load imbalance between ranks. The partition is not changed.
+   * Must be called collectively.
+   *
+   * @param step Time step number.
+   */
+  void update_load_metrics(const int step);
+
   /**
    *  @brief Write particle properties to an output file.
    *  @param step Time step number.
    */
   void write(const int step);
 
+  /**
+   * @brief If \p step is a checkpoint step, according to the frequency read
+   * from the config file, write the particles and the state returned by
+   * write_checkpoint_state to CHECKPOINT_OUTPUT_<step>.h5. If particle load
+   * measurement is enabled, the element costs are written to
+   * CHECKPOINT_OUTPUT_<step>ELEMENT_COSTS_SUFFIX. Must be called collectively.
+   *
+   * @param step Time step number.
+   */
+  void write_checkpoint(const int step);
+
+  /**
+   * @brief If a restart file is named in the config file, read the particles
+   * and the state restored by read_checkpoint_state from it. The particles
+   * are moved to their owning ranks, which need not match the number of
+   * ranks that wrote the checkpoint. Must be called collectively.
+   *
+   * @returns true if the particle system was restored from a checkpoint.
+   */
+  bool read_checkpoint();
+
+  /// True if the particle system was restored from a checkpoint.
+  bool restarted = false;
+
   /**
    *  @brief Sets up the particle system with the information from the
    * ParticleReader
@@ -130,6 +195,15 @@ protected:
   ParticleMeshInterfaceSharedPtr particle_mesh_interface;
   /// Pointer to ParticleReader object
   ParticleReaderSharedPtr config;
+  /// Profiler for the particle work in each step, disabled by default.
+  StepProfilerSharedPtr step_profiler;
+  /// Measures the particle cost per element and the load imbalance.
+  ParticleLoadMetricsSharedPtr load_metrics;
+  /// Moves particles directly to halo neighbours, null unless enabled in the
+  /// config file.
+  NeighbourTransferSharedPtr neighbour_transfer;
+  /// Store reference positions in reduced precision. Read from config file.
+  bool reduced_precision = false;
 
   /**
    * @brief Set up per-step particle output
@@ -152,6 +226,23 @@ protected:
   /// @brief Read some parameters associated with all particle systems.
   void read_params();
 
+  /**
+   * @brief Write the state of a derived particle system, e.g. counters and
+   * random number generators, to a checkpoint. Called collectively by
+   * write_checkpoint after the particles are written.
+   *
+   * @param writer Open checkpoint to write to.
+   */
+  virtual void write_checkpoint_state(IO::ParticleCheckpointWriter &writer){};
+
+  /**
+   * @brief Restore the state written by write_checkpoint_state. Called
+   * collectively by read_checkpoint after the particles are read.
+   *
+   * @param reader Open checkpoint to read from.
+   */
+  virtual void read_checkpoint_state(IO::ParticleCheckpointReader &reader){};
+
   /**
    * @brief Store particle param values in a map.Values are reported later via
    * add_params_report()
@@ -168,6 +259,14 @@ protected:
 private:
   /// Output frequency read from config file
   int output_freq;
+  /// Particle load measurement frequency read from config file
+  int load_metrics_freq = 0;
+  /// Checkpoint frequency read from config file
+  int checkpoint_freq = 0;
+  /// Use the neighbour transfer if non-zero, read from config file
+  int neighbour_transfer_enabled = 0;
+  /// Write the neighbour transfer statistics of each step if non-zero
+  int neighbour_transfer_stats = 0;
   /**
    * Map containing parameter name,value pairs to be written to stdout when
    * the nektar equation system is initialised. Populated with report_param().
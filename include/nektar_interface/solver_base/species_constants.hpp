@@ -0,0 +1,156 @@
+#ifndef __SPECIES_CONSTANTS_H_
+#define __SPECIES_CONSTANTS_H_
+
+#include <neso_particles.hpp>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Properties which are uniform over the particles of a species, e.g. charge
+ * and mass, stored once per species rather than in a ParticleDat per
+ * particle. Kernels iterate over the particles of one species at a time, see
+ * get_sub_group, and capture the constants of that species by value, hence
+ * the constants cost no memory traffic per particle.
+ *
+ * With a single species the iteration set is the whole ParticleGroup and no
+ * per-particle data is required. With more than one species each particle
+ * carries its species index in an INT ParticleDat, which add_to_spec adds to
+ * the ParticleSpec.
+ */
+class SpeciesConstants {
+protected:
+  int num_species;
+  std::vector<std::string> names;
+  std::map<std::string, int> indices;
+  /// Values in species major order.
+  std::vector<REAL> values;
+  std::vector<ParticleSubGroupSharedPtr> sub_groups;
+
+  inline int get_index(const std::string &name) const {
+    auto it = this->indices.find(name);
+    NESOASSERT(it != this->indices.end(),
+               "Unknown species property \"" + name + "\".");
+    return it->second;
+  }
+
+public:
+  /// ParticleDat holding the species index of each particle, only present if
+  /// there is more than one species.
+  const Sym<INT> species_sym;
+
+  /**
+   * Create a table of species constants, initialised to zero.
+   *
+   * @param num_species Number of species.
+   * @param names Names of the properties of each species.
+   * @param species_sym ParticleDat to hold the species index of each particle
+   * if there is more than one species.
+   */
+  SpeciesConstants(const int num_species, const std::vector<std::string> names,
+                   const Sym<INT> species_sym = Sym<INT>("SPECIES"))
+      : num_species(num_species), names(names), species_sym(species_sym) {
+    NESOASSERT(num_species > 0, "Expected at least one species.");
+    const int num_names = names.size();
+    for (int ix = 0; ix < num_names; ix++) {
+      NESOASSERT(this->indices.count(names[ix]) == 0,
+                 "Duplicate species property \"" + names[ix] + "\".");
+      this->indices[names[ix]] = ix;
+    }
+    this->values.assign(num_species * num_names, 0.0);
+  }
+
+  /**
+   * @returns Number of species.
+   */
+  inline int get_num_species() const { return this->num_species; }
+
+  /**
+   * @returns True if the particles carry their species index in species_sym.
+   */
+  inline bool has_species_dat() const { return this->num_species > 1; }
+
+  /**
+   * Set the value of a property for a species.
+   *
+   * @param species Species index.
+   * @param name Property name.
+   * @param value New value.
+   */
+  inline void set(const int species, const std::string &name,
+                  const REAL value) {
+    NESOASSERT((0 <= species) && (species < this->num_species),
+               "Bad species index.");
+    this->values[species * this->names.size() + this->get_index(name)] =
+        value;
+  }
+
+  /**
+   * @param species Species index.
+   * @param name Property name.
+   * @returns Value of the property for the species.
+   */
+  inline REAL get(const int species, const std::string &name) const {
+    NESOASSERT((0 <= species) && (species < this->num_species),
+               "Bad species index.");
+    return this->values[species * this->names.size() + this->get_index(name)];
+  }
+
+  /**
+   * Add the species index ParticleDat to a ParticleSpec if there is more than
+   * one species.
+   *
+   * @param particle_spec ParticleSpec to extend.
+   */
+  inline void add_to_spec(ParticleSpec &particle_spec) const {
+    if (this->has_species_dat()) {
+      particle_spec.push(ParticleProp(this->species_sym, 1));
+    }
+  }
+
+  /**
+   * Create the iteration set of each species. Must be called once the
+   * ParticleGroup exists.
+   *
+   * @param particle_group ParticleGroup holding the particles of all species.
+   */
+  inline void setup_sub_groups(ParticleGroupSharedPtr particle_group) {
+    this->sub_groups.clear();
+    if (!this->has_species_dat()) {
+      this->sub_groups.push_back(
+          std::make_shared<ParticleSubGroup>(particle_group));
+      return;
+    }
+    for (int sx = 0; sx < this->num_species; sx++) {
+      const INT k_species = sx;
+      this->sub_groups.push_back(particle_sub_group(
+          particle_group,
+          [=](auto SPECIES) { return SPECIES.at(0) == k_species; },
+          Access::read(this->species_sym)));
+    }
+  }
+
+  /**
+   * @param species Species index.
+   * @returns The particles of a species, setup_sub_groups must have been
+   * called.
+   */
+  inline ParticleSubGroupSharedPtr get_sub_group(const int species) const {
+    NESOASSERT((0 <= species) &&
+                   (species < static_cast<int>(this->sub_groups.size())),
+               "No iteration set for species, call setup_sub_groups.");
+    return this->sub_groups[species];
+  }
+};
+
+typedef std::shared_ptr<SpeciesConstants> SpeciesConstantsSharedPtr;
+
+} // namespace NESO
+
+#endif
@@ -42,6 +42,18 @@ protected:
     // No additional params yet
   };
 
+  /**
+   * @brief Start a new step of the step profiler. Subclasses which override
+   * this method should call it, or begin the step themselves, before doing
+   * any work.
+   *
+   * @param step Time step number
+   */
+  virtual bool v_PreIntegrate(int step) override {
+    this->step_profiler->begin_step(step);
+    return NEKEQNSYS::v_PreIntegrate(step);
+  }
+
   /** @brief Check that the names of fields identified as time-evolving are
    * valid.
    *
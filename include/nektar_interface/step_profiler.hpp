@@ -0,0 +1,627 @@
+#ifndef __STEP_PROFILER_H_
+#define __STEP_PROFILER_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mpi.h>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <LibUtilities/Communication/CommMpi.h>
+#include <neso_particles.hpp>
+
+using namespace NESO::Particles;
+namespace LU = Nektar::LibUtilities;
+
+namespace NESO {
+
+/**
+ * The categories of work in a solver time step. Every timed region belongs to
+ * exactly one category and the categories are reduced over all MPI ranks in
+ * this order.
+ */
+enum class StepRegion : int {
+  /// Evaluation of the right hand side of the fluid equations.
+  FluidRHS = 0,
+  /// Particle pushes and other particle loops that update particle state.
+  ParticlePush,
+  /// Mapping particle positions to cells.
+  Mapping,
+  /// Moving particles between cells and MPI ranks.
+  Transfer,
+  /// Projection (deposition) of particle data onto fields.
+  Projection,
+  /// Evaluation of fields at particle positions.
+  Evaluation,
+  /// Linear or nonlinear field solves.
+  Solve,
+  /// File output and diagnostics.
+  IO
+};
+
+/// Number of StepRegion categories.
+inline constexpr int num_step_regions = 8;
+
+/**
+ * @param region Category to get the name of.
+ * @returns Human readable name of the category.
+ */
+inline const char *step_region_name(const StepRegion region) {
+  static constexpr std::array<const char *, num_step_regions> names = {
+      "fluid_rhs",  "particle_push", "mapping", "transfer",
+      "projection", "evaluation",    "solve",   "io"};
+  return names.at(static_cast<int>(region));
+}
+
+/**
+ * Statistics of one named region over all MPI ranks. Times are the total
+ * exclusive wall time spent in the region on each rank, i.e. excluding the
+ * time spent in regions nested inside it.
+ */
+struct StepProfilerStats {
+  StepRegion region;
+  std::string name;
+  /// Total number of times the region was entered on all ranks.
+  std::int64_t count;
+  double min;
+  double mean;
+  double max;
+};
+
+/**
+ * Timeline profiler for the time steps of a solver. Work is recorded in named
+ * regions, e.g. a kernel or a stage of the step, which each belong to a
+ * StepRegion category. The profiler accumulates the wall time of each region,
+ * reduces the totals over all ranks into min/max/mean statistics and writes
+ * the timeline of every rank as a single Chrome trace (JSON) file which can be
+ * opened with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Regions may be nested, e.g. the mapping inside a particle transfer. The
+ * totals attribute time to the innermost open region only, hence the totals of
+ * all regions sum to the time spent in regions without double counting. The
+ * timeline events keep the full duration of each region so that the trace
+ * shows the nesting.
+ *
+ * Times are host wall times. Regions that launch device kernels should wait
+ * on those kernels before the region ends.
+ *
+ * When disabled every method returns immediately, hence the profiler can be
+ * left in the code paths of production runs. The collective methods must be
+ * called on all ranks of the communicator.
+ *
+ * Configurable with the following session parameters (see create):
+ *  * profile_timeline: Enable the profiler if non-zero (default 0).
+ *  * profile_timeline_max_events: Maximum number of timeline events stored on
+ *    each rank (default 100000). Totals are recorded for all events.
+ */
+class StepProfiler {
+protected:
+  struct Event {
+    int region;
+    int name;
+    int step;
+    double start;
+    double duration;
+  };
+
+  MPI_Comm comm;
+  int rank;
+  int size;
+  decltype(profile_timestamp()) origin;
+  std::string trace_filename;
+  std::size_t max_events;
+  std::vector<Event> events;
+  std::vector<std::string> names;
+  std::map<std::string, int> name_ids;
+  /// (category, name id) -> (total time, count).
+  std::map<std::pair<int, int>, std::pair<double, std::int64_t>> totals;
+  int step;
+  double step_start;
+  bool step_open;
+  bool finalised;
+  /// Time spent in regions nested inside each open region.
+  std::vector<double> open_regions;
+
+  static inline std::string json_escape(const std::string &s) {
+    std::string out;
+    out.reserve(s.size());
+    for (const char c : s) {
+      if (c == '"' || c == '\\') {
+        out.push_back('\\');
+      }
+      out.push_back(c);
+    }
+    return out;
+  }
+
+  inline void add_to_parent(const double duration) {
+    if (!this->open_regions.empty()) {
+      this->open_regions.back() += duration;
+    }
+  }
+
+  inline void record(const int region, const int name_id, const double t_start,
+                     const double t_end, const double nested_time = 0.0) {
+    auto &total = this->totals[{region, name_id}];
+    total.first += (t_end - t_start) - nested_time;
+    total.second++;
+    if (this->events.size() < this->max_events) {
+      this->events.push_back(
+          {region, name_id, this->step, t_start, t_end - t_start});
+    }
+  }
+
+public:
+  /// Disable (implicit) copies.
+  StepProfiler(const StepProfiler &st) = delete;
+  /// Disable (implicit) copies.
+  StepProfiler &operator=(StepProfiler const &a) = delete;
+
+  /// Is the profiler recording.
+  const bool enabled;
+
+  /**
+   * Create a new profiler. Collective on the communicator if enabled, the
+   * time origins of the ranks are aligned with a barrier.
+   *
+   * @param enabled Record regions.
+   * @param trace_filename Filename for the Chrome trace, no trace is written
+   * if empty.
+   * @param comm MPI communicator to reduce over (default MPI_COMM_WORLD).
+   * @param max_events Maximum number of timeline events stored per rank.
+   */
+  StepProfiler(const bool enabled = false, std::string trace_filename = "",
+               MPI_Comm comm = MPI_COMM_WORLD,
+               const std::size_t max_events = 100000)
+      : comm(comm), rank(0), size(1), trace_filename(trace_filename),
+        max_events(max_events), step(-1), step_start(0.0), step_open(false),
+        finalised(false), enabled(enabled) {
+    if (this->enabled) {
+      MPICHK(MPI_Comm_rank(comm, &this->rank));
+      MPICHK(MPI_Comm_size(comm, &this->size));
+      MPICHK(MPI_Barrier(comm));
+    }
+    this->origin = profile_timestamp();
+  }
+
+  /**
+   * Create a profiler configured from the session parameters
+   * profile_timeline and profile_timeline_max_events. The profiler reduces
+   * over the MPI communicator of the session. If enabled the trace is written
+   * to <session name>_timeline.json.
+   *
+   * @param session Nektar++ session to read parameters from.
+   * @returns New profiler instance.
+   */
+  static inline std::shared_ptr<StepProfiler>
+  create(LU::SessionReaderSharedPtr session) {
+    int enabled = 0;
+    int max_events = 100000;
+    session->LoadParameter("profile_timeline", enabled, 0);
+    session->LoadParameter("profile_timeline_max_events", max_events,
+                           max_events);
+    NESOASSERT(max_events >= 0,
+               "profile_timeline_max_events must not be negative.");
+
+    // Coupled executables split MPI_COMM_WORLD, hence use the session
+    // communicator.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    auto session_comm =
+        std::dynamic_pointer_cast<LU::CommMpi>(session->GetComm());
+    if (session_comm) {
+      comm = session_comm->GetComm();
+    }
+
+    return std::make_shared<StepProfiler>(
+        enabled != 0, session->GetSessionName() + "_timeline.json", comm,
+        static_cast<std::size_t>(max_events));
+  }
+
+  /**
+   * @returns Wall time in seconds since the profiler was created.
+   */
+  inline double now() const {
+    return profile_elapsed(this->origin, profile_timestamp());
+  }
+
+  /**
+   * Get the integer identifier for a region name.
+   *
+   * @param name Region name.
+   * @returns Identifier for the name.
+   */
+  inline int get_name_id(const std::string &name) {
+    auto it = this->name_ids.find(name);
+    if (it != this->name_ids.end()) {
+      return it->second;
+    }
+    const int id = static_cast<int>(this->names.size());
+    this->names.push_back(name);
+    this->name_ids[name] = id;
+    return id;
+  }
+
+  /**
+   * Open a region which is timed by the caller. Regions opened while this
+   * region is open are nested inside it. Use StepProfilerRegion rather than
+   * calling this directly.
+   *
+   * @returns Depth of the region to pass to end_region.
+   */
+  inline std::size_t begin_region() {
+    this->open_regions.push_back(0.0);
+    return this->open_regions.size() - 1;
+  }
+
+  /**
+   * Close a region opened with begin_region and record it. Any regions nested
+   * inside it which are still open are closed without being recorded.
+   *
+   * @param depth Depth returned by begin_region.
+   * @param region Category of the region.
+   * @param name_id Identifier returned by get_name_id.
+   * @param t_start Start time as returned by now.
+   * @param t_end End time as returned by now.
+   */
+  inline void end_region(const std::size_t depth, const StepRegion region,
+                         const int name_id, const double t_start,
+                         const double t_end) {
+    if (depth >= this->open_regions.size()) {
+      return;
+    }
+    const double nested_time = this->open_regions.at(depth);
+    this->open_regions.resize(depth);
+    this->record(static_cast<int>(region), name_id, t_start, t_end,
+                 nested_time);
+    this->add_to_parent(t_end - t_start);
+  }
+
+  /**
+   * Record a region which has already been timed.
+   *
+   * @param region Category of the region.
+   * @param name Name of the region.
+   * @param t_start Start time as returned by now.
+   * @param t_end End time as returned by now.
+   */
+  inline void add_event(const StepRegion region, const std::string &name,
+                        const double t_start, const double t_end) {
+    if (this->enabled) {
+      this->record(static_cast<int>(region), this->get_name_id(name), t_start,
+                   t_end);
+      this->add_to_parent(t_end - t_start);
+    }
+  }
+
+  /**
+   * Record a region with a known identifier which has already been timed.
+   *
+   * @param region Category of the region.
+   * @param name_id Identifier returned by get_name_id.
+   * @param t_start Start time as returned by now.
+   * @param t_end End time as returned by now.
+   */
+  inline void add_event(const StepRegion region, const int name_id,
+                        const double t_start, const double t_end) {
+    if (this->enabled) {
+      this->record(static_cast<int>(region), name_id, t_start, t_end);
+      this->add_to_parent(t_end - t_start);
+    }
+  }
+
+  /**
+   * Add time to the totals of a region without adding a timeline event. Use
+   * for work which is accumulated over many small intervals. The time is
+   * removed from the totals of the enclosing open region.
+   *
+   * @param region Category of the region.
+   * @param name Name of the region.
+   * @param duration Time in seconds.
+   * @param count Number of times the region was entered (default 1).
+   */
+  inline void add_duration(const StepRegion region, const std::string &name,
+                           const double duration,
+                           const std::int64_t count = 1) {
+    if (this->enabled) {
+      auto &total = this->totals[{static_cast<int>(region),
+                                  this->get_name_id(name)}];
+      total.first += duration;
+      total.second += count;
+      this->add_to_parent(duration);
+    }
+  }
+
+  /**
+   * Start a new time step. Ends the current step if one is open and differs
+   * from the passed step.
+   *
+   * @param step Index of the time step.
+   */
+  inline void begin_step(const int step) {
+    if (!this->enabled || (this->step_open && this->step == step)) {
+      return;
+    }
+    this->end_step();
+    this->step = step;
+    this->step_start = this->now();
+    this->step_open = true;
+  }
+
+  /**
+   * End the current time step if one is open.
+   */
+  inline void end_step() {
+    if (!this->enabled || !this->step_open) {
+      return;
+    }
+    const double t_end = this->now();
+    const int name_id = this->get_name_id("step");
+    if (this->events.size() < this->max_events) {
+      this->events.push_back({-1, name_id, this->step, this->step_start,
+                              t_end - this->step_start});
+    }
+    auto &total = this->totals[{-1, name_id}];
+    total.first += t_end - this->step_start;
+    total.second++;
+    this->step_open = false;
+  }
+
+  /**
+   * Reduce the totals of all regions over the ranks of the communicator. The
+   * union of the regions on all ranks is reduced, a rank which never entered
+   * a region contributes a time of zero. Collective on the communicator.
+   *
+   * @returns Statistics for each region, ordered by category then name. The
+   * time steps appear first with the name "step".
+   */
+  inline std::vector<StepProfilerStats> reduce() {
+    std::vector<StepProfilerStats> stats;
+    if (!this->enabled) {
+      return stats;
+    }
+
+    // Gather the keys on all ranks to form the union of keys in the same order
+    // on every rank.
+    std::string local_keys;
+    for (auto &kv : this->totals) {
+      local_keys += std::to_string(kv.first.first) + " " +
+                    this->names.at(kv.first.second) + "\n";
+    }
+    int local_size = static_cast<int>(local_keys.size());
+    std::vector<int> sizes(this->size);
+    MPICHK(MPI_Allgather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT,
+                         this->comm));
+    std::vector<int> displs(this->size);
+    int total_size = 0;
+    for (int rx = 0; rx < this->size; rx++) {
+      displs[rx] = total_size;
+      total_size += sizes[rx];
+    }
+    std::vector<char> all_keys(std::max(total_size, 1));
+    MPICHK(MPI_Allgatherv(local_keys.data(), local_size, MPI_CHAR,
+                          all_keys.data(), sizes.data(), displs.data(),
+                          MPI_CHAR, this->comm));
+
+    std::set<std::pair<int, std::string>> keys;
+    std::istringstream key_stream(std::string(all_keys.data(), total_size));
+    std::string line;
+    while (std::getline(key_stream, line)) {
+      const auto split = line.find(' ');
+      keys.insert({std::stoi(line.substr(0, split)), line.substr(split + 1)});
+    }
+
+    const int num_keys = static_cast<int>(keys.size());
+    std::vector<double> local_times(std::max(num_keys, 1), 0.0);
+    std::vector<std::int64_t> local_counts(std::max(num_keys, 1), 0);
+    int index = 0;
+    for (auto &key : keys) {
+      auto it_name = this->name_ids.find(key.second);
+      if (it_name != this->name_ids.end()) {
+        auto it = this->totals.find({key.first, it_name->second});
+        if (it != this->totals.end()) {
+          local_times[index] = it->second.first;
+          local_counts[index] = it->second.second;
+        }
+      }
+      index++;
+    }
+
+    std::vector<double> min_times(std::max(num_keys, 1));
+    std::vector<double> max_times(std::max(num_keys, 1));
+    std::vector<double> sum_times(std::max(num_keys, 1));
+    std::vector<std::int64_t> counts(std::max(num_keys, 1));
+    MPICHK(MPI_Allreduce(local_times.data(), min_times.data(), num_keys,
+                         MPI_DOUBLE, MPI_MIN, this->comm));
+    MPICHK(MPI_Allreduce(local_times.data(), max_times.data(), num_keys,
+                         MPI_DOUBLE, MPI_MAX, this->comm));
+    MPICHK(MPI_Allreduce(local_times.data(), sum_times.data(), num_keys,
+                         MPI_DOUBLE, MPI_SUM, this->comm));
+    MPICHK(MPI_Allreduce(local_counts.data(), counts.data(), num_keys,
+                         MPI_INT64_T, MPI_SUM, this->comm));
+
+    stats.reserve(num_keys);
+    index = 0;
+    for (auto &key : keys) {
+      stats.push_back({static_cast<StepRegion>(key.first), key.second,
+                       counts[index], min_times[index],
+                       sum_times[index] / this->size, max_times[index]});
+      index++;
+    }
+    return stats;
+  }
+
+  /**
+   * Print the reduced statistics of all regions on rank 0. Collective on the
+   * communicator.
+   */
+  inline void report() {
+    if (!this->enabled) {
+      return;
+    }
+    auto stats = this->reduce();
+    if (this->rank == 0) {
+      nprint("Step profile over", this->size,
+             "ranks (category, region, calls, min, mean, max, max/mean):");
+      for (auto &s : stats) {
+        const int region = static_cast<int>(s.region);
+        const std::string category =
+            (region < 0) ? "step" : step_region_name(s.region);
+        const double imbalance = (s.mean > 0.0) ? s.max / s.mean : 1.0;
+        nprint(category, s.name, s.count, s.min, s.mean, s.max, imbalance);
+      }
+    }
+  }
+
+  /**
+   * Write the timeline of all ranks to the Chrome trace file on rank 0. Each
+   * rank is a process in the trace. Collective on the communicator.
+   */
+  inline void write_trace() {
+    if (!this->enabled || this->trace_filename.empty()) {
+      return;
+    }
+
+    std::ostringstream local_stream;
+    local_stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":"
+                 << this->rank << ",\"args\":{\"name\":\"rank "
+                 << this->rank << "\"}}";
+    for (auto &event : this->events) {
+      const std::string category =
+          (event.region < 0)
+              ? "step"
+              : step_region_name(static_cast<StepRegion>(event.region));
+      local_stream << ",\n{\"name\":\""
+                   << json_escape(this->names.at(event.name))
+                   << "\",\"cat\":\"" << category
+                   << "\",\"ph\":\"X\",\"pid\":" << this->rank
+                   << ",\"tid\":0,\"ts\":" << event.start * 1.0e6
+                   << ",\"dur\":" << event.duration * 1.0e6
+                   << ",\"args\":{\"step\":" << event.step << "}}";
+    }
+    const std::string local_events = local_stream.str();
+
+    int local_size = static_cast<int>(local_events.size());
+    std::vector<int> sizes(this->size);
+    MPICHK(MPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0,
+                      this->comm));
+    std::vector<int> displs(this->size);
+    int total_size = 0;
+    for (int rx = 0; rx < this->size; rx++) {
+      displs[rx] = total_size;
+      total_size += sizes[rx];
+    }
+    std::vector<char> all_events((this->rank == 0) ? std::max(total_size, 1)
+                                                   : 1);
+    MPICHK(MPI_Gatherv(local_events.data(), local_size, MPI_CHAR,
+                       all_events.data(), sizes.data(), displs.data(),
+                       MPI_CHAR, 0, this->comm));
+
+    if (this->rank == 0) {
+      std::ofstream trace(this->trace_filename);
+      NESOASSERT(trace.is_open(), "Could not open file for timeline trace.");
+      trace << "{\"traceEvents\":[\n";
+      for (int rx = 0; rx < this->size; rx++) {
+        if (rx > 0) {
+          trace << ",\n";
+        }
+        trace.write(all_events.data() + displs[rx], sizes[rx]);
+      }
+      trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+  }
+
+  /**
+   * End the current step, print the report and write the trace. Subsequent
+   * calls have no effect. Collective on the communicator.
+   */
+  inline void finalise() {
+    if (!this->enabled || this->finalised) {
+      return;
+    }
+    this->end_step();
+    this->report();
+    this->write_trace();
+    this->finalised = true;
+  }
+};
+
+typedef std::shared_ptr<StepProfiler> StepProfilerSharedPtr;
+
+/**
+ * Times a named region from construction until end is called or the object
+ * goes out of scope, e.g.
+ *
+ *    {
+ *      StepProfilerRegion region(profiler, StepRegion::ParticlePush, "push");
+ *      // work to time
+ *    }
+ */
+class StepProfilerRegion {
+protected:
+  StepProfiler *profiler;
+  StepRegion region;
+  int name_id;
+  std::size_t depth;
+  double t_start;
+
+public:
+  /// Disable (implicit) copies.
+  StepProfilerRegion(const StepProfilerRegion &st) = delete;
+  /// Disable (implicit) copies.
+  StepProfilerRegion &operator=(StepProfilerRegion const &a) = delete;
+
+  /**
+   * Start timing a region.
+   *
+   * @param profiler Profiler to record the region with, may be nullptr.
+   * @param region Category of the region.
+   * @param name Name of the region.
+   */
+  StepProfilerRegion(StepProfiler *profiler, const StepRegion region,
+                     const std::string &name)
+      : profiler((profiler != nullptr && profiler->enabled) ? profiler
+                                                            : nullptr),
+        region(region), name_id(-1), depth(0), t_start(0.0) {
+    if (this->profiler != nullptr) {
+      this->name_id = this->profiler->get_name_id(name);
+      this->depth = this->profiler->begin_region();
+      this->t_start = this->profiler->now();
+    }
+  }
+
+  /**
+   * Start timing a region.
+   *
+   * @param profiler Profiler to record the region with, may be nullptr.
+   * @param region Category of the region.
+   * @param name Name of the region.
+   */
+  StepProfilerRegion(const StepProfilerSharedPtr &profiler,
+                     const StepRegion region, const std::string &name)
+      : StepProfilerRegion(profiler.get(), region, name) {}
+
+  /**
+   * Stop timing the region. Subsequent calls have no effect.
+   */
+  inline void end() {
+    if (this->profiler != nullptr) {
+      this->profiler->end_region(this->depth, this->region, this->name_id,
+                                 this->t_start, this->profiler->now());
+      this->profiler = nullptr;
+    }
+  }
+
+  ~StepProfilerRegion() { this->end(); }
+};
+
+} // namespace NESO
+
+#endif
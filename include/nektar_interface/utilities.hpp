@@ -192,7 +192,8 @@ inline void write_vtu(std::shared_ptr<T> field, std::string filename,
 
 /**
  * Evaluate a scalar valued Nektar++ function at a point. Avoids assertion
- * issue.
+ * issue. The point is located on the host, to evaluate a field or the
+ * derivatives of a field at many points see FieldPointEvaluate.
  *
  * @param field Nektar++ field.
  * @param x X coordinate.
@@ -0,0 +1,106 @@
+#ifndef __UTILITY_MPI_H_
+#define __UTILITY_MPI_H_
+
+#include <mpi.h>
+#include <neso_particles.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace NESO::Particles;
+
+namespace NESO {
+
+/**
+ * Sparse exchange of one integer from this rank to each of a set of remote
+ * ranks, where the receiving ranks do not know in advance which ranks will
+ * send to them. Uses the non-blocking consensus (NBX) algorithm: synchronous
+ * sends are posted to each destination, incoming messages are probed for and
+ * received until all local sends have been matched, at which point a
+ * non-blocking barrier is entered; the exchange is complete once the barrier
+ * completes. The cost therefore grows with the number of neighbours and the
+ * logarithm of the communicator size, rather than with the communicator size.
+ *
+ * The exchange runs on a duplicate of the communicator such that messages
+ * from successive exchanges cannot be confused. Must be called collectively
+ * on the communicator.
+ *
+ * @param[in] comm MPI communicator.
+ * @param[in] send_ranks Distinct remote ranks to send to.
+ * @param[in] send_data Value to send to each rank in send_ranks.
+ * @param[out] recv_ranks Remote ranks which sent to this rank, sorted in
+ * increasing order.
+ * @param[out] recv_data Value sent by each rank in recv_ranks.
+ * @returns Number of remote ranks which sent to this rank.
+ */
+inline int sparse_exchange_counts(MPI_Comm comm,
+                                  const std::vector<int> &send_ranks,
+                                  const std::vector<int> &send_data,
+                                  std::vector<int> &recv_ranks,
+                                  std::vector<int> &recv_data) {
+  NESOASSERT(send_ranks.size() == send_data.size(),
+             "Expected one value per send rank.");
+  const int tag = 47;
+  MPI_Comm nbx_comm;
+  MPICHK(MPI_Comm_dup(comm, &nbx_comm));
+
+  const int num_send_ranks = send_ranks.size();
+  std::vector<MPI_Request> send_requests(num_send_ranks);
+  for (int rankx = 0; rankx < num_send_ranks; rankx++) {
+    MPICHK(MPI_Issend(send_data.data() + rankx, 1, MPI_INT,
+                      send_ranks[rankx], tag, nbx_comm,
+                      send_requests.data() + rankx));
+  }
+
+  std::vector<int> unsorted_ranks;
+  std::vector<int> unsorted_data;
+  MPI_Request request_barrier;
+  bool barrier_active = false;
+  bool done = false;
+  while (!done) {
+    int flag;
+    MPI_Status status;
+    MPICHK(MPI_Iprobe(MPI_ANY_SOURCE, tag, nbx_comm, &flag, &status));
+    if (flag) {
+      int value;
+      MPICHK(MPI_Recv(&value, 1, MPI_INT, status.MPI_SOURCE, tag, nbx_comm,
+                      MPI_STATUS_IGNORE));
+      unsorted_ranks.push_back(status.MPI_SOURCE);
+      unsorted_data.push_back(value);
+    }
+    if (barrier_active) {
+      int barrier_flag;
+      MPICHK(MPI_Test(&request_barrier, &barrier_flag, MPI_STATUS_IGNORE));
+      done = barrier_flag;
+    } else {
+      int sends_flag;
+      MPICHK(MPI_Testall(num_send_ranks, send_requests.data(), &sends_flag,
+                         MPI_STATUSES_IGNORE));
+      if (sends_flag) {
+        MPICHK(MPI_Ibarrier(nbx_comm, &request_barrier));
+        barrier_active = true;
+      }
+    }
+  }
+  MPICHK(MPI_Comm_free(&nbx_comm));
+
+  // Order by source rank such that the output is deterministic.
+  const int num_recv_ranks = unsorted_ranks.size();
+  std::vector<int> order(num_recv_ranks);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+    return unsorted_ranks[a] < unsorted_ranks[b];
+  });
+  recv_ranks.resize(num_recv_ranks);
+  recv_data.resize(num_recv_ranks);
+  for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
+    recv_ranks[rankx] = unsorted_ranks[order[rankx]];
+    recv_data[rankx] = unsorted_data[order[rankx]];
+  }
+  return num_recv_ranks;
+}
+
+} // namespace NESO
+
+#endif
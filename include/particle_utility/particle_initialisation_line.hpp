@@ -97,12 +97,6 @@ public:
     }
     NESO::Particles::parallel_advection_initialisation(particle_group);
 
-    auto particle_mesh_interface =
-        std::dynamic_pointer_cast<ParticleMeshInterface>(domain->mesh);
-    // Setup map between cell indices
-    auto cell_id_translation = std::make_shared<CellIDTranslation>(
-        sycl_target, particle_group->cell_id_dat, particle_mesh_interface);
-    cell_id_translation->execute();
     particle_group->cell_move();
 
     // the particles left on this rank correspond to the owned points along the
@@ -217,6 +211,12 @@ public:
     this->index_end = scan_output - 1;
   }
 
+  /**
+   * @returns Reference to the RNG used to sample points, e.g. to checkpoint
+   * and restore its state.
+   */
+  inline std::mt19937 &get_rng() { return this->rng; }
+
   /**
    * Sample N local point indices (globally) and place the indices in the
    * provided output container.
@@ -0,0 +1,139 @@
+#ifndef __SOLVER_ANALYTICSOURCE_H_
+#define __SOLVER_ANALYTICSOURCE_H_
+
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <LibUtilities/BasicUtils/Vmath.hpp>
+#include <MultiRegions/ExpList.h>
+#include <nektar_interface/utilities.hpp>
+
+#include <memory>
+#include <regex>
+#include <string>
+
+namespace LU = Nektar::LibUtilities;
+namespace MR = Nektar::MultiRegions;
+
+namespace NESO::Solvers {
+
+/**
+ * Point values of an analytic session function, evaluated at the quadrature
+ * points of a field. Quadrature point coordinates are computed once, on
+ * construction. Expressions that do not depend on time are evaluated once and
+ * cached; time-dependent expressions are re-evaluated, at most once per
+ * distinct time, with a single vectorised call to the expression evaluator
+ * over all points. Non-deterministic expressions, i.e. those that call the
+ * random number function "awgn", are never cached and are re-evaluated on
+ * every call.
+ */
+class AnalyticSource {
+public:
+  /**
+   * @param session Session reader defining the function.
+   * @param field Field whose quadrature points the function is evaluated at.
+   * @param func_name Name of the session function, e.g. "dens_src".
+   * @param var_idx Index of the variable within the function.
+   */
+  AnalyticSource(LU::SessionReaderSharedPtr session, MR::ExpListSharedPtr field,
+                 const std::string &func_name, const int var_idx)
+      : func_name(func_name) {
+    NESOASSERT(session->DefinesFunction(func_name),
+               "AnalyticSource: session does not define function '" +
+                   func_name + "'.");
+    this->func = session->GetFunction(func_name, var_idx);
+    this->time_dependent = depends_on_time(this->func->GetExpression());
+    this->deterministic = is_deterministic(this->func->GetExpression());
+
+    const int npts = field->GetTotPoints();
+    this->x = Array<OneD, NekDouble>(npts);
+    this->y = Array<OneD, NekDouble>(npts);
+    this->z = Array<OneD, NekDouble>(npts);
+    field->GetCoords(this->x, this->y, this->z);
+    this->values = Array<OneD, NekDouble>(npts, 0.0);
+
+    evaluate(0.0);
+    if (!this->time_dependent && this->deterministic) {
+      // Coordinates are no longer needed.
+      this->x = Array<OneD, NekDouble>();
+      this->y = Array<OneD, NekDouble>();
+      this->z = Array<OneD, NekDouble>();
+    }
+  }
+
+  /**
+   * Test whether an expression references the time variable "t".
+   *
+   * @param expr Expression string.
+   * @returns True if @p expr contains "t" as a standalone identifier.
+   */
+  static inline bool depends_on_time(const std::string &expr) {
+    static const std::regex t_regex("(^|[^A-Za-z0-9_])t([^A-Za-z0-9_]|$)");
+    return std::regex_search(expr, t_regex);
+  }
+
+  /**
+   * Test whether an expression always evaluates to the same values, i.e. does
+   * not call the random number function "awgn".
+   *
+   * @param expr Expression string.
+   * @returns False if @p expr contains "awgn" as a standalone identifier.
+   */
+  static inline bool is_deterministic(const std::string &expr) {
+    static const std::regex awgn_regex(
+        "(^|[^A-Za-z0-9_])awgn([^A-Za-z0-9_]|$)");
+    return !std::regex_search(expr, awgn_regex);
+  }
+
+  /// @returns True if the expression is re-evaluated at each new time.
+  inline bool is_time_dependent() const { return this->time_dependent; }
+
+  /// @returns True if the point values may be cached between calls.
+  inline bool is_cached() const { return this->deterministic; }
+
+  /**
+   * Get the point values of the function at a given time.
+   *
+   * @param time Time at which to evaluate; ignored if the expression is time
+   * independent.
+   * @returns Point values, valid until the next call.
+   */
+  inline const Array<OneD, NekDouble> &get_values(const NekDouble time) {
+    if (!this->deterministic ||
+        (this->time_dependent && time != this->values_time)) {
+      evaluate(time);
+    }
+    return this->values;
+  }
+
+  /**
+   * Add the point values of the function to an array.
+   *
+   * @param[in,out] out_arr Array of point values to add to.
+   * @param time Time at which to evaluate the function.
+   */
+  inline void add_to(Array<OneD, NekDouble> &out_arr, const NekDouble time) {
+    const Array<OneD, NekDouble> &vals = get_values(time);
+    Vmath::Vadd(vals.size(), out_arr, 1, vals, 1, out_arr, 1);
+  }
+
+protected:
+  std::string func_name;
+  LU::EquationSharedPtr func;
+  bool time_dependent;
+  bool deterministic;
+  NekDouble values_time;
+  Array<OneD, NekDouble> x;
+  Array<OneD, NekDouble> y;
+  Array<OneD, NekDouble> z;
+  Array<OneD, NekDouble> values;
+
+  inline void evaluate(const NekDouble time) {
+    this->func->Evaluate(this->x, this->y, this->z, time, this->values);
+    this->values_time = time;
+  }
+};
+
+typedef std::shared_ptr<AnalyticSource> AnalyticSourceSharedPtr;
+
+} // namespace NESO::Solvers
+
+#endif
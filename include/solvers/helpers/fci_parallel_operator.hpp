@@ -0,0 +1,660 @@
+#ifndef __SOLVER_FCIPARALLELOPERATOR_H_
+#define __SOLVER_FCIPARALLELOPERATOR_H_
+
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <LibUtilities/Communication/CommMpi.h>
+#include <MultiRegions/ExpList.h>
+#include <mpi.h>
+#include <nektar_interface/utilities.hpp>
+#include <nektar_interface/utility_mpi.hpp>
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace LU = Nektar::LibUtilities;
+namespace MR = Nektar::MultiRegions;
+
+namespace NESO::Solvers {
+
+/**
+ * Flux-coordinate independent (FCI) parallel derivatives of fields with a
+ * homogeneous 1D (Fourier) expansion in z, whose planes are used as the
+ * poloidal planes. On construction the magnetic field line through each
+ * quadrature point is traced, forwards and backwards, to the neighbouring
+ * planes. The interpolation weights of the 2D expansion at the points where
+ * the field lines cross those planes are stored as two sparse matrices, one
+ * row per quadrature point, hence applying the operator is a sparse
+ * matrix-vector product followed by a finite difference along the field line.
+ *
+ * Field lines may cross planes in elements held on other MPI ranks. The
+ * owning rank then computes the interpolated values and sends them to the
+ * rank which needs them, i.e. each application is one sparse neighbour
+ * exchange. The owners are found at setup by requesting each crossing from
+ * the neighbour ranks whose elements' bounding box holds it.
+ *
+ * Configurable with the following session function and parameters (see
+ * create):
+ *  * MagneticField: Session function with variables Bx, By and Bz. If not
+ *    defined the uniform field passed to create is used.
+ *  * fci_num_substeps: RK4 steps used to trace a field line between
+ *    neighbouring planes (default 8).
+ *  * fci_periodic_xy: Wrap field lines which leave the (x,y) bounding box of
+ *    the mesh periodically into it (default 1 if all boundary conditions of
+ *    the field are periodic, otherwise 0).
+ */
+class FCIParallelOperator {
+public:
+  /// Writes the magnetic field vector at the point (x, y, z) to B[0:3].
+  typedef std::function<void(const NekDouble x, const NekDouble y,
+                             const NekDouble z, NekDouble *B)>
+      MagneticField;
+
+  /**
+   * @param field Field with a homogeneous 1D expansion to compute the
+   * parallel derivatives of. All planes must be held on this MPI rank.
+   * @param magnetic_field Magnetic field, Bz must not vanish.
+   * @param comm MPI communicator the (x,y) mesh is partitioned over.
+   * @param num_substeps Number of RK4 steps between neighbouring planes.
+   * @param periodic_xy Wrap field lines periodically into the (x,y) bounding
+   * box of the mesh.
+   */
+  FCIParallelOperator(MR::ExpListSharedPtr field, MagneticField magnetic_field,
+                      MPI_Comm comm, const int num_substeps = 8,
+                      const bool periodic_xy = false)
+      : comm(comm), magnetic_field(magnetic_field),
+        num_substeps(num_substeps), periodic_xy(periodic_xy) {
+    NESOASSERT(field->GetExpType() == MR::e3DH1D,
+               "FCIParallelOperator requires a homogeneous 1D expansion.");
+    NESOASSERT(num_substeps > 0, "fci_num_substeps must be positive.");
+    this->num_planes = field->GetHomogeneousBasis()->GetNumModes();
+    NESOASSERT(static_cast<int>(field->GetZIDs().size()) == this->num_planes,
+               "FCIParallelOperator requires all planes on each MPI rank.");
+    this->plane = field->GetPlane(0);
+    this->npts = field->GetTotPoints();
+    this->plane_npts = this->npts / this->num_planes;
+    this->dz = field->GetHomoLen() / this->num_planes;
+    MPICHK(MPI_Comm_rank(comm, &this->rank));
+    MPICHK(MPI_Comm_size(comm, &this->size));
+
+    this->setup_bounding_box();
+    this->setup_stencils(field);
+  }
+
+  /**
+   * Create an operator configured from the session.
+   *
+   * @param session Session reader to read the function and parameters from.
+   * @param field Field with a homogeneous 1D expansion.
+   * @param Bvec Uniform magnetic field used if the session does not define
+   * the MagneticField function.
+   * @returns New operator.
+   */
+  static inline std::shared_ptr<FCIParallelOperator>
+  create(LU::SessionReaderSharedPtr session, MR::ExpListSharedPtr field,
+         const std::vector<NekDouble> &Bvec) {
+    MagneticField magnetic_field;
+    if (session->DefinesFunction("MagneticField")) {
+      std::array<LU::EquationSharedPtr, 3> funcs;
+      const std::array<std::string, 3> names = {"Bx", "By", "Bz"};
+      for (int dx = 0; dx < 3; dx++) {
+        NESOASSERT(session->DefinesFunction("MagneticField", names[dx]),
+                   "MagneticField function does not define " + names[dx] +
+                       ".");
+        funcs[dx] = session->GetFunction("MagneticField", names[dx]);
+      }
+      magnetic_field = [=](const NekDouble x, const NekDouble y,
+                           const NekDouble z, NekDouble *B) {
+        for (int dx = 0; dx < 3; dx++) {
+          B[dx] = funcs[dx]->Evaluate(x, y, z);
+        }
+      };
+    } else {
+      NESOASSERT(Bvec.size() == 3, "Expected a 3 component magnetic field.");
+      const std::array<NekDouble, 3> B_uniform = {Bvec[0], Bvec[1], Bvec[2]};
+      magnetic_field = [=](const NekDouble, const NekDouble, const NekDouble,
+                           NekDouble *B) {
+        for (int dx = 0; dx < 3; dx++) {
+          B[dx] = B_uniform[dx];
+        }
+      };
+    }
+
+    // Field lines are only wrapped by default if the domain is periodic.
+    auto bcs = field->GetBndConditions();
+    bool is_pbc = bcs.size() > 0;
+    for (auto &bc : bcs) {
+      is_pbc &= (bc->GetBoundaryConditionType() ==
+                 Nektar::SpatialDomains::ePeriodic);
+    }
+    int num_substeps;
+    int periodic_xy;
+    session->LoadParameter("fci_num_substeps", num_substeps, 8);
+    session->LoadParameter("fci_periodic_xy", periodic_xy, is_pbc ? 1 : 0);
+
+    // Coupled executables split MPI_COMM_WORLD, hence use the session
+    // communicator.
+    MPI_Comm comm = MPI_COMM_WORLD;
+    auto session_comm =
+        std::dynamic_pointer_cast<LU::CommMpi>(session->GetComm());
+    if (session_comm) {
+      comm = session_comm->GetComm();
+    }
+    return std::make_shared<FCIParallelOperator>(
+        field, magnetic_field, comm, num_substeps, periodic_xy != 0);
+  }
+
+  /**
+   * Interpolate values onto the points where the field lines through the
+   * quadrature points cross the neighbouring planes. Collective on the
+   * communicator.
+   *
+   * @param inarray Values at the quadrature points.
+   * @param[out] forward Values one plane forwards along the field lines.
+   * @param[out] backward Values one plane backwards along the field lines.
+   */
+  inline void interpolate(const Array<OneD, const NekDouble> &inarray,
+                          Array<OneD, NekDouble> &forward,
+                          Array<OneD, NekDouble> &backward) {
+    const NekDouble *in = inarray.data();
+    const int num_send_ranks = this->send_ranks.size();
+    const int num_recv_ranks = this->recv_ranks.size();
+    std::vector<MPI_Request> requests(num_send_ranks + num_recv_ranks);
+
+    // Post the receives, then compute and send the values other ranks need.
+    for (int rx = 0; rx < num_recv_ranks; rx++) {
+      const int start = this->recv_offsets[rx];
+      MPICHK(MPI_Irecv(this->recv_buffer.data() + start,
+                       this->recv_offsets[rx + 1] - start, MPI_DOUBLE,
+                       this->recv_ranks[rx], tag, this->comm,
+                       requests.data() + rx));
+    }
+    this->export_stencils.apply(in, this->send_buffer.data());
+    for (int rx = 0; rx < num_send_ranks; rx++) {
+      const int start = this->send_offsets[rx];
+      MPICHK(MPI_Isend(this->send_buffer.data() + start,
+                       this->send_offsets[rx + 1] - start, MPI_DOUBLE,
+                       this->send_ranks[rx], tag, this->comm,
+                       requests.data() + num_recv_ranks + rx));
+    }
+
+    // Rows which need remote values are empty and set below.
+    this->local_stencils.apply(in, this->values.data());
+    MPICHK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+    const int num_recv = this->recv_rows.size();
+    for (int ix = 0; ix < num_recv; ix++) {
+      this->values[this->recv_rows[ix]] = this->recv_buffer[ix];
+    }
+
+    for (int ix = 0; ix < this->npts; ix++) {
+      forward[ix] = this->values[ix];
+      backward[ix] = this->values[this->npts + ix];
+    }
+  }
+
+  /**
+   * Compute the derivative along the magnetic field, b . grad(f), with a
+   * centred difference along the field lines. Collective on the
+   * communicator.
+   *
+   * @param inarray Values at the quadrature points.
+   * @param[out] outarray Parallel derivative at the quadrature points.
+   */
+  inline void grad_par(const Array<OneD, const NekDouble> &inarray,
+                       Array<OneD, NekDouble> &outarray) {
+    this->interpolate(inarray, this->tmp_forward, this->tmp_backward);
+    for (int ix = 0; ix < this->npts; ix++) {
+      outarray[ix] = (this->tmp_forward[ix] - this->tmp_backward[ix]) /
+                     (this->length_forward[ix] + this->length_backward[ix]);
+    }
+  }
+
+  /**
+   * Compute the second derivative with respect to the arc length along the
+   * magnetic field lines, b . grad(b . grad(f)), with a centred difference
+   * along the field lines. Collective on the communicator.
+   *
+   * @param inarray Values at the quadrature points.
+   * @param[out] outarray Second parallel derivative at the quadrature points.
+   */
+  inline void grad2_par(const Array<OneD, const NekDouble> &inarray,
+                        Array<OneD, NekDouble> &outarray) {
+    this->interpolate(inarray, this->tmp_forward, this->tmp_backward);
+    for (int ix = 0; ix < this->npts; ix++) {
+      const NekDouble lf = this->length_forward[ix];
+      const NekDouble lb = this->length_backward[ix];
+      outarray[ix] = 2.0 *
+                     ((this->tmp_forward[ix] - inarray[ix]) / lf -
+                      (inarray[ix] - this->tmp_backward[ix]) / lb) /
+                     (lf + lb);
+    }
+  }
+
+  /**
+   * @returns Number of field line crossings on this rank interpolated by
+   * another rank.
+   */
+  inline int get_num_remote_points() const { return this->recv_rows.size(); }
+
+  /**
+   * @returns Number of non-zero interpolation weights stored on this rank.
+   */
+  inline std::size_t get_num_weights() const {
+    return this->local_stencils.cols.size() +
+           this->export_stencils.cols.size();
+  }
+
+protected:
+  /// Compressed sparse row interpolation weights.
+  struct Stencils {
+    std::vector<int> row_ptr = {0};
+    std::vector<int> cols;
+    std::vector<NekDouble> weights;
+
+    inline void end_row() { this->row_ptr.push_back(this->cols.size()); }
+
+    inline void apply(const NekDouble *in, NekDouble *out) const {
+      const int num_rows = this->row_ptr.size() - 1;
+      for (int rx = 0; rx < num_rows; rx++) {
+        NekDouble value = 0.0;
+        for (int ex = this->row_ptr[rx]; ex < this->row_ptr[rx + 1]; ex++) {
+          value += this->weights[ex] * in[this->cols[ex]];
+        }
+        out[rx] = value;
+      }
+    }
+  };
+
+  static constexpr int tag = 48;
+  static constexpr NekDouble locate_tol = 1.0e-8;
+
+  MPI_Comm comm;
+  int rank;
+  int size;
+  MagneticField magnetic_field;
+  const int num_substeps;
+  const bool periodic_xy;
+  MR::ExpListSharedPtr plane;
+  int num_planes;
+  int npts;
+  int plane_npts;
+  NekDouble dz;
+  std::array<NekDouble, 2> origin;
+  std::array<NekDouble, 2> extent;
+  /// Bounding box of the elements on this rank, lower then upper corner.
+  std::array<NekDouble, 4> local_box;
+
+  /// Field line length to the forward and backward planes.
+  std::vector<NekDouble> length_forward;
+  std::vector<NekDouble> length_backward;
+
+  /// Rows 0 to npts-1 are forward values, npts to 2*npts-1 backward values.
+  Stencils local_stencils;
+  std::vector<NekDouble> values;
+
+  /// Rows evaluated for other ranks, grouped by destination rank.
+  Stencils export_stencils;
+  std::vector<int> send_ranks;
+  std::vector<int> send_offsets;
+  std::vector<NekDouble> send_buffer;
+
+  /// Rows of values which are evaluated by other ranks.
+  std::vector<int> recv_ranks;
+  std::vector<int> recv_offsets;
+  std::vector<int> recv_rows;
+  std::vector<NekDouble> recv_buffer;
+
+  Array<OneD, NekDouble> tmp_forward;
+  Array<OneD, NekDouble> tmp_backward;
+
+  inline void setup_bounding_box() {
+    auto &lower = this->local_box;
+    lower = {std::numeric_limits<NekDouble>::max(),
+             std::numeric_limits<NekDouble>::max(),
+             std::numeric_limits<NekDouble>::lowest(),
+             std::numeric_limits<NekDouble>::lowest()};
+    NekDouble *upper = lower.data() + 2;
+    const int num_elements = this->plane->GetExpSize();
+    for (int ex = 0; ex < num_elements; ex++) {
+      // Nektar++ bounding boxes are (xmin, ymin, zmin, xmax, ymax, zmax).
+      auto box = this->plane->GetExp(ex)->GetGeom()->GetBoundingBox();
+      for (int dx = 0; dx < 2; dx++) {
+        lower[dx] = std::min(lower[dx], box[dx]);
+        upper[dx] = std::max(upper[dx], box[3 + dx]);
+      }
+    }
+    MPICHK(MPI_Allreduce(lower.data(), this->origin.data(), 2, MPI_DOUBLE,
+                         MPI_MIN, this->comm));
+    MPICHK(MPI_Allreduce(upper, this->extent.data(), 2, MPI_DOUBLE, MPI_MAX,
+                         this->comm));
+    for (int dx = 0; dx < 2; dx++) {
+      this->extent[dx] -= this->origin[dx];
+    }
+  }
+
+  /**
+   * Exchange blocks of values with known ranks. Used at setup, before any
+   * interpolation messages are posted.
+   *
+   * @param datatype MPI datatype of the values.
+   * @param send_ranks Ranks to send to.
+   * @param send_counts Number of items sent to each rank.
+   * @param stride Number of values per item.
+   * @param send_data Values to send, grouped by rank in the order of
+   * send_ranks.
+   * @param recv_ranks Ranks to receive from.
+   * @param recv_counts Number of items received from each rank.
+   * @param[out] recv_data Values received, grouped by rank in the order of
+   * recv_ranks.
+   */
+  template <typename T>
+  inline void exchange(const MPI_Datatype datatype,
+                       const std::vector<int> &send_ranks,
+                       const std::vector<int> &send_counts, const int stride,
+                       const std::vector<T> &send_data,
+                       const std::vector<int> &recv_ranks,
+                       const std::vector<int> &recv_counts,
+                       std::vector<T> &recv_data) const {
+    const int num_send_ranks = send_ranks.size();
+    const int num_recv_ranks = recv_ranks.size();
+    std::vector<MPI_Request> requests(num_send_ranks + num_recv_ranks);
+    recv_data.resize(
+        stride * std::accumulate(recv_counts.begin(), recv_counts.end(), 0));
+    int offset = 0;
+    for (int rx = 0; rx < num_recv_ranks; rx++) {
+      MPICHK(MPI_Irecv(recv_data.data() + offset, stride * recv_counts[rx],
+                       datatype, recv_ranks[rx], tag, this->comm,
+                       requests.data() + rx));
+      offset += stride * recv_counts[rx];
+    }
+    offset = 0;
+    for (int rx = 0; rx < num_send_ranks; rx++) {
+      MPICHK(MPI_Isend(send_data.data() + offset, stride * send_counts[rx],
+                       datatype, send_ranks[rx], tag, this->comm,
+                       requests.data() + num_recv_ranks + rx));
+      offset += stride * send_counts[rx];
+    }
+    MPICHK(MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+  }
+
+  /**
+   * Trace a field line from (x, y, z) to the plane z + delta_z with RK4 in z.
+   *
+   * @param[in, out] x x coordinate.
+   * @param[in, out] y y coordinate.
+   * @param z Start z coordinate.
+   * @param delta_z Signed distance in z to trace.
+   * @returns Length of the field line.
+   */
+  inline NekDouble trace(NekDouble &x, NekDouble &y, const NekDouble z,
+                         const NekDouble delta_z) const {
+    // d(x, y, s)/dz for the field line.
+    auto lambda_rhs = [&](const NekDouble px, const NekDouble py,
+                          const NekDouble pz, NekDouble *d) {
+      NekDouble B[3];
+      this->magnetic_field(px, py, pz, B);
+      NESOASSERT(std::abs(B[2]) > 0.0,
+                 "FCIParallelOperator requires a non-zero Bz.");
+      d[0] = B[0] / B[2];
+      d[1] = B[1] / B[2];
+      d[2] = std::sqrt(B[0] * B[0] + B[1] * B[1] + B[2] * B[2]) /
+             std::abs(B[2]);
+    };
+    const NekDouble h = delta_z / this->num_substeps;
+    NekDouble length = 0.0;
+    NekDouble pz = z;
+    NekDouble k1[3], k2[3], k3[3], k4[3];
+    for (int sx = 0; sx < this->num_substeps; sx++) {
+      lambda_rhs(x, y, pz, k1);
+      lambda_rhs(x + 0.5 * h * k1[0], y + 0.5 * h * k1[1], pz + 0.5 * h, k2);
+      lambda_rhs(x + 0.5 * h * k2[0], y + 0.5 * h * k2[1], pz + 0.5 * h, k3);
+      lambda_rhs(x + h * k3[0], y + h * k3[1], pz + h, k4);
+      x += h * (k1[0] + 2.0 * k2[0] + 2.0 * k3[0] + k4[0]) / 6.0;
+      y += h * (k1[1] + 2.0 * k2[1] + 2.0 * k3[1] + k4[1]) / 6.0;
+      length +=
+          std::abs(h) * (k1[2] + 2.0 * k2[2] + 2.0 * k3[2] + k4[2]) / 6.0;
+      pz += h;
+    }
+    return length;
+  }
+
+  inline void wrap(NekDouble &x, NekDouble &y) const {
+    if (this->periodic_xy) {
+      x -= this->extent[0] *
+           std::floor((x - this->origin[0]) / this->extent[0]);
+      y -= this->extent[1] *
+           std::floor((y - this->origin[1]) / this->extent[1]);
+    }
+  }
+
+  /**
+   * Append the interpolation weights of the plane expansion at a point to a
+   * row of stencils.
+   *
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @param target_plane Plane to interpolate on.
+   * @param[in, out] stencils Stencils to append the weights to.
+   * @returns False if the point is not in an element on this rank.
+   */
+  inline bool add_stencil(const NekDouble x, const NekDouble y,
+                          const int target_plane, Stencils &stencils) const {
+    Array<OneD, NekDouble> coords(3, 0.0);
+    Array<OneD, NekDouble> local_coords(3, 0.0);
+    coords[0] = x;
+    coords[1] = y;
+    const int ex = this->plane->GetExpIndex(coords, local_coords, locate_tol);
+    if (ex < 0) {
+      return false;
+    }
+    auto exp = this->plane->GetExp(ex);
+    Array<OneD, NekDouble> collapsed(2);
+    exp->LocCoordToLocCollapsed(local_coords, collapsed);
+    auto I0 = exp->GetBasis(0)->GetI(collapsed);
+    auto I1 = exp->GetBasis(1)->GetI(collapsed + 1);
+    const int nq0 = exp->GetNumPoints(0);
+    const int nq1 = exp->GetNumPoints(1);
+    const int offset =
+        target_plane * this->plane_npts + this->plane->GetPhys_Offset(ex);
+    for (int j1 = 0; j1 < nq1; j1++) {
+      for (int j0 = 0; j0 < nq0; j0++) {
+        stencils.cols.push_back(offset + j1 * nq0 + j0);
+        stencils.weights.push_back((*I0)(0, j0) * (*I1)(0, j1));
+      }
+    }
+    return true;
+  }
+
+  inline void setup_stencils(MR::ExpListSharedPtr field) {
+    Array<OneD, NekDouble> x(this->npts), y(this->npts), z(this->npts);
+    field->GetCoords(x, y, z);
+    this->length_forward.resize(this->npts);
+    this->length_backward.resize(this->npts);
+
+    // Crossings which are not in a local element, as (x, y, plane).
+    std::vector<NekDouble> unresolved;
+    std::vector<int> unresolved_rows;
+    for (int dirx = 0; dirx < 2; dirx++) {
+      const int sign = (dirx == 0) ? 1 : -1;
+      auto &lengths =
+          (dirx == 0) ? this->length_forward : this->length_backward;
+      for (int ix = 0; ix < this->npts; ix++) {
+        NekDouble px = x[ix];
+        NekDouble py = y[ix];
+        lengths[ix] = this->trace(px, py, z[ix], sign * this->dz);
+        this->wrap(px, py);
+        const int target_plane =
+            (ix / this->plane_npts + sign + this->num_planes) %
+            this->num_planes;
+        if (!this->add_stencil(px, py, target_plane, this->local_stencils)) {
+          unresolved.push_back(px);
+          unresolved.push_back(py);
+          unresolved.push_back(target_plane);
+          unresolved_rows.push_back(dirx * this->npts + ix);
+        }
+        this->local_stencils.end_row();
+      }
+    }
+    this->values.resize(2 * this->npts);
+    this->tmp_forward = Array<OneD, NekDouble>(this->npts);
+    this->tmp_backward = Array<OneD, NekDouble>(this->npts);
+
+    // Each crossing which is not local is requested from the ranks whose
+    // elements' bounding box holds it, i.e. the neighbour ranks, and is
+    // evaluated by the lowest of those ranks which finds it in an element.
+    std::vector<NekDouble> boxes(4 * this->size);
+    MPICHK(MPI_Allgather(this->local_box.data(), 4, MPI_DOUBLE, boxes.data(),
+                         4, MPI_DOUBLE, this->comm));
+    const NekDouble tol =
+        locate_tol * std::max(this->extent[0], this->extent[1]);
+    auto lambda_overlaps = [&](const int rx, const NekDouble *lower,
+                               const NekDouble *upper) {
+      const NekDouble *box = boxes.data() + 4 * rx;
+      return (lower[0] <= box[2] + tol) && (lower[1] <= box[3] + tol) &&
+             (upper[0] >= box[0] - tol) && (upper[1] >= box[1] - tol);
+    };
+
+    // Only the ranks which overlap the crossings of this rank are tested for
+    // each crossing.
+    const int num_unresolved = unresolved_rows.size();
+    std::array<NekDouble, 4> unresolved_box = {
+        std::numeric_limits<NekDouble>::max(),
+        std::numeric_limits<NekDouble>::max(),
+        std::numeric_limits<NekDouble>::lowest(),
+        std::numeric_limits<NekDouble>::lowest()};
+    for (int ux = 0; ux < num_unresolved; ux++) {
+      for (int dx = 0; dx < 2; dx++) {
+        const NekDouble p = unresolved[3 * ux + dx];
+        unresolved_box[dx] = std::min(unresolved_box[dx], p);
+        unresolved_box[2 + dx] = std::max(unresolved_box[2 + dx], p);
+      }
+    }
+    std::vector<int> neighbour_ranks;
+    for (int rx = 0; rx < this->size; rx++) {
+      if ((rx != this->rank) &&
+          lambda_overlaps(rx, unresolved_box.data(),
+                          unresolved_box.data() + 2)) {
+        neighbour_ranks.push_back(rx);
+      }
+    }
+    std::map<int, std::vector<int>> rank_queries;
+    for (int ux = 0; ux < num_unresolved; ux++) {
+      const NekDouble *p = unresolved.data() + 3 * ux;
+      bool requested = false;
+      for (const int rx : neighbour_ranks) {
+        if (lambda_overlaps(rx, p, p)) {
+          rank_queries[rx].push_back(ux);
+          requested = true;
+        }
+      }
+      NESOASSERT(requested, "A field line leaves the mesh between planes.");
+    }
+
+    // Send the requests, the peer ranks are those which request crossings
+    // from this rank.
+    std::vector<int> query_ranks, query_counts;
+    std::vector<NekDouble> query_points;
+    for (auto &pair : rank_queries) {
+      query_ranks.push_back(pair.first);
+      query_counts.push_back(pair.second.size());
+      for (const int ux : pair.second) {
+        for (int cx = 0; cx < 3; cx++) {
+          query_points.push_back(unresolved[3 * ux + cx]);
+        }
+      }
+    }
+    std::vector<int> peer_ranks, peer_counts;
+    sparse_exchange_counts(this->comm, query_ranks, query_counts, peer_ranks,
+                           peer_counts);
+    std::vector<NekDouble> peer_points;
+    this->exchange(MPI_DOUBLE, query_ranks, query_counts, 3, query_points,
+                   peer_ranks, peer_counts, peer_points);
+
+    // Report which requested crossings are held by this rank.
+    const int num_peer_queries = peer_points.size() / 3;
+    std::vector<int> peer_found(num_peer_queries);
+    Stencils candidates;
+    for (int qx = 0; qx < num_peer_queries; qx++) {
+      const NekDouble *p = peer_points.data() + 3 * qx;
+      peer_found[qx] =
+          this->add_stencil(p[0], p[1], static_cast<int>(p[2]), candidates);
+    }
+    std::vector<int> query_found;
+    this->exchange(MPI_INT, peer_ranks, peer_counts, 1, peer_found,
+                   query_ranks, query_counts, query_found);
+
+    // The requested ranks are in increasing order, hence the first rank which
+    // finds a crossing is the lowest.
+    std::vector<int> owners(num_unresolved, -1);
+    std::vector<int> query_selected(query_found.size(), 0);
+    int index = 0;
+    for (auto &pair : rank_queries) {
+      for (const int ux : pair.second) {
+        if (query_found[index] && (owners[ux] < 0)) {
+          owners[ux] = pair.first;
+          query_selected[index] = 1;
+        }
+        index++;
+      }
+    }
+    for (int ux = 0; ux < num_unresolved; ux++) {
+      NESOASSERT(owners[ux] >= 0,
+                 "A field line leaves the mesh between planes.");
+    }
+    std::vector<int> peer_selected;
+    this->exchange(MPI_INT, query_ranks, query_counts, 1, query_selected,
+                   peer_ranks, peer_counts, peer_selected);
+
+    // Rows evaluated for other ranks, in the order of the requesting rank.
+    this->send_offsets.push_back(0);
+    index = 0;
+    const int num_peer_ranks = peer_ranks.size();
+    for (int rx = 0; rx < num_peer_ranks; rx++) {
+      int num_rows = 0;
+      for (int qx = 0; qx < peer_counts[rx]; qx++) {
+        if (peer_selected[index]) {
+          const NekDouble *p = peer_points.data() + 3 * index;
+          this->add_stencil(p[0], p[1], static_cast<int>(p[2]),
+                            this->export_stencils);
+          this->export_stencils.end_row();
+          num_rows++;
+        }
+        index++;
+      }
+      if (num_rows > 0) {
+        this->send_ranks.push_back(peer_ranks[rx]);
+        this->send_offsets.push_back(this->send_offsets.back() + num_rows);
+      }
+    }
+    this->send_buffer.resize(this->send_offsets.back());
+
+    // Rows of this rank evaluated by other ranks, grouped by owner.
+    this->recv_offsets.push_back(0);
+    for (auto &pair : rank_queries) {
+      int num_rows = 0;
+      for (const int ux : pair.second) {
+        if (owners[ux] == pair.first) {
+          this->recv_rows.push_back(unresolved_rows[ux]);
+          num_rows++;
+        }
+      }
+      if (num_rows > 0) {
+        this->recv_ranks.push_back(pair.first);
+        this->recv_offsets.push_back(this->recv_offsets.back() + num_rows);
+      }
+    }
+    this->recv_buffer.resize(this->recv_rows.size());
+  }
+};
+
+typedef std::shared_ptr<FCIParallelOperator> FCIParallelOperatorSharedPtr;
+
+} // namespace NESO::Solvers
+
+#endif
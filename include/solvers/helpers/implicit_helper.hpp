@@ -1,7 +1,16 @@
 #ifndef __SOLVER_IMPLICITHELPER_H_
 #define __SOLVER_IMPLICITHELPER_H_
 
+#include <LibUtilities/LinearAlgebra/Lapack.hpp>
 #include <LibUtilities/LinearAlgebra/NekNonlinSysIter.h>
+#include <neso_particles.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace LU = Nektar::LibUtilities;
 namespace MR = Nektar::MultiRegions;
@@ -14,7 +23,8 @@ public:
                  Array<OneD, MR::ExpListSharedPtr> fields_in,
                  LU::TimeIntegrationSchemeOperators &ode_in, int n_fields_in)
       : session(session_in), fields(fields_in), ode(ode_in),
-        n_fields(n_fields_in), projected_in_arr(n_fields_in) {
+        n_fields(n_fields_in), projected_in_arr(n_fields_in),
+        in_views(n_fields_in), out_views(n_fields_in) {
     this->comm = session->GetComm()->GetSpaceComm();
 
     // Set n_pts, then make sure all fields have the same points
@@ -29,6 +39,13 @@ public:
     for (int ifld = 0; ifld < this->n_fields; ++ifld) {
       this->projected_in_arr[ifld] = Array<OneD, NekDouble>(this->n_pts);
     }
+
+    // Allocate flattened work arrays once, rather than per solve/iteration
+    const unsigned int n_tot = this->n_fields * this->n_pts;
+    this->in_arr_flat = Array<OneD, NekDouble>(n_tot);
+    this->out_arr_flat = Array<OneD, NekDouble>(n_tot);
+    this->soln_plus = Array<OneD, NekDouble>(n_tot);
+    this->res_plus = Array<OneD, NekDouble>(n_tot);
   }
 
   /// Default destructor.
@@ -43,24 +60,21 @@ public:
     this->time = time;
 
     /*
-     * Copy in/out points for each field into flattened arrays of size
-     * N_pts_per_field*N_fields
+     * Copy in/out points for each field into (preallocated) flattened arrays
+     * of size N_pts_per_field*N_fields
      */
-    Array<OneD, NekDouble> in_arr_flat(this->n_fields * this->n_pts);
-    Array<OneD, NekDouble> out_arr_flat(this->n_fields * this->n_pts);
-    Array<OneD, NekDouble> tmp;
     for (auto ifld = 0; ifld < this->n_fields; ++ifld) {
-      int offset = ifld * this->n_pts;
-      Vmath::Vcopy(this->n_pts, in_pts[ifld], 1, tmp = in_arr_flat + offset, 1);
+      std::copy_n(in_pts[ifld].data(), this->n_pts,
+                  this->in_arr_flat.data() + ifld * this->n_pts);
     }
 
     // Pass flattened arrays to solver
-    implicit_time_int_1D(in_arr_flat, out_arr_flat);
+    implicit_time_int_1D(this->in_arr_flat, this->out_arr_flat);
 
     // Put the result back into a field-indexed output array
     for (auto ifld = 0; ifld < this->n_fields; ++ifld) {
-      int offset = ifld * this->n_pts;
-      Vmath::Vcopy(this->n_pts, out_arr_flat + offset, 1, out_pts[ifld], 1);
+      std::copy_n(this->out_arr_flat.data() + ifld * this->n_pts, this->n_pts,
+                  out_pts[ifld].data());
     }
   }
 
@@ -79,6 +93,18 @@ public:
     this->session->LoadParameter("GMRESMaxHessMatBand",
                                  key.m_KrylovMaxHessMatBand, 31);
 
+    // Load parameters for the preconditioner
+    this->session->LoadSolverInfo("ImplicitPreconditioner", this->precon_type,
+                                  "Null");
+    NESOASSERT(this->precon_type == "Null" ||
+                   this->precon_type == "BlockJacobi",
+               "ImplicitHelper: ImplicitPreconditioner must be one of "
+               "'Null' or 'BlockJacobi'.");
+    this->session->LoadParameter("PreconMatFreezNumb", this->precon_refresh,
+                                 10);
+    NESOASSERT(this->precon_refresh > 0,
+               "ImplicitHelper: PreconMatFreezNumb must be positive.");
+
     // Load parameters for the non-linear solver
     this->session->LoadParameter("JacobiFreeEps", this->jacobi_free_eps,
                                  5.0E-8);
@@ -96,10 +122,15 @@ public:
 
     // Set up operators
     LU::NekSysOperators operators;
-    operators.DefineNekSysResEval(&ImplicitHelper::non_lin_sys_evaluator_1D,
-                                  this);
+    operators.DefineNekSysResEval(&ImplicitHelper::newton_res_eval, this);
     operators.DefineNekSysLhsEval(&ImplicitHelper::matrix_multiply_MF, this);
-    operators.DefineNekSysPrecon(&ImplicitHelper::do_null_precon, this);
+    if (this->precon_type == "BlockJacobi") {
+      init_block_jacobi();
+      operators.DefineNekSysPrecon(&ImplicitHelper::do_block_jacobi_precon,
+                                   this);
+    } else {
+      operators.DefineNekSysPrecon(&ImplicitHelper::do_null_precon, this);
+    }
 
     // Initialize non-linear system
     int n_pts_all_fields = this->n_fields * this->n_pts;
@@ -109,6 +140,24 @@ public:
     this->non_lin_solver->SetSysOperators(operators);
   }
 
+  /**
+   * Print accumulated Newton and linear iteration counts on rank 0.
+   */
+  void print_stats() const {
+    if (this->comm->GetRank() == 0) {
+      const double lin_its_per_newton_it =
+          (this->tot_newton_its > 0) ? static_cast<double>(this->tot_lin_its) /
+                                           this->tot_newton_its
+                                     : 0.0;
+      NESO::Particles::nprint(
+          "Implicit solver (" + this->precon_type + " preconditioner):",
+          this->tot_imp_stages, "stages,", this->tot_newton_its,
+          "Newton its,", this->tot_lin_its, "linear its,",
+          lin_its_per_newton_it, "linear its per Newton it,",
+          this->precon_builds, "precon builds");
+    }
+  }
+
 protected:
   // Implicit solver parameters
   NekDouble array_norm = -1.0;
@@ -120,6 +169,31 @@ protected:
   int tot_lin_its = 0;
   int tot_newton_its = 0;
 
+  // Preconditioner settings and state
+  std::string precon_type = "Null";
+  /// Number of Newton iterations between rebuilds of the block Jacobian
+  int precon_refresh = 10;
+  int newton_its_since_build = 0;
+  int precon_builds = 0;
+  bool precon_stale = true;
+  NekDouble precon_lambda = 0.0;
+  /// Element colours; elements sharing a vertex have different colours
+  std::vector<int> elmt_colours;
+  int n_colours = 0;
+  /// Largest block size across all ranks
+  int max_block_size = 0;
+  /// Per-element offsets into the quad point arrays, point counts and
+  /// offsets into the block storage
+  std::vector<int> elmt_phys_offsets;
+  std::vector<int> elmt_n_pts;
+  std::vector<std::size_t> block_offsets;
+  std::vector<std::size_t> pivot_offsets;
+  /// LAPACK LU factors of the element blocks (column-major) and their pivots
+  std::vector<NekDouble> block_lu;
+  std::vector<int> block_pivots;
+  /// Scratch space for applying a single block
+  std::vector<NekDouble> block_work;
+
   // Store number of points per field as a member var for convenience
   unsigned int n_pts;
 
@@ -132,26 +206,206 @@ protected:
 
   // Storage used in non_lin_sys_evaluator
   Array<OneD, Array<OneD, NekDouble>> projected_in_arr;
+  /// Per-field views into the flattened arrays passed to the evaluator
+  Array<OneD, Array<OneD, NekDouble>> in_views;
+  Array<OneD, Array<OneD, NekDouble>> out_views;
+  // Flattened work arrays used in implicit_time_int and matrix_multiply_MF
+  Array<OneD, NekDouble> in_arr_flat;
+  Array<OneD, NekDouble> out_arr_flat;
+  Array<OneD, NekDouble> soln_plus;
+  Array<OneD, NekDouble> res_plus;
 
   /**
-   * Calculate array norm.
+   * Calculate array norm (squared L2 norm over all fields) with a single pass
+   * over the flattened array and a single scalar reduction.
    */
   void calc_ref_vals(const Array<OneD, const NekDouble> &in_arr) {
+    NekDouble norm =
+        Vmath::Dot(this->n_fields * this->n_pts, in_arr, in_arr);
+    this->comm->GetSpaceComm()->AllReduce(norm, LU::ReduceSum);
+    this->array_norm = norm;
+  }
 
-    Array<OneD, NekDouble> fld_array_norms(this->n_fields, 0.0);
+  /**
+   * Residual evaluation called by the Newton solver once per Newton
+   * iteration. Tracks when the block Jacobi preconditioner needs rebuilding.
+   */
+  void newton_res_eval(const Array<OneD, const NekDouble> &in_arr_flat,
+                       Array<OneD, NekDouble> &out_arr_flat, const bool &flag) {
+    if (++this->newton_its_since_build > this->precon_refresh ||
+        this->precon_lambda != this->time_int_lambda) {
+      this->precon_stale = true;
+    }
+    non_lin_sys_evaluator_1D(in_arr_flat, out_arr_flat, flag);
+  }
 
-    // Compute array norm for each field
-    for (auto ifld = 0; ifld < this->n_fields; ++ifld) {
-      int offset = ifld * this->n_pts;
-      fld_array_norms[ifld] =
-          Vmath::Dot(this->n_pts, in_arr + offset, in_arr + offset);
+  /**
+   * Index in the flattened solution array of entry @p k of element block
+   * @p ie. Blocks are ordered field-major, matching the flattened layout.
+   */
+  inline std::size_t block_dof(const int ie, const int k) const {
+    const int npe = this->elmt_n_pts[ie];
+    return static_cast<std::size_t>(k / npe) * this->n_pts +
+           this->elmt_phys_offsets[ie] + (k % npe);
+  }
+
+  /**
+   * Set up element colouring and block storage for the block Jacobi
+   * preconditioner.
+   */
+  void init_block_jacobi() {
+    auto fld = this->fields[0];
+    const int n_elmts = fld->GetExpSize();
+    this->elmt_phys_offsets.resize(n_elmts);
+    this->elmt_n_pts.resize(n_elmts);
+    this->block_offsets.resize(n_elmts);
+    this->pivot_offsets.resize(n_elmts);
+    this->elmt_colours.assign(n_elmts, -1);
+
+    std::size_t block_storage = 0;
+    std::size_t pivot_storage = 0;
+    int local_max_block_size = 0;
+    for (int ie = 0; ie < n_elmts; ++ie) {
+      this->elmt_phys_offsets[ie] = fld->GetPhys_Offset(ie);
+      this->elmt_n_pts[ie] = fld->GetExp(ie)->GetTotPoints();
+      const int block_size = this->n_fields * this->elmt_n_pts[ie];
+      this->block_offsets[ie] = block_storage;
+      this->pivot_offsets[ie] = pivot_storage;
+      block_storage += static_cast<std::size_t>(block_size) * block_size;
+      pivot_storage += block_size;
+      local_max_block_size = std::max(local_max_block_size, block_size);
     }
-    this->comm->GetSpaceComm()->AllReduce(fld_array_norms, LU::ReduceSum);
+    this->block_lu.resize(block_storage);
+    this->block_pivots.resize(pivot_storage);
+    this->block_work.resize(local_max_block_size);
 
-    // Sum over all fields
-    this->array_norm = 0.0;
-    for (auto ifld = 0; ifld < this->n_fields; ++ifld) {
-      this->array_norm += fld_array_norms[ifld];
+    /*
+     * Greedy colouring such that elements sharing a vertex have different
+     * colours. Perturbing every element of one colour at once then only
+     * pollutes the extracted blocks through non-local couplings (e.g. the
+     * potential solve), which the preconditioner tolerates.
+     */
+    std::map<int, std::vector<int>> vertex_to_elmts;
+    for (int ie = 0; ie < n_elmts; ++ie) {
+      auto geom = fld->GetExp(ie)->GetGeom();
+      for (int iv = 0; iv < geom->GetNumVerts(); ++iv) {
+        vertex_to_elmts[geom->GetVid(iv)].push_back(ie);
+      }
+    }
+    int local_n_colours = 0;
+    for (int ie = 0; ie < n_elmts; ++ie) {
+      std::set<int> used;
+      auto geom = fld->GetExp(ie)->GetGeom();
+      for (int iv = 0; iv < geom->GetNumVerts(); ++iv) {
+        for (auto je : vertex_to_elmts[geom->GetVid(iv)]) {
+          used.insert(this->elmt_colours[je]);
+        }
+      }
+      int colour = 0;
+      while (used.count(colour)) {
+        colour++;
+      }
+      this->elmt_colours[ie] = colour;
+      local_n_colours = std::max(local_n_colours, colour + 1);
+    }
+
+    // Every rank must make the same number of (collective) RHS evaluations
+    this->n_colours = local_n_colours;
+    this->max_block_size = local_max_block_size;
+    this->comm->GetSpaceComm()->AllReduce(this->n_colours, LU::ReduceMax);
+    this->comm->GetSpaceComm()->AllReduce(this->max_block_size, LU::ReduceMax);
+  }
+
+  /**
+   * Rebuild the element blocks of the Jacobian of the non-linear residual
+   * about the current Newton iterate by finite differences, then LU-factorise
+   * them with LAPACK. Costs n_colours * max_block_size residual evaluations.
+   * The RHS operators are only available as a residual evaluation, hence the
+   * blocks cannot be formed from an analytic local Jacobian.
+   */
+  void build_block_jacobi() {
+    const Array<OneD, const NekDouble> ref_sln =
+        this->non_lin_solver->GetRefSolution();
+    const Array<OneD, const NekDouble> ref_res =
+        this->non_lin_solver->GetRefResidual();
+    const unsigned int n_tot = ref_sln.size();
+    const int n_elmts = this->elmt_colours.size();
+
+    Array<OneD, NekDouble> &soln_plus = this->soln_plus;
+    Array<OneD, NekDouble> &res_plus = this->res_plus;
+    std::vector<NekDouble> elmt_eps(n_elmts);
+
+    for (int colour = 0; colour < this->n_colours; ++colour) {
+      for (int k = 0; k < this->max_block_size; ++k) {
+        Vmath::Vcopy(n_tot, ref_sln, 1, soln_plus, 1);
+        for (int ie = 0; ie < n_elmts; ++ie) {
+          if (this->elmt_colours[ie] == colour &&
+              k < this->n_fields * this->elmt_n_pts[ie]) {
+            const std::size_t idx = block_dof(ie, k);
+            elmt_eps[ie] =
+                this->jacobi_free_eps * std::max(1.0, std::abs(ref_sln[idx]));
+            soln_plus[idx] += elmt_eps[ie];
+          }
+        }
+        non_lin_sys_evaluator_1D(soln_plus, res_plus, false);
+        for (int ie = 0; ie < n_elmts; ++ie) {
+          const int block_size = this->n_fields * this->elmt_n_pts[ie];
+          if (this->elmt_colours[ie] == colour && k < block_size) {
+            NekDouble *col = this->block_lu.data() + this->block_offsets[ie] +
+                             static_cast<std::size_t>(k) * block_size;
+            for (int r = 0; r < block_size; ++r) {
+              const std::size_t idx = block_dof(ie, r);
+              col[r] = (res_plus[idx] - ref_res[idx]) / elmt_eps[ie];
+            }
+          }
+        }
+      }
+    }
+
+    for (int ie = 0; ie < n_elmts; ++ie) {
+      const int block_size = this->n_fields * this->elmt_n_pts[ie];
+      int info = 0;
+      Lapack::Dgetrf(block_size, block_size,
+                     this->block_lu.data() + this->block_offsets[ie],
+                     block_size,
+                     this->block_pivots.data() + this->pivot_offsets[ie],
+                     info);
+      NESOASSERT(info == 0, "ImplicitHelper: singular block in block Jacobi "
+                            "preconditioner.");
+    }
+
+    this->precon_stale = false;
+    this->precon_lambda = this->time_int_lambda;
+    this->newton_its_since_build = 0;
+    this->precon_builds++;
+  }
+
+  /**
+   * Element block Jacobi preconditioner. The blocks are rebuilt lazily every
+   * PreconMatFreezNumb Newton iterations, or when lambda changes.
+   */
+  void do_block_jacobi_precon(const Array<OneD, const NekDouble> &in_arr,
+                              Array<OneD, NekDouble> &out_arr,
+                              [[maybe_unused]] const bool &flag) {
+    if (this->precon_stale) {
+      build_block_jacobi();
+    }
+    const int n_elmts = this->elmt_colours.size();
+    NekDouble *local = this->block_work.data();
+    for (int ie = 0; ie < n_elmts; ++ie) {
+      const int block_size = this->n_fields * this->elmt_n_pts[ie];
+      for (int k = 0; k < block_size; ++k) {
+        local[k] = in_arr[block_dof(ie, k)];
+      }
+      int info = 0;
+      Lapack::Dgetrs('N', block_size, 1,
+                     this->block_lu.data() + this->block_offsets[ie],
+                     block_size,
+                     this->block_pivots.data() + this->pivot_offsets[ie],
+                     local, block_size, info);
+      for (int k = 0; k < block_size; ++k) {
+        out_arr[block_dof(ie, k)] = local[k];
+      }
     }
   }
 
@@ -175,21 +429,21 @@ protected:
   }
 
   /**
-   * Roll up flattened in/out arrays and pass them to the system evaluator.
-   * Used by the Matrix-Free operator.
+   * Point the (preallocated) per-field views at the flattened in/out arrays
+   * and pass them to the system evaluator; no data is copied. The input is
+   * wrapped rather than offset, as assigning an offset const Array to a
+   * non-const Array copies it. Used by the Matrix-Free operator.
    */
-  void non_lin_sys_evaluator_1D(const Array<OneD, const NekDouble> &in_arr_flat,
-                                Array<OneD, NekDouble> &out_arr_flat,
+  void non_lin_sys_evaluator_1D(const Array<OneD, const NekDouble> &in_flat,
+                                Array<OneD, NekDouble> &out_flat,
                                 [[maybe_unused]] const bool &flag) {
-    // Copy in/out values in field-indexed arrays
-    Array<OneD, Array<OneD, NekDouble>> in_arr(this->n_fields);
-    Array<OneD, Array<OneD, NekDouble>> out_arr(this->n_fields);
     for (auto ifld = 0; ifld < this->n_fields; ++ifld) {
       int offset = ifld * this->n_pts;
-      in_arr[ifld] = in_arr_flat + offset;
-      out_arr[ifld] = out_arr_flat + offset;
+      this->in_views[ifld] = Array<OneD, NekDouble>(
+          this->n_pts, const_cast<NekDouble *>(in_flat.data()) + offset, true);
+      this->out_views[ifld] = out_flat + offset;
     }
-    non_lin_sys_evaluator(in_arr, out_arr);
+    non_lin_sys_evaluator(this->in_views, this->out_views);
   }
 
   /**
@@ -199,23 +453,21 @@ protected:
   non_lin_sys_evaluator(const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
                         Array<OneD, Array<OneD, NekDouble>> &out_arr) {
 
-    // Zero temporary array
-    for (int ifld = 0; ifld < this->n_fields; ++ifld) {
-      Vmath::Zero(this->n_pts, this->projected_in_arr[ifld], 1);
-    }
-
-    // Do projection, then evaluate RHS
+    // Do projection (which writes every point, so no zeroing is needed),
+    // then evaluate RHS
     this->ode.DoProjection(in_arr, this->projected_in_arr, this->time);
     this->ode.DoOdeRhs(this->projected_in_arr, out_arr, this->time);
 
+    // u_{i+1} = u_i - lambda*rhs - ref_source, in a single pass per field
+    const NekDouble *ref_src = this->non_lin_solver->GetRefSourceVec().data();
+    const NekDouble lambda = this->time_int_lambda;
     for (int ifld = 0; ifld < this->n_fields; ++ifld) {
-      // u_{i+1} = u_i - lambda*rhs
-      Vmath::Svtvp(this->n_pts, -this->time_int_lambda, out_arr[ifld], 1,
-                   in_arr[ifld], 1, out_arr[ifld], 1);
-      // Subtract reference source vector
-      Vmath::Vsub(this->n_pts, out_arr[ifld], 1,
-                  this->non_lin_solver->GetRefSourceVec() + ifld * this->n_pts,
-                  1, out_arr[ifld], 1);
+      const NekDouble *u = in_arr[ifld].data();
+      const NekDouble *src = ref_src + ifld * this->n_pts;
+      NekDouble *out = out_arr[ifld].data();
+      for (unsigned int i = 0; i < this->n_pts; ++i) {
+        out[i] = u[i] - lambda * out[i] - src[i];
+      }
     }
   }
 
@@ -233,13 +485,17 @@ protected:
     NekDouble eps = this->jacobi_free_eps *
                     sqrt((sqrt(this->array_norm) + 1.0) / magninarray);
 
-    Array<OneD, NekDouble> soln_plus{n_tot};
-    Array<OneD, NekDouble> res_plus{n_tot};
+    Vmath::Svtvp(n_tot, eps, in_arr, 1, ref_sln, 1, this->soln_plus, 1);
+    non_lin_sys_evaluator_1D(this->soln_plus, this->res_plus, flag);
 
-    Vmath::Svtvp(n_tot, eps, in_arr, 1, ref_sln, 1, soln_plus, 1);
-    non_lin_sys_evaluator_1D(soln_plus, res_plus, flag);
-    Vmath::Vsub(n_tot, res_plus, 1, ref_res, 1, out, 1);
-    Vmath::Smul(n_tot, 1.0 / eps, out, 1, out, 1);
+    // out = (res_plus - ref_res) / eps
+    const NekDouble inv_eps = 1.0 / eps;
+    const NekDouble *k_res_plus = this->res_plus.data();
+    const NekDouble *k_ref_res = ref_res.data();
+    NekDouble *k_out = out.data();
+    for (unsigned int i = 0; i < n_tot; ++i) {
+      k_out[i] = (k_res_plus[i] - k_ref_res[i]) * inv_eps;
+    }
   }
 };
 
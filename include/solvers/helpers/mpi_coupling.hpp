@@ -0,0 +1,657 @@
+#ifndef __SOLVER_MPICOUPLING_H_
+#define __SOLVER_MPICOUPLING_H_
+
+#include <LibUtilities/Communication/CommMpi.h>
+#include <MultiRegions/ExpList.h>
+#include <SolverUtils/Core/Coupling.h>
+#include <mpi.h>
+#include <nektar_interface/utilities.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace LU = Nektar::LibUtilities;
+namespace MR = Nektar::MultiRegions;
+namespace SU = Nektar::SolverUtils;
+
+namespace NESO::Solvers {
+
+/**
+ * Registry of applications launched together in a single (MPMD) MPI job,
+ * e.g.
+ *
+ *   mpirun -np 2 Diffusion --couple A a.xml : -np 2 Diffusion --couple B b.xml
+ *
+ * MPI_COMM_WORLD is split into one communicator per application, and the
+ * lowest world rank of each application is recorded so that
+ * intercommunicators can be created between them.
+ */
+class CoupledApps {
+public:
+  /// Command line flag used to name the application on this rank.
+  static constexpr const char *cmd_line_flag = "--couple";
+
+  /// Name of the application on this rank.
+  std::string name;
+  /// Communicator containing only the ranks of this application.
+  MPI_Comm comm = MPI_COMM_NULL;
+  /// Lowest rank in MPI_COMM_WORLD of each application, indexed by name.
+  std::map<std::string, int> leaders;
+
+  /// @returns The process-wide registry.
+  static CoupledApps &get() {
+    static CoupledApps instance;
+    return instance;
+  }
+
+  /// @returns True if MPI_COMM_WORLD has been split between applications.
+  inline bool is_split() const { return this->comm != MPI_COMM_NULL; }
+
+  /**
+   * Remove "--couple <name>" from a set of command line arguments.
+   *
+   * @param argc Number of arguments.
+   * @param argv Arguments.
+   * @param[out] app_name Application name; empty if the flag is not present.
+   * @returns Remaining arguments, followed by a null pointer.
+   */
+  static inline std::vector<char *> strip_args(int argc, char **argv,
+                                               std::string &app_name) {
+    std::vector<char *> args;
+    app_name.clear();
+    for (int ia = 0; ia < argc; ia++) {
+      if (std::strcmp(argv[ia], cmd_line_flag) == 0) {
+        NESOASSERT(ia + 1 < argc, std::string(cmd_line_flag) +
+                                      " requires an application name.");
+        app_name = argv[++ia];
+      } else {
+        args.push_back(argv[ia]);
+      }
+    }
+    args.push_back(nullptr);
+    return args;
+  }
+
+  /**
+   * Identify session files (.xml, .xml.gz, .nekg) in a set of arguments.
+   *
+   * @param args Null-terminated arguments, as returned by strip_args.
+   * @returns Session file names, in order.
+   */
+  static inline std::vector<std::string>
+  get_session_filenames(const std::vector<char *> &args) {
+    auto ends_with = [](const std::string &s, const std::string &suffix) {
+      return s.size() >= suffix.size() &&
+             s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    std::vector<std::string> filenames;
+    for (std::size_t ia = 1; ia + 1 < args.size(); ia++) {
+      const std::string arg(args[ia]);
+      if (ends_with(arg, ".xml") || ends_with(arg, ".xml.gz") ||
+          ends_with(arg, ".nekg")) {
+        filenames.push_back(arg);
+      }
+    }
+    return filenames;
+  }
+
+  /**
+   * Split MPI_COMM_WORLD by application name. Collective on MPI_COMM_WORLD.
+   *
+   * @param app_name Name of the application on this rank.
+   */
+  inline void split(const std::string &app_name) {
+    NESOASSERT(!this->is_split(), "CoupledApps: split called twice.");
+    int rank, size;
+    MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+    MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+    int max_len = app_name.size() + 1;
+    MPICHK(MPI_Allreduce(MPI_IN_PLACE, &max_len, 1, MPI_INT, MPI_MAX,
+                         MPI_COMM_WORLD));
+    std::vector<char> local_name(max_len, '\0');
+    std::copy(app_name.begin(), app_name.end(), local_name.begin());
+    std::vector<char> all_names(static_cast<std::size_t>(max_len) * size);
+    MPICHK(MPI_Allgather(local_name.data(), max_len, MPI_CHAR,
+                         all_names.data(), max_len, MPI_CHAR,
+                         MPI_COMM_WORLD));
+
+    this->leaders.clear();
+    for (int rx = 0; rx < size; rx++) {
+      const std::string name_rx(all_names.data() +
+                                static_cast<std::size_t>(rx) * max_len);
+      if (!this->leaders.count(name_rx)) {
+        this->leaders[name_rx] = rx;
+      }
+    }
+
+    this->name = app_name;
+    MPICHK(MPI_Comm_split(MPI_COMM_WORLD, this->leaders.at(app_name), rank,
+                          &this->comm));
+  }
+
+  /**
+   * Free the communicator of this application and forget the split, after
+   * which split may be called again. Collective over the ranks of this
+   * application.
+   */
+  inline void free() {
+    if (this->is_split()) {
+      MPICHK(MPI_Comm_free(&this->comm));
+      this->comm = MPI_COMM_NULL;
+    }
+    this->name.clear();
+    this->leaders.clear();
+  }
+
+  /**
+   * Create an intercommunicator between this application and another.
+   * Collective over the ranks of both applications.
+   *
+   * @param remote_name Name of the remote application.
+   * @returns New intercommunicator; the caller should free it.
+   */
+  inline MPI_Comm create_intercomm(const std::string &remote_name) const {
+    NESOASSERT(this->is_split(), "CoupledApps: MPI_COMM_WORLD has not been "
+                                 "split; pass " +
+                                     std::string(cmd_line_flag) +
+                                     " <name> on the command line.");
+    NESOASSERT(this->leaders.count(remote_name),
+               "CoupledApps: no application named '" + remote_name + "'.");
+    const int local_leader = this->leaders.at(this->name);
+    const int remote_leader = this->leaders.at(remote_name);
+    // Both sides must agree on the tag.
+    const int tag = std::min(local_leader, remote_leader);
+    MPI_Comm intercomm;
+    MPICHK(MPI_Intercomm_create(this->comm, 0, MPI_COMM_WORLD, remote_leader,
+                                tag, &intercomm));
+    return intercomm;
+  }
+};
+
+/**
+ * Nektar++ MPI communicator over an application's share of MPI_COMM_WORLD.
+ * Exists only to expose the (protected) CommMpi constructor that wraps an
+ * existing MPI communicator.
+ */
+class CoupledCommMpi : public LU::CommMpi {
+public:
+  CoupledCommMpi(MPI_Comm comm) : LU::CommMpi(comm) {}
+};
+
+/**
+ * Built-in alternative to the CWIPI coupling, selected with
+ *
+ *   <COUPLING NAME="this-app" TYPE="MPI"> ... </COUPLING>
+ *
+ * and the same RemoteName, SendSteps, SendVariables, ReceiveSteps and
+ * ReceiveVariables properties. Each application must be started with
+ * "--couple <NAME>".
+ *
+ * On initialisation, the quadrature points of each side are located in the
+ * other side's mesh, and the weights that interpolate from an element's
+ * quadrature points to each located point are stored. An exchange is then a
+ * weighted sum per point on the sending side, followed by non-blocking
+ * point-to-point messages over an intercommunicator. Receives for the next
+ * exchange are posted as soon as the previous one completes, and sends are
+ * only completed before the send buffer is next reused, so exchanges overlap
+ * with the solve.
+ */
+class MPICoupling : public SU::Coupling {
+public:
+  friend class Nektar::MemoryManager<MPICoupling>;
+
+  /// Creates an instance of this class
+  static SU::CouplingSharedPtr create(MR::ExpListSharedPtr field) {
+    SU::CouplingSharedPtr p =
+        Nektar::MemoryManager<MPICoupling>::AllocateSharedPtr(field);
+    p->Init();
+    return p;
+  }
+
+  /// Name of the class
+  inline static std::string class_name =
+      SU::GetCouplingFactory().RegisterCreatorFunction(
+          "MPI", MPICoupling::create, "Built-in MPI coupling");
+
+  virtual ~MPICoupling() { v_Finalize(); }
+
+  /// @returns Number of local points that were not found in the remote mesh.
+  inline int get_num_unlocated_points() const { return this->num_unlocated; }
+
+protected:
+  MPICoupling(MR::ExpListSharedPtr field) : SU::Coupling(field) {
+    m_config["REMOTENAME"] = "";
+    m_config["TOLERANCE"] = "1e-8";
+    // Accepted for compatibility with CWIPI configurations; values are always
+    // interpolated from the sending field.
+    m_config["SENDMETHOD"] = "EVALUATE";
+  }
+
+  /// Message tag used for field exchanges.
+  static constexpr int exchange_tag = 4207;
+
+  MPI_Comm intercomm = MPI_COMM_NULL;
+  int remote_size = 0;
+  int num_unlocated = 0;
+
+  /// Per remote rank offsets into src_phys_offsets (remote_size + 1).
+  std::vector<int> src_rank_offsets;
+  /// Element phys offset and weight offset of each point served remotely.
+  std::vector<int> src_phys_offsets;
+  std::vector<std::size_t> src_weight_offsets;
+  std::vector<int> src_num_weights;
+  std::vector<NekDouble> src_weights;
+
+  /// Per remote rank offsets into tgt_points (remote_size + 1).
+  std::vector<int> tgt_rank_offsets;
+  /// Local point index of each value received.
+  std::vector<int> tgt_points;
+
+  std::vector<NekDouble> send_buf;
+  std::vector<NekDouble> recv_buf;
+  std::vector<MPI_Request> send_requests;
+  std::vector<MPI_Request> recv_requests;
+  bool recvs_posted = false;
+
+  virtual void v_Init() override {
+    SU::Coupling::v_Init();
+
+    const std::string remote_name = m_config["REMOTENAME"];
+    NESOASSERT(!remote_name.empty(),
+               "MPICoupling: the RemoteName property must be set.");
+    auto &apps = CoupledApps::get();
+    NESOASSERT(apps.is_split() && apps.name == m_couplingName,
+               "MPICoupling: run with '" +
+                   std::string(CoupledApps::cmd_line_flag) + " " +
+                   m_couplingName + "' to use coupling '" + m_couplingName +
+                   "'.");
+
+    this->intercomm = apps.create_intercomm(remote_name);
+    MPICHK(MPI_Comm_remote_size(this->intercomm, &this->remote_size));
+
+    // Both directions are set up in the same order on both sides.
+    const bool first =
+        apps.leaders.at(apps.name) < apps.leaders.at(remote_name);
+    setup_direction(first);
+    setup_direction(!first);
+
+    int local_unlocated = this->num_unlocated;
+    MPI_Comm local_comm = apps.comm;
+    MPICHK(MPI_Allreduce(&local_unlocated, &this->num_unlocated, 1, MPI_INT,
+                         MPI_SUM, local_comm));
+    int rank;
+    MPICHK(MPI_Comm_rank(local_comm, &rank));
+    if ((rank == 0) && (this->num_unlocated > 0)) {
+      nprint("MPICoupling:", this->num_unlocated,
+             "points were not found in the mesh of", remote_name,
+             "and will not be updated by received values.");
+    }
+  }
+
+  virtual void
+  v_Send(const int step, [[maybe_unused]] const NekDouble time,
+         const Array<OneD, const Array<OneD, NekDouble>> &field,
+         std::vector<std::string> &var_names) override {
+    if (m_nSendVars < 1 || m_sendSteps < 1 || step % m_sendSteps) {
+      return;
+    }
+    const std::vector<int> var_map = map_variables(var_names, m_sendVarNames);
+    const int nvars = var_map.size();
+    const int npts = this->src_phys_offsets.size();
+
+    // The previous exchange must complete before the buffer is reused.
+    wait_all(this->send_requests);
+    this->send_buf.resize(static_cast<std::size_t>(nvars) * npts);
+
+    for (int rx = 0; rx < this->remote_size; rx++) {
+      const int start = this->src_rank_offsets[rx];
+      const int count = this->src_rank_offsets[rx + 1] - start;
+      if (count == 0) {
+        continue;
+      }
+      NekDouble *buf = this->send_buf.data() +
+                       static_cast<std::size_t>(start) * nvars;
+      for (int vx = 0; vx < nvars; vx++) {
+        const NekDouble *phys = field[var_map[vx]].data();
+        for (int px = 0; px < count; px++) {
+          const int ix = start + px;
+          const NekDouble *w = this->src_weights.data() +
+                               this->src_weight_offsets[ix];
+          const NekDouble *p = phys + this->src_phys_offsets[ix];
+          NekDouble value = 0.0;
+          for (int wx = 0; wx < this->src_num_weights[ix]; wx++) {
+            value += w[wx] * p[wx];
+          }
+          buf[vx * count + px] = value;
+        }
+      }
+      this->send_requests.emplace_back();
+      MPICHK(MPI_Isend(buf, nvars * count, MPI_DOUBLE, rx, exchange_tag,
+                       this->intercomm, &this->send_requests.back()));
+    }
+  }
+
+  virtual void v_Receive(const int step,
+                         [[maybe_unused]] const NekDouble time,
+                         Array<OneD, Array<OneD, NekDouble>> &field,
+                         std::vector<std::string> &var_names) override {
+    if (m_nRecvVars < 1 || m_recvSteps < 1 || step % m_recvSteps) {
+      return;
+    }
+    const std::vector<int> var_map = map_variables(var_names, m_recvVarNames);
+    const int nvars = var_map.size();
+
+    if (!this->recvs_posted) {
+      post_receives();
+    }
+    wait_all(this->recv_requests);
+    this->recvs_posted = false;
+
+    for (int rx = 0; rx < this->remote_size; rx++) {
+      const int start = this->tgt_rank_offsets[rx];
+      const int count = this->tgt_rank_offsets[rx + 1] - start;
+      const NekDouble *buf =
+          this->recv_buf.data() + static_cast<std::size_t>(start) * nvars;
+      for (int vx = 0; vx < nvars; vx++) {
+        NekDouble *phys = field[var_map[vx]].data();
+        for (int px = 0; px < count; px++) {
+          phys[this->tgt_points[start + px]] = buf[vx * count + px];
+        }
+      }
+    }
+
+    // Post the receives for the next exchange so that they overlap with the
+    // solve.
+    post_receives();
+  }
+
+  virtual void v_Finalize() override {
+    int finalised;
+    MPICHK(MPI_Finalized(&finalised));
+    if (finalised || this->intercomm == MPI_COMM_NULL) {
+      return;
+    }
+    wait_all(this->send_requests);
+    for (auto &request : this->recv_requests) {
+      MPICHK(MPI_Cancel(&request));
+      MPICHK(MPI_Wait(&request, MPI_STATUS_IGNORE));
+    }
+    this->recv_requests.clear();
+    MPICHK(MPI_Comm_free(&this->intercomm));
+    this->intercomm = MPI_COMM_NULL;
+  }
+
+  static inline void wait_all(std::vector<MPI_Request> &requests) {
+    if (requests.size()) {
+      MPICHK(MPI_Waitall(requests.size(), requests.data(),
+                         MPI_STATUSES_IGNORE));
+      requests.clear();
+    }
+  }
+
+  /**
+   * Map the coupled variable names onto indices of the arrays passed to
+   * Send/Receive.
+   */
+  static inline std::vector<int>
+  map_variables(const std::vector<std::string> &var_names,
+                const std::vector<std::string> &coupled_names) {
+    std::vector<int> var_map;
+    for (auto &name : coupled_names) {
+      auto it = std::find(var_names.begin(), var_names.end(), name);
+      NESOASSERT(it != var_names.end(),
+                 "MPICoupling: coupled variable '" + name +
+                     "' was not passed to Send/Receive.");
+      var_map.push_back(std::distance(var_names.begin(), it));
+    }
+    return var_map;
+  }
+
+  inline void post_receives() {
+    const int nvars = m_nRecvVars;
+    this->recv_buf.resize(static_cast<std::size_t>(nvars) *
+                          this->tgt_points.size());
+    for (int rx = 0; rx < this->remote_size; rx++) {
+      const int start = this->tgt_rank_offsets[rx];
+      const int count = this->tgt_rank_offsets[rx + 1] - start;
+      if (count == 0) {
+        continue;
+      }
+      this->recv_requests.emplace_back();
+      MPICHK(MPI_Irecv(this->recv_buf.data() +
+                           static_cast<std::size_t>(start) * nvars,
+                       nvars * count, MPI_DOUBLE, rx, exchange_tag,
+                       this->intercomm, &this->recv_requests.back()));
+    }
+    this->recvs_posted = true;
+  }
+
+  /**
+   * Compute the weights that interpolate from the quadrature points of an
+   * element to a point with local coordinates @p lcoord. Quadrature points
+   * are a tensor product in collapsed coordinates, so the weights are
+   * products of 1D Lagrange interpolation weights.
+   */
+  inline void compute_weights(const int elmt,
+                              const Array<OneD, NekDouble> &lcoord) {
+    auto exp = m_evalField->GetExp(elmt);
+    const int ndim = exp->GetShapeDimension();
+    Array<OneD, NekDouble> eta(ndim);
+    exp->LocCoordToLocCollapsed(lcoord, eta);
+
+    std::vector<std::vector<NekDouble>> weights_1d(ndim);
+    for (int dx = 0; dx < ndim; dx++) {
+      const int nq = exp->GetNumPoints(dx);
+      Array<OneD, NekDouble> x(1, eta[dx]);
+      auto interp =
+          LU::PointsManager()[exp->GetBasis(dx)->GetPointsKey()]->GetI(x);
+      weights_1d[dx].resize(nq);
+      for (int qx = 0; qx < nq; qx++) {
+        weights_1d[dx][qx] = (*interp)(0, qx);
+      }
+    }
+
+    const int nq = exp->GetTotPoints();
+    this->src_phys_offsets.push_back(m_evalField->GetPhys_Offset(elmt));
+    this->src_weight_offsets.push_back(this->src_weights.size());
+    this->src_num_weights.push_back(nq);
+    for (int qx = 0; qx < nq; qx++) {
+      NekDouble w = 1.0;
+      int stride = 1;
+      for (int dx = 0; dx < ndim; dx++) {
+        const int nq_dx = weights_1d[dx].size();
+        w *= weights_1d[dx][(qx / stride) % nq_dx];
+        stride *= nq_dx;
+      }
+      this->src_weights.push_back(w);
+    }
+  }
+
+  /**
+   * Set up one direction of the exchange. Collective over the
+   * intercommunicator; the remote side calls this with the opposite value of
+   * @p is_source.
+   *
+   * @param is_source If true, this side locates the remote side's points and
+   * will send values; otherwise this side will receive values.
+   */
+  inline void setup_direction(const bool is_source) {
+    const NekDouble tol = std::stod(m_config["TOLERANCE"]);
+    const int nremote = this->remote_size;
+
+    // Bounding box of the local mesh (only meaningful on the source side).
+    std::vector<NekDouble> bbox = {
+        std::numeric_limits<NekDouble>::max(),
+        std::numeric_limits<NekDouble>::max(),
+        std::numeric_limits<NekDouble>::max(),
+        std::numeric_limits<NekDouble>::lowest(),
+        std::numeric_limits<NekDouble>::lowest(),
+        std::numeric_limits<NekDouble>::lowest()};
+    if (is_source) {
+      for (int ex = 0; ex < m_evalField->GetExpSize(); ex++) {
+        auto geom = m_evalField->GetExp(ex)->GetGeom();
+        for (int vx = 0; vx < geom->GetNumVerts(); vx++) {
+          NekDouble xyz[3];
+          geom->GetVertex(vx)->GetCoords(xyz[0], xyz[1], xyz[2]);
+          for (int dx = 0; dx < 3; dx++) {
+            bbox[dx] = std::min(bbox[dx], xyz[dx]);
+            bbox[dx + 3] = std::max(bbox[dx + 3], xyz[dx]);
+          }
+        }
+      }
+      for (int dx = 0; dx < 3; dx++) {
+        const NekDouble pad = 0.05 * (bbox[dx + 3] - bbox[dx]) + tol;
+        bbox[dx] -= pad;
+        bbox[dx + 3] += pad;
+      }
+    }
+    std::vector<NekDouble> remote_bboxes(6 * nremote);
+    MPICHK(MPI_Allgather(bbox.data(), 6, MPI_DOUBLE, remote_bboxes.data(), 6,
+                         MPI_DOUBLE, this->intercomm));
+
+    // Target side: send each local point to the source ranks whose bounding
+    // box contains it.
+    const int npts = m_evalField->GetTotPoints();
+    Array<OneD, NekDouble> x(npts, 0.0), y(npts, 0.0), z(npts, 0.0);
+    std::vector<std::vector<int>> candidates(nremote);
+    if (!is_source) {
+      m_evalField->GetCoords(x, y, z);
+      for (int px = 0; px < npts; px++) {
+        const NekDouble xyz[3] = {x[px], y[px], z[px]};
+        for (int rx = 0; rx < nremote; rx++) {
+          const NekDouble *bb = remote_bboxes.data() + 6 * rx;
+          bool inside = true;
+          for (int dx = 0; dx < 3; dx++) {
+            inside = inside && (xyz[dx] >= bb[dx]) && (xyz[dx] <= bb[dx + 3]);
+          }
+          if (inside) {
+            candidates[rx].push_back(px);
+          }
+        }
+      }
+    }
+
+    std::vector<int> send_counts(nremote, 0), recv_counts(nremote, 0);
+    for (int rx = 0; rx < nremote; rx++) {
+      send_counts[rx] = candidates[rx].size();
+    }
+    MPICHK(MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1,
+                        MPI_INT, this->intercomm));
+
+    auto exclusive_scan = [](const std::vector<int> &counts, const int scale) {
+      std::vector<int> offsets(counts.size() + 1, 0);
+      for (std::size_t ix = 0; ix < counts.size(); ix++) {
+        offsets[ix + 1] = offsets[ix] + scale * counts[ix];
+      }
+      return offsets;
+    };
+
+    // Exchange candidate point coordinates.
+    std::vector<int> send_offsets = exclusive_scan(send_counts, 3);
+    std::vector<int> recv_offsets = exclusive_scan(recv_counts, 3);
+    std::vector<NekDouble> send_coords(send_offsets.back());
+    std::vector<NekDouble> recv_coords(recv_offsets.back());
+    for (int rx = 0; rx < nremote; rx++) {
+      int ix = send_offsets[rx];
+      for (auto px : candidates[rx]) {
+        send_coords[ix++] = x[px];
+        send_coords[ix++] = y[px];
+        send_coords[ix++] = z[px];
+      }
+    }
+    std::vector<int> send_counts3(nremote), recv_counts3(nremote);
+    for (int rx = 0; rx < nremote; rx++) {
+      send_counts3[rx] = 3 * send_counts[rx];
+      recv_counts3[rx] = 3 * recv_counts[rx];
+    }
+    MPICHK(MPI_Alltoallv(send_coords.data(), send_counts3.data(),
+                         send_offsets.data(), MPI_DOUBLE, recv_coords.data(),
+                         recv_counts3.data(), recv_offsets.data(), MPI_DOUBLE,
+                         this->intercomm));
+
+    // Source side: try to locate each received point.
+    const int num_recv = recv_offsets.back() / 3;
+    std::vector<int> found(num_recv, 0);
+    std::vector<int> found_elmts(num_recv, -1);
+    std::vector<Array<OneD, NekDouble>> found_lcoords(num_recv);
+    const int coord_dim = m_evalField->GetCoordim(0);
+    for (int px = 0; px < num_recv; px++) {
+      Array<OneD, NekDouble> gcoord(3, 0.0);
+      for (int dx = 0; dx < 3; dx++) {
+        gcoord[dx] = recv_coords[3 * px + dx];
+      }
+      Array<OneD, NekDouble> lcoord(std::max(coord_dim, 3), 0.0);
+      const int elmt = m_evalField->GetExpIndex(gcoord, lcoord, tol);
+      if (elmt >= 0) {
+        found[px] = 1;
+        found_elmts[px] = elmt;
+        found_lcoords[px] = lcoord;
+      }
+    }
+
+    // Return the found flags to the target side.
+    std::vector<int> send_offsets1 = exclusive_scan(send_counts, 1);
+    std::vector<int> recv_offsets1 = exclusive_scan(recv_counts, 1);
+    std::vector<int> found_flags(send_offsets1.back());
+    MPICHK(MPI_Alltoallv(found.data(), recv_counts.data(),
+                         recv_offsets1.data(), MPI_INT, found_flags.data(),
+                         send_counts.data(), send_offsets1.data(), MPI_INT,
+                         this->intercomm));
+
+    // Target side: each point is served by the first rank that found it.
+    std::vector<int> chosen(send_offsets1.back(), 0);
+    if (!is_source) {
+      std::vector<int> served(npts, 0);
+      std::vector<std::vector<int>> served_points(nremote);
+      for (int rx = 0; rx < nremote; rx++) {
+        for (int cx = 0; cx < send_counts[rx]; cx++) {
+          const int ix = send_offsets1[rx] + cx;
+          const int px = candidates[rx][cx];
+          if (found_flags[ix] && !served[px]) {
+            served[px] = 1;
+            chosen[ix] = 1;
+            served_points[rx].push_back(px);
+          }
+        }
+      }
+      this->tgt_rank_offsets.assign(nremote + 1, 0);
+      this->tgt_points.clear();
+      for (int rx = 0; rx < nremote; rx++) {
+        this->tgt_points.insert(this->tgt_points.end(),
+                                served_points[rx].begin(),
+                                served_points[rx].end());
+        this->tgt_rank_offsets[rx + 1] = this->tgt_points.size();
+      }
+      this->num_unlocated = std::count(served.begin(), served.end(), 0);
+    }
+
+    // Tell the source side which points it serves.
+    std::vector<int> chosen_flags(num_recv, 0);
+    MPICHK(MPI_Alltoallv(chosen.data(), send_counts.data(),
+                         send_offsets1.data(), MPI_INT, chosen_flags.data(),
+                         recv_counts.data(), recv_offsets1.data(), MPI_INT,
+                         this->intercomm));
+
+    if (is_source) {
+      this->src_rank_offsets.assign(nremote + 1, 0);
+      for (int rx = 0; rx < nremote; rx++) {
+        for (int cx = 0; cx < recv_counts[rx]; cx++) {
+          const int px = recv_offsets1[rx] + cx;
+          if (chosen_flags[px]) {
+            compute_weights(found_elmts[px], found_lcoords[px]);
+          }
+        }
+        this->src_rank_offsets[rx + 1] = this->src_phys_offsets.size();
+      }
+    }
+  }
+};
+
+} // namespace NESO::Solvers
+
+#endif
@@ -6,6 +6,8 @@
 #include <SpatialDomains/MeshGraph.h>
 #include <SpatialDomains/MeshGraphIO.h>
 
+#include "helpers/mpi_coupling.hpp"
+
 namespace LU = Nektar::LibUtilities;
 namespace SD = Nektar::SpatialDomains;
 namespace SU = Nektar::SolverUtils;
@@ -29,8 +31,23 @@ public:
    *  @param argv Array of char* filenames (like for main).
    */
   SolverRunner(int argc, char **argv) {
-    // Create session reader.
-    this->session = LU::SessionReader::CreateInstance(argc, argv);
+    // Create session reader. If this rank is one of several coupled
+    // applications, the session only spans the ranks of this application.
+    std::string app_name;
+    std::vector<char *> args =
+        NESO::Solvers::CoupledApps::strip_args(argc, argv, app_name);
+    if (app_name.empty()) {
+      this->session = LU::SessionReader::CreateInstance(argc, argv);
+    } else {
+      auto &apps = NESO::Solvers::CoupledApps::get();
+      apps.split(app_name);
+      std::vector<std::string> filenames =
+          NESO::Solvers::CoupledApps::get_session_filenames(args);
+      LU::CommSharedPtr comm =
+          std::make_shared<NESO::Solvers::CoupledCommMpi>(apps.comm);
+      this->session = LU::SessionReader::CreateInstance(
+          args.size() - 1, args.data(), filenames, comm);
+    }
     // Read the mesh and create a MeshGraph object.
     this->graph = SD::MeshGraphIO::Read(this->session);
     // Create driver.
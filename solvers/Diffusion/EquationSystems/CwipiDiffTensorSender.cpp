@@ -33,7 +33,8 @@ void CwipiDiffTensorSender::v_InitObject(bool DeclareField) {
 }
 
 bool CwipiDiffTensorSender::v_PreIntegrate(int step) {
-  // Send diff tensor coeffs to the other cwipi-enabled exec (1st step only)
+  this->step_profiler->begin_step(step);
+  // Send diff tensor coeffs to the other coupled exec (1st step only)
   if (this->coupling && step == 0) {
     // Extract coeff values from map into a Nektar Array
     std::vector<std::string> fld_names = {"d00", "d01", "d11"};
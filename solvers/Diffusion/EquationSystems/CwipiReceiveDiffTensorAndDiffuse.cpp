@@ -31,7 +31,8 @@ void CwipiReceiveDiffTensorAndDiffuse::v_InitObject(bool DeclareField) {
 }
 
 bool CwipiReceiveDiffTensorAndDiffuse::v_PreIntegrate(int step) {
-  // Receive difftensor coeffs from the other cwipi-enabled exec (1st step only)
+  this->step_profiler->begin_step(step);
+  // Receive difftensor coeffs from the other coupled exec (1st step only)
   if (this->coupling && step == 0) {
     std::vector<std::string> fld_names = {"d00", "d01", "d11"};
     Nektar::Array<Nektar::OneD, Nektar::Array<Nektar::OneD, Nektar::NekDouble>>
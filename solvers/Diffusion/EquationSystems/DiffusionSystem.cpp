@@ -52,6 +52,8 @@ void DiffusionSystem::do_implicit_solve(
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time,
     const NekDouble lambda) {
   boost::ignore_unused(time);
+  StepProfilerRegion region(this->step_profiler, StepRegion::Solve,
+                            "DiffusionSystem::do_implicit_solve");
 
   // Update lambda factor
   this->helmsolve_factors[SR::eFactorLambda] = 1.0 / lambda / this->epsilon;
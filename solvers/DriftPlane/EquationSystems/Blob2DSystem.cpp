@@ -38,6 +38,8 @@ void Blob2DSystem::create_riemann_solver() {
 void Blob2DSystem::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "Blob2DSystem::explicit_time_int");
   const int ne_idx = this->field_to_index["ne"];
   const int w_idx = this->field_to_index["w"];
   const int phi_idx = this->field_to_index["phi"];
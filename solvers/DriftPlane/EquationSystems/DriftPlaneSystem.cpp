@@ -148,6 +148,8 @@ void DriftPlaneSystem::load_params() {
 }
 void DriftPlaneSystem::solve_phi(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::Solve,
+                            "DriftPlaneSystem::solve_phi");
 
   int w_idx = this->field_to_index["w"];
   int ph_idx = this->field_to_index.get_idx("ph");
@@ -65,8 +65,10 @@ public:
     // Output is enabled (on rank 0) if recording step is +ve
     this->output_enabled = this->rank == 0 && this->recording_step > 0;
 
-    // Energy calc assumes a 3D mesh for now; check that's satisfied
-    NESOASSERT(this->n->GetGraph()->GetMeshDimension() == 3,
+    // Energy calc assumes a 3D mesh (or a 2D mesh with a homogeneous 1D
+    // expansion in z) for now; check that's satisfied
+    NESOASSERT(this->n->GetGraph()->GetMeshDimension() == 3 ||
+                   this->n->GetExpType() == MR::e3DH1D,
                "GrowthRatesRecorder requires a 3D mesh.");
 
     // Check that n, w, phi all have the same number of quad points
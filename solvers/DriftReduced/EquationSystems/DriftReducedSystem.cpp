@@ -1,6 +1,8 @@
 #include <LibUtilities/BasicUtils/Vmath.hpp>
 #include <LibUtilities/TimeIntegration/TimeIntegrationScheme.h>
+#include <MultiRegions/ContField3DHomogeneous1D.h>
 #include <boost/core/ignore_unused.hpp>
+#include <nektar_interface/function_homogeneous_1d.hpp>
 
 #include "DriftReducedSystem.hpp"
 
@@ -78,24 +80,22 @@ void DriftReducedSystem::add_adv_terms(
 /**
  * @brief Add (density) source term via a Nektar session function.
  *
- * @details Looks for a function called "dens_src", evaluates it, and adds the
- * result to @p out_arr
+ * @details Looks for a function called "dens_src" and adds its values to
+ * @p out_arr. Point values are computed on the first call and cached, unless
+ * the expression depends on time.
  *
  * @param[out] out_arr RHS array to add the source too
- * @todo Check function exists, rather than relying on Nektar ASSERT
+ * @param time Current time
  */
 void DriftReducedSystem::add_density_source(
-    Array<OneD, Array<OneD, NekDouble>> &out_arr) {
+    Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
 
   int ne_idx = this->field_to_index["ne"];
-  int npts = GetNpoints();
-  Array<OneD, NekDouble> tmpx(npts), tmpy(npts), tmpz(npts);
-  m_fields[ne_idx]->GetCoords(tmpx, tmpy, tmpz);
-  Array<OneD, NekDouble> dens_src(npts, 0.0);
-  LU::EquationSharedPtr dens_src_func =
-      m_session->GetFunction("dens_src", ne_idx);
-  dens_src_func->Evaluate(tmpx, tmpy, tmpz, dens_src);
-  Vmath::Vadd(npts, out_arr[ne_idx], 1, dens_src, 1, out_arr[ne_idx], 1);
+  if (!this->dens_src) {
+    this->dens_src = std::make_shared<AnalyticSource>(
+        m_session, m_fields[ne_idx], "dens_src", ne_idx);
+  }
+  this->dens_src->add_to(out_arr[ne_idx], time);
 }
 
 /**
@@ -323,7 +323,7 @@ void DriftReducedSystem::load_params() {
 
   // ***Assumes field aligned with z-axis***
   // Magnetic field strength. Fix B = [0, 0, Bxy] for now
-  this->Bvec = std::vector<NekDouble>(m_graph->GetSpaceDimension(), 0);
+  this->Bvec = std::vector<NekDouble>(3, 0);
   m_session->LoadParameter("Bxy", this->Bvec[2], 0.1);
 
   // Coefficient factors for potential solve
@@ -337,6 +337,9 @@ void DriftReducedSystem::load_params() {
   // Reference number density
   m_session->LoadParameter("nRef", this->n_ref, 1.0);
 
+  // Interval, in RHS evaluations, between checks for non-finite field values
+  this->field_health_check = FieldHealthCheck::create(m_session);
+
   // Type of Riemann solver to use. Default = "Upwind"
   m_session->LoadSolverInfo("UpwindType", this->riemann_solver_type, "Upwind");
 
@@ -351,7 +354,7 @@ void DriftReducedSystem::load_params() {
   this->Bmag =
       std::sqrt(this->Bvec[0] * this->Bvec[0] + this->Bvec[1] * this->Bvec[1] +
                 this->Bvec[2] * this->Bvec[2]);
-  this->b_unit = std::vector<NekDouble>(m_graph->GetSpaceDimension());
+  this->b_unit = std::vector<NekDouble>(3);
   for (auto idim = 0; idim < this->b_unit.size(); idim++) {
     this->b_unit[idim] = (this->Bmag > 0) ? this->Bvec[idim] / this->Bmag : 0.0;
   }
@@ -365,6 +368,8 @@ void DriftReducedSystem::load_params() {
  */
 void DriftReducedSystem::solve_phi(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::Solve,
+                            "DriftReducedSystem::solve_phi");
 
   // Field indices
   int npts = GetNpoints();
@@ -381,14 +386,22 @@ void DriftReducedSystem::solve_phi(
   // Set coefficient factors
   factors[StdRegions::eFactorCoeffD00] = this->d00;
   factors[StdRegions::eFactorCoeffD11] = this->d11;
-  if (this->n_dims == 3) {
-    factors[StdRegions::eFactorCoeffD22] = this->d22;
-  }
 
   // Solve for phi. Output of this routine is in coefficient (spectral)
   // space, so backwards transform to physical space since we'll need that
   // for the advection step & computing drift velocity.
-  m_fields[phi_idx]->HelmSolve(rhs, m_fields[phi_idx]->UpdateCoeffs(), factors);
+  if (m_HomogeneousType == eHomogeneous1D) {
+    // One 2D solve per Fourier mode in z
+    Homogeneous1D::helm_solve(m_fields[phi_idx], rhs,
+                              m_fields[phi_idx]->UpdateCoeffs(), factors,
+                              this->d22);
+  } else {
+    if (this->n_dims == 3) {
+      factors[StdRegions::eFactorCoeffD22] = this->d22;
+    }
+    m_fields[phi_idx]->HelmSolve(rhs, m_fields[phi_idx]->UpdateCoeffs(),
+                                 factors);
+  }
   m_fields[phi_idx]->BwdTrans(m_fields[phi_idx]->GetCoeffs(),
                               m_fields[phi_idx]->UpdatePhys());
 }
@@ -406,6 +419,8 @@ void DriftReducedSystem::v_GenerateSummary(SU::SummaryList &s) {
 
   SU::AddSummaryItem(s, "Reference density", this->n_ref);
   SU::AddSummaryItem(s, "Density floor", this->n_floor_fac);
+  SU::AddSummaryItem(s, "Field health check interval",
+                     this->field_health_check->interval);
 
   SU::AddSummaryItem(s, "Riemann solver", this->riemann_solver_type);
   // Particle stuff
@@ -430,6 +445,12 @@ void DriftReducedSystem::v_InitObject(bool create_field) {
   }
   TimeEvoEqnSysBase::v_InitObject(create_field);
 
+  // A 2D mesh with a homogeneous 1D (Fourier) expansion in z is 3D
+  if (m_HomogeneousType == eHomogeneous1D) {
+    Homogeneous1D::check_field(m_fields[0]);
+    this->n_dims = 3;
+  }
+
   NESOASSERT(this->n_dims == 2 || this->n_dims == 3,
              "2DHW system requires a 2D or 3D mesh.");
 
@@ -440,8 +461,16 @@ void DriftReducedSystem::v_InitObject(bool create_field) {
   // discontinuous field, which is done via the hybridisable discontinuous
   // Galerkin (HDG) approach.
   int phi_idx = this->field_to_index["phi"];
-  m_fields[phi_idx] = Nektar::MemoryManager<MR::ContField>::AllocateSharedPtr(
-      m_session, m_graph, m_session->GetVariable(phi_idx), true, true);
+  if (m_HomogeneousType == eHomogeneous1D) {
+    m_fields[phi_idx] = Nektar::MemoryManager<MR::ContField3DHomogeneous1D>::
+        AllocateSharedPtr(m_session,
+                          m_fields[0]->GetHomogeneousBasis()->GetBasisKey(),
+                          m_LhomZ, m_useFFT, m_homogen_dealiasing, m_graph,
+                          m_session->GetVariable(phi_idx));
+  } else {
+    m_fields[phi_idx] = Nektar::MemoryManager<MR::ContField>::AllocateSharedPtr(
+        m_session, m_graph, m_session->GetVariable(phi_idx), true, true);
+  }
 
   // Create storage for advection velocities, parallel velocity difference,ExB
   // drift velocity, E field. These are 3D regardless of the mesh dimension.
@@ -520,7 +549,17 @@ void DriftReducedSystem::v_InitObject(bool create_field) {
     idx++;
   }
 
-  if (this->particles_enabled) {
+  if (this->particles_enabled && m_HomogeneousType == eHomogeneous1D) {
+    // Project and evaluate plane by plane
+    int low_order_project;
+    m_session->LoadParameter("low_order_project", low_order_project, 0);
+    NESOASSERT(!low_order_project,
+               "low_order_project is not supported for homogeneous 1D fields.");
+    this->particle_sys->setup_project_homogeneous(
+        m_fields[this->field_to_index["ne_src"]]);
+    this->particle_sys->setup_evaluate_ne_homogeneous(
+        m_fields[this->field_to_index["ne"]]);
+  } else if (this->particles_enabled) {
     // Set up object to project onto density source field
     int low_order_project;
     m_session->LoadParameter("low_order_project", low_order_project, 0);
@@ -550,6 +589,10 @@ bool DriftReducedSystem::v_PostIntegrate(int step) {
     this->particle_sys->write(step);
     this->particle_sys->write_source_fields();
   }
+  if (this->particles_enabled) {
+    this->particle_sys->update_load_metrics(step);
+    this->particle_sys->write_checkpoint(step);
+  }
   return UnsteadySystem::v_PostIntegrate(step);
 }
 
@@ -560,6 +603,7 @@ bool DriftReducedSystem::v_PostIntegrate(int step) {
  * @param step Time step number
  */
 bool DriftReducedSystem::v_PreIntegrate(int step) {
+  this->step_profiler->begin_step(step);
   if (this->particles_enabled) {
     // Integrate the particle system to the requested time.
     this->particle_sys->integrate(m_time + m_timestep, this->part_timestep);
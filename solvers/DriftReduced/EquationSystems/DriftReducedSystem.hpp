@@ -7,8 +7,10 @@
 #include <SolverUtils/EquationSystem.h>
 #include <SolverUtils/Forcing/Forcing.h>
 #include <SolverUtils/RiemannSolvers/RiemannSolver.h>
+#include <nektar_interface/field_health_check.hpp>
 #include <nektar_interface/solver_base/time_evolved_eqnsys_base.hpp>
 #include <nektar_interface/utilities.hpp>
+#include <solvers/helpers/analytic_source.hpp>
 #include <solvers/solver_callback_handler.hpp>
 
 #include "../ParticleSystems/NeutralParticleSystem.hpp"
@@ -50,6 +52,8 @@ protected:
   std::vector<NekDouble> Bvec{3};
   /// Magnitude of the magnetic field
   NekDouble Bmag;
+  /// Cached point values of the "dens_src" session function
+  AnalyticSourceSharedPtr dens_src;
   /// Normalised magnetic field vector
   std::vector<NekDouble> b_unit;
   /** Source fields cast to DisContFieldSharedPtr, indexed by name, for use in
@@ -60,6 +64,8 @@ protected:
   Array<OneD, Array<OneD, NekDouble>> Evec{3};
   /// Storage for ExB drift velocity
   Array<OneD, Array<OneD, NekDouble>> ExB_vel{3};
+  /// Periodic non-finite checks of the fields in the RHS evaluations
+  FieldHealthCheckSharedPtr field_health_check;
   /// Factor used to set the density floor (n_floor = n_floor_fac * n_ref)
   NekDouble n_floor_fac;
   /// Reference number density
@@ -77,7 +83,8 @@ protected:
       Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time,
       std::vector<std::string> eqn_labels = std::vector<std::string>());
 
-  void add_density_source(Array<OneD, Array<OneD, NekDouble>> &out_arr);
+  void add_density_source(Array<OneD, Array<OneD, NekDouble>> &out_arr,
+                          const NekDouble time);
 
   void add_particle_sources(std::vector<std::string> target_fields,
                             Array<OneD, Array<OneD, NekDouble>> &out_arr);
@@ -25,21 +25,18 @@ HW2DSystem::HW2DSystem(const LU::SessionReaderSharedPtr &session,
 void HW2DSystem::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
-
-#ifdef NESO_DEBUG
-  /**
-   * Check in_arr for NaN/inf (*very* slow).
-   * N.B. A similar check in UnsteadySystem::v_DoSolve only catches NaN.
-   */
-  for (auto &var : {"ne", "w"}) {
-    auto fidx = this->field_to_index[var];
-    for (auto ii = 0; ii < in_arr[fidx].size(); ii++) {
-      std::stringstream err_msg;
-      err_msg << "Found NaN/inf in field " << var;
-      NESOASSERT(std::isfinite(in_arr[fidx][ii]), err_msg.str().c_str());
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "HW2DSystem::explicit_time_int");
+
+  // Check in_arr for NaN/inf on every field_health_check_interval-th call
+  if (this->field_health_check->begin_stage()) {
+    for (auto &var : {"ne", "w"}) {
+      auto fidx = this->field_to_index[var];
+      this->field_health_check->check("HW2DSystem::explicit_time_int", var,
+                                      in_arr[fidx].data(), in_arr[fidx].size(),
+                                      m_fields[fidx]);
     }
   }
-#endif
 
   zero_out_array(out_arr);
 
@@ -106,9 +103,10 @@ void HW2DSystem::v_InitObject(bool DeclareField) {
   // Create diagnostic for recording growth rates
   if (this->diag_growth_rates_recording_enabled) {
     this->diag_growth_rates_recorder =
-        std::make_shared<GrowthRatesRecorder<MR::DisContField>>(
-            m_session, 2, this->discont_fields["ne"], this->discont_fields["w"],
-            this->discont_fields["phi"], GetNpoints(), this->alpha,
+        std::make_shared<GrowthRatesRecorder<MR::ExpList>>(
+            m_session, 2, m_fields[this->field_to_index["ne"]],
+            m_fields[this->field_to_index["w"]],
+            m_fields[this->field_to_index["phi"]], GetNpoints(), this->alpha,
             this->kappa);
   }
 }
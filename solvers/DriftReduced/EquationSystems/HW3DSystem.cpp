@@ -3,6 +3,7 @@
 #include <LibUtilities/BasicUtils/Vmath.hpp>
 #include <LibUtilities/TimeIntegration/TimeIntegrationScheme.h>
 #include <boost/core/ignore_unused.hpp>
+#include <nektar_interface/function_homogeneous_1d.hpp>
 
 namespace NESO::Solvers::DriftReduced {
 std::string HW3DSystem::class_name =
@@ -45,9 +46,18 @@ void HW3DSystem::calc_par_dyn_term(
   // Write phi-n into temporary input array
   Vmath::Vsub(npts, m_fields[phi_idx]->GetPhys(), 1, in_arr[ne_idx], 1,
               this->diff_in_arr[0], 1);
-  // Use diffusion object to calculate second deriv of phi-n in z direction
-  this->diffusion->Diffuse(1, diff_fields, this->diff_in_arr,
-                           this->diff_out_arr);
+  if (this->fci_operator) {
+    // Second deriv of phi-n along the magnetic field lines
+    this->fci_operator->grad2_par(this->diff_in_arr[0], this->diff_out_arr[0]);
+  } else if (m_HomogeneousType == eHomogeneous1D) {
+    // Second deriv of phi-n in z direction is diagonal in Fourier space
+    Homogeneous1D::deriv_zz(m_fields[ne_idx], this->diff_in_arr[0],
+                            this->diff_out_arr[0]);
+  } else {
+    // Use diffusion object to calculate second deriv of phi-n in z direction
+    this->diffusion->Diffuse(1, diff_fields, this->diff_in_arr,
+                             this->diff_out_arr);
+  }
   // Multiply by constants to compute term
   Vmath::Smul(npts, this->alpha, this->diff_out_arr[0], 1, this->par_dyn_term,
               1);
@@ -63,14 +73,16 @@ void HW3DSystem::calc_par_dyn_term(
 void HW3DSystem::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
-
-  // Check in_arr for NaNs
-  for (auto &var : {"ne", "w"}) {
-    auto fidx = this->field_to_index[var];
-    for (auto ii = 0; ii < in_arr[fidx].size(); ii++) {
-      std::stringstream err_msg;
-      err_msg << "Found NaN in field " << var;
-      NESOASSERT(std::isfinite(in_arr[fidx][ii]), err_msg.str().c_str());
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "HW3DSystem::explicit_time_int");
+
+  // Check in_arr for NaN/inf on every field_health_check_interval-th call
+  if (this->field_health_check->begin_stage()) {
+    for (auto &var : {"ne", "w"}) {
+      auto fidx = this->field_to_index[var];
+      this->field_health_check->check("HW3DSystem::explicit_time_int", var,
+                                      in_arr[fidx].data(), in_arr[fidx].size(),
+                                      m_fields[fidx]);
     }
   }
 
@@ -142,6 +154,8 @@ void HW3DSystem::load_params() {
   DriftReducedSystem::load_params();
   // Diffusion type
   m_session->LoadSolverInfo("DiffusionType", this->diff_type, "LDG");
+  // Parallel operator type
+  m_session->LoadSolverInfo("ParallelOperator", this->par_op_type, "Default");
 
   // physical constants
   constexpr NekDouble e = 1.6e-19;
@@ -206,11 +220,26 @@ void HW3DSystem::v_InitObject(bool DeclareField) {
   // Bind RHS function for time integration object
   m_ode.DefineOdeRhs(&HW3DSystem::explicit_time_int, this);
 
-  // Set up diffusion object
-  this->diffusion = SU::GetDiffusionFactory().CreateInstance(this->diff_type,
-                                                             this->diff_type);
-  this->diffusion->SetFluxVector(&HW3DSystem::get_flux_vector_diff, this);
-  this->diffusion->InitObject(m_session, m_fields);
+  // Set up diffusion object; not needed for a homogeneous 1D expansion in z,
+  // where the parallel dynamics term is computed spectrally
+  if (m_HomogeneousType != eHomogeneous1D) {
+    this->diffusion = SU::GetDiffusionFactory().CreateInstance(this->diff_type,
+                                                               this->diff_type);
+    this->diffusion->SetFluxVector(&HW3DSystem::get_flux_vector_diff, this);
+    this->diffusion->InitObject(m_session, m_fields);
+  }
+
+  // Set up the field-aligned parallel operator; stencils are built once here
+  if (this->par_op_type == "FCI") {
+    NESOASSERT(m_HomogeneousType == eHomogeneous1D,
+               "The FCI parallel operator requires a homogeneous 1D "
+               "expansion in z.");
+    this->fci_operator = FCIParallelOperator::create(
+        m_session, m_fields[this->field_to_index["ne"]], this->Bvec);
+  } else {
+    NESOASSERT(this->par_op_type == "Default",
+               "Unknown ParallelOperator: " + this->par_op_type);
+  }
 
   // Allocate temporary arrays used in the diffusion calc
   int npts = GetNpoints();
@@ -222,9 +251,10 @@ void HW3DSystem::v_InitObject(bool DeclareField) {
   // Create diagnostic for recording growth rates
   if (this->diag_growth_rates_recording_enabled) {
     this->diag_growth_rates_recorder =
-        std::make_shared<GrowthRatesRecorder<MR::DisContField>>(
-            m_session, 3, this->discont_fields["ne"], this->discont_fields["w"],
-            this->discont_fields["phi"], GetNpoints(), this->alpha,
+        std::make_shared<GrowthRatesRecorder<MR::ExpList>>(
+            m_session, 3, m_fields[this->field_to_index["ne"]],
+            m_fields[this->field_to_index["w"]],
+            m_fields[this->field_to_index["phi"]], GetNpoints(), this->alpha,
             this->kappa);
   }
 }
@@ -8,6 +8,7 @@
 #include <SolverUtils/Forcing/Forcing.h>
 #include <SolverUtils/RiemannSolvers/RiemannSolver.h>
 #include <nektar_interface/utilities.hpp>
+#include <solvers/helpers/fci_parallel_operator.hpp>
 #include <solvers/solver_callback_handler.hpp>
 
 #include "../Diagnostics/GrowthRatesRecorder.hpp"
@@ -72,6 +73,12 @@ private:
   // Diffusion object
   SU::DiffusionSharedPtr diffusion;
 
+  // Parallel operator type; "Default" or "FCI"
+  std::string par_op_type;
+
+  // Field-aligned parallel operator, if par_op_type is "FCI"
+  FCIParallelOperatorSharedPtr fci_operator;
+
   // Array for storage of parallel dynamics term
   Array<OneD, NekDouble> par_dyn_term;
 
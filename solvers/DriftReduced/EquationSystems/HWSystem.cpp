@@ -34,7 +34,7 @@ void HWSystem::calc_E_and_adv_vels(
 
   Vmath::Zero(npts, this->par_vel_elec, 1);
   // vAdv[iDim] = b[iDim]*v_par + v_ExB[iDim] for each species
-  for (auto iDim = 0; iDim < m_graph->GetSpaceDimension(); iDim++) {
+  for (auto iDim = 0; iDim < this->n_dims; iDim++) {
     Vmath::Svtvp(npts, this->b_unit[iDim], this->par_vel_elec, 1,
                  this->ExB_vel[iDim], 1, this->adv_vel_elec[iDim], 1);
   }
@@ -77,8 +77,8 @@ void HWSystem::v_InitObject(bool DeclareField) {
 
   // Create diagnostic for recording fluid and particles masses
   if (this->diag_mass_recording_enabled) {
-    this->diag_mass_recorder = std::make_shared<MassRecorder<MR::DisContField>>(
-        m_session, this->particle_sys, this->discont_fields["ne"]);
+    this->diag_mass_recorder = std::make_shared<MassRecorder<MR::ExpList>>(
+        m_session, this->particle_sys, m_fields[this->field_to_index["ne"]]);
   }
 }
 
@@ -86,6 +86,8 @@ void HWSystem::v_InitObject(bool DeclareField) {
  * @brief Compute diagnostics, if enabled, then call base class member func.
  */
 bool HWSystem::v_PostIntegrate(int step) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                            "HWSystem::diagnostics");
   if (this->diag_growth_rates_recording_enabled) {
     this->diag_growth_rates_recorder->compute(step);
   }
@@ -93,6 +95,7 @@ bool HWSystem::v_PostIntegrate(int step) {
   if (this->diag_mass_recording_enabled) {
     this->diag_mass_recorder->compute(step);
   }
+  region.end();
 
   this->solver_callback_handler.call_post_integrate(this);
   return DriftReducedSystem::v_PostIntegrate(step);
@@ -103,6 +106,7 @@ bool HWSystem::v_PostIntegrate(int step) {
  * enabled, then call base class member func.
  */
 bool HWSystem::v_PreIntegrate(int step) {
+  this->step_profiler->begin_step(step);
   this->solver_callback_handler.call_pre_integrate(this);
 
   if (this->diag_mass_recording_enabled) {
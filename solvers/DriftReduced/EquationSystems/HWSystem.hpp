@@ -24,10 +24,9 @@ public:
   friend class Nektar::MemoryManager<HWSystem>;
 
   /// Object that allows optional recording of energy and enstrophy growth rates
-  std::shared_ptr<GrowthRatesRecorder<MR::DisContField>>
-      diag_growth_rates_recorder;
+  std::shared_ptr<GrowthRatesRecorder<MR::ExpList>> diag_growth_rates_recorder;
   /// Object that allows optional recording of total fluid, particle masses
-  std::shared_ptr<MassRecorder<MR::DisContField>> diag_mass_recorder;
+  std::shared_ptr<MassRecorder<MR::ExpList>> diag_mass_recorder;
   /// Callback handler to call user defined callbacks.
   SolverCallbackHandler<HWSystem> solver_callback_handler;
 
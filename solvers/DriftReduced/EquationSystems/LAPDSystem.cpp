@@ -204,6 +204,8 @@ void LAPDSystem::calc_E_and_adv_vels(
 void LAPDSystem::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "LAPDSystem::explicit_time_int");
 
   // Zero out_arr
   for (auto ifld = 0; ifld < out_arr.size(); ifld++) {
@@ -233,7 +235,7 @@ void LAPDSystem::explicit_time_int(
   add_adv_terms({"ne"}, m_adv_PD, m_adv_vel_PD, in_arr, out_arr, time, {"w"});
 
   // Add density source via xml-defined function
-  add_density_source(out_arr);
+  add_density_source(out_arr, time);
 }
 
 /**
@@ -138,6 +138,8 @@ void RogersRicci2D::v_InitObject(bool DeclareField) {
 void RogersRicci2D::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "RogersRicci2D::explicit_time_int");
 
   solve_phi(in_arr);
 
@@ -194,6 +196,17 @@ Array<OneD, NekDouble> &RogersRicci2D::get_norm_vel() {
                                               this->ExB_vel);
 }
 
+/**
+ * @brief Report implicit solver iteration counts on info steps, then call
+ * base class member func.
+ */
+bool RogersRicci2D::v_PostIntegrate(int step) {
+  if (this->implicit_helper && m_infosteps && !((step + 1) % m_infosteps)) {
+    this->implicit_helper->print_stats();
+  }
+  return DriftReducedSystem::v_PostIntegrate(step);
+}
+
 /**
  * @brief Read model params required for the 2D Rogers & Ricci system.
  */
@@ -85,6 +85,8 @@ protected:
 
   virtual void load_params() override final;
 
+  virtual bool v_PostIntegrate(int step) override;
+
 private:
   // Model params
   NekDouble coulomb_log;
@@ -8,7 +8,6 @@ void NeutralParticleSystem::init_spec() {
       NP::ParticleProp(NP::Sym<NP::REAL>("COMPUTATIONAL_WEIGHT"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("SOURCE_DENSITY"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("ELECTRON_DENSITY"), 1),
-      NP::ParticleProp(NP::Sym<NP::REAL>("MASS"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("VELOCITY"), 3)};
 }
 
@@ -14,6 +14,7 @@
 #include <LibUtilities/BasicUtils/SessionReader.h>
 #include <boost/math/special_functions/erf.hpp>
 #include <nektar_interface/function_evaluation.hpp>
+#include <nektar_interface/function_homogeneous_1d.hpp>
 #include <nektar_interface/function_projection.hpp>
 #include <nektar_interface/particle_interface.hpp>
 #include <nektar_interface/solver_base/partsys_base.hpp>
@@ -98,26 +99,7 @@ public:
     get_from_session(this->config, "particle_drift_velocity",
                      this->particle_drift_velocity, 0.0);
 
-    // Set particle region = domain volume for now
-    double particle_region_volume = this->periodic_bc->global_extent[0];
-    for (auto idim = 1; idim < this->ndim; idim++) {
-      particle_region_volume *= this->periodic_bc->global_extent[idim];
-    }
-
-    // read or deduce a number density from the configuration file
-    get_from_session(this->config, "particle_number_density",
-                     this->particle_number_density, -1.0);
-    if (this->particle_number_density < 0.0) {
-      this->particle_init_weight = 1.0;
-      this->particle_number_density =
-          this->num_parts_tot / particle_region_volume;
-    } else {
-      const double num_phys_particles =
-          this->particle_number_density * particle_region_volume;
-      this->particle_init_weight =
-          (this->num_parts_tot == 0) ? 0.0
-                                     : num_phys_particles / this->num_parts_tot;
-    }
+    this->compute_particle_weight();
 
     // get seed from file
     std::srand(std::time(nullptr));
@@ -177,12 +159,20 @@ public:
    *  Project particle source terms onto nektar fields.
    */
   inline void project_source_terms() {
-    NESOASSERT(this->field_project != nullptr,
+    NESOASSERT((this->field_project != nullptr) ||
+                   (this->field_project_homogeneous != nullptr),
                "Field project object is null. Was setup_project called?");
 
     std::vector<NP::Sym<NP::REAL>> syms = {NP::Sym<NP::REAL>("SOURCE_DENSITY")};
     std::vector<int> components = {0};
-    this->field_project->project(syms, components);
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::Projection,
+                                    "NeutralParticleSystem::project");
+    if (this->field_project_homogeneous) {
+      this->field_project_homogeneous->project(syms[0], components[0]);
+    } else {
+      this->field_project->project(syms, components);
+    }
     if (this->low_order_project) {
       FU::Interpolator<std::vector<MR::ExpListSharedPtr>> interpolator{};
       std::vector<MR::ExpListSharedPtr> in_exp = {
@@ -191,6 +181,7 @@ public:
           this->discont_fields["ne_src"]};
       interpolator.Interpolate(in_exp, out_exp);
     }
+    region.end();
     // remove fully ionised particles from the simulation
     remove_marked_particles();
   }
@@ -206,6 +197,41 @@ public:
     this->discont_fields["ne"] = n;
   }
 
+  /**
+   * Set up the evaluation of a homogeneous 1D (2.5D) number density field. The
+   * particles are mapped on the 2D mesh of the planes and hold their z
+   * coordinate in the third component of POSITION.
+   *
+   * @param n Nektar++ homogeneous 1D field storing fluid number density.
+   */
+  inline void setup_evaluate_ne_homogeneous(MR::ExpListSharedPtr n) {
+    this->field_evaluate_ne_homogeneous =
+        std::make_shared<FieldEvaluateHomogeneous1D<MR::DisContField>>(
+            n, this->particle_group, this->cell_id_translation);
+    this->lhom = n->GetHomoLen();
+    this->compute_particle_weight();
+    // The planes carry the boundary conditions in (x, y).
+    this->discont_fields["ne"] =
+        std::dynamic_pointer_cast<MR::DisContField>(n->GetPlane(0));
+  }
+
+  /**
+   * Set up the projection onto a homogeneous 1D (2.5D) source field.
+   *
+   * @param ne_src Nektar++ homogeneous 1D field to project particle source
+   * terms onto.
+   */
+  inline void setup_project_homogeneous(MR::ExpListSharedPtr ne_src) {
+    this->field_project_homogeneous =
+        std::make_shared<FieldProjectHomogeneous1D<MR::DisContField>>(
+            ne_src, this->particle_group, this->cell_id_translation);
+    this->lhom = ne_src->GetHomoLen();
+    this->compute_particle_weight();
+    this->discont_fields["ne_src"] =
+        std::dynamic_pointer_cast<MR::DisContField>(ne_src->GetPlane(0));
+    this->low_order_project = false;
+  }
+
   /**
    * Set up the projection object
    *
@@ -245,6 +271,9 @@ public:
    *  Write the projection fields to vtu for debugging.
    */
   inline void write_source_fields() {
+    NESO::StepProfilerRegion region(
+        this->step_profiler, NESO::StepRegion::IO,
+        "NeutralParticleSystem::write_source_fields");
     for (auto entry : this->discont_fields) {
       std::string filename = "debug_" + entry.first + "_" +
                              std::to_string(this->debug_write_fields_count++) +
@@ -254,6 +283,36 @@ public:
   }
 
 protected:
+  /**
+   * Set the number density and the initial weight of the particles from the
+   * volume of the particle region, which is the domain. With homogeneous 1D
+   * fields the region extends over the homogeneous length in z.
+   */
+  inline void compute_particle_weight() {
+    double particle_region_volume = this->periodic_bc->global_extent[0];
+    for (auto idim = 1; idim < this->ndim; idim++) {
+      particle_region_volume *= this->periodic_bc->global_extent[idim];
+    }
+    if (this->lhom > 0.0) {
+      particle_region_volume *= this->lhom;
+    }
+
+    // read or deduce a number density from the configuration file
+    get_from_session(this->config, "particle_number_density",
+                     this->particle_number_density, -1.0);
+    if (this->particle_number_density < 0.0) {
+      this->particle_init_weight = 1.0;
+      this->particle_number_density =
+          this->num_parts_tot / particle_region_volume;
+    } else {
+      const double num_phys_particles =
+          this->particle_number_density * particle_region_volume;
+      this->particle_init_weight =
+          (this->num_parts_tot == 0) ? 0.0
+                                     : num_phys_particles / this->num_parts_tot;
+    }
+  }
+
   /// Assumed background density in SI units, read from session
   double n_bg_SI;
   /// Particle drift velocity
@@ -282,6 +341,15 @@ protected:
   std::shared_ptr<FieldEvaluate<MR::DisContField>> field_evaluate_ne;
   /// Object used to project onto Nektar number density field
   std::shared_ptr<FieldProject<MR::DisContField>> field_project;
+  /// Object used to evaluate a homogeneous 1D number density field
+  std::shared_ptr<FieldEvaluateHomogeneous1D<MR::DisContField>>
+      field_evaluate_ne_homogeneous;
+  /// Object used to project onto a homogeneous 1D source field
+  std::shared_ptr<FieldProjectHomogeneous1D<MR::DisContField>>
+      field_project_homogeneous;
+  /// Length in z of homogeneous 1D fields, zero if the fields are not
+  /// homogeneous
+  double lhom = 0.0;
   /// Variable to toggle use of low order projection
   bool low_order_project;
   /// Object to handle particle removal
@@ -291,6 +359,22 @@ protected:
   /// Simulation time
   double simulation_time = 0.0;
 
+  virtual void
+  write_checkpoint_state(NESO::IO::ParticleCheckpointWriter &writer) override {
+    writer.write_value("total_num_particles_added",
+                       this->total_num_particles_added);
+    writer.write_value("simulation_time", this->simulation_time);
+    writer.write_rng("rng_phasespace", this->rng_phasespace);
+  }
+
+  virtual void
+  read_checkpoint_state(NESO::IO::ParticleCheckpointReader &reader) override {
+    reader.read_value("total_num_particles_added",
+                      this->total_num_particles_added);
+    reader.read_value("simulation_time", this->simulation_time);
+    reader.read_rng("rng_phasespace", this->rng_phasespace);
+  }
+
   /**
    * Add particles to the simulation.
    *
@@ -321,21 +405,26 @@ protected:
       double mu = 0.0;
       double sigma;
       get_from_session(this->config, "particle_source_width", sigma, 0.5);
-      positions = NP::normal_distribution(N, this->ndim, mu, sigma,
+      // With homogeneous 1D fields the particles also move in z.
+      const int ndim_particles = (this->lhom > 0.0) ? 3 : this->ndim;
+      positions = NP::normal_distribution(N, ndim_particles, mu, sigma,
                                           this->rng_phasespace);
       // Centre of distribution
       std::vector<double> offsets = {0.0, 0.0,
                                      (this->periodic_bc->global_extent[2] -
                                       this->periodic_bc->global_origin[2]) /
                                          2};
+      if (this->lhom > 0.0) {
+        offsets[2] = this->lhom / 2;
+      }
 
       velocities = NP::normal_distribution(
-          N, this->ndim, this->particle_drift_velocity,
+          N, ndim_particles, this->particle_drift_velocity,
           this->particle_thermal_velocity, this->rng_phasespace);
 
       // Set positions, velocities
       for (int ipart = 0; ipart < N; ipart++) {
-        for (int idim = 0; idim < this->ndim; idim++) {
+        for (int idim = 0; idim < ndim_particles; idim++) {
           initial_distribution[NP::Sym<NP::REAL>("POSITION")][ipart][idim] =
               positions[idim][ipart] + offsets[idim];
           initial_distribution[NP::Sym<NP::REAL>("VELOCITY")][ipart][idim] =
@@ -349,8 +438,6 @@ protected:
             ipart % cell_count;
         initial_distribution[NP::Sym<NP::REAL>("COMPUTATIONAL_WEIGHT")][ipart]
                             [0] = this->particle_init_weight;
-        initial_distribution[NP::Sym<NP::REAL>("MASS")][ipart][0] =
-            this->particle_mass;
         initial_distribution[NP::Sym<NP::INT>("PARTICLE_ID")][ipart][0] =
             ipart + rstart + this->total_num_particles_added;
       }
@@ -379,21 +466,40 @@ protected:
     NESOASSERT(this->is_fully_periodic(),
                "NeutralParticleSystem: Only fully periodic BCs are supported.");
     this->periodic_bc->execute();
+    // Homogeneous 1D fields are periodic in z.
+    if (this->lhom > 0.0) {
+      const double k_lhom = this->lhom;
+      NP::particle_loop(
+          "NeutralParticleSystem::periodic_z", this->particle_group,
+          [=](auto k_P) {
+            k_P.at(2) -= k_lhom * sycl::floor(k_P.at(2) / k_lhom);
+          },
+          NP::Access::write(NP::Sym<NP::REAL>("POSITION")))
+          ->execute();
+    }
   }
 
   /**
    *  Evaluate fields at the particle locations.
    */
   inline void evaluate_fields() {
-    NESOASSERT(this->field_evaluate_ne != nullptr,
+    NESOASSERT((this->field_evaluate_ne != nullptr) ||
+                   (this->field_evaluate_ne_homogeneous != nullptr),
                "FieldEvaluate object is null. Was setup_evaluate_ne called?");
 
-    this->field_evaluate_ne->evaluate(NP::Sym<NP::REAL>("ELECTRON_DENSITY"));
-
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::Evaluation,
+                                    "NeutralParticleSystem::evaluate_fields");
     // Unit conversion factors
     const double k_n_to_SI = this->n_to_SI;
     const auto k_n_bg_SI = this->n_bg_SI;
 
+    if (this->field_evaluate_ne_homogeneous) {
+      this->field_evaluate_ne_homogeneous->evaluate(
+          NP::Sym<NP::REAL>("ELECTRON_DENSITY"));
+    } else {
+      this->field_evaluate_ne->evaluate(NP::Sym<NP::REAL>("ELECTRON_DENSITY"));
+    }
     NP::particle_loop(
         "NeutralParticleSystem::evaluate_fields", this->particle_group,
         [=](auto k_n) { k_n.at(0) = k_n_bg_SI + k_n.at(0) * k_n_to_SI; },
@@ -407,7 +513,9 @@ protected:
    * @param dt Time step size.
    */
   inline void forward_euler(const double dt) {
-    auto t0 = NP::profile_timestamp();
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::ParticlePush,
+                                    "NeutralParticleSystem::forward_euler");
     const double k_dt = dt;
 
     NP::particle_loop(
@@ -420,10 +528,7 @@ protected:
         NP::Access::write(NP::Sym<NP::REAL>("POSITION")),
         NP::Access::read(NP::Sym<NP::REAL>("VELOCITY")))
         ->execute();
-
-    this->sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "ForwardEuler_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
+    region.end();
 
     // positions were written so we apply boundary conditions and move
     // particles between ranks
@@ -481,7 +586,9 @@ protected:
                                expint_barry_approx(invratio + k_c_i));
     const NP::INT k_remove_key = particle_remove_key;
 
-    auto t0 = NP::profile_timestamp();
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::ParticlePush,
+                                    "NeutralParticleSystem::ionise");
 
     NP::particle_loop(
         "NeutralParticleSystem::ionise", this->particle_group,
@@ -511,10 +618,6 @@ protected:
         NP::Access::write(NP::Sym<NP::REAL>("SOURCE_DENSITY")),
         NP::Access::write(NP::Sym<NP::REAL>("COMPUTATIONAL_WEIGHT")))
         ->execute();
-
-    this->sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "Ionisation_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
   }
 
   /**
@@ -547,14 +650,26 @@ protected:
    *  Apply boundary conditions and transfer particles between MPI ranks.
    */
   inline void transfer_particles() {
-    auto t0 = NP::profile_timestamp();
+    if (this->neighbour_transfer) {
+      NESO::StepProfilerRegion region(
+          this->step_profiler, NESO::StepRegion::Transfer,
+          "NeutralParticleSystem::neighbour_transfer");
+      this->boundary_conditions();
+      this->neighbour_transfer->execute();
+      return;
+    }
+
+    NESO::StepProfilerRegion region_move(this->step_profiler,
+                                         NESO::StepRegion::Transfer,
+                                         "NeutralParticleSystem::hybrid_move");
     this->boundary_conditions();
     this->particle_group->hybrid_move();
-    this->cell_id_translation->execute();
+    region_move.end();
+
+    NESO::StepProfilerRegion region_cell_move(
+        this->step_profiler, NESO::StepRegion::Transfer,
+        "NeutralParticleSystem::cell_move");
     this->particle_group->cell_move();
-    this->sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "transfer_particles", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
   }
 };
 } // namespace NESO::Solvers::DriftReduced
@@ -2,9 +2,13 @@
 #define __NESOSOLVERS_ELECTROSTATIC2D3V_LINEFIELDEVALUATIONS_HPP__
 
 #include "../ParticleSystems/ChargedParticles.hpp"
+#include <hdf5.h>
 #include <memory>
 #include <mpi.h>
+#include <nektar_interface/function_point_evaluation.hpp>
 #include <neso_particles.hpp>
+#include <string>
+#include <vector>
 
 #include "FieldMean.hpp"
 
@@ -12,34 +16,101 @@ namespace NP = NESO::Particles;
 
 namespace NESO::Solvers::Electrostatic2D3V {
 /**
- * Evaluate the value or derivative of the potential field at a set of points
- * that form two lines. One line is in the x direction the other line is in the
- * y direction. Output is a particle trajectory where the particles are fixed
- * along one of the two lines. A particle property INDEX (INT, 1 component)
- * indicates which line the point resides on:
- *  - In 1D (two lines, crossed in a plus sign arrangment):
- *    - 0 for the x direction line, and the index in the y direction
- *    - the index along the x direction line, and 1 for the x direction line
- *  - In a 2D grid:
- *    - the index in x direction and index in the y direction
- * The field evaluations/derivatives are stored on the
- * FIELD_EVALUATION particle property (REAL, 1 component for evaluations, 2
- * components for derivatives).
+ * Evaluate the value or derivative of the potential field at a grid of probe
+ * points. The probe points are fixed, hence they are located once on
+ * construction and held in compact device buffers of cells and reference
+ * positions. Evaluations use BaryEvaluateBase::evaluate_points, as
+ * FieldPointEvaluate does, and are accumulated in device memory over a number
+ * of steps before they are gathered and written.
+ *
+ * Output is a HDF5 file with the datasets:
+ *  - index (INT, num_points x 2): index of the point in the x and y
+ *    directions.
+ *  - positions (REAL, num_points x 2): position of each point.
+ *  - steps (INT, extendable): the step of each written evaluation.
+ *  - evaluations (REAL, extendable x num_points x ncomp): the field
+ *    evaluations (ncomp = 1) or derivatives (ncomp = 2).
  */
 template <typename T> class LineFieldEvaluations {
 private:
   int step;
   bool mean_shift;
+  bool derivative;
+  int ndim;
+  int ncomp;
+  int buffer_steps;
+  int num_buffered;
+  int num_local_points;
+  int num_global_points;
+  hsize_t num_written;
   NP::SYCLTargetSharedPtr sycl_target;
-  std::shared_ptr<CellIDTranslation> cell_id_translation;
   std::shared_ptr<T> field;
-  std::shared_ptr<FieldEvaluate<T>> field_evaluate;
-  std::shared_ptr<NP::H5Part> h5part;
+  std::shared_ptr<BaryEvaluateBase<T>> bary_evaluate_base;
   std::unique_ptr<FieldMean<T>> field_mean;
+  std::unique_ptr<NP::BufferDevice<int>> d_cells;
+  std::unique_ptr<NP::BufferDevice<NP::REAL>> d_ref_positions;
+  std::unique_ptr<NP::BufferDeviceHost<NP::REAL>> dh_evaluations;
+  std::vector<Array<OneD, NekDouble>> physvals;
+  std::vector<Array<OneD, NekDouble> *> physvals_ptrs;
+  std::vector<int> buffered_steps;
+
+  // Members used on rank 0 to assemble and write the output.
+  std::vector<int> recv_point_counts;
+  std::vector<int> recv_point_displs;
+  std::vector<int> recv_point_ids;
+  std::vector<NP::REAL> recv_evaluations;
+  std::vector<NP::REAL> write_evaluations;
+  hid_t file;
+  hid_t dataset_steps;
+  hid_t dataset_evaluations;
+
+  inline void h5chk(const herr_t err) {
+    NESOASSERT(err >= 0, "LineFieldEvaluations: HDF5 error");
+  }
+
+  template <typename U>
+  inline void write_static(const std::string key, const hid_t type,
+                           const std::vector<U> &values) {
+    const hsize_t dims[2] = {static_cast<hsize_t>(this->num_global_points), 2};
+    auto dataspace = H5Screate_simple(2, dims, NULL);
+    auto dataset = H5Dcreate2(this->file, key.c_str(), type, dataspace,
+                              H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    h5chk(H5Dwrite(dataset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   values.data()));
+    h5chk(H5Dclose(dataset));
+    h5chk(H5Sclose(dataspace));
+  }
+
+  inline hid_t create_extendable(const std::string key, const hid_t type,
+                                 const int rank, const hsize_t *chunk_dims) {
+    hsize_t dims[3] = {0, chunk_dims[1], chunk_dims[2]};
+    hsize_t max_dims[3] = {H5S_UNLIMITED, chunk_dims[1], chunk_dims[2]};
+    auto dataspace = H5Screate_simple(rank, dims, max_dims);
+    auto plist = H5Pcreate(H5P_DATASET_CREATE);
+    h5chk(H5Pset_chunk(plist, rank, chunk_dims));
+    auto dataset = H5Dcreate2(this->file, key.c_str(), type, dataspace,
+                              H5P_DEFAULT, plist, H5P_DEFAULT);
+    h5chk(H5Pclose(plist));
+    h5chk(H5Sclose(dataspace));
+    return dataset;
+  }
+
+  inline void append(const hid_t dataset, const hid_t type, const int rank,
+                     const hsize_t *block_dims, const void *values) {
+    hsize_t new_dims[3] = {this->num_written + block_dims[0], block_dims[1],
+                           block_dims[2]};
+    h5chk(H5Dset_extent(dataset, new_dims));
+    auto filespace = H5Dget_space(dataset);
+    const hsize_t offset[3] = {this->num_written, 0, 0};
+    h5chk(H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, NULL,
+                              block_dims, NULL));
+    auto memspace = H5Screate_simple(rank, block_dims, NULL);
+    h5chk(H5Dwrite(dataset, type, memspace, filespace, H5P_DEFAULT, values));
+    h5chk(H5Sclose(memspace));
+    h5chk(H5Sclose(filespace));
+  }
 
 public:
-  /// NP::ParticleGroup of interest.
-  NP::ParticleGroupSharedPtr particle_group;
   /// The MPI communicator used by this instance.
   MPI_Comm comm;
 
@@ -52,141 +123,144 @@ public:
    * will be used.
    * @param nx Number of sample points in the x direction.
    * @param ny Number of sample points in the y direction.
-   * @bool derivative Bool to evaluate derivatives instead of field value.
-   * @bool mean_shift Bool to enable shifting of evaluations by minus the mean.
+   * @param derivative Bool to evaluate derivatives instead of field value.
+   * @param mean_shift Bool to enable shifting of evaluations by minus the mean,
+   * not valid with derivative as the mean does not change the derivatives.
+   * @param buffer_steps Number of steps to hold in device memory between
+   * writes to the output file.
    */
   LineFieldEvaluations(std::shared_ptr<T> field,
                        std::shared_ptr<ChargedParticles> charged_particles,
                        const int nx, const int ny,
                        const bool derivative = false,
-                       const bool mean_shift = false)
-      : field(field), step(0), mean_shift(mean_shift) {
+                       const bool mean_shift = false,
+                       const int buffer_steps = 1)
+      : step(0), mean_shift(mean_shift), derivative(derivative),
+        buffer_steps(buffer_steps), num_buffered(0), num_written(0),
+        field(field), file(H5I_INVALID_HID) {
 
     int flag;
     MPICHK(MPI_Initialized(&flag));
     ASSERTL1(flag, "MPI is not initialised");
 
-    auto domain = charged_particles->particle_group->domain;
-    this->sycl_target = charged_particles->sycl_target;
-
-    const int ncomp = (derivative) ? domain->mesh->get_ndim() : 1;
-
-    ParticleSpec particle_spec{
-        NP::ParticleProp(NP::Sym<NP::REAL>("P"), 2, true),
-        NP::ParticleProp(NP::Sym<NP::INT>("CELL_ID"), 1, true),
-        NP::ParticleProp(NP::Sym<NP::REAL>("FIELD_EVALUATION"), ncomp),
-        NP::ParticleProp(NP::Sym<NP::INT>("INDEX"), 2)};
-
     NESOASSERT(nx >= 0, "LineFieldEvaluations: bad nx count");
     NESOASSERT(ny >= 0, "LineFieldEvaluations: bad ny count");
+    NESOASSERT(buffer_steps > 0, "LineFieldEvaluations: bad buffer steps");
+    NESOASSERT(!(derivative && mean_shift),
+               "LineFieldEvaluations: mean_shift is not valid for derivatives");
 
-    this->particle_group = std::make_shared<NP::ParticleGroup>(
-        domain, particle_spec, this->sycl_target);
-
-    // Setup map between cell indices
-    this->cell_id_translation = std::make_shared<CellIDTranslation>(
-        this->sycl_target, this->particle_group->cell_id_dat,
-        charged_particles->particle_mesh_interface);
-
-    this->field_evaluate = std::make_shared<FieldEvaluate<T>>(
-        field, this->particle_group, this->cell_id_translation, derivative);
+    auto mesh = charged_particles->particle_mesh_interface;
+    this->sycl_target = charged_particles->sycl_target;
+    this->comm = this->sycl_target->comm_pair.comm_parent;
+    this->ndim = mesh->get_ndim();
+    this->ncomp = (derivative) ? this->ndim : 1;
+    this->num_global_points = nx * ny;
+
+    const double extentx =
+        charged_particles->boundary_conditions->global_extent[0];
+    const double extenty =
+        charged_particles->boundary_conditions->global_extent[1];
+    const double hx = extentx / ((double)nx);
+    const double hy = extenty / ((double)ny);
+    const double init_pos_x =
+        charged_particles->boundary_conditions->global_origin[0] + 0.5 * hx;
+    const double init_pos_y =
+        charged_particles->boundary_conditions->global_origin[1] + 0.5 * hy;
 
     const int rank = this->sycl_target->comm_pair.rank_parent;
+    std::vector<int> probe_index;
+    std::vector<NP::REAL> probe_positions;
     if (rank == 0) {
-      if (false) {
-        NP::ParticleSet initial_distribution(
-            nx + ny, this->particle_group->get_particle_spec());
-
-        const double extentx =
-            charged_particles->boundary_conditions->global_extent[0];
-        const double extenty =
-            charged_particles->boundary_conditions->global_extent[1];
-        const double hx = extentx / ((double)nx);
-        const double hy = extenty / ((double)ny);
-
-        // get the first location
-        double tmp_pos =
-            charged_particles->boundary_conditions->global_origin[0];
-        tmp_pos += 0.5 * hx;
-        double tmp_other_dim =
-            charged_particles->boundary_conditions->global_origin[1] +
-            0.5 * extenty;
-
-        for (int px = 0; px < nx; px++) {
-          initial_distribution[NP::Sym<NP::REAL>("P")][px][0] = tmp_pos;
-          initial_distribution[NP::Sym<NP::REAL>("P")][px][1] = tmp_other_dim;
-          tmp_pos += hx;
-          initial_distribution[NP::Sym<NP::INT>("INDEX")][px][0] = 0;
-          initial_distribution[NP::Sym<NP::INT>("INDEX")][px][1] = px;
+      probe_index.reserve(2 * this->num_global_points);
+      probe_positions.reserve(2 * this->num_global_points);
+      for (int px = 0; px < nx; px++) {
+        for (int py = 0; py < ny; py++) {
+          probe_index.push_back(px);
+          probe_index.push_back(py);
+          probe_positions.push_back(init_pos_x + px * hx);
+          probe_positions.push_back(init_pos_y + py * hy);
         }
-
-        tmp_pos = charged_particles->boundary_conditions->global_origin[1];
-        tmp_pos += 0.5 * hy;
-        tmp_other_dim =
-            charged_particles->boundary_conditions->global_origin[0] +
-            0.5 * extentx;
-
-        for (int px = nx; px < (nx + ny); px++) {
-          initial_distribution[NP::Sym<NP::REAL>("P")][px][0] = tmp_other_dim;
-          initial_distribution[NP::Sym<NP::REAL>("P")][px][1] = tmp_pos;
-          tmp_pos += hy;
-          initial_distribution[NP::Sym<NP::INT>("INDEX")][px][0] = 1;
-          initial_distribution[NP::Sym<NP::INT>("INDEX")][px][1] = px - nx;
-        }
-
-        this->particle_group->add_particles_local(initial_distribution);
-      } else {
-        NP::ParticleSet initial_distribution(
-            nx * ny, this->particle_group->get_particle_spec());
-
-        const double extentx =
-            charged_particles->boundary_conditions->global_extent[0];
-        const double hx = extentx / ((double)nx);
-
-        const double extenty =
-            charged_particles->boundary_conditions->global_extent[1];
-        const double hy = extenty / ((double)ny);
-
-        // get the first location
-        double init_pos_x =
-            charged_particles->boundary_conditions->global_origin[0];
-        init_pos_x += 0.5 * hx;
-
-        double init_pos_y =
-            charged_particles->boundary_conditions->global_origin[1];
-        init_pos_y += 0.5 * hy;
-
-        int ip = 0;
-        for (int px = 0; px < nx; px++) {
-          for (int py = 0; py < ny; py++) {
-            initial_distribution[NP::Sym<NP::REAL>("P")][ip][0] =
-                init_pos_x + px * hx;
-            initial_distribution[NP::Sym<NP::REAL>("P")][ip][1] =
-                init_pos_y + py * hy;
-            initial_distribution[NP::Sym<NP::INT>("INDEX")][ip][0] = px;
-            initial_distribution[NP::Sym<NP::INT>("INDEX")][ip][1] = py;
-            ip += 1;
-          }
-        }
-
-        this->particle_group->add_particles_local(initial_distribution);
       }
     }
 
-    this->particle_group->hybrid_move();
-    this->cell_id_translation->execute();
-    this->particle_group->cell_move();
+    // The probes do not move, hence they are located once and the global ids
+    // in local order are fixed.
+    auto located = locate_points(this->sycl_target, mesh, probe_positions);
+    this->bary_evaluate_base = std::make_shared<BaryEvaluateBase<T>>(
+        field, mesh, located.cell_id_translation);
+    auto &h_ids = located.ids;
+    this->num_local_points = h_ids.size();
+    if (this->num_local_points == 0) {
+      located.cells.push_back(0);
+      located.ref_positions.resize(this->ndim, 0.0);
+    }
+    this->d_cells = std::make_unique<NP::BufferDevice<int>>(this->sycl_target,
+                                                            located.cells);
+    this->d_ref_positions = std::make_unique<NP::BufferDevice<NP::REAL>>(
+        this->sycl_target, located.ref_positions);
+    this->dh_evaluations = std::make_unique<NP::BufferDeviceHost<NP::REAL>>(
+        this->sycl_target,
+        std::max(1, buffer_steps * this->num_local_points * this->ncomp));
+
+    const int num_quadrature_points = this->field->GetTotPoints();
+    this->physvals.resize(this->ncomp);
+    this->physvals_ptrs.resize(this->ncomp);
+    for (int cx = 0; cx < this->ncomp; cx++) {
+      this->physvals.at(cx) = Array<OneD, NekDouble>(num_quadrature_points);
+      this->physvals_ptrs.at(cx) = &this->physvals.at(cx);
+    }
 
-    std::string filename;
-    if (derivative) {
-      filename = "Electrostatic2D3V_line_field_deriv_evaluations.h5part";
-    } else {
-      filename = "Electrostatic2D3V_line_field_evaluations.h5part";
+    // Rank 0 needs the global ids of the points held on each rank to
+    // assemble the output.
+    const int size = this->sycl_target->comm_pair.size_parent;
+    this->recv_point_counts.resize(size);
+    this->recv_point_displs.resize(size);
+    MPICHK(MPI_Gather(&this->num_local_points, 1, MPI_INT,
+                      this->recv_point_counts.data(), 1, MPI_INT, 0,
+                      this->comm));
+    int total_points = 0;
+    for (int rx = 0; rx < size; rx++) {
+      this->recv_point_displs.at(rx) = total_points;
+      total_points += this->recv_point_counts.at(rx);
+    }
+    if (rank == 0) {
+      NESOASSERT(total_points == this->num_global_points,
+                 "LineFieldEvaluations: probe points were lost in binning.");
+      this->recv_point_ids.resize(total_points);
     }
+    MPICHK(MPI_Gatherv(h_ids.data(), this->num_local_points, MPI_INT,
+                       this->recv_point_ids.data(),
+                       this->recv_point_counts.data(),
+                       this->recv_point_displs.data(), MPI_INT, 0, this->comm));
 
-    this->h5part = std::make_shared<NP::H5Part>(
-        filename, this->particle_group, NP::Sym<NP::INT>("INDEX"),
-        NP::Sym<NP::REAL>("FIELD_EVALUATION"));
+    if (rank == 0) {
+      std::string filename;
+      if (derivative) {
+        filename = "Electrostatic2D3V_line_field_deriv_evaluations.h5";
+      } else {
+        filename = "Electrostatic2D3V_line_field_evaluations.h5";
+      }
+      this->file = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT,
+                             H5P_DEFAULT);
+      NESOASSERT(this->file != H5I_INVALID_HID,
+                 "LineFieldEvaluations: invalid HDF5 file identifier");
+      this->write_static("index", H5T_NATIVE_INT, probe_index);
+      this->write_static("positions", H5T_NATIVE_DOUBLE, probe_positions);
+
+      const hsize_t chunk_steps[3] = {static_cast<hsize_t>(buffer_steps), 1,
+                                      1};
+      this->dataset_steps =
+          this->create_extendable("steps", H5T_NATIVE_INT, 1, chunk_steps);
+      const hsize_t chunk_evaluations[3] = {
+          static_cast<hsize_t>(buffer_steps),
+          static_cast<hsize_t>(std::max(this->num_global_points, 1)),
+          static_cast<hsize_t>(this->ncomp)};
+      this->dataset_evaluations = this->create_extendable(
+          "evaluations", H5T_NATIVE_DOUBLE, 3, chunk_evaluations);
+      this->write_evaluations.resize(
+          static_cast<std::size_t>(buffer_steps) * this->num_global_points *
+          this->ncomp);
+    }
 
     if (this->mean_shift) {
       this->field_mean = std::make_unique<FieldMean<T>>(this->field);
@@ -194,38 +268,148 @@ public:
   }
 
   /**
-   * Evaluate the derivative of the potential at the points and write a new
-   * step to the trajectory.
+   * Evaluate the potential or the derivative of the potential at the points
+   * and record a new step. The evaluations are written to the output file
+   * once buffer_steps steps are held. Must be called collectively.
    *
-   * @param step_in Optional override of particle step in trajectory.
+   * @param step_in Optional override of step in output.
    */
   inline void write(int step_in = -1) {
     if (step_in > -1) {
       this->step = step_in;
     }
+    auto t0 = NP::profile_timestamp();
+
+    // Interpolation reproduces constants, hence shifting the quadrature
+    // point values by the mean shifts every evaluation by the mean.
+    auto global_physvals = this->field->GetPhys();
+    const int num_quadrature_points = global_physvals.size();
+    if (this->derivative) {
+      for (int dx = 0; dx < this->ndim; dx++) {
+        this->field->PhysDeriv(dx, global_physvals, this->physvals.at(dx));
+      }
+    } else if (this->mean_shift) {
+      Vmath::Sadd(num_quadrature_points, -this->field_mean->get_mean(),
+                  global_physvals, 1, this->physvals.at(0), 1);
+    } else {
+      this->physvals.at(0) = Array<OneD, NekDouble>(
+          num_quadrature_points,
+          const_cast<NekDouble *>(global_physvals.data()), true);
+    }
 
-    // get the field deriv evaluations
-    this->field_evaluate->evaluate(NP::Sym<NP::REAL>("FIELD_EVALUATION"));
-
-    if (this->mean_shift) {
-      const double k_mean = this->field_mean->get_mean();
-      NP::particle_loop(
-          "LineFieldEvaluations::write", this->particle_group,
-          [=](auto k_EVAL) { k_EVAL.at(0) -= k_mean; },
-          NP::Access::write(NP::Sym<NP::REAL>("FIELD_EVALUATION")))
-          ->execute();
+    // Evaluate directly into the buffer slot for this step.
+    if (this->num_local_points > 0) {
+      const int stride = this->num_local_points * this->ncomp;
+      this->bary_evaluate_base
+          ->evaluate_points(this->num_local_points, this->d_cells->ptr,
+                            this->d_ref_positions->ptr, this->physvals_ptrs,
+                            this->dh_evaluations->d_buffer.ptr +
+                                this->num_buffered * stride)
+          .wait_and_throw();
     }
 
-    this->h5part->write(this->step);
+    this->buffered_steps.push_back(this->step);
+    this->num_buffered++;
     this->step++;
+    this->sycl_target->profile_map.inc(
+        "LineFieldEvaluations", "write", 1,
+        NP::profile_elapsed(t0, NP::profile_timestamp()));
+
+    if (this->num_buffered == this->buffer_steps) {
+      this->flush();
+    }
+  }
+
+  /**
+   * Gather the buffered evaluations onto rank 0 and append them to the
+   * output file. Must be called collectively.
+   */
+  inline void flush() {
+    if (this->num_buffered == 0) {
+      return;
+    }
+    auto t0 = NP::profile_timestamp();
+    const int rank = this->sycl_target->comm_pair.rank_parent;
+    const int size = this->sycl_target->comm_pair.size_parent;
+    const int values_per_point = this->num_buffered * this->ncomp;
+    const int num_send = this->num_local_points * values_per_point;
+    if (num_send > 0) {
+      this->sycl_target->queue
+          .memcpy(this->dh_evaluations->h_buffer.ptr,
+                  this->dh_evaluations->d_buffer.ptr,
+                  num_send * sizeof(NP::REAL))
+          .wait_and_throw();
+    }
+
+    std::vector<int> recv_counts;
+    std::vector<int> recv_displs;
+    if (rank == 0) {
+      recv_counts.resize(size);
+      recv_displs.resize(size);
+      for (int rx = 0; rx < size; rx++) {
+        recv_counts.at(rx) = this->recv_point_counts.at(rx) * values_per_point;
+        recv_displs.at(rx) = this->recv_point_displs.at(rx) * values_per_point;
+      }
+      this->recv_evaluations.resize(
+          static_cast<std::size_t>(this->num_global_points) *
+          values_per_point);
+    }
+    MPICHK(MPI_Gatherv(this->dh_evaluations->h_buffer.ptr, num_send,
+                       MPI_DOUBLE, this->recv_evaluations.data(),
+                       recv_counts.data(), recv_displs.data(), MPI_DOUBLE, 0,
+                       this->comm));
+
+    if (rank == 0) {
+      // Reorder from [rank][step][point][component] into
+      // [step][global point][component].
+      for (int rx = 0; rx < size; rx++) {
+        const int num_points = this->recv_point_counts.at(rx);
+        const int point_offset = this->recv_point_displs.at(rx);
+        const NP::REAL *recv =
+            this->recv_evaluations.data() + point_offset * values_per_point;
+        for (int sx = 0; sx < this->num_buffered; sx++) {
+          for (int px = 0; px < num_points; px++) {
+            const int id = this->recv_point_ids.at(point_offset + px);
+            for (int cx = 0; cx < this->ncomp; cx++) {
+              this->write_evaluations.at(
+                  (sx * this->num_global_points + id) * this->ncomp + cx) =
+                  recv[(sx * num_points + px) * this->ncomp + cx];
+            }
+          }
+        }
+      }
+
+      const hsize_t block_steps[3] = {
+          static_cast<hsize_t>(this->num_buffered), 1, 1};
+      this->append(this->dataset_steps, H5T_NATIVE_INT, 1, block_steps,
+                   this->buffered_steps.data());
+      const hsize_t block_evaluations[3] = {
+          static_cast<hsize_t>(this->num_buffered),
+          static_cast<hsize_t>(this->num_global_points),
+          static_cast<hsize_t>(this->ncomp)};
+      this->append(this->dataset_evaluations, H5T_NATIVE_DOUBLE, 3,
+                   block_evaluations, this->write_evaluations.data());
+    }
+
+    this->num_written += this->num_buffered;
+    this->num_buffered = 0;
+    this->buffered_steps.clear();
+    this->sycl_target->profile_map.inc(
+        "LineFieldEvaluations", "flush", 1,
+        NP::profile_elapsed(t0, NP::profile_timestamp()));
   }
 
   /**
-   *  Close the output file and free local members as required. Must be called.
+   *  Write any buffered steps and close the output file. Must be called.
    */
   inline void close() {
-    this->h5part->close();
-    this->particle_group->free();
+    this->flush();
+    if (this->file != H5I_INVALID_HID) {
+      h5chk(H5Dclose(this->dataset_steps));
+      h5chk(H5Dclose(this->dataset_evaluations));
+      h5chk(H5Fclose(this->file));
+      this->file = H5I_INVALID_HID;
+    }
   }
 };
 
@@ -72,6 +72,8 @@ public:
   std::shared_ptr<PotentialEnergy<T>> potential_energy;
   /// Class to write simulation details to HDF5 file
   std::shared_ptr<IO::GenericHDF5Writer> generic_hdf5_writer;
+  /// Timeline profiler for the steps of the main loop.
+  StepProfilerSharedPtr step_profiler;
 
   /**
    *  Create new simulation instance using a nektar++ session. The parameters
@@ -88,6 +90,8 @@ public:
 
     this->charged_particles =
         std::make_shared<ChargedParticles>(session, graph);
+    this->step_profiler = StepProfiler::create(session);
+    this->charged_particles->set_step_profiler(this->step_profiler);
     this->poisson_particle_coupling =
         std::make_shared<PoissonParticleCoupling<T>>(session, graph, drv,
                                                      this->charged_particles);
@@ -181,6 +185,7 @@ public:
 
     int eval_nx = -1;
     int eval_ny = -1;
+    int eval_buffer_steps = 16;
     if (this->line_field_deriv_evaluations_flag) {
       this->session->LoadParameter(line_field_deriv_evalutions_name,
                                    this->line_field_deriv_evaluations_step);
@@ -188,6 +193,8 @@ public:
                                    eval_nx);
       this->session->LoadParameter("line_field_deriv_evaluations_numy",
                                    eval_ny);
+      this->session->LoadParameter("line_field_deriv_evaluations_buffer_steps",
+                                   eval_buffer_steps, eval_buffer_steps);
     }
     this->line_field_deriv_evaluations_flag &=
         (this->line_field_deriv_evaluations_step > 0);
@@ -195,11 +202,13 @@ public:
     if (this->line_field_deriv_evaluations_flag) {
       this->line_field_evaluations = std::make_shared<LineFieldEvaluations<T>>(
           this->poisson_particle_coupling->potential_function,
-          this->charged_particles, eval_nx, eval_ny, false, true);
+          this->charged_particles, eval_nx, eval_ny, false, true,
+          eval_buffer_steps);
       this->line_field_deriv_evaluations =
           std::make_shared<LineFieldEvaluations<T>>(
               this->poisson_particle_coupling->potential_function,
-              this->charged_particles, eval_nx, eval_ny, true);
+              this->charged_particles, eval_nx, eval_ny, true, false,
+              eval_buffer_steps);
     }
   };
 
@@ -220,6 +229,7 @@ public:
     // MAIN LOOP START
     for (int stepx = 0; stepx < this->num_time_steps; stepx++) {
       this->time_step = stepx;
+      this->step_profiler->begin_step(stepx);
 
       // These 3 lines perform the simulation timestep.
       this->integrator_1();
@@ -241,6 +251,9 @@ public:
 
       if (this->num_write_field_energy_steps > 0) {
         if ((stepx % this->num_write_field_energy_steps) == 0) {
+          StepProfilerRegion region(
+              this->step_profiler, StepRegion::IO,
+              "ElectrostaticElectronBernsteinWaves2D3V::energy");
           this->field_energy->compute();
           this->kinetic_energy->compute();
           this->potential_energy->compute();
@@ -260,6 +273,9 @@ public:
 
       if (this->line_field_deriv_evaluations_flag &&
           (stepx % this->line_field_deriv_evaluations_step == 0)) {
+        StepProfilerRegion region(
+            this->step_profiler, StepRegion::IO,
+            "ElectrostaticElectronBernsteinWaves2D3V::line_field_evaluations");
         this->line_field_deriv_evaluations->write(stepx);
         this->line_field_evaluations->write(stepx);
       }
@@ -302,7 +318,9 @@ public:
         NP::nprint("Time taken:", time_taken);
         NP::nprint("Time taken per step:", time_taken_per_step);
       }
+      this->poisson_particle_coupling->print_solve_iterations();
     }
+    this->step_profiler->finalise();
   }
 
   /**
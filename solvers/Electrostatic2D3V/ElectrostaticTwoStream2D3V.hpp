@@ -36,6 +36,7 @@ private:
   SU::DriverSharedPtr drv;
 
   int num_write_particle_steps;
+  int num_checkpoint_steps;
   int num_write_field_steps;
   int num_write_field_energy_steps;
   int num_print_steps;
@@ -87,6 +88,8 @@ public:
   std::shared_ptr<PotentialEnergy<T>> potential_energy;
   /// Class to write simulation details to HDF5 file
   std::shared_ptr<NESO::IO::GenericHDF5Writer> generic_hdf5_writer;
+  /// Timeline profiler for the steps of the main loop.
+  StepProfilerSharedPtr step_profiler;
 
   /**
    *  Create new simulation instance using a nektar++ session. The parameters
@@ -103,6 +106,8 @@ public:
 
     this->charged_particles =
         std::make_shared<ChargedParticles>(session, graph);
+    this->step_profiler = StepProfiler::create(session);
+    this->charged_particles->set_step_profiler(this->step_profiler);
     this->poisson_particle_coupling =
         std::make_shared<PoissonParticleCoupling<T>>(session, graph, drv,
                                                      this->charged_particles);
@@ -117,6 +122,8 @@ public:
                                  this->num_write_field_energy_steps);
     this->session->LoadParameter("particle_num_print_steps",
                                  this->num_print_steps);
+    this->session->LoadParameter("particle_num_checkpoint_steps",
+                                 this->num_checkpoint_steps, 0);
 
     this->rank = this->charged_particles->sycl_target->comm_pair.rank_parent;
     if ((this->rank == 0) && ((this->num_write_field_energy_steps > 0) ||
@@ -214,6 +221,7 @@ public:
 
     int eval_nx = -1;
     int eval_ny = -1;
+    int eval_buffer_steps = 16;
     if (this->line_field_deriv_evaluations_flag) {
       this->session->LoadParameter(line_field_deriv_evalutions_name,
                                    this->line_field_deriv_evaluations_step);
@@ -221,6 +229,8 @@ public:
                                    eval_nx);
       this->session->LoadParameter("line_field_deriv_evaluations_numy",
                                    eval_ny);
+      this->session->LoadParameter("line_field_deriv_evaluations_buffer_steps",
+                                   eval_buffer_steps, eval_buffer_steps);
     }
     this->line_field_deriv_evaluations_flag &=
         (this->line_field_deriv_evaluations_step > 0);
@@ -228,11 +238,13 @@ public:
     if (this->line_field_deriv_evaluations_flag) {
       this->line_field_evaluations = std::make_shared<LineFieldEvaluations<T>>(
           this->poisson_particle_coupling->potential_function,
-          this->charged_particles, eval_nx, eval_ny, false, true);
+          this->charged_particles, eval_nx, eval_ny, false, true,
+          eval_buffer_steps);
       this->line_field_deriv_evaluations =
           std::make_shared<LineFieldEvaluations<T>>(
               this->poisson_particle_coupling->potential_function,
-              this->charged_particles, eval_nx, eval_ny, true);
+              this->charged_particles, eval_nx, eval_ny, true, false,
+              eval_buffer_steps);
     }
   };
 
@@ -250,25 +262,26 @@ public:
     }
 
     auto t0 = NP::profile_timestamp();
-    auto t0_benchmark = NP::profile_timestamp();
     // MAIN LOOP START
     for (int stepx = 0; stepx < this->num_time_steps; stepx++) {
       this->time_step = stepx;
+      this->step_profiler->begin_step(stepx);
       // These 3 lines perform the simulation timestep.
       this->integrator_1();
       this->poisson_particle_coupling->compute_field();
       this->integrator_2();
 
-      if (stepx == 99) {
-        t0_benchmark = NP::profile_timestamp();
-      }
-
       // Below this line are the diagnostic calls for the timestep.
       if (this->num_write_particle_steps > 0) {
         if ((stepx % this->num_write_particle_steps) == 0) {
           this->charged_particles->write();
         }
       }
+      if (this->num_checkpoint_steps > 0) {
+        if ((stepx % this->num_checkpoint_steps) == 0) {
+          this->charged_particles->write_checkpoint(stepx);
+        }
+      }
       if (this->num_write_field_steps > 0) {
         if ((stepx % this->num_write_field_steps) == 0) {
           this->poisson_particle_coupling->write_forcing(stepx);
@@ -278,6 +291,8 @@ public:
 
       if (this->num_write_field_energy_steps > 0) {
         if ((stepx % this->num_write_field_energy_steps) == 0) {
+          StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                                    "ElectrostaticTwoStream2D3V::energy");
           this->field_energy->compute();
           this->kinetic_energy->compute();
           this->potential_energy->compute();
@@ -297,6 +312,9 @@ public:
 
       if (this->line_field_deriv_evaluations_flag &&
           (stepx % this->line_field_deriv_evaluations_step == 0)) {
+        StepProfilerRegion region(
+            this->step_profiler, StepRegion::IO,
+            "ElectrostaticTwoStream2D3V::line_field_evaluations");
         this->line_field_evaluations->write(stepx);
         this->line_field_deriv_evaluations->write(stepx);
       }
@@ -321,6 +339,19 @@ public:
                              (stepx + 1));
             }
           }
+
+          auto &neighbour_transfer =
+              this->charged_particles->neighbour_transfer;
+          if (neighbour_transfer) {
+            auto stats = neighbour_transfer->reduce_stats();
+            if (this->rank == 0) {
+              NP::nprint("transfer sent:", stats.num_sent,
+                         "bytes:", stats.bytes_sent,
+                         "global:", stats.num_global,
+                         "exchange time:", stats.time_exchange,
+                         "total time:", stats.time_total);
+            }
+          }
         }
       }
 
@@ -336,16 +367,12 @@ public:
         const double time_taken =
             NP::profile_elapsed(t0, NP::profile_timestamp());
         const double time_taken_per_step = time_taken / this->num_time_steps;
-        const double bench_time_taken =
-            NP::profile_elapsed(t0_benchmark, NP::profile_timestamp());
-        const double bench_time_taken_per_step =
-            bench_time_taken / (this->num_time_steps - 100);
         NP::nprint("Time taken:", time_taken);
         NP::nprint("Time taken per step:", time_taken_per_step);
-        NP::nprint("BENCHMARK Time taken:", bench_time_taken);
-        NP::nprint("BENCHMARK Time taken per step:", bench_time_taken_per_step);
       }
+      this->poisson_particle_coupling->print_solve_iterations();
     }
+    this->step_profiler->finalise();
   }
 
   /**
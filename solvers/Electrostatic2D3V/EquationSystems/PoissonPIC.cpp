@@ -1,5 +1,8 @@
 #include "PoissonPIC.hpp"
 
+#include <LibUtilities/LinearAlgebra/Blas.hpp>
+#include <LocalRegions/MatrixKey.h>
+
 namespace NESO::Solvers::Electrostatic2D3V {
 std::string PoissonPIC::className1 =
     SU::GetEquationSystemFactory().RegisterCreatorFunction("PoissonPIC",
@@ -10,7 +13,9 @@ std::string PoissonPIC::className2 =
 
 PoissonPIC::PoissonPIC(const LU::SessionReaderSharedPtr &session,
                        const SD::MeshGraphSharedPtr &graph)
-    : SU::EquationSystem(session, graph), m_factors() {
+    : SU::EquationSystem(session, graph), m_factors(), m_matrix_free(false),
+      m_tolerance(1.0e-10), m_max_iterations(10000), m_num_iterations(-1),
+      m_total_num_iterations(-1), m_residual(0.0), m_converged(true) {
   m_factors[SR::eFactorLambda] = 0.0;
   m_factors[SR::eFactorTau] = 1.0;
   auto variables = session->GetVariables();
@@ -33,12 +38,208 @@ int PoissonPIC::GetFieldIndex(const std::string name) {
 
 void PoissonPIC::v_InitObject(bool DeclareFields) {
   SU::EquationSystem::v_InitObject(true);
+
+  int matrix_free;
+  m_session->LoadParameter("poisson_matrix_free", matrix_free, 0);
+  m_session->LoadParameter("poisson_tolerance", m_tolerance, 1.0e-10);
+  m_session->LoadParameter("poisson_max_iterations", m_max_iterations, 10000);
+  m_matrix_free = matrix_free > 0;
+  if (m_matrix_free) {
+    this->SetupMatrixFree();
+  }
+}
+
+int PoissonPIC::GetNumIterations() { return m_num_iterations; }
+
+int64_t PoissonPIC::GetTotalNumIterations() { return m_total_num_iterations; }
+
+Nektar::NekDouble PoissonPIC::GetResidual() { return m_residual; }
+
+bool PoissonPIC::HasConverged() { return m_converged; }
+
+void PoissonPIC::SetupMatrixFree() {
+  const int u_index = this->GetFieldIndex("u");
+  m_u_field = std::dynamic_pointer_cast<MR::ContField>(m_fields[u_index]);
+  ASSERTL0(m_u_field != nullptr,
+           "The matrix-free Poisson solve requires a continuous projection.");
+  m_assembly_map = m_u_field->GetLocalToGlobalMap();
+  ASSERTL0(m_assembly_map->GetNumGlobalDirBndCoeffs() == 0,
+           "The matrix-free Poisson solve does not support Dirichlet "
+           "boundary conditions.");
+
+  m_num_global = m_assembly_map->GetNumGlobalCoeffs();
+  const int num_local = m_u_field->GetNcoeffs();
+  const int num_phys = m_u_field->GetTotPoints();
+
+  m_rhs_global = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_r = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_z = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_p = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_ap = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_solution_global =
+      Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global, 0.0);
+  m_wsp_local0 = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(num_local);
+  m_wsp_local1 = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(num_local);
+
+  // Store the elemental matrices and assemble the diagonal of the operator
+  // from them. The signs of the local to global map square to one on the
+  // diagonal.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> diag_global(m_num_global,
+                                                             0.0);
+  const int num_expansions = m_u_field->GetExpSize();
+  m_elemental_matrices.reserve(num_expansions);
+  for (int ex = 0; ex < num_expansions; ex++) {
+    auto expansion = m_u_field->GetExp(ex);
+    Nektar::LocalRegions::MatrixKey matrix_key(
+        SR::eHelmholtz, expansion->DetShapeType(), *expansion, m_factors);
+    auto matrix = expansion->GetLocMatrix(matrix_key);
+    ASSERTL0(matrix->GetStorageType() == Nektar::eFULL,
+             "Expected elemental Helmholtz matrices in full storage.");
+    m_elemental_matrices.push_back(matrix);
+    const int offset = m_u_field->GetCoeff_Offset(ex);
+    const int num_coeffs = expansion->GetNcoeffs();
+    for (int cx = 0; cx < num_coeffs; cx++) {
+      diag_global[m_assembly_map->GetLocalToGlobalMap(offset + cx)] +=
+          (*matrix)(cx, cx);
+    }
+  }
+  m_assembly_map->UniversalAssemble(diag_global);
+  m_inv_diag = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  for (int cx = 0; cx < m_num_global; cx++) {
+    m_inv_diag[cx] = (std::abs(diag_global[cx]) > 0.0)
+                         ? 1.0 / diag_global[cx]
+                         : 1.0;
+  }
+
+  // The unit field spans the null space of the periodic operator.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> ones_phys(num_phys, 1.0);
+  m_u_field->FwdTrans(ones_phys, m_wsp_local0);
+  m_ones_global = Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_assembly_map->LocalToGlobal(m_wsp_local0, m_ones_global);
+
+  // The integral of a function is the inner product of the global
+  // coefficients with the integrals of the global basis functions.
+  m_u_field->IProductWRTBase(ones_phys, m_wsp_local0);
+  m_basis_integrals =
+      Nektar::Array<Nektar::OneD, Nektar::NekDouble>(m_num_global);
+  m_assembly_map->Assemble(m_wsp_local0, m_basis_integrals);
+  m_volume = this->GlobalDot(m_ones_global, m_basis_integrals);
+
+  m_num_iterations = 0;
+  m_total_num_iterations = 0;
+}
+
+void PoissonPIC::ApplyOperator(
+    const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &in,
+    Nektar::Array<Nektar::OneD, Nektar::NekDouble> &out) {
+  m_assembly_map->GlobalToLocal(in, m_wsp_local0);
+  const int num_expansions = m_elemental_matrices.size();
+  for (int ex = 0; ex < num_expansions; ex++) {
+    const auto &matrix = m_elemental_matrices[ex];
+    const int offset = m_u_field->GetCoeff_Offset(ex);
+    const int num_coeffs = matrix->GetRows();
+    Blas::Dgemv('N', num_coeffs, num_coeffs, matrix->Scale(),
+                matrix->GetRawPtr(), num_coeffs, m_wsp_local0.data() + offset,
+                1, 0.0, m_wsp_local1.data() + offset, 1);
+  }
+  m_assembly_map->Assemble(m_wsp_local1, out);
+}
+
+Nektar::NekDouble PoissonPIC::GlobalDot(
+    const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &a,
+    const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &b) {
+  // Degrees of freedom shared between ranks are only counted once.
+  const auto &unique = m_assembly_map->GetGlobalToUniversalMapUnique();
+  Nektar::NekDouble value = 0.0;
+  for (int cx = 0; cx < m_num_global; cx++) {
+    value += unique[cx] * a[cx] * b[cx];
+  }
+  m_comm->GetRowComm()->AllReduce(value, LU::ReduceSum);
+  return value;
+}
+
+void PoissonPIC::RemoveMean(Nektar::Array<Nektar::OneD, Nektar::NekDouble> &x) {
+  const Nektar::NekDouble mean =
+      this->GlobalDot(x, m_basis_integrals) / m_volume;
+  Vmath::Svtvp(m_num_global, -mean, m_ones_global, 1, x, 1, x, 1);
+}
+
+void PoissonPIC::DoSolveMatrixFree() {
+  const int u_index = this->GetFieldIndex("u");
+  const int rho_index = this->GetFieldIndex("rho");
+  const int n = m_num_global;
+
+  // Assemble the RHS with the same sign convention as HelmSolve.
+  m_u_field->IProductWRTBase(m_fields[rho_index]->GetPhys(), m_wsp_local0);
+  Vmath::Neg(m_u_field->GetNcoeffs(), m_wsp_local0, 1);
+  m_assembly_map->Assemble(m_wsp_local0, m_rhs_global);
+
+  // Project out the null space component of the RHS such that the singular
+  // system is consistent.
+  const Nektar::NekDouble ones_norm2 =
+      this->GlobalDot(m_ones_global, m_ones_global);
+  const Nektar::NekDouble rhs_null =
+      this->GlobalDot(m_rhs_global, m_ones_global) / ones_norm2;
+  Vmath::Svtvp(n, -rhs_null, m_ones_global, 1, m_rhs_global, 1, m_rhs_global,
+               1);
+
+  const Nektar::NekDouble rhs_norm =
+      std::sqrt(this->GlobalDot(m_rhs_global, m_rhs_global));
+  m_num_iterations = 0;
+  m_residual = 0.0;
+  m_converged = true;
+
+  if (rhs_norm > 0.0) {
+    // Warm start from the previous solution: r = b - Ax, z = M^{-1}r, p = z.
+    this->ApplyOperator(m_solution_global, m_ap);
+    Vmath::Vsub(n, m_rhs_global, 1, m_ap, 1, m_r, 1);
+    Vmath::Vmul(n, m_inv_diag, 1, m_r, 1, m_z, 1);
+    Vmath::Vcopy(n, m_z, 1, m_p, 1);
+    Nektar::NekDouble rz = this->GlobalDot(m_r, m_z);
+    Nektar::NekDouble r_norm = std::sqrt(this->GlobalDot(m_r, m_r));
+    const Nektar::NekDouble tolerance = m_tolerance * rhs_norm;
+
+    while ((r_norm > tolerance) && (m_num_iterations < m_max_iterations)) {
+      this->ApplyOperator(m_p, m_ap);
+      const Nektar::NekDouble alpha = rz / this->GlobalDot(m_p, m_ap);
+      Vmath::Svtvp(n, alpha, m_p, 1, m_solution_global, 1, m_solution_global,
+                   1);
+      Vmath::Svtvp(n, -alpha, m_ap, 1, m_r, 1, m_r, 1);
+      Vmath::Vmul(n, m_inv_diag, 1, m_r, 1, m_z, 1);
+      const Nektar::NekDouble rz_new = this->GlobalDot(m_r, m_z);
+      const Nektar::NekDouble beta = rz_new / rz;
+      rz = rz_new;
+      Vmath::Svtvp(n, beta, m_p, 1, m_z, 1, m_p, 1);
+      r_norm = std::sqrt(this->GlobalDot(m_r, m_r));
+      m_num_iterations++;
+    }
+    // Non-convergence is recorded rather than fatal, the caller decides
+    // whether a solve that stopped at the iteration limit is acceptable.
+    m_residual = r_norm / rhs_norm;
+    m_converged = r_norm <= tolerance;
+  } else {
+    Vmath::Zero(n, m_solution_global, 1);
+  }
+  m_total_num_iterations += m_num_iterations;
+
+  // The solution of the singular system is chosen to have zero mean.
+  this->RemoveMean(m_solution_global);
+  m_assembly_map->GlobalToLocal(m_solution_global,
+                                m_fields[u_index]->UpdateCoeffs());
+  m_fields[u_index]->BwdTrans(m_fields[u_index]->GetCoeffs(),
+                              m_fields[u_index]->UpdatePhys());
+  m_fields[u_index]->SetPhysState(true);
 }
 
 PoissonPIC::~PoissonPIC() {}
 
 void PoissonPIC::v_GenerateSummary(SU::SummaryList &s) {
   SU::EquationSystem::SessionSummary(s);
+  SU::AddSummaryItem(s, "Poisson solve",
+                     m_matrix_free ? "Matrix-free Jacobi PCG" : "HelmSolve");
+  if (m_matrix_free) {
+    SU::AddSummaryItem(s, "Poisson tolerance", m_tolerance);
+  }
 }
 
 Nektar::Array<Nektar::OneD, bool> PoissonPIC::v_GetSystemSingularChecks() {
@@ -49,6 +250,10 @@ Nektar::Array<Nektar::OneD, bool> PoissonPIC::v_GetSystemSingularChecks() {
 }
 
 void PoissonPIC::v_DoSolve() {
+  if (m_matrix_free) {
+    this->DoSolveMatrixFree();
+    return;
+  }
   const int u_index = this->GetFieldIndex("u");
   const int rho_index = this->GetFieldIndex("rho");
   Vmath::Zero(m_fields[u_index]->GetNcoeffs(),
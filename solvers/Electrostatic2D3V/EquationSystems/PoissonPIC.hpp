@@ -1,12 +1,18 @@
 #ifndef __NESOSOLVERS_ELECTROSTATIC2D3V_POISSONPIC_HPP__
 #define __NESOSOLVERS_ELECTROSTATIC2D3V_POISSONPIC_HPP__
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include <MultiRegions/AssemblyMap/AssemblyMapCG.h>
+#include <MultiRegions/ContField.h>
 #include <SolverUtils/EquationSystem.h>
 
 namespace LU = Nektar::LibUtilities;
+namespace MR = Nektar::MultiRegions;
 namespace SD = Nektar::SpatialDomains;
 namespace SR = Nektar::StdRegions;
 namespace SU = Nektar::SolverUtils;
@@ -40,8 +46,76 @@ public:
    */
   int GetFieldIndex(const std::string name);
 
+  /**
+   *  Get the number of Krylov iterations performed by the most recent solve.
+   *
+   *  @returns Iteration count or -1 if the Nektar++ linear solver is in use.
+   */
+  int GetNumIterations();
+
+  /**
+   *  Get the number of Krylov iterations summed over all solves.
+   *
+   *  @returns Iteration count or -1 if the Nektar++ linear solver is in use.
+   */
+  int64_t GetTotalNumIterations();
+
+  /**
+   *  Get the relative residual norm at the end of the most recent solve.
+   *
+   *  @returns Residual norm divided by the RHS norm, 0 if the Nektar++ linear
+   *  solver is in use.
+   */
+  Nektar::NekDouble GetResidual();
+
+  /**
+   *  Determine if the most recent solve reached the requested tolerance.
+   *
+   *  @returns False if the matrix-free solve stopped at the iteration limit.
+   */
+  bool HasConverged();
+
 protected:
   SR::ConstFactorMap m_factors;
+
+  /// Solve with the matrix-free preconditioned CG implementation instead of
+  /// the Nektar++ HelmSolve path.
+  bool m_matrix_free;
+  /// Relative residual tolerance for the matrix-free solve.
+  Nektar::NekDouble m_tolerance;
+  /// Maximum number of iterations for the matrix-free solve.
+  int m_max_iterations;
+  /// Number of iterations in the last matrix-free solve.
+  int m_num_iterations;
+  /// Total number of iterations over all matrix-free solves.
+  int64_t m_total_num_iterations;
+  /// Relative residual norm at the end of the last matrix-free solve.
+  Nektar::NekDouble m_residual;
+  /// True if the last matrix-free solve reached the tolerance.
+  bool m_converged;
+
+  /// Continuous expansion for u used by the matrix-free solve.
+  std::shared_ptr<MR::ContField> m_u_field;
+  /// Local to global map for u used by the matrix-free solve.
+  MR::AssemblyMapCGSharedPtr m_assembly_map;
+  /// Elemental Helmholtz matrices, the global operator is never assembled.
+  std::vector<Nektar::DNekScalMatSharedPtr> m_elemental_matrices;
+  /// Number of rank local global degrees of freedom.
+  int m_num_global;
+  /// Inverse of the assembled operator diagonal (Jacobi preconditioner).
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> m_inv_diag;
+  /// Global coefficients of the unit field.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> m_ones_global;
+  /// Integrals of the global basis functions.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> m_basis_integrals;
+  /// Solution from the previous solve, used as the initial guess.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> m_solution_global;
+  /// Work arrays for the matrix-free solve.
+  Nektar::Array<Nektar::OneD, Nektar::NekDouble> m_rhs_global, m_r, m_z, m_p,
+      m_ap, m_wsp_local0, m_wsp_local1;
+  /// Volume of the domain.
+  Nektar::NekDouble m_volume;
+
   PoissonPIC(const LU::SessionReaderSharedPtr &pSession,
              const SD::MeshGraphSharedPtr &pGraph);
 
@@ -51,6 +125,22 @@ protected:
 
 private:
   virtual Nektar::Array<Nektar::OneD, bool> v_GetSystemSingularChecks();
+
+  /// Set up the persistent operator data for the matrix-free solve.
+  void SetupMatrixFree();
+  /// Solve the Poisson equation with the matrix-free solve.
+  void DoSolveMatrixFree();
+  /// Apply the assembled operator to a vector of global coefficients.
+  void
+  ApplyOperator(const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &in,
+                Nektar::Array<Nektar::OneD, Nektar::NekDouble> &out);
+  /// Inner product of two vectors of global coefficients over all ranks.
+  Nektar::NekDouble
+  GlobalDot(const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &a,
+            const Nektar::Array<Nektar::OneD, const Nektar::NekDouble> &b);
+  /// Remove the component of a global coefficient vector in the null space
+  /// (constant functions) such that the represented function has zero mean.
+  void RemoveMean(Nektar::Array<Nektar::OneD, Nektar::NekDouble> &x);
 };
 } // namespace NESO::Solvers::Electrostatic2D3V
 
@@ -10,10 +10,13 @@
 
 #include <LibUtilities/BasicUtils/SessionReader.h>
 #include <boost/math/special_functions/erf.hpp>
+#include <io/particle_checkpoint.hpp>
 #include <nektar_interface/function_evaluation.hpp>
 #include <nektar_interface/function_projection.hpp>
 #include <nektar_interface/geometry_transport/halo_extension.hpp>
 #include <nektar_interface/particle_interface.hpp>
+#include <nektar_interface/solver_base/species_constants.hpp>
+#include <nektar_interface/step_profiler.hpp>
 #include <neso_particles.hpp>
 #include <particle_utility/position_distribution.hpp>
 
@@ -145,8 +148,6 @@ private:
           initial_distribution[NP::Sym<NP::REAL>("V")][px][1] = 0.0;
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
               this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              this->particle_mass;
         }
       } else if (distribution_position == 1) {
         double initial_velocity;
@@ -183,8 +184,6 @@ private:
           initial_distribution[NP::Sym<NP::REAL>("V")][px][1] = 0.0;
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
               this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              this->particle_mass;
         }
       } else if (distribution_position == 2) {
         double initial_velocity;
@@ -210,8 +209,6 @@ private:
           initial_distribution[NP::Sym<NP::REAL>("V")][px][1] = 0.0;
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
               this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              this->particle_mass;
         }
       } else if (distribution_position == 3) {
         double initial_velocity;
@@ -234,10 +231,11 @@ private:
               (species) ? 0.0 : initial_velocity;
           ;
           initial_distribution[NP::Sym<NP::REAL>("V")][px][1] = 0.0;
+          const int species_index = (species) ? 1 : 0;
+          initial_distribution[this->species_constants->species_sym][px][0] =
+              species_index;
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
-              (species) ? this->particle_charge : -1.0 * this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              (species) ? this->particle_mass * 1000000 : this->particle_mass;
+              this->species_constants->get(species_index, "Q");
         }
       } else if (distribution_position == 4) {
         // 3V Maxwellian
@@ -283,8 +281,6 @@ private:
 
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
               this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              this->particle_mass;
         }
       } else if (distribution_position == 5) {
         double initial_velocity;
@@ -308,8 +304,6 @@ private:
           initial_distribution[NP::Sym<NP::REAL>("V")][px][2] = 0.0;
           initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] =
               this->particle_charge;
-          initial_distribution[NP::Sym<NP::REAL>("M")][px][0] =
-              this->particle_mass;
         }
       }
 
@@ -382,6 +376,13 @@ public:
   std::shared_ptr<CellIDTranslation> cell_id_translation;
   /// Trajectory writer for particles.
   std::shared_ptr<NP::H5Part> h5part;
+  /// Profiler for the particle work in each step, disabled by default.
+  StepProfilerSharedPtr step_profiler;
+  /// Charge "Q" and mass "M" of each species.
+  SpeciesConstantsSharedPtr species_constants;
+  /// Moves particles directly to halo neighbours, null unless enabled with
+  /// particle_neighbour_transfer.
+  std::shared_ptr<NeighbourTransfer> neighbour_transfer;
 
   /**
    *  Set the constant and uniform magnetic field over the entire domain.
@@ -423,6 +424,7 @@ public:
       : session(session), graph(graph), comm(comm), tol(1.0e-8),
         h5part_exists(false) {
 
+    this->step_profiler = std::make_shared<StepProfiler>();
     this->B_0 = 0.0;
     this->B_1 = 0.0;
     this->B_2 = 0.0;
@@ -458,23 +460,43 @@ public:
 
     this->sycl_target = std::make_shared<NP::SYCLTarget>(
         0, particle_mesh_interface->get_comm());
+    // Optionally store the reference positions in reduced precision, in place
+    // of the REAL NESO_REFERENCE_POSITIONS ParticleDat.
+    int reduced_precision = 0;
+    if (this->session->DefinesParameter("particle_reduced_precision")) {
+      this->session->LoadParameter("particle_reduced_precision",
+                                   reduced_precision);
+    }
+    auto mapper_config = std::make_shared<ParameterStore>();
+    mapper_config->set<INT>("NektarGraphLocalMapper/reduced_precision",
+                            reduced_precision);
     this->nektar_graph_local_mapper = std::make_shared<NektarGraphLocalMapper>(
-        this->sycl_target, this->particle_mesh_interface);
+        this->sycl_target, this->particle_mesh_interface, mapper_config);
     this->domain = std::make_shared<NP::Domain>(
         this->particle_mesh_interface, this->nektar_graph_local_mapper);
 
+    // The two stream distribution has a second, heavy, species of opposite
+    // charge. Charge and mass are uniform per species.
+    int distribution_position = -1;
+    this->session->LoadParameter("particle_distribution_position",
+                                 distribution_position);
+    const int num_species = (distribution_position == 3) ? 2 : 1;
+    this->species_constants = std::make_shared<SpeciesConstants>(
+        num_species, std::vector<std::string>{"Q", "M"});
+
     // Create ParticleGroup
     ParticleSpec particle_spec{
         NP::ParticleProp(NP::Sym<NP::REAL>("P"), 2, true),
         NP::ParticleProp(NP::Sym<NP::INT>("CELL_ID"), 1, true),
         NP::ParticleProp(NP::Sym<NP::INT>("PARTICLE_ID"), 1),
         NP::ParticleProp(NP::Sym<NP::REAL>("Q"), 1),
-        NP::ParticleProp(NP::Sym<NP::REAL>("M"), 1),
         NP::ParticleProp(NP::Sym<NP::REAL>("V"), 3),
         NP::ParticleProp(NP::Sym<NP::REAL>("E"), 2)};
+    this->species_constants->add_to_spec(particle_spec);
 
     this->particle_group = std::make_shared<NP::ParticleGroup>(
         this->domain, particle_spec, this->sycl_target);
+    this->species_constants->setup_sub_groups(this->particle_group);
 
     // Setup PBC boundary conditions.
     this->boundary_conditions = std::make_shared<NektarCartesianPeriodic>(
@@ -485,6 +507,19 @@ public:
         this->sycl_target, this->particle_group->cell_id_dat,
         this->particle_mesh_interface);
 
+    // Optionally transfer particles directly to halo neighbours
+    int neighbour_transfer_enabled, neighbour_transfer_stats;
+    this->session->LoadParameter("particle_neighbour_transfer",
+                                 neighbour_transfer_enabled, 0);
+    this->session->LoadParameter("particle_neighbour_transfer_stats",
+                                 neighbour_transfer_stats, 0);
+    if (neighbour_transfer_enabled) {
+      this->neighbour_transfer = std::make_shared<NeighbourTransfer>(
+          this->particle_group, this->particle_mesh_interface,
+          this->cell_id_translation,
+          neighbour_transfer_stats ? "neighbour_transfer_stats.csv" : "");
+    }
+
     const double volume = this->boundary_conditions->global_extent[0] *
                           this->boundary_conditions->global_extent[1];
 
@@ -519,45 +554,132 @@ public:
       // TODO throw!
     }
 
-    // Add particle to the particle group
-    this->add_particles();
+    if (num_species == 1) {
+      this->species_constants->set(0, "Q", this->particle_charge);
+      this->species_constants->set(0, "M", this->particle_mass);
+    } else {
+      this->species_constants->set(0, "Q", -1.0 * this->particle_charge);
+      this->species_constants->set(0, "M", this->particle_mass);
+      this->species_constants->set(1, "Q", this->particle_charge);
+      this->species_constants->set(1, "M", this->particle_mass * 1000000);
+    }
+
+    // Add particles to the particle group, or restore them from a checkpoint
+    if (this->session->DefinesSolverInfo("ParticleRestartFile")) {
+      this->read_checkpoint(
+          this->session->GetSolverInfo("ParticleRestartFile"));
+    } else {
+      this->add_particles();
+    }
 
     // create a Boris integrator
     this->integrator_boris = std::make_shared<IntegratorBorisUniformB>(
-        this->particle_group, this->dt, this->B_0, this->B_1, this->B_2,
-        this->particle_E_coefficient);
+        this->particle_group, this->species_constants, this->dt, this->B_0,
+        this->B_1, this->B_2, this->particle_E_coefficient);
   };
 
   /**
    *  Write current particle state to trajectory.
    */
   inline void write() {
+    StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                              "ChargedParticles::write");
     if (!this->h5part_exists) {
-      // Create instance to write particle data to h5 file
-      this->h5part = std::make_shared<NP::H5Part>(
-          "Electrostatic2D3V_particle_trajectory.h5part", this->particle_group,
-          NP::Sym<NP::REAL>("P"), NP::Sym<NP::INT>("CELL_ID"),
-          NP::Sym<NP::REAL>("V"), NP::Sym<NP::REAL>("E"),
-          NP::Sym<NP::INT>("NESO_MPI_RANK"), NP::Sym<NP::INT>("PARTICLE_ID"),
-          NP::Sym<NP::REAL>("NESO_REFERENCE_POSITIONS"));
+      // Create instance to write particle data to h5 file. Reference
+      // positions held in reduced precision are packed, hence not written.
+      if (this->particle_group->contains_dat(
+              ReducedPrecision::get_reference_positions_sym())) {
+        this->h5part = std::make_shared<NP::H5Part>(
+            "Electrostatic2D3V_particle_trajectory.h5part",
+            this->particle_group, NP::Sym<NP::REAL>("P"),
+            NP::Sym<NP::INT>("CELL_ID"), NP::Sym<NP::REAL>("V"),
+            NP::Sym<NP::REAL>("E"), NP::Sym<NP::INT>("NESO_MPI_RANK"),
+            NP::Sym<NP::INT>("PARTICLE_ID"));
+      } else {
+        this->h5part = std::make_shared<NP::H5Part>(
+            "Electrostatic2D3V_particle_trajectory.h5part",
+            this->particle_group, NP::Sym<NP::REAL>("P"),
+            NP::Sym<NP::INT>("CELL_ID"), NP::Sym<NP::REAL>("V"),
+            NP::Sym<NP::REAL>("E"), NP::Sym<NP::INT>("NESO_MPI_RANK"),
+            NP::Sym<NP::INT>("PARTICLE_ID"),
+            NP::Sym<NP::REAL>("NESO_REFERENCE_POSITIONS"));
+      }
       this->h5part_exists = true;
     }
 
     this->h5part->write();
   }
 
+  /**
+   *  Write the particles to a checkpoint file which can be restarted from by
+   *  setting the ParticleRestartFile SOLVERINFO. Must be called collectively.
+   *
+   *  @param step Time step number, appended to the checkpoint file name.
+   */
+  inline void write_checkpoint(const int step) {
+    StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                              "ChargedParticles::write_checkpoint");
+    IO::ParticleCheckpointWriter writer(
+        "Electrostatic2D3V_particle_checkpoint_" + std::to_string(step) + ".h5",
+        this->sycl_target->comm_pair.comm_parent);
+    writer.write_particles(this->particle_group);
+    writer.write_value("step", static_cast<NP::INT>(step));
+    writer.close();
+  }
+
+  /**
+   *  Restore the particles from a checkpoint file written by
+   *  write_checkpoint. The particles are moved to their owning ranks, which
+   *  need not match the number of ranks that wrote the checkpoint. Must be
+   *  called collectively.
+   *
+   *  @param filename Checkpoint file to read.
+   */
+  inline void read_checkpoint(const std::string &filename) {
+    IO::ParticleCheckpointReader reader(
+        filename, this->sycl_target->comm_pair.comm_parent);
+    const NP::INT npart = reader.read_particles(this->particle_group);
+    reader.close();
+    if (this->sycl_target->comm_pair.rank_parent == 0) {
+      NP::nprint("Restored", npart, "particles from checkpoint", filename);
+    }
+  }
+
   /**
    *  Apply boundary conditions and transfer particles between MPI ranks.
    */
   inline void transfer_particles() {
-    auto t0 = NP::profile_timestamp();
+    if (this->neighbour_transfer) {
+      StepProfilerRegion region(this->step_profiler, StepRegion::Transfer,
+                                "ChargedParticles::neighbour_transfer");
+      this->boundary_conditions->execute();
+      this->neighbour_transfer->execute();
+      return;
+    }
+
+    StepProfilerRegion region_move(this->step_profiler, StepRegion::Transfer,
+                                   "ChargedParticles::hybrid_move");
     this->boundary_conditions->execute();
     this->particle_group->hybrid_move();
-    this->cell_id_translation->execute();
+    region_move.end();
+
+    StepProfilerRegion region_cell_move(this->step_profiler,
+                                        StepRegion::Transfer,
+                                        "ChargedParticles::cell_move");
     this->particle_group->cell_move();
-    this->sycl_target->profile_map.inc(
-        "ChargedParticles", "transfer_particles", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
+  }
+
+  /**
+   * Set the profiler which records the particle work in each step.
+   *
+   * @param step_profiler Step profiler owned by the simulation.
+   */
+  inline void set_step_profiler(StepProfilerSharedPtr step_profiler) {
+    this->step_profiler = step_profiler;
+    this->nektar_graph_local_mapper->set_step_profiler(step_profiler);
+    if (this->neighbour_transfer) {
+      this->neighbour_transfer->set_step_profiler(step_profiler);
+    }
   }
 
   /**
@@ -567,6 +689,9 @@ public:
     if (this->h5part_exists) {
       this->h5part->close();
     }
+    if (this->neighbour_transfer) {
+      this->neighbour_transfer->free();
+    }
     this->particle_group->free();
     this->particle_mesh_interface->free();
     this->sycl_target->free();
@@ -576,33 +701,33 @@ public:
    * Velocity Verlet - First step.
    */
   inline void velocity_verlet_1() {
-    auto t0 = NP::profile_timestamp();
+    StepProfilerRegion region(this->step_profiler, StepRegion::ParticlePush,
+                              "ChargedParticles::velocity_verlet_1");
     const double k_dt = this->dt;
     const double k_dht = this->dt * 0.5;
     const NP::REAL k_E_coefficient = this->particle_E_coefficient;
 
-    NP::particle_loop(
-        "ChargedParticles::velocity_verlet_1", this->particle_group,
-        [=](auto k_Q, auto k_E, auto k_M, auto k_V, auto k_P) {
-          const double Q = k_Q.at(0);
-          const double dht_inverse_particle_mass =
-              k_E_coefficient * k_dht * Q / k_M.at(0);
-          k_V.at(0) -= k_E.at(0) * dht_inverse_particle_mass;
-          k_V.at(1) -= k_E.at(1) * dht_inverse_particle_mass;
-
-          k_P.at(0) += k_dt * k_V.at(0);
-          k_P.at(1) += k_dt * k_V.at(1);
-        },
-        NP::Access::read(NP::Sym<NP::REAL>("Q")),
-        NP::Access::read(NP::Sym<NP::REAL>("E")),
-        NP::Access::read(NP::Sym<NP::REAL>("M")),
-        NP::Access::write(NP::Sym<NP::REAL>("V")),
-        NP::Access::write(NP::Sym<NP::REAL>("P")))
-        ->execute();
-
-    sycl_target->profile_map.inc(
-        "ChargedParticles", "VelocityVerlet_1_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
+    const int num_species = this->species_constants->get_num_species();
+    for (int sx = 0; sx < num_species; sx++) {
+      const double dht_inverse_particle_mass =
+          k_E_coefficient * k_dht * this->species_constants->get(sx, "Q") /
+          this->species_constants->get(sx, "M");
+      NP::particle_loop(
+          "ChargedParticles::velocity_verlet_1",
+          this->species_constants->get_sub_group(sx),
+          [=](auto k_E, auto k_V, auto k_P) {
+            k_V.at(0) -= k_E.at(0) * dht_inverse_particle_mass;
+            k_V.at(1) -= k_E.at(1) * dht_inverse_particle_mass;
+
+            k_P.at(0) += k_dt * k_V.at(0);
+            k_P.at(1) += k_dt * k_V.at(1);
+          },
+          NP::Access::read(NP::Sym<NP::REAL>("E")),
+          NP::Access::write(NP::Sym<NP::REAL>("V")),
+          NP::Access::write(NP::Sym<NP::REAL>("P")))
+          ->execute();
+    }
+    region.end();
 
     // positions were written so we apply boundary conditions and move
     // particles between ranks
@@ -613,40 +738,46 @@ public:
    * Velocity Verlet - Second step.
    */
   inline void velocity_verlet_2() {
-    auto t0 = NP::profile_timestamp();
+    StepProfilerRegion region(this->step_profiler, StepRegion::ParticlePush,
+                              "ChargedParticles::velocity_verlet_2");
     const double k_dht = this->dt * 0.5;
     const NP::REAL k_E_coefficient = this->particle_E_coefficient;
 
-    NP::particle_loop(
-        "ChargedParticles::velocity_verlet_2", this->particle_group,
-        [=](auto k_Q, auto k_E, auto k_M, auto k_V) {
-          const double Q = k_Q.at(0);
-          const double dht_inverse_particle_mass =
-              k_E_coefficient * k_dht * Q / k_M.at(0);
-          k_V.at(0) -= k_E.at(0) * dht_inverse_particle_mass;
-          k_V.at(1) -= k_E.at(1) * dht_inverse_particle_mass;
-        },
-        NP::Access::read(NP::Sym<NP::REAL>("Q")),
-        NP::Access::read(NP::Sym<NP::REAL>("E")),
-        NP::Access::read(NP::Sym<NP::REAL>("M")),
-        NP::Access::write(NP::Sym<NP::REAL>("V")))
-        ->execute();
-
-    sycl_target->profile_map.inc(
-        "ChargedParticles", "VelocityVerlet_2_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
+    const int num_species = this->species_constants->get_num_species();
+    for (int sx = 0; sx < num_species; sx++) {
+      const double dht_inverse_particle_mass =
+          k_E_coefficient * k_dht * this->species_constants->get(sx, "Q") /
+          this->species_constants->get(sx, "M");
+      NP::particle_loop(
+          "ChargedParticles::velocity_verlet_2",
+          this->species_constants->get_sub_group(sx),
+          [=](auto k_E, auto k_V) {
+            k_V.at(0) -= k_E.at(0) * dht_inverse_particle_mass;
+            k_V.at(1) -= k_E.at(1) * dht_inverse_particle_mass;
+          },
+          NP::Access::read(NP::Sym<NP::REAL>("E")),
+          NP::Access::write(NP::Sym<NP::REAL>("V")))
+          ->execute();
+    }
   }
 
   /**
    * Boris - First step.
    */
-  inline void boris_1() { this->integrator_boris->boris_1(); }
+  inline void boris_1() {
+    StepProfilerRegion region(this->step_profiler, StepRegion::ParticlePush,
+                              "ChargedParticles::boris_1");
+    this->integrator_boris->boris_1();
+  }
 
   /**
    * Boris - Second step.
    */
   inline void boris_2() {
+    StepProfilerRegion region(this->step_profiler, StepRegion::ParticlePush,
+                              "ChargedParticles::boris_2");
     this->integrator_boris->boris_2();
+    region.end();
     // positions were written so we apply boundary conditions and move
     // particles between ranks
     this->transfer_particles();
@@ -1,6 +1,7 @@
 #ifndef __NESOSOLVERS_ELECTROSTATIC2D3V_BORISINTEGRATOR_HPP__
 #define __NESOSOLVERS_ELECTROSTATIC2D3V_BORISINTEGRATOR_HPP__
 
+#include <nektar_interface/solver_base/species_constants.hpp>
 #include <neso_particles.hpp>
 
 namespace NP = NESO::Particles;
@@ -19,6 +20,7 @@ class IntegratorBorisUniformB {
 private:
   NP::ParticleGroupSharedPtr particle_group;
   NP::SYCLTargetSharedPtr sycl_target;
+  SpeciesConstantsSharedPtr species_constants;
 
   double dt;
   double B_0;
@@ -51,11 +53,25 @@ public:
     this->particle_E_coefficient = x;
   }
 
-  IntegratorBorisUniformB(NP::ParticleGroupSharedPtr particle_group, double &dt,
-                          double &B_0, double &B_1, double &B_2,
+  /**
+   *  Create an integrator for a ParticleGroup.
+   *
+   *  @param particle_group ParticleGroup to integrate.
+   *  @param species_constants Charge "Q" and mass "M" of each species, with
+   *  the iteration sets of the species set up.
+   *  @param dt Time step size.
+   *  @param B_0 Magnetic field B in x direction.
+   *  @param B_1 Magnetic field B in y direction.
+   *  @param B_2 Magnetic field B in z direction.
+   *  @param particle_E_coefficient Scaling coefficient for the electric field.
+   */
+  IntegratorBorisUniformB(NP::ParticleGroupSharedPtr particle_group,
+                          SpeciesConstantsSharedPtr species_constants,
+                          double &dt, double &B_0, double &B_1, double &B_2,
                           double &particle_E_coefficient)
       : particle_group(particle_group),
-        sycl_target(particle_group->sycl_target), dt(dt), B_0(B_0), B_1(B_1),
+        sycl_target(particle_group->sycl_target),
+        species_constants(species_constants), dt(dt), B_0(B_0), B_1(B_1),
         B_2(B_2), particle_E_coefficient(particle_E_coefficient) {}
 
   /**
@@ -77,72 +93,75 @@ public:
     const double k_B_2 = this->B_2;
     const NP::REAL k_E_coefficient = this->particle_E_coefficient;
 
-    NP::particle_loop(
-        "IntegratorBorisUniformB::boris_2", this->particle_group,
-        [=](auto k_P, auto k_V, auto k_M, auto k_E, auto k_Q) {
-          const NP::REAL Q = k_Q.at(0);
-          const NP::REAL M = k_M.at(0);
-          const NP::REAL QoM = Q / M;
-
-          const NP::REAL scaling_t = QoM * k_dht;
-          const NP::REAL t_0 = k_B_0 * scaling_t;
-          const NP::REAL t_1 = k_B_1 * scaling_t;
-          const NP::REAL t_2 = k_B_2 * scaling_t;
-
-          const NP::REAL tmagsq = t_0 * t_0 + t_1 * t_1 + t_2 * t_2;
-          const NP::REAL scaling_s = 2.0 / (1.0 + tmagsq);
-
-          const NP::REAL s_0 = scaling_s * t_0;
-          const NP::REAL s_1 = scaling_s * t_1;
-          const NP::REAL s_2 = scaling_s * t_2;
-
-          const NP::REAL V_0 = k_V.at(0);
-          const NP::REAL V_1 = k_V.at(1);
-          const NP::REAL V_2 = k_V.at(2);
-
-          // The E dat contains d(phi)/dx not E -> multiply by -1.
-          const NP::REAL v_minus_0 =
-              V_0 + (-1.0 * k_E.at(0)) * scaling_t * k_E_coefficient;
-          const NP::REAL v_minus_1 =
-              V_1 + (-1.0 * k_E.at(1)) * scaling_t * k_E_coefficient;
-          // E is zero in the z direction
-          const NP::REAL v_minus_2 = V_2;
-
-          NP::REAL v_prime_0, v_prime_1, v_prime_2;
-          ELEC_PIC_2D3V_CROSS_PRODUCT_3D(v_minus_0, v_minus_1, v_minus_2, t_0,
-                                         t_1, t_2, v_prime_0, v_prime_1,
-                                         v_prime_2)
-
-          v_prime_0 += v_minus_0;
-          v_prime_1 += v_minus_1;
-          v_prime_2 += v_minus_2;
-
-          NP::REAL v_plus_0, v_plus_1, v_plus_2;
-          ELEC_PIC_2D3V_CROSS_PRODUCT_3D(v_prime_0, v_prime_1, v_prime_2, s_0,
-                                         s_1, s_2, v_plus_0, v_plus_1, v_plus_2)
-
-          v_plus_0 += v_minus_0;
-          v_plus_1 += v_minus_1;
-          v_plus_2 += v_minus_2;
-
-          // The E dat contains d(phi)/dx not E -> multiply by -1.
-          k_V.at(0) =
-              v_plus_0 + scaling_t * (-1.0 * k_E.at(0)) * k_E_coefficient;
-          k_V.at(1) =
-              v_plus_1 + scaling_t * (-1.0 * k_E.at(1)) * k_E_coefficient;
-          // E is zero in the z direction
-          k_V.at(2) = v_plus_2;
-
-          // update of position to next time step
-          k_P.at(0) += k_dt * k_V.at(0);
-          k_P.at(1) += k_dt * k_V.at(1);
-        },
-        NP::Access::write(NP::Sym<NP::REAL>("P")),
-        NP::Access::write(NP::Sym<NP::REAL>("V")),
-        NP::Access::read(NP::Sym<NP::REAL>("M")),
-        NP::Access::read(NP::Sym<NP::REAL>("E")),
-        NP::Access::read(NP::Sym<NP::REAL>("Q")))
-        ->execute();
+    // Charge and mass are uniform per species, hence each species is pushed
+    // with its own charge to mass ratio.
+    const int num_species = this->species_constants->get_num_species();
+    for (int sx = 0; sx < num_species; sx++) {
+      const NP::REAL QoM = this->species_constants->get(sx, "Q") /
+                           this->species_constants->get(sx, "M");
+      NP::particle_loop(
+          "IntegratorBorisUniformB::boris_2",
+          this->species_constants->get_sub_group(sx),
+          [=](auto k_P, auto k_V, auto k_E) {
+            const NP::REAL scaling_t = QoM * k_dht;
+            const NP::REAL t_0 = k_B_0 * scaling_t;
+            const NP::REAL t_1 = k_B_1 * scaling_t;
+            const NP::REAL t_2 = k_B_2 * scaling_t;
+
+            const NP::REAL tmagsq = t_0 * t_0 + t_1 * t_1 + t_2 * t_2;
+            const NP::REAL scaling_s = 2.0 / (1.0 + tmagsq);
+
+            const NP::REAL s_0 = scaling_s * t_0;
+            const NP::REAL s_1 = scaling_s * t_1;
+            const NP::REAL s_2 = scaling_s * t_2;
+
+            const NP::REAL V_0 = k_V.at(0);
+            const NP::REAL V_1 = k_V.at(1);
+            const NP::REAL V_2 = k_V.at(2);
+
+            // The E dat contains d(phi)/dx not E -> multiply by -1.
+            const NP::REAL v_minus_0 =
+                V_0 + (-1.0 * k_E.at(0)) * scaling_t * k_E_coefficient;
+            const NP::REAL v_minus_1 =
+                V_1 + (-1.0 * k_E.at(1)) * scaling_t * k_E_coefficient;
+            // E is zero in the z direction
+            const NP::REAL v_minus_2 = V_2;
+
+            NP::REAL v_prime_0, v_prime_1, v_prime_2;
+            ELEC_PIC_2D3V_CROSS_PRODUCT_3D(v_minus_0, v_minus_1, v_minus_2, t_0,
+                                           t_1, t_2, v_prime_0, v_prime_1,
+                                           v_prime_2)
+
+            v_prime_0 += v_minus_0;
+            v_prime_1 += v_minus_1;
+            v_prime_2 += v_minus_2;
+
+            NP::REAL v_plus_0, v_plus_1, v_plus_2;
+            ELEC_PIC_2D3V_CROSS_PRODUCT_3D(v_prime_0, v_prime_1, v_prime_2,
+                                           s_0, s_1, s_2, v_plus_0, v_plus_1,
+                                           v_plus_2)
+
+            v_plus_0 += v_minus_0;
+            v_plus_1 += v_minus_1;
+            v_plus_2 += v_minus_2;
+
+            // The E dat contains d(phi)/dx not E -> multiply by -1.
+            k_V.at(0) =
+                v_plus_0 + scaling_t * (-1.0 * k_E.at(0)) * k_E_coefficient;
+            k_V.at(1) =
+                v_plus_1 + scaling_t * (-1.0 * k_E.at(1)) * k_E_coefficient;
+            // E is zero in the z direction
+            k_V.at(2) = v_plus_2;
+
+            // update of position to next time step
+            k_P.at(0) += k_dt * k_V.at(0);
+            k_P.at(1) += k_dt * k_V.at(1);
+          },
+          NP::Access::write(NP::Sym<NP::REAL>("P")),
+          NP::Access::write(NP::Sym<NP::REAL>("V")),
+          NP::Access::read(NP::Sym<NP::REAL>("E")))
+          ->execute();
+    }
 
     this->sycl_target->profile_map.inc(
         "IntegratorBorisUniformB", "Boris_2_Execute", 1,
@@ -1,9 +1,11 @@
 #ifndef __NESOSOLVERS_ELECTROSTATIC2D3V_POISSONPARTICLECOUPLING_HPP__
 #define __NESOSOLVERS_ELECTROSTATIC2D3V_POISSONPARTICLECOUPLING_HPP__
 
+#include <nektar_interface/function_basis_projection.hpp>
 #include <nektar_interface/function_evaluation.hpp>
 #include <nektar_interface/function_projection.hpp>
 #include <nektar_interface/particle_interface.hpp>
+#include <nektar_interface/particle_shape.hpp>
 #include <nektar_interface/utilities.hpp>
 #include <neso_particles.hpp>
 
@@ -12,6 +14,8 @@
 #include <SolverUtils/Driver.h>
 #include <SolverUtils/EquationSystem.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -20,6 +24,7 @@
 #include <mpi.h>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "../EquationSystems/PoissonPIC.hpp"
 #include "ChargedParticles.hpp"
@@ -33,14 +38,32 @@ using Nektar::NekDouble;
 using Nektar::OneD;
 namespace NESO::Solvers::Electrostatic2D3V {
 
+/**
+ *  Couples the charged particles to the Poisson solve. Each call to
+ *  compute_field runs the following pipeline of stages:
+ *
+ *    1) deposit: the particle charges are projected into a RHS vector which
+ *       remains in device memory.
+ *    2) neutralise: the total charge is reduced on the device and the RHS is
+ *       neutralised and rescaled by the particle weight on the device.
+ *    3) solve: the RHS is copied to the host once, the mass matrix system is
+ *       solved and the Poisson equation is solved.
+ *    4) gather: the gradient of the potential is evaluated at the particle
+ *       locations.
+ *
+ *  All buffers used by the pipeline are allocated once at construction and
+ *  reused for every step. Each stage is recorded as a region of the step
+ *  profiler of the charged particles.
+ */
 template <typename T> class PoissonParticleCoupling {
 private:
   LU::SessionReaderSharedPtr session;
   SD::MeshGraphSharedPtr graph;
   SU::DriverSharedPtr driver;
   std::shared_ptr<ChargedParticles> charged_particles;
+  NP::SYCLTargetSharedPtr sycl_target;
 
-  std::shared_ptr<FieldProject<T>> field_project;
+  std::shared_ptr<FunctionProjectBasis<T>> function_project_basis;
   std::shared_ptr<FieldEvaluate<T>> field_evaluate;
 
   Array<OneD, SU::EquationSystemSharedPtr> equation_system;
@@ -54,64 +77,116 @@ private:
   Array<OneD, NekDouble> potential_phys;
   Array<OneD, NekDouble> potential_coeffs;
 
+  /// Host copy of the neutralised and scaled projection RHS.
+  Array<OneD, NekDouble> forcing_rhs;
+  /// Coefficients of the neutralising field on the device.
+  std::unique_ptr<NP::BufferDevice<NP::REAL>> d_ncd_coeff_values;
+  /// Projection RHS of the neutralising field on the device.
+  std::unique_ptr<NP::BufferDevice<NP::REAL>> d_ncd_rhs_values;
+  /// Space for the reduction of the total charge.
+  std::unique_ptr<NP::BufferDeviceHost<NP::REAL>> dh_total_charge;
+
   double volume;
   int tot_points_u;
   int tot_points_f;
   int num_coeffs_u;
   int num_coeffs_f;
 
-  inline void add_neutralising_field() {
-    // Modifiable reference to coeffs
-    auto coeffs = this->forcing_function->UpdateCoeffs();
-    const int num_coeffs_f = this->forcing_function->GetNcoeffs();
+  /// Number of calls to compute_field.
+  int64_t num_steps;
+
+  /**
+   *  Project the particle charges into the device RHS vector.
+   *
+   *  @returns Device pointer to the RHS vector.
+   */
+  inline NP::REAL *deposit() {
+    return this->function_project_basis->project_device(
+        this->charged_particles->particle_group,
+        this->charged_particles->get_charge_sym(), 0, this->num_coeffs_f);
+  }
 
-    // get the curent charge integral
-    const double total_charge = this->forcing_function->Integral();
+  /**
+   *  Add the neutralising field to the RHS and rescale by the particle weight.
+   *  The total charge is the inner product of the RHS with the coefficients of
+   *  the unit field, which are the negated neutralising coefficients. The
+   *  neutralised and scaled RHS is copied to the host.
+   *
+   *  @param d_rhs Device pointer to the RHS vector.
+   */
+  inline void neutralise(NP::REAL *d_rhs) {
+    auto &queue = this->sycl_target->queue;
+    const std::size_t num_coeffs = static_cast<std::size_t>(this->num_coeffs_f);
+    const NP::REAL *k_ncd_coeffs = this->d_ncd_coeff_values->ptr;
+    const NP::REAL *k_ncd_rhs = this->d_ncd_rhs_values->ptr;
+    NP::REAL *k_total_charge = this->dh_total_charge->d_buffer.ptr;
+    NP::REAL *k_rhs = d_rhs;
+
+    auto e_fill = queue.fill(k_total_charge, static_cast<NP::REAL>(0.0), 1);
+    auto e_reduce = queue.submit([&](sycl::handler &cgh) {
+      cgh.depends_on(e_fill);
+      cgh.parallel_for<>(
+          sycl::range<1>(num_coeffs),
+          sycl::reduction(k_total_charge, sycl::plus<NP::REAL>()),
+          [=](sycl::id<1> idx, auto &total) {
+            total += -k_rhs[idx] * k_ncd_coeffs[idx];
+          });
+    });
+    queue
+        .memcpy(this->dh_total_charge->h_buffer.ptr, k_total_charge,
+                sizeof(NP::REAL), e_reduce)
+        .wait_and_throw();
+
+    const double total_charge_local = this->dh_total_charge->h_buffer.ptr[0];
+    double total_charge;
+    MPICHK(MPI_Allreduce(&total_charge_local, &total_charge, 1, MPI_DOUBLE,
+                         MPI_SUM, this->sycl_target->comm_pair.comm_parent));
     NESOASSERT(std::isfinite(total_charge),
                "Total charge is not finite (e.g. NaN or Inf/-Inf).");
 
-    const double average_charge_density = total_charge / this->volume;
-    NESOASSERT(std::isfinite(average_charge_density),
+    const NP::REAL k_average_charge_density = total_charge / this->volume;
+    NESOASSERT(std::isfinite(k_average_charge_density),
                "Average charge density is not finite (e.g. NaN or Inf/-Inf).");
-
-    for (int cx = 0; cx < num_coeffs_f; cx++) {
-      NESOASSERT(std::isfinite(coeffs[cx]),
-                 "A forcing coefficient is not finite (e.g. NaN or Inf/-Inf).");
-      coeffs[cx] += this->ncd_coeff_values[cx] * average_charge_density;
-    }
-
-    // Modifiable reference to phys values
-    auto phys_values = this->forcing_function->UpdatePhys();
-    const int num_phys_f = this->forcing_function->GetTotPoints();
-    for (int cx = 0; cx < num_phys_f; cx++) {
-      NESOASSERT(std::isfinite(phys_values[cx]),
-                 "A phys value is not finite (e.g. NaN or Inf/-Inf).");
-      phys_values[cx] += this->ncd_phys_values[cx] * average_charge_density;
-    }
-
-    // integral should be approximately 0
-    const auto integral_forcing_func = this->forcing_function->Integral() *
-                                       this->charged_particles->particle_weight;
-
-    std::string error_msg =
-        "RHS is not neutral, log10 error: " +
-        std::to_string(std::log10(ABS(integral_forcing_func)));
-    NESOASSERT(ABS(integral_forcing_func) < 1.0e-6, error_msg.c_str());
+    const NP::REAL k_scaling_factor =
+        -this->charged_particles->particle_weight;
+
+    auto e_scale = queue.parallel_for<>(
+        sycl::range<1>(num_coeffs), [=](sycl::id<1> idx) {
+          k_rhs[idx] = k_scaling_factor *
+                       (k_rhs[idx] + k_average_charge_density * k_ncd_rhs[idx]);
+        });
+    queue
+        .memcpy(this->forcing_rhs.data(), k_rhs, num_coeffs * sizeof(NP::REAL),
+                e_scale)
+        .wait_and_throw();
   }
 
-  inline void solve_equation_system() {
-    auto phys_f = this->forcing_function->UpdatePhys();
+  /**
+   *  Solve the mass matrix system for the forcing function and then solve the
+   *  Poisson equation.
+   */
+  inline void solve() {
     auto coeffs_f = this->forcing_function->UpdateCoeffs();
-
-    const double scaling_factor = -this->charged_particles->particle_weight;
-    for (int cx = 0; cx < tot_points_f; cx++) {
-      phys_f[cx] *= scaling_factor;
-    }
-    for (int cx = 0; cx < num_coeffs_f; cx++) {
-      coeffs_f[cx] = scaling_factor;
+    auto phys_f = this->forcing_function->UpdatePhys();
+    multiply_by_inverse_mass_matrix(this->forcing_function, this->forcing_rhs,
+                                    coeffs_f);
+    this->forcing_function->BwdTrans(coeffs_f, phys_f);
+    this->poisson_pic->DoSolve();
+    if ((!this->poisson_pic->HasConverged()) &&
+        (this->sycl_target->comm_pair.rank_parent == 0)) {
+      NP::nprint("PoissonParticleCoupling warning: Poisson solve did not "
+                 "converge, relative residual:",
+                 this->poisson_pic->GetResidual(),
+                 "iterations:", this->poisson_pic->GetNumIterations());
     }
+  }
 
-    this->poisson_pic->DoSolve();
+  /**
+   *  Evaluate the derivative of the potential at the particle locations.
+   */
+  inline void gather() {
+    this->field_evaluate->evaluate(
+        this->charged_particles->get_potential_gradient_sym());
   }
 
 public:
@@ -125,7 +200,8 @@ public:
                           SU::DriverSharedPtr driver,
                           std::shared_ptr<ChargedParticles> charged_particles)
       : session(session), graph(graph), driver(driver),
-        charged_particles(charged_particles) {
+        charged_particles(charged_particles),
+        sycl_target(charged_particles->sycl_target), num_steps(0) {
 
     this->equation_system = this->driver->GetEqu();
     this->poisson_pic =
@@ -168,9 +244,27 @@ public:
     this->potential_function->SetCoeffsArray(this->potential_coeffs);
 
     // Create a projection object for the RHS.
-    this->field_project = std::make_shared<FieldProject<T>>(
-        this->forcing_function, this->charged_particles->particle_group,
+    this->function_project_basis = std::make_shared<FunctionProjectBasis<T>>(
+        this->forcing_function,
+        this->charged_particles->particle_mesh_interface,
         this->charged_particles->cell_id_translation);
+    this->forcing_rhs = Array<OneD, NekDouble>(num_coeffs_f);
+
+    // Use the same particle shape for deposition and gather such that the
+    // coupling conserves energy.
+    int particle_shape_type;
+    ParticleShape particle_shape;
+    this->session->LoadParameter("particle_shape", particle_shape_type, 0);
+    this->session->LoadParameter("particle_shape_width", particle_shape.width,
+                                 0.0);
+    this->session->LoadParameter("particle_shape_order", particle_shape.order,
+                                 2);
+    NESOASSERT((particle_shape_type >= 0) && (particle_shape_type <= 2),
+               "Unknown particle_shape, expected 0 (delta), 1 (Gaussian) or 2 "
+               "(B-spline).");
+    particle_shape.type = static_cast<ParticleShapeType>(particle_shape_type);
+    this->function_project_basis->set_particle_shape(particle_shape);
+    this->field_evaluate->set_particle_shape(particle_shape);
 
     auto forcing_boundary_conditions =
         this->forcing_function->GetBndConditions();
@@ -231,6 +325,23 @@ public:
           "Neutralising phys value is not finite (e.g. NaN or Inf/-Inf)..");
     }
 
+    // The projection RHS of the neutralising field, i.e. the inner product
+    // of the neutralising field with the test functions.
+    Array<OneD, NekDouble> ncd_rhs_values(num_coeffs_f);
+    this->forcing_function->IProductWRTBase(this->ncd_phys_values,
+                                            ncd_rhs_values);
+
+    // Copy the neutralising field to the device for the neutralise stage.
+    this->d_ncd_coeff_values = std::make_unique<NP::BufferDevice<NP::REAL>>(
+        this->sycl_target,
+        std::vector<NP::REAL>(this->ncd_coeff_values.begin(),
+                              this->ncd_coeff_values.end()));
+    this->d_ncd_rhs_values = std::make_unique<NP::BufferDevice<NP::REAL>>(
+        this->sycl_target, std::vector<NP::REAL>(ncd_rhs_values.begin(),
+                                                 ncd_rhs_values.end()));
+    this->dh_total_charge =
+        std::make_unique<NP::BufferDeviceHost<NP::REAL>>(this->sycl_target, 1);
+
     auto phys_u = this->potential_function->UpdatePhys();
     auto phys_f = this->forcing_function->UpdatePhys();
     for (int cx = 0; cx < tot_points_u; cx++) {
@@ -249,41 +360,57 @@ public:
     }
   }
 
+  /**
+   *  Compute the electric field at the particle locations from the particle
+   *  charges, i.e. deposit the charge, solve the Poisson equation and
+   *  evaluate the gradient of the potential at the particle locations.
+   */
   inline void compute_field() {
+    auto &profiler = this->charged_particles->step_profiler;
+
+    StepProfilerRegion region_deposit(profiler, StepRegion::Projection,
+                                      "PoissonParticleCoupling::deposit");
+    NP::REAL *d_rhs = this->deposit();
+    region_deposit.end();
+
+    StepProfilerRegion region_neutralise(
+        profiler, StepRegion::Projection,
+        "PoissonParticleCoupling::neutralise");
+    this->neutralise(d_rhs);
+    region_neutralise.end();
+
+    StepProfilerRegion region_solve(profiler, StepRegion::Solve,
+                                    "PoissonParticleCoupling::solve");
+    this->solve();
+    region_solve.end();
+
+    StepProfilerRegion region_gather(profiler, StepRegion::Evaluation,
+                                     "PoissonParticleCoupling::gather");
+    this->gather();
+    region_gather.end();
+
+    this->num_steps++;
+  }
 
-    auto phys_u = this->potential_function->UpdatePhys();
-    auto phys_f = this->forcing_function->UpdatePhys();
-    auto coeffs_u = this->potential_function->UpdateCoeffs();
-    auto coeffs_f = this->forcing_function->UpdateCoeffs();
-
-    for (int cx = 0; cx < tot_points_u; cx++) {
-      phys_u[cx] = 0.0;
-    }
-    for (int cx = 0; cx < tot_points_f; cx++) {
-      phys_f[cx] = 0.0;
-    }
-    for (int cx = 0; cx < num_coeffs_u; cx++) {
-      coeffs_u[cx] = 0.0;
-    }
-    for (int cx = 0; cx < num_coeffs_f; cx++) {
-      coeffs_f[cx] = 0.0;
+  /**
+   *  Print the average number of iterations per Poisson solve on rank 0 if the
+   *  solver is iterative.
+   */
+  inline void print_solve_iterations() {
+    if (this->sycl_target->comm_pair.rank_parent == 0) {
+      const int64_t num_iterations = this->poisson_pic->GetTotalNumIterations();
+      if ((num_iterations > -1) && (this->num_steps > 0)) {
+        NP::nprint("PoissonParticleCoupling iterations per solve:",
+                   static_cast<double>(num_iterations) /
+                       static_cast<double>(this->num_steps));
+      }
     }
-
-    // Project density field
-    this->field_project->project(this->charged_particles->get_charge_sym());
-
-    // Add background density to neutralise the overall system.
-    this->add_neutralising_field();
-
-    // Poisson solve
-    this->solve_equation_system();
-
-    // Evaluate the derivative of the potential at the particle locations.
-    this->field_evaluate->evaluate(
-        this->charged_particles->get_potential_gradient_sym());
   }
 
   inline void write_forcing(const int step) {
+    StepProfilerRegion region(this->charged_particles->step_profiler,
+                              StepRegion::IO,
+                              "PoissonParticleCoupling::write_forcing");
     const int rank =
         this->charged_particles->sycl_target->comm_pair.rank_parent;
     std::string name =
@@ -292,6 +419,9 @@ public:
   }
 
   inline void write_potential(const int step) {
+    StepProfilerRegion region(this->charged_particles->step_profiler,
+                              StepRegion::IO,
+                              "PoissonParticleCoupling::write_potential");
     const int rank =
         this->charged_particles->sycl_target->comm_pair.rank_parent;
     std::string name = "potential_" + std::to_string(rank) + "_" +
@@ -104,6 +104,8 @@ void SOLSystem::init_advection() {
 void SOLSystem::explicit_time_int(
     const Array<OneD, const Array<OneD, NekDouble>> &in_arr,
     Array<OneD, Array<OneD, NekDouble>> &out_arr, const NekDouble time) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::FluidRHS,
+                            "SOLSystem::explicit_time_int");
   int num_vars = in_arr.size();
   int num_pts = GetNpoints();
   int num_trace_pts = GetTraceTotPoints();
@@ -75,8 +75,12 @@ bool SOLWithParticlesSystem::v_PostIntegrate(int step) {
     this->particle_sys->write(step);
     this->particle_sys->write_source_fields();
   }
+  this->particle_sys->update_load_metrics(step);
+  this->particle_sys->write_checkpoint(step);
 
   if (this->mass_recording_enabled) {
+    StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                              "SOLWithParticlesSystem::mass_recording");
     this->diag_mass_recording->compute(step);
   }
 
@@ -85,6 +89,7 @@ bool SOLWithParticlesSystem::v_PostIntegrate(int step) {
 }
 
 bool SOLWithParticlesSystem::v_PreIntegrate(int step) {
+  this->step_profiler->begin_step(step);
   this->solver_callback_handler.call_pre_integrate(this);
 
   if (this->mass_recording_enabled) {
@@ -3,6 +3,12 @@
 #include "SourceTerms.hpp"
 
 namespace NESO::Solvers::SimpleSOL {
+
+static inline NekDouble calc_gaussian(NekDouble prefac, NekDouble mu,
+                                      NekDouble sigma, NekDouble s) {
+  return prefac * exp(-(mu - s) * (mu - s) / 2 / sigma / sigma);
+}
+
 std::string SourceTerms::class_name =
     SU::GetForcingFactory().RegisterCreatorFunction(
         "SourceTerms", SourceTerms::create, "Source terms for 1D SOL code");
@@ -56,11 +62,28 @@ void SourceTerms::v_InitObject(const Array<OneD, MR::ExpListSharedPtr> &fields,
   this->u_prefac = source_mask * 7.296657414e-27 * -1e26 * sigma0 / this->sigma;
   this->E_prefac =
       source_mask * 7.978845608e-5 * 30000.0 * sigma0 / this->sigma;
-}
 
-NekDouble calc_gaussian(NekDouble prefac, NekDouble mu, NekDouble sigma,
-                        NekDouble s) {
-  return prefac * exp(-(mu - s) * (mu - s) / 2 / sigma / sigma);
+  /*
+   * The Gaussian sources don't depend on time or on the solution, so compute
+   * their point values once here; v_Apply then only adds them to the RHS.
+   */
+  this->rho_src = Array<OneD, NekDouble>(num_pts);
+  this->rhou_src = Array<OneD, NekDouble>(num_pts);
+  this->rhov_src = Array<OneD, NekDouble>(num_pts);
+  this->E_src = Array<OneD, NekDouble>(num_pts);
+  for (auto ii = 0; ii < num_pts; ii++) {
+    const NekDouble s_ii = this->s[ii];
+    const NekDouble u_src =
+        (s_ii / this->mu - 1.) *
+        calc_gaussian(this->u_prefac, this->mu, this->sigma, s_ii);
+    this->rho_src[ii] =
+        calc_gaussian(this->rho_prefac, this->mu, this->sigma, s_ii);
+    this->rhou_src[ii] = std::cos(this->theta) * u_src;
+    this->rhov_src[ii] = std::sin(this->theta) * u_src;
+    // Divided by 2 since the LHS of the energy equation has been doubled
+    this->E_src[ii] =
+        calc_gaussian(this->E_prefac, this->mu, this->sigma, s_ii) / 2.0;
+  }
 }
 
 void SourceTerms::v_Apply(const Array<OneD, MR::ExpListSharedPtr> &fields,
@@ -75,32 +98,16 @@ void SourceTerms::v_Apply(const Array<OneD, MR::ExpListSharedPtr> &fields,
   int rhov_idx = this->field_to_index.get_idx("rhov");
   int E_idx = this->field_to_index.get_idx("E");
 
-  // Density source term
-  for (int i = 0; i < out_arr[rho_idx].size(); ++i) {
-    out_arr[rho_idx][i] +=
-        calc_gaussian(this->rho_prefac, this->mu, this->sigma, this->s[i]);
-  }
-  // rho*u source term
-  for (int i = 0; i < out_arr[rhou_idx].size(); ++i) {
-    out_arr[rhou_idx][i] +=
-        std::cos(this->theta) * (this->s[i] / this->mu - 1.) *
-        calc_gaussian(this->u_prefac, this->mu, this->sigma, this->s[i]);
-  }
+  // Add cached Gaussian source terms
+  auto add_src = [&](const int idx, const Array<OneD, const NekDouble> &src) {
+    Vmath::Vadd(out_arr[idx].size(), out_arr[idx], 1, src, 1, out_arr[idx], 1);
+  };
+  add_src(rho_idx, this->rho_src);
+  add_src(rhou_idx, this->rhou_src);
   if (ndims == 2) {
-    // rho*v source term
-    for (int i = 0; i < out_arr[rhov_idx].size(); ++i) {
-      out_arr[rhov_idx][i] +=
-          std::sin(this->theta) * (this->s[i] / this->mu - 1.) *
-          calc_gaussian(this->u_prefac, this->mu, this->sigma, this->s[i]);
-    }
-  }
-
-  // E source term - divided by 2 since the LHS of the energy equation has
-  // been doubled
-  for (int i = 0; i < out_arr[E_idx].size(); ++i) {
-    out_arr[E_idx][i] +=
-        calc_gaussian(this->E_prefac, this->mu, this->sigma, this->s[i]) / 2.0;
+    add_src(rhov_idx, this->rhov_src);
   }
+  add_src(E_idx, this->E_src);
 
   // Add sources stored as separate fields, if they exist
   std::vector<std::string> target_fields = {"rho", "rhou", "rhov", "E"};
@@ -109,10 +116,7 @@ void SourceTerms::v_Apply(const Array<OneD, MR::ExpListSharedPtr> &fields,
     if (src_field_idx >= 0) {
       int dst_field_idx = this->field_to_index.get_idx(target_field);
       if (dst_field_idx >= 0) {
-        auto phys_vals = fields[src_field_idx]->GetPhys();
-        for (int i = 0; i < out_arr[dst_field_idx].size(); ++i) {
-          out_arr[dst_field_idx][i] += phys_vals[i];
-        }
+        add_src(dst_field_idx, fields[src_field_idx]->GetPhys());
       }
     }
   }
@@ -55,6 +55,12 @@ private:
   // Pre-computed (1D) coord along source-oriented axis
   Array<OneD, NekDouble> s;
 
+  // Pre-computed point values of the (time-independent) source terms
+  Array<OneD, NekDouble> E_src;
+  Array<OneD, NekDouble> rho_src;
+  Array<OneD, NekDouble> rhou_src;
+  Array<OneD, NekDouble> rhov_src;
+
   // Source parameters
   NekDouble E_prefac;
   NekDouble mu;
@@ -11,7 +11,6 @@ void NeutralParticleSystem::init_spec() {
       NP::ParticleProp(NP::Sym<NP::REAL>("SOURCE_MOMENTUM"), 2),
       NP::ParticleProp(NP::Sym<NP::REAL>("ELECTRON_DENSITY"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("ELECTRON_TEMPERATURE"), 1),
-      NP::ParticleProp(NP::Sym<NP::REAL>("MASS"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("VELOCITY"), 3)};
 }
 
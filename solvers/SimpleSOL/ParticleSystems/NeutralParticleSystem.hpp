@@ -97,6 +97,32 @@ protected:
       source_samplers;
   std::shared_ptr<NP::ParticleRemover> particle_remover;
 
+  virtual void
+  write_checkpoint_state(NESO::IO::ParticleCheckpointWriter &writer) override {
+    writer.write_rank_value("total_num_particles_added",
+                            this->total_num_particles_added);
+    writer.write_value("simulation_time", this->simulation_time);
+    writer.write_rng("rng_phasespace", this->rng_phasespace);
+    for (std::size_t linex = 0; linex < this->source_samplers.size();
+         linex++) {
+      writer.write_rng("source_sampler_" + std::to_string(linex),
+                       this->source_samplers[linex]->get_rng());
+    }
+  }
+
+  virtual void
+  read_checkpoint_state(NESO::IO::ParticleCheckpointReader &reader) override {
+    reader.read_rank_value("total_num_particles_added",
+                           this->total_num_particles_added);
+    reader.read_value("simulation_time", this->simulation_time);
+    reader.read_rng("rng_phasespace", this->rng_phasespace);
+    for (std::size_t linex = 0; linex < this->source_samplers.size();
+         linex++) {
+      reader.read_rng("source_sampler_" + std::to_string(linex),
+                      this->source_samplers[linex]->get_rng());
+    }
+  }
+
   // Project object to project onto number density and momentum fields
   std::shared_ptr<FieldProject<MR::DisContField>> field_project;
   // Evaluate object to evaluate number density field
@@ -206,7 +232,11 @@ public:
                                            NP::Sym<NP::REAL>("SOURCE_MOMENTUM"),
                                            NP::Sym<NP::REAL>("SOURCE_ENERGY")};
     std::vector<int> components = {0, 0, 1, 0};
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::Projection,
+                                    "NeutralParticleSystem::project");
     this->field_project->project(syms, components);
+    region.end();
 
     // remove fully ionised particles from the simulation
     remove_marked_particles();
@@ -262,8 +292,6 @@ public:
 
           line_distribution[NP::Sym<NP::INT>("PARTICLE_ID")][px][0] = rank;
           line_distribution[NP::Sym<NP::INT>("PARTICLE_ID")][px][1] = px;
-          line_distribution[NP::Sym<NP::REAL>("MASS")][px][0] =
-              this->particle_mass;
           line_distribution[NP::Sym<NP::REAL>("COMPUTATIONAL_WEIGHT")][px][0] =
               this->particle_weight;
         }
@@ -277,6 +305,9 @@ public:
    *  Write the projection fields to vtu for debugging.
    */
   inline void write_source_fields() {
+    NESO::StepProfilerRegion region(
+        this->step_profiler, NESO::StepRegion::IO,
+        "NeutralParticleSystem::write_source_fields");
     for (auto entry : this->fields) {
       std::string filename = "debug_" + entry.first + "_" +
                              std::to_string(this->debug_write_fields_count++) +
@@ -335,14 +366,26 @@ public:
    *  Apply boundary conditions and transfer particles between MPI ranks.
    */
   inline void transfer_particles() {
-    auto t0 = NP::profile_timestamp();
+    if (this->neighbour_transfer) {
+      NESO::StepProfilerRegion region(
+          this->step_profiler, NESO::StepRegion::Transfer,
+          "NeutralParticleSystem::neighbour_transfer");
+      this->boundary_conditions();
+      this->neighbour_transfer->execute();
+      return;
+    }
+
+    NESO::StepProfilerRegion region_move(this->step_profiler,
+                                         NESO::StepRegion::Transfer,
+                                         "NeutralParticleSystem::hybrid_move");
     this->boundary_conditions();
     this->particle_group->hybrid_move();
-    this->cell_id_translation->execute();
+    region_move.end();
+
+    NESO::StepProfilerRegion region_cell_move(
+        this->step_profiler, NESO::StepRegion::Transfer,
+        "NeutralParticleSystem::cell_move");
     this->particle_group->cell_move();
-    this->sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "transfer_particles", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
   }
 
   /**
@@ -378,7 +421,9 @@ public:
    * @param dt Time step size.
    */
   inline void forward_euler(const double dt) {
-    auto t0 = NP::profile_timestamp();
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::ParticlePush,
+                                    "NeutralParticleSystem::forward_euler");
     const double k_dt = dt;
     NP::particle_loop(
         "NeutralParticleSystem::forward_euler", this->particle_group,
@@ -389,9 +434,7 @@ public:
         NP::Access::write(NP::Sym<NP::REAL>("POSITION")),
         NP::Access::read(NP::Sym<NP::REAL>("VELOCITY")))
         ->execute();
-    sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "ForwardEuler_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
+    region.end();
     // positions were written so we apply boundary conditions and move
     // particles between ranks
     this->transfer_particles();
@@ -416,6 +459,9 @@ public:
     NESOASSERT(this->field_evaluate_T != nullptr,
                "FieldEvaluate object is null. Was setup_evaluate_T called?");
 
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::Evaluation,
+                                    "NeutralParticleSystem::evaluate_fields");
     this->field_evaluate_n->evaluate(NP::Sym<NP::REAL>("ELECTRON_DENSITY"));
     this->field_evaluate_T->evaluate(NP::Sym<NP::REAL>("ELECTRON_TEMPERATURE"));
 
@@ -466,7 +512,9 @@ public:
 
     const INT k_remove_key = this->particle_remove_key;
 
-    auto t0 = NP::profile_timestamp();
+    NESO::StepProfilerRegion region(this->step_profiler,
+                                    NESO::StepRegion::ParticlePush,
+                                    "NeutralParticleSystem::ionise");
 
     NP::particle_loop(
         "NeutralParticleSystem::ionise", this->particle_group,
@@ -521,10 +569,6 @@ public:
         NP::Access::read(NP::Sym<NP::REAL>("VELOCITY")),
         NP::Access::write(NP::Sym<NP::REAL>("COMPUTATIONAL_WEIGHT")))
         ->execute();
-
-    sycl_target->profile_map.inc(
-        "NeutralParticleSystem", "Ionisation_Execute", 1,
-        NP::profile_elapsed(t0, NP::profile_timestamp()));
   }
 
   virtual void set_up_particles() override {
@@ -44,42 +44,29 @@ B0 = sqrt(Bx^2 + By^2 + Bz^2)
 Wc = charge * B0 / mass
 Wp = sqrt(charge^2 * n0 / mass)
 
-fname_phi = "Electrostatic2D3V_line_field_evaluations.h5part"
-fname_Exy = "Electrostatic2D3V_line_field_deriv_evaluations.h5part"
+fname_phi = "Electrostatic2D3V_line_field_evaluations.h5"
+fname_Exy = "Electrostatic2D3V_line_field_deriv_evaluations.h5"
 
-function getindices(fname=fname_phi)
-  x = h5read(fname, "Step#0/x")
-  y = h5read(fname, "Step#0/y")
-  @assert length(x) == length(y)
-  x = h5read(fname, "Step#0/x");
-  y = h5read(fname, "Step#0/y");
-
-  xy = [i for i in eachrow(hcat(x, y))];
-
-  perm = sortperm(xy, by=x->(x[1], x[2]));
-  return perm
-end
-
-perminds = getindices()
-NG = Int(sqrt(length(perminds)))
+# Points are stored in x major order, i.e. the y index varies fastest.
+positions = h5read(fname_phi, "positions")
+NG = Int(sqrt(size(positions, 2)))
 @assert NG == ndiagx == ndiagy
 
-function get3D(fname, str)
-  fz(i) = h5read(fname, "Step#$(i * NS)/" * str)
-
-  output = cat([reshape(fz(i)[perminds], NG, NG) for i in 0:(NT÷NS)-1]..., dims=3);
+function get3D(fname, component)
+  evaluations = h5read(fname, "evaluations")
+  output = reshape(evaluations[component, :, 1:(NT÷NS)], NG, NG, :)
   @assert size(output, 1) == ndiagx
   @assert size(output, 2) == ndiagy
   @assert size(output, 3) == NT÷NS
   return output
 end
 
-x2d = get3D(fname_phi, "x")
-y2d = get3D(fname_phi, "y")
+x2d = reshape(positions[1, :], NG, NG)
+y2d = reshape(positions[2, :], NG, NG)
 
-phis = get3D(fname_phi, "FIELD_EVALUATION_0")
-Exs = get3D(fname_Exy, "FIELD_EVALUATION_0")
-Eys = get3D(fname_Exy, "FIELD_EVALUATION_1")
+phis = get3D(fname_phi, 1)
+Exs = get3D(fname_Exy, 1)
+Eys = get3D(fname_Exy, 2)
 
 NF = size(x2d, 2)
 @show NG, NP, NP÷NG^2, NT, NS, NF, dt
@@ -30,12 +30,15 @@ inline double get_B_error(const int N, const int N_step, double dt) {
       NP::ParticleProp(NP::Sym<NP::REAL>("P_CORRECT"), 2),
       NP::ParticleProp(NP::Sym<NP::REAL>("V"), 3),
       NP::ParticleProp(NP::Sym<NP::INT>("CELL_ID"), 1, true),
-      NP::ParticleProp(NP::Sym<NP::REAL>("M"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("E"), ndim),
-      NP::ParticleProp(NP::Sym<NP::REAL>("Q"), 1),
       NP::ParticleProp(NP::Sym<NP::REAL>("P_ORIG"), ndim)};
 
   auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto species_constants = std::make_shared<NESO::SpeciesConstants>(
+      1, std::vector<std::string>{"Q", "M"});
+  species_constants->set(0, "Q", 1.0);
+  species_constants->set(0, "M", 1.0);
+  species_constants->setup_sub_groups(A);
 
   if (sycl_target->comm_pair.rank_parent == 0) {
     std::mt19937 rng_pos(52234234);
@@ -55,8 +58,6 @@ inline double get_B_error(const int N, const int N_step, double dt) {
       initial_distribution[NP::Sym<NP::REAL>("V")][px][0] = 1.0;
       initial_distribution[NP::Sym<NP::REAL>("V")][px][1] = 0.0;
       initial_distribution[NP::Sym<NP::REAL>("V")][px][2] = 0.0;
-      initial_distribution[NP::Sym<NP::REAL>("M")][px][0] = 1.0;
-      initial_distribution[NP::Sym<NP::REAL>("Q")][px][0] = 1.0;
       initial_distribution[NP::Sym<NP::INT>("CELL_ID")][px][0] = 0;
     }
 
@@ -71,7 +72,7 @@ inline double get_B_error(const int N, const int N_step, double dt) {
   double particle_E_coefficient = 0.0;
 
   auto integrator_boris = std::make_shared<ES2D3V::IntegratorBorisUniformB>(
-      A, dt, B_0, B_1, B_2, particle_E_coefficient);
+      A, species_constants, dt, B_0, B_1, B_2, particle_E_coefficient);
 
   double T = 0.0;
   const int cell_count = domain->mesh->get_cell_count();
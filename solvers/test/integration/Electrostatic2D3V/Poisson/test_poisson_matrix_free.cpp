@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SolverUtils/EquationSystem.h>
+#include <SpatialDomains/MeshGraphIO.h>
+
+#include "../../../../../solvers/Electrostatic2D3V/EquationSystems/PoissonPIC.hpp"
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Nektar;
+using namespace Nektar::SolverUtils;
+namespace ES2D3V = NESO::Solvers::Electrostatic2D3V;
+
+/*
+ * Solve the periodic Poisson problem with a known solution with the
+ * matrix-free solve and the Nektar++ HelmSolve. Neither reference depends on
+ * the decomposition, hence running this test with more than one MPI rank
+ * checks the parallel matrix-free solve against the serial solution.
+ */
+TEST(Electrostatic2D3V, PoissonMatrixFree) {
+  std::filesystem::path source_file = __FILE__;
+  std::filesystem::path source_dir = source_file.parent_path();
+  std::filesystem::path conditions_file = source_dir / "poisson_conditions.xml";
+  std::filesystem::path mesh_file =
+      source_dir / ".." / "ElectronBernsteinWaves" / "ebw_mesh.xml";
+
+  std::vector<std::string> args = {"test_poisson_matrix_free",
+                                   std::string(conditions_file),
+                                   std::string(mesh_file)};
+  std::vector<char *> argv;
+  for (auto &arg : args) {
+    argv.push_back(arg.data());
+  }
+
+  auto session = LibUtilities::SessionReader::CreateInstance(
+      static_cast<int>(argv.size()), argv.data());
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  const double two_pi = 2.0 * M_PI;
+  MultiRegions::ExpListSharedPtr u;
+  auto lambda_solve = [&](int matrix_free) {
+    session->SetParameter("poisson_matrix_free", matrix_free);
+    auto poisson_pic = std::dynamic_pointer_cast<ES2D3V::PoissonPIC>(
+        GetEquationSystemFactory().CreateInstance("PoissonPIC", session,
+                                                  graph));
+    EXPECT_TRUE(poisson_pic != nullptr);
+    auto fields = poisson_pic->UpdateFields();
+    u = fields[poisson_pic->GetFieldIndex("u")];
+    auto rho = fields[poisson_pic->GetFieldIndex("rho")];
+
+    // u = sin(2 pi x) sin(2 pi y) solves laplace(u) = -8 pi^2 u.
+    const int num_phys = rho->GetTotPoints();
+    Array<OneD, NekDouble> x(num_phys), y(num_phys);
+    rho->GetCoords(x, y);
+    auto rho_phys = rho->UpdatePhys();
+    for (int px = 0; px < num_phys; px++) {
+      rho_phys[px] =
+          -2.0 * two_pi * two_pi * std::sin(two_pi * x[px]) *
+          std::sin(two_pi * y[px]);
+    }
+    rho->FwdTrans(rho->GetPhys(), rho->UpdateCoeffs());
+    rho->BwdTrans(rho->GetCoeffs(), rho->UpdatePhys());
+    poisson_pic->DoSolve();
+
+    // The periodic solution is only defined up to a constant.
+    Array<OneD, NekDouble> ones(num_phys, 1.0);
+    const NekDouble volume = u->Integral(ones);
+    const NekDouble mean = u->Integral(u->GetPhys()) / volume;
+    Array<OneD, NekDouble> u_phys(num_phys);
+    Vmath::Sadd(num_phys, -mean, u->GetPhys(), 1, u_phys, 1);
+
+    Array<OneD, NekDouble> u_exact(num_phys);
+    for (int px = 0; px < num_phys; px++) {
+      u_exact[px] = std::sin(two_pi * x[px]) * std::sin(two_pi * y[px]);
+    }
+    const NekDouble err = u->L2(u_phys, u_exact) / u->L2(u_exact);
+
+    if (matrix_free) {
+      EXPECT_TRUE(poisson_pic->HasConverged());
+      EXPECT_TRUE(poisson_pic->GetResidual() <= 1.0e-12);
+      EXPECT_TRUE(poisson_pic->GetNumIterations() > 0);
+    }
+    EXPECT_TRUE(err < 1.0e-4);
+    return u_phys;
+  };
+
+  auto u_helm = lambda_solve(0);
+  auto u_matrix_free = lambda_solve(1);
+
+  // Both solutions use the same partition hence share quadrature points.
+  const NekDouble diff = u->L2(u_matrix_free, u_helm) / u->L2(u_helm);
+  EXPECT_TRUE(diff < 1.0e-8);
+
+  session->Finalise();
+}
@@ -458,4 +458,41 @@ void eval_modes(const LibUtilities::ShapeType shape_type, const int P,
   }
 }
 
+void eval_modes(const LibUtilities::ShapeType shape_type, const int P0,
+                const int P1, const int P2, const double eta0,
+                const double eta1, const double eta2, std::vector<double> &b) {
+
+  if (shape_type == eQuadrilateral) {
+    NESOASSERT(b.size() >= P0 * P1,
+               "Output vector too small - expected at least P0 * P1.");
+    int mode = 0;
+    for (int my = 0; my < P1; my++) {
+      for (int mx = 0; mx < P0; mx++) {
+        b[mode] = eval_modA_i(mx, eta0) * eval_modA_i(my, eta1);
+        mode++;
+      }
+    }
+  } else if (shape_type == eHexahedron) {
+    NESOASSERT(b.size() >= P0 * P1 * P2,
+               "Output vector too small - expected at least P0 * P1 * P2.");
+    int mode = 0;
+    for (int mz = 0; mz < P2; mz++) {
+      for (int my = 0; my < P1; my++) {
+        for (int mx = 0; mx < P0; mx++) {
+          b[mode] = eval_modA_i(mx, eta0) * eval_modA_i(my, eta1) *
+                    eval_modA_i(mz, eta2);
+          mode++;
+        }
+      }
+    }
+  } else {
+    const bool is_3d = (shape_type == ePyramid) || (shape_type == ePrism) ||
+                       (shape_type == eTetrahedron);
+    NESOASSERT((P0 == P1) && ((!is_3d) || (P0 == P2)),
+               "Differing numbers of modes in coordinate directions are only "
+               "supported for quadrilaterals and hexahedrons.");
+    eval_modes(shape_type, P0, eta0, eta1, eta2, b);
+  }
+}
+
 } // namespace NESO::BasisReference
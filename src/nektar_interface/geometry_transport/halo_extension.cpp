@@ -157,30 +157,13 @@ int halo_get_map_rank_to_cells(
  * @returns Number of remote MPI ranks to setup communication with.
  */
 int halo_get_num_send_ranks(MPI_Comm comm, std::vector<int> &recv_ranks) {
-
-  MPI_Win recv_win;
-  int *recv_win_data;
-  MPICHK(MPI_Win_allocate(sizeof(int), sizeof(int), MPI_INFO_NULL, comm,
-                          &recv_win_data, &recv_win));
-  recv_win_data[0] = 0;
-  MPI_Request request_barrier;
-  MPICHK(MPI_Ibarrier(comm, &request_barrier));
-  MPICHK(MPI_Wait(&request_barrier, MPI_STATUS_IGNORE));
-  // start to setup the communication pattern
-  const int one[1] = {1};
-  int recv[1];
-  for (int rank : recv_ranks) {
-    MPICHK(MPI_Win_lock(MPI_LOCK_SHARED, rank, 0, recv_win));
-    MPICHK(MPI_Get_accumulate(one, 1, MPI_INT, recv, 1, MPI_INT, rank, 0, 1,
-                              MPI_INT, MPI_SUM, recv_win));
-    MPICHK(MPI_Win_unlock(rank, recv_win));
-  }
-
-  MPICHK(MPI_Barrier(comm));
-  const int num_send_ranks = recv_win_data[0];
-  MPICHK(MPI_Win_free(&recv_win));
-
-  return num_send_ranks;
+  // Notify each rank this rank requests geometry objects from, the remote
+  // ranks which send to this rank are not needed here.
+  std::vector<int> notifications(recv_ranks.size(), 1);
+  std::vector<int> send_ranks;
+  std::vector<int> send_notifications;
+  return sparse_exchange_counts(comm, recv_ranks, notifications, send_ranks,
+                                send_notifications);
 }
 
 /**
@@ -415,7 +398,8 @@ void halo_get_rank_to_geoms_3d(
  * @param[in] offset Integer offset to apply to MeshHierarchy cells in all
  * coordinate directions.
  * @param[in,out] particle_mesh_interface ParticleMeshInterface to extend the
- * halos of.
+ * halos of. If it holds a SetupCache, the extended halos are read from the
+ * cache when present and written to it otherwise.
  */
 void extend_halos_fixed_offset(
     const int offset, ParticleMeshInterfaceSharedPtr particle_mesh_interface,
@@ -425,6 +409,41 @@ void extend_halos_fixed_offset(
     return;
   }
 
+  // The extended halos depend on the offset, the periodicity and the halos
+  // before the extension, which identify the extension in the setup cache.
+  auto setup_cache = particle_mesh_interface->setup_cache;
+  std::uint64_t stage_hash = 0xcbf29ce484222325ULL;
+  particle_mesh_interface->halo_extension_from_cache = false;
+  if (setup_cache) {
+    SetupCache::hash_combine(stage_hash, offset);
+    SetupCache::hash_combine(stage_hash, pbc);
+    for (auto &remote_geom : particle_mesh_interface->remote_triangles) {
+      SetupCache::hash_combine(stage_hash, remote_geom->rank);
+      SetupCache::hash_combine(stage_hash, remote_geom->id);
+    }
+    for (auto &remote_geom : particle_mesh_interface->remote_quads) {
+      SetupCache::hash_combine(stage_hash, remote_geom->rank);
+      SetupCache::hash_combine(stage_hash, remote_geom->id);
+    }
+    for (auto &remote_geom : particle_mesh_interface->remote_geoms_3d) {
+      SetupCache::hash_combine(stage_hash, remote_geom->rank);
+      SetupCache::hash_combine(stage_hash, remote_geom->id);
+    }
+    std::vector<INT> owned_mh_cells;
+    std::vector<INT> unowned_mh_cells;
+    std::vector<std::shared_ptr<RemoteGeom2D<TriGeom>>> remote_triangles;
+    std::vector<std::shared_ptr<RemoteGeom2D<QuadGeom>>> remote_quads;
+    std::vector<std::shared_ptr<RemoteGeom3D>> remote_geoms_3d;
+    if (setup_cache->read(owned_mh_cells, unowned_mh_cells, remote_triangles,
+                          remote_quads, remote_geoms_3d, stage_hash)) {
+      particle_mesh_interface->remote_triangles = remote_triangles;
+      particle_mesh_interface->remote_quads = remote_quads;
+      particle_mesh_interface->remote_geoms_3d = remote_geoms_3d;
+      particle_mesh_interface->halo_extension_from_cache = true;
+      return;
+    }
+  }
+
   MPI_Comm comm = particle_mesh_interface->comm;
   const int comm_rank = particle_mesh_interface->comm_rank;
   const int ndim = particle_mesh_interface->ndim;
@@ -632,6 +651,14 @@ void extend_halos_fixed_offset(
       }
     }
   }
+
+  if (setup_cache) {
+    setup_cache->write(particle_mesh_interface->owned_mh_cells,
+                       particle_mesh_interface->unowned_mh_cells,
+                       particle_mesh_interface->remote_triangles,
+                       particle_mesh_interface->remote_quads,
+                       particle_mesh_interface->remote_geoms_3d, stage_hash);
+  }
 }
 
 } // namespace NESO
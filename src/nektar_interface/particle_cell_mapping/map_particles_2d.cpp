@@ -25,6 +25,10 @@ MapParticles2D::MapParticles2D(
   this->map_particles_common =
       std::make_unique<MapParticlesCommon>(sycl_target);
 
+  // The mappers write the cell on the owning rank rather than the geometry id.
+  std::map<int, int> map_geom_to_cell;
+  particle_mesh_interface->get_geom_to_cell_map(map_geom_to_cell);
+
   if (this->count_deformed > 0) {
 
     std::map<int, std::shared_ptr<QuadGeom>> quads_local;
@@ -49,11 +53,11 @@ MapParticles2D::MapParticles2D(
     this->map_particles_newton_linear_quad = std::make_unique<
         Newton::MapParticlesNewton<Newton::MappingQuadLinear2D>>(
         Newton::MappingQuadLinear2D{}, this->sycl_target, quads_local,
-        quads_remote, config);
+        quads_remote, map_geom_to_cell, config);
   }
 
   this->map_particles_2d_regular = std::make_unique<MapParticles2DRegular>(
-      sycl_target, particle_mesh_interface, config);
+      sycl_target, particle_mesh_interface, map_geom_to_cell, config);
 }
 
 void MapParticles2D::map(ParticleGroup &particle_group, const int map_cell) {
@@ -5,7 +5,7 @@ namespace NESO {
 MapParticles2DRegular::MapParticles2DRegular(
     SYCLTargetSharedPtr sycl_target,
     ParticleMeshInterfaceSharedPtr particle_mesh_interface,
-    ParameterStoreSharedPtr config)
+    const std::map<int, int> &map_geom_to_cell, ParameterStoreSharedPtr config)
     : CoarseMappersBase(sycl_target),
       particle_mesh_interface(particle_mesh_interface) {
 
@@ -80,7 +80,7 @@ MapParticles2DRegular::MapParticles2DRegular(
       NESOASSERT((cell_index < cell_count) && (0 <= cell_index),
                  "Bad cell index from map.");
       NESOASSERT(id == geom.first, "ID mismatch");
-      this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+      this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
       this->dh_mpi_ranks->h_buffer.ptr[cell_index] = rank;
       const int geom_type = shape_type_to_int(geom.second->GetShapeType());
       NESOASSERT((geom_type == index_tri_geom) ||
@@ -95,7 +95,7 @@ MapParticles2DRegular::MapParticles2DRegular(
       const int cell_index = this->coarse_lookup_map->gid_to_lookup_id.at(id);
       NESOASSERT((cell_index < cell_count) && (0 <= cell_index),
                  "Bad cell index from map.");
-      this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+      this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
       this->dh_mpi_ranks->h_buffer.ptr[cell_index] = geom->rank;
       const int geom_type = shape_type_to_int(geom->geom->GetShapeType());
       NESOASSERT((geom_type == index_tri_geom) ||
@@ -112,14 +112,10 @@ MapParticles2DRegular::MapParticles2DRegular(
   }
 }
 
-void MapParticles2DRegular::map(ParticleGroup &particle_group,
-                                const int map_cell) {
-
-  // This method will only map into regular geoms (triangles and quads which
-  // are parallelograms).
-  if (this->num_regular_geoms == 0) {
-    return;
-  }
+template <typename T>
+void MapParticles2DRegular::map_inner(ParticleGroup &particle_group,
+                                      const int map_cell,
+                                      ParticleDatSharedPtr<T> ref_positions) {
 
   auto &clm = this->coarse_lookup_map;
 
@@ -151,8 +147,6 @@ void MapParticles2DRegular::map(ParticleGroup &particle_group,
   const auto position_dat = particle_group.position_dat;
   auto cell_ids = particle_group.cell_id_dat;
   auto mpi_ranks = particle_group.mpi_rank_dat;
-  auto ref_positions =
-      particle_group.get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"));
 
   auto loop = particle_loop(
       "MapParticles2DRegular::map", position_dat,
@@ -254,12 +248,12 @@ void MapParticles2DRegular::map(ParticleGroup &particle_group,
                          ((-1.0 - k_tol) <= eta1) && (eta1 <= (1.0 + k_tol));
 
             if (cell_found) {
-              const int geom_id = k_map_cell_ids[geom_map_index];
+              const int cell = k_map_cell_ids[geom_map_index];
               const int mpi_rank = k_map_mpi_ranks[geom_map_index];
-              k_part_cell_ids.at(0) = geom_id;
+              k_part_cell_ids.at(0) = cell;
               k_part_mpi_ranks.at(1) = mpi_rank;
-              k_part_ref_positions.at(0) = xi0;
-              k_part_ref_positions.at(1) = xi1;
+              ReducedPrecision::set(k_part_ref_positions, 0, xi0);
+              ReducedPrecision::set(k_part_ref_positions, 1, xi1);
             }
           }
         }
@@ -274,4 +268,19 @@ void MapParticles2DRegular::map(ParticleGroup &particle_group,
   }
 }
 
+void MapParticles2DRegular::map(ParticleGroup &particle_group,
+                                const int map_cell) {
+
+  // This method will only map into regular geoms (triangles and quads which
+  // are parallelograms).
+  if (this->num_regular_geoms == 0) {
+    return;
+  }
+
+  ReducedPrecision::visit_reference_positions(
+      particle_group, [&](auto ref_positions) {
+        this->map_inner(particle_group, map_cell, ref_positions);
+      });
+}
+
 } // namespace NESO
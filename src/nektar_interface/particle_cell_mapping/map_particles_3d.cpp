@@ -12,6 +12,10 @@ MapParticles3D::MapParticles3D(
   this->map_particles_common =
       std::make_unique<MapParticlesCommon>(sycl_target);
 
+  // The mappers write the cell on the owning rank rather than the geometry id.
+  std::map<int, int> map_geom_to_cell;
+  particle_mesh_interface->get_geom_to_cell_map(map_geom_to_cell);
+
   this->map_particles_3d_regular = nullptr;
   this->map_particles_host = nullptr;
   std::get<0>(this->map_particles_3d_deformed_linear) = nullptr;
@@ -51,7 +55,7 @@ MapParticles3D::MapParticles3D(
   // Create a mapper for 3D regular geometry objects
   if (geometry_container_3d.regular.size()) {
     this->map_particles_3d_regular = std::make_unique<MapParticles3DRegular>(
-        sycl_target, particle_mesh_interface, config);
+        sycl_target, particle_mesh_interface, map_geom_to_cell, config);
   }
 
   // Create mappers for the deformed geometry objects with linear faces
@@ -60,28 +64,32 @@ MapParticles3D::MapParticles3D(
         Newton::MapParticlesNewton<Newton::MappingTetLinear3D>>(
         Newton::MappingTetLinear3D{}, this->sycl_target,
         geometry_container_3d.deformed_linear.tet.local,
-        geometry_container_3d.deformed_linear.tet.remote, config);
+        geometry_container_3d.deformed_linear.tet.remote, map_geom_to_cell,
+        config);
   }
   if (geometry_container_3d.deformed_linear.prism.size()) {
     std::get<1>(this->map_particles_3d_deformed_linear) = std::make_unique<
         Newton::MapParticlesNewton<Newton::MappingPrismLinear3D>>(
         Newton::MappingPrismLinear3D{}, this->sycl_target,
         geometry_container_3d.deformed_linear.prism.local,
-        geometry_container_3d.deformed_linear.prism.remote, config);
+        geometry_container_3d.deformed_linear.prism.remote, map_geom_to_cell,
+        config);
   }
   if (geometry_container_3d.deformed_linear.hex.size()) {
     std::get<2>(this->map_particles_3d_deformed_linear) = std::make_unique<
         Newton::MapParticlesNewton<Newton::MappingHexLinear3D>>(
         Newton::MappingHexLinear3D{}, this->sycl_target,
         geometry_container_3d.deformed_linear.hex.local,
-        geometry_container_3d.deformed_linear.hex.remote, config);
+        geometry_container_3d.deformed_linear.hex.remote, map_geom_to_cell,
+        config);
   }
   if (geometry_container_3d.deformed_linear.pyr.size()) {
     std::get<3>(this->map_particles_3d_deformed_linear) = std::make_unique<
         Newton::MapParticlesNewton<Newton::MappingPyrLinear3D>>(
         Newton::MappingPyrLinear3D{}, this->sycl_target,
         geometry_container_3d.deformed_linear.pyr.local,
-        geometry_container_3d.deformed_linear.pyr.remote, config);
+        geometry_container_3d.deformed_linear.pyr.remote, map_geom_to_cell,
+        config);
   }
   if (geometry_container_3d.deformed_non_linear.size()) {
 
@@ -109,12 +117,18 @@ MapParticles3D::MapParticles3D(
     this->map_particles_3d_deformed_non_linear =
         std::make_unique<Newton::MapParticlesNewton<Newton::MappingGeneric3D>>(
             Newton::MappingGeneric3D{}, this->sycl_target, local, remote,
-            config);
+            map_geom_to_cell, config);
   }
 
   // Create a host mapper as a last resort mapping attempt.
   this->map_particles_host = std::make_unique<MapParticlesHost>(
-      sycl_target, particle_mesh_interface, config);
+      sycl_target, particle_mesh_interface, map_geom_to_cell, config);
+}
+
+void MapParticles3D::set_step_profiler(StepProfilerSharedPtr step_profiler) {
+  if (this->map_particles_host) {
+    this->map_particles_host->set_step_profiler(step_profiler);
+  }
 }
 
 void MapParticles3D::map(ParticleGroup &particle_group, const int map_cell) {
@@ -4,7 +4,7 @@ namespace NESO {
 MapParticles3DRegular::MapParticles3DRegular(
     SYCLTargetSharedPtr sycl_target,
     ParticleMeshInterfaceSharedPtr particle_mesh_interface,
-    ParameterStoreSharedPtr config)
+    const std::map<int, int> &map_geom_to_cell, ParameterStoreSharedPtr config)
     : CoarseMappersBase(sycl_target),
       particle_mesh_interface(particle_mesh_interface) {
 
@@ -73,7 +73,7 @@ MapParticles3DRegular::MapParticles3DRegular(
       NESOASSERT((cell_index < cell_count) && (0 <= cell_index),
                  "Bad cell index from map.");
       NESOASSERT(id == geom.first, "ID mismatch");
-      this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+      this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
       this->dh_mpi_ranks->h_buffer.ptr[cell_index] = rank;
       const int geom_type = shape_type_to_int(geom.second->GetShapeType());
       NESOASSERT((geom_type == index_tet) || (geom_type == index_pyr) ||
@@ -89,7 +89,7 @@ MapParticles3DRegular::MapParticles3DRegular(
       const int cell_index = this->coarse_lookup_map->gid_to_lookup_id.at(id);
       NESOASSERT((cell_index < cell_count) && (0 <= cell_index),
                  "Bad cell index from map.");
-      this->dh_cell_ids->h_buffer.ptr[cell_index] = id;
+      this->dh_cell_ids->h_buffer.ptr[cell_index] = map_geom_to_cell.at(id);
       this->dh_mpi_ranks->h_buffer.ptr[cell_index] = geom->rank;
       const int geom_type = shape_type_to_int(geom->geom->GetShapeType());
       NESOASSERT((geom_type == index_tet) || (geom_type == index_pyr) ||
@@ -107,13 +107,10 @@ MapParticles3DRegular::MapParticles3DRegular(
   }
 }
 
-void MapParticles3DRegular::map(ParticleGroup &particle_group,
-                                const int map_cell) {
-
-  // This method will only map into regular geoms.
-  if (this->num_regular_geoms == 0) {
-    return;
-  }
+template <typename T>
+void MapParticles3DRegular::map_inner(ParticleGroup &particle_group,
+                                      const int map_cell,
+                                      ParticleDatSharedPtr<T> ref_positions) {
 
   auto &clm = this->coarse_lookup_map;
   // Get kernel pointers to the mesh data.
@@ -141,8 +138,8 @@ void MapParticles3DRegular::map(ParticleGroup &particle_group,
       Access::direct_get(Access::write(particle_group.cell_id_dat));
   auto k_part_mpi_ranks =
       Access::direct_get(Access::write(particle_group.mpi_rank_dat));
-  auto k_part_ref_positions = Access::direct_get(Access::write(
-      particle_group.get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS"))));
+  auto k_part_ref_positions =
+      Access::direct_get(Access::write(ref_positions));
 
   // Get iteration set for particles, two cases single cell case or all cells
   const int max_cell_occupancy = (map_cell > -1)
@@ -293,13 +290,16 @@ void MapParticles3DRegular::map(ParticleGroup &particle_group,
 
                     cell_found = dist <= k_tol;
                     if (cell_found) {
-                      const int geom_id = k_map_cell_ids[geom_map_index];
+                      const int cell = k_map_cell_ids[geom_map_index];
                       const int mpi_rank = k_map_mpi_ranks[geom_map_index];
-                      k_part_cell_ids[cellx][0][layerx] = geom_id;
+                      k_part_cell_ids[cellx][0][layerx] = cell;
                       k_part_mpi_ranks[cellx][1][layerx] = mpi_rank;
-                      k_part_ref_positions[cellx][0][layerx] = Lcoords[0];
-                      k_part_ref_positions[cellx][1][layerx] = Lcoords[1];
-                      k_part_ref_positions[cellx][2][layerx] = Lcoords[2];
+                      ReducedPrecision::write(k_part_ref_positions, cellx,
+                                              0, layerx, Lcoords[0]);
+                      ReducedPrecision::write(k_part_ref_positions, cellx,
+                                              1, layerx, Lcoords[1]);
+                      ReducedPrecision::write(k_part_ref_positions, cellx,
+                                              2, layerx, Lcoords[2]);
                       break;
                     }
                   }
@@ -314,9 +314,21 @@ void MapParticles3DRegular::map(ParticleGroup &particle_group,
                          k_part_cell_ids);
   Access::direct_restore(Access::write(particle_group.mpi_rank_dat),
                          k_part_mpi_ranks);
-  Access::direct_restore(Access::write(particle_group.get_dat(
-                             Sym<REAL>("NESO_REFERENCE_POSITIONS"))),
-                         k_part_ref_positions);
+  Access::direct_restore(Access::write(ref_positions), k_part_ref_positions);
+}
+
+void MapParticles3DRegular::map(ParticleGroup &particle_group,
+                                const int map_cell) {
+
+  // This method will only map into regular geoms.
+  if (this->num_regular_geoms == 0) {
+    return;
+  }
+
+  ReducedPrecision::visit_reference_positions(
+      particle_group, [&](auto ref_positions) {
+        this->map_inner(particle_group, map_cell, ref_positions);
+      });
 }
 
 } // namespace NESO
@@ -8,17 +8,24 @@ namespace NESO {
  *  @param sycl_target SYCLTarget on which to perform mapping.
  *  @param particle_mesh_interface ParticleMeshInterface containing 2D
  * Nektar++ cells.
+ *  @param map_geom_to_cell Map from Nektar++ geometry id to cell on the
+ *  owning rank.
  */
 MapParticlesHost::MapParticlesHost(
     SYCLTargetSharedPtr sycl_target,
     ParticleMeshInterfaceSharedPtr particle_mesh_interface,
-    ParameterStoreSharedPtr config)
+    const std::map<int, int> &map_geom_to_cell, ParameterStoreSharedPtr config)
     : sycl_target(sycl_target),
-      particle_mesh_interface(particle_mesh_interface) {
+      particle_mesh_interface(particle_mesh_interface),
+      map_geom_to_cell(map_geom_to_cell) {
 
   this->tol = config->get("MapParticlesHost/tol", 0.0);
 }
 
+void MapParticlesHost::set_step_profiler(StepProfilerSharedPtr step_profiler) {
+  this->step_profiler = step_profiler;
+}
+
 /**
  *  Called internally by NESO-Particles to map positions to Nektar++
  *  triangles and quads.
@@ -26,12 +33,12 @@ MapParticlesHost::MapParticlesHost(
 void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
 
   ParticleDatSharedPtr<REAL> &position_dat = particle_group.position_dat;
-  ParticleDatSharedPtr<REAL> &ref_position_dat =
-      particle_group[Sym<REAL>("NESO_REFERENCE_POSITIONS")];
   ParticleDatSharedPtr<INT> &cell_id_dat = particle_group.cell_id_dat;
   ParticleDatSharedPtr<INT> &mpi_rank_dat = particle_group.mpi_rank_dat;
 
   auto t0 = profile_timestamp();
+  StepProfilerRegion region(this->step_profiler, StepRegion::Mapping,
+                            "MapParticlesHost::map");
   const int rank = this->sycl_target->comm_pair.rank_parent;
   const int ndim = this->particle_mesh_interface->ndim;
   const int ncell = this->particle_mesh_interface->get_cell_count();
@@ -40,8 +47,9 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
 
   CellDataT<REAL> particle_positions(sycl_target, nrow_max,
                                      position_dat->ncomp);
-  CellDataT<REAL> ref_particle_positions(sycl_target, nrow_max,
-                                         ref_position_dat->ncomp);
+  // Reference positions are held in double precision on the host and are
+  // rounded on copy if the ParticleGroup stores them in reduced precision.
+  CellDataT<REAL> ref_particle_positions(sycl_target, nrow_max, ndim);
   CellDataT<INT> mpi_ranks(sycl_target, nrow_max, mpi_rank_dat->ncomp);
   CellDataT<INT> cell_ids(sycl_target, nrow_max, cell_id_dat->ncomp);
 
@@ -66,12 +74,12 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
     auto t0_copy_from = profile_timestamp();
     position_dat->cell_dat.get_cell_async(cellx, particle_positions,
                                           event_stack);
-    ref_position_dat->cell_dat.get_cell_async(cellx, ref_particle_positions,
-                                              event_stack);
     mpi_rank_dat->cell_dat.get_cell_async(cellx, mpi_ranks, event_stack);
     cell_id_dat->cell_dat.get_cell_async(cellx, cell_ids, event_stack);
 
     event_stack.wait();
+    ReducedPrecision::get_reference_positions_cell(particle_group, cellx,
+                                                   ref_particle_positions);
     time_copy_from += profile_elapsed(t0_copy_from, profile_timestamp());
 
     const int nrow = mpi_rank_dat->cell_dat.nrow[cellx];
@@ -121,7 +129,7 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
           }
           if (geom_found) {
             (mpi_ranks)[1][rowx] = rank;
-            (cell_ids)[0][rowx] = ex;
+            (cell_ids)[0][rowx] = this->map_geom_to_cell.at(ex);
             for (int dimx = 0; dimx < ndim; dimx++) {
               ref_particle_positions[dimx][rowx] = local_coord[dimx];
             }
@@ -144,7 +152,8 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
                                              local_coord, tol);
               if (geom_found) {
                 (mpi_ranks)[1][rowx] = remote_geom->rank;
-                (cell_ids)[0][rowx] = remote_geom->id;
+                (cell_ids)[0][rowx] =
+                    this->map_geom_to_cell.at(remote_geom->id);
                 for (int dimx = 0; dimx < ndim; dimx++) {
                   ref_particle_positions[dimx][rowx] = local_coord[dimx];
                 }
@@ -160,7 +169,8 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
                                              local_coord, tol);
               if (geom_found) {
                 (mpi_ranks)[1][rowx] = remote_geom->rank;
-                (cell_ids)[0][rowx] = remote_geom->id;
+                (cell_ids)[0][rowx] =
+                    this->map_geom_to_cell.at(remote_geom->id);
                 for (int dimx = 0; dimx < ndim; dimx++) {
                   ref_particle_positions[dimx][rowx] = local_coord[dimx];
                 }
@@ -177,7 +187,8 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
                                              local_coord, tol);
               if (geom_found) {
                 (mpi_ranks)[1][rowx] = remote_geom->rank;
-                (cell_ids)[0][rowx] = remote_geom->id;
+                (cell_ids)[0][rowx] =
+                    this->map_geom_to_cell.at(remote_geom->id);
                 for (int dimx = 0; dimx < ndim; dimx++) {
                   ref_particle_positions[dimx][rowx] = local_coord[dimx];
                 }
@@ -193,13 +204,13 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
     }
 
     auto t0_copy_to = profile_timestamp();
-    ref_position_dat->cell_dat.set_cell_async(cellx, ref_particle_positions,
-                                              event_stack);
+    ReducedPrecision::set_reference_positions_cell(particle_group, cellx,
+                                                   ref_particle_positions);
     mpi_rank_dat->cell_dat.set_cell_async(cellx, mpi_ranks, event_stack);
     cell_id_dat->cell_dat.set_cell_async(cellx, cell_ids, event_stack);
     event_stack.wait();
 
-    time_copy_to = profile_elapsed(t0_copy_to, profile_timestamp());
+    time_copy_to += profile_elapsed(t0_copy_to, profile_timestamp());
   }
 
   sycl_target->profile_map.inc("NektarGraphLocalMapper", "copy_to", 0,
@@ -212,6 +223,19 @@ void MapParticlesHost::map(ParticleGroup &particle_group, const int map_cell) {
                                time_copy_from);
   sycl_target->profile_map.inc("NektarGraphLocalMapper", "map", 1,
                                profile_elapsed(t0, profile_timestamp()));
+
+  // The lookups are timed per particle, hence are reported as totals.
+  auto profiler = this->step_profiler;
+  if (profiler != nullptr) {
+    profiler->add_duration(StepRegion::Mapping, "MapParticlesHost::copy_from",
+                           time_copy_from);
+    profiler->add_duration(StepRegion::Mapping, "MapParticlesHost::map_nektar",
+                           time_map_nektar);
+    profiler->add_duration(StepRegion::Mapping, "MapParticlesHost::map_halo",
+                           time_halo_lookup);
+    profiler->add_duration(StepRegion::Mapping, "MapParticlesHost::copy_to",
+                           time_copy_to);
+  }
 }
 
 } // namespace NESO
@@ -5,11 +5,22 @@ namespace NESO {
 void NektarGraphLocalMapper::particle_group_callback(
     ParticleGroup &particle_group) {
 
-  particle_group.add_particle_dat(
-      ParticleDat(particle_group.sycl_target,
-                  ParticleProp(Sym<REAL>("NESO_REFERENCE_POSITIONS"),
-                               particle_group.domain->mesh->get_ndim()),
-                  particle_group.domain->mesh->get_cell_count()));
+  // The mappers write the reference positions to whichever of these
+  // ParticleDats exists, see ReducedPrecision::visit_reference_positions.
+  if (this->reduced_precision) {
+    particle_group.add_particle_dat(ParticleDat(
+        particle_group.sycl_target,
+        ParticleProp(ReducedPrecision::get_reference_positions_sym(),
+                     ReducedPrecision::get_ncomp(
+                         particle_group.domain->mesh->get_ndim())),
+        particle_group.domain->mesh->get_cell_count()));
+  } else {
+    particle_group.add_particle_dat(
+        ParticleDat(particle_group.sycl_target,
+                    ParticleProp(Sym<REAL>("NESO_REFERENCE_POSITIONS"),
+                                 particle_group.domain->mesh->get_ndim()),
+                    particle_group.domain->mesh->get_cell_count()));
+  }
 };
 
 NektarGraphLocalMapper::NektarGraphLocalMapper(
@@ -19,6 +30,9 @@ NektarGraphLocalMapper::NektarGraphLocalMapper(
     : sycl_target(sycl_target),
       particle_mesh_interface(particle_mesh_interface) {
 
+  this->reduced_precision =
+      config->get<INT>("NektarGraphLocalMapper/reduced_precision", 0) != 0;
+
   const int ndim = this->particle_mesh_interface->ndim;
   if (ndim == 2) {
     this->map_particles_2d = std::make_unique<MapParticles2D>(
@@ -31,6 +45,13 @@ NektarGraphLocalMapper::NektarGraphLocalMapper(
   }
 };
 
+void NektarGraphLocalMapper::set_step_profiler(
+    StepProfilerSharedPtr step_profiler) {
+  if (this->map_particles_3d) {
+    this->map_particles_3d->set_step_profiler(step_profiler);
+  }
+}
+
 /**
  *  Called internally by NESO-Particles to map positions to Nektar++
  *  geometry objects.
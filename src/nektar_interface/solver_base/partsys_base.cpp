@@ -22,17 +22,30 @@ PartSysBase::PartSysBase(const ParticleReaderSharedPtr config,
   // Store options
   this->options = options;
 
+  // Optionally reuse the mesh setup of a previous run
+  std::string setup_cache_dir = "";
+  if (config->session->DefinesSolverInfo(SETUP_CACHE_STR)) {
+    setup_cache_dir = config->session->GetSolverInfo(SETUP_CACHE_STR);
+  }
+
   // Create interface between particles and nektar++
-  this->particle_mesh_interface =
-      std::make_shared<ParticleMeshInterface>(graph, 0, this->comm);
+  this->particle_mesh_interface = std::make_shared<ParticleMeshInterface>(
+      graph, 0, this->comm, setup_cache_dir);
   extend_halos_fixed_offset(this->options.extend_halos_offset,
                             this->particle_mesh_interface);
   this->sycl_target =
       std::make_shared<SYCLTarget>(0, particle_mesh_interface->get_comm());
+  int reduced_precision;
+  config->load_parameter(REDUCED_PRECISION_STR, reduced_precision, 0);
+  this->reduced_precision = reduced_precision != 0;
+  auto mapper_config = std::make_shared<ParameterStore>();
+  mapper_config->set<INT>("NektarGraphLocalMapper/reduced_precision",
+                          this->reduced_precision ? 1 : 0);
   this->nektar_graph_local_mapper = std::make_shared<NektarGraphLocalMapper>(
-      this->sycl_target, this->particle_mesh_interface);
+      this->sycl_target, this->particle_mesh_interface, mapper_config);
   this->domain = std::make_shared<Domain>(this->particle_mesh_interface,
                                           this->nektar_graph_local_mapper);
+  this->step_profiler = std::make_shared<StepProfiler>();
 }
 
 /**
@@ -56,15 +69,46 @@ void PartSysBase::free() {
   if (this->h5part) {
     this->h5part->close();
   }
+  if (this->neighbour_transfer) {
+    this->neighbour_transfer->free();
+  }
   this->particle_group->free();
   this->sycl_target->free();
   this->particle_mesh_interface->free();
 }
 
+void PartSysBase::set_step_profiler(StepProfilerSharedPtr step_profiler) {
+  this->step_profiler = step_profiler;
+  this->nektar_graph_local_mapper->set_step_profiler(step_profiler);
+  if (this->neighbour_transfer) {
+    this->neighbour_transfer->set_step_profiler(step_profiler);
+  }
+}
+
 bool PartSysBase::is_output_step(int step) {
   return this->output_freq > 0 && (step % this->output_freq) == 0;
 }
 
+void PartSysBase::update_load_metrics(const int step) {
+  if (this->load_metrics_freq <= 0 || (step % this->load_metrics_freq) != 0 ||
+      !this->load_metrics) {
+    return;
+  }
+  // The measurement is dominated by the reductions over the ranks.
+  StepProfilerRegion region(this->step_profiler, StepRegion::Transfer,
+                            "PartSysBase::update_load_metrics");
+  this->load_metrics->update();
+  auto particle_metrics = this->load_metrics->get_particle_metrics();
+  auto cost_metrics = this->load_metrics->get_cost_metrics();
+  if (this->sycl_target->comm_pair.rank_parent == 0) {
+    nprint("Particle load at step", step,
+           "- particles per rank (min, mean, max):", particle_metrics.min,
+           particle_metrics.mean, particle_metrics.max,
+           "imbalance:", particle_metrics.imbalance(),
+           "element cost imbalance:", cost_metrics.imbalance());
+  }
+}
+
 void PartSysBase::read_params() {
 
   // Read total number of particles / number per cell from config
@@ -105,9 +149,28 @@ void PartSysBase::read_params() {
   // ToDo Should probably be unsigned, but complicates use of LoadParameter
   this->config->load_parameter(PART_OUTPUT_FREQ_STR, this->output_freq, 0);
   report_param("Output frequency (steps)", this->output_freq);
+
+  // Particle load measurement frequency
+  this->config->load_parameter(LOAD_METRICS_FREQ_STR, this->load_metrics_freq,
+                               0);
+  report_param("Load metrics frequency (steps)", this->load_metrics_freq);
+
+  // Checkpoint frequency
+  this->config->load_parameter(CHECKPOINT_FREQ_STR, this->checkpoint_freq, 0);
+  report_param("Checkpoint frequency (steps)", this->checkpoint_freq);
+
+  // Transfer particles directly to halo neighbours
+  this->config->load_parameter(NEIGHBOUR_TRANSFER_STR,
+                               this->neighbour_transfer_enabled, 0);
+  this->config->load_parameter(NEIGHBOUR_TRANSFER_STATS_STR,
+                               this->neighbour_transfer_stats, 0);
+  report_param("Neighbour transfer", this->neighbour_transfer_enabled);
+  report_param("Reduced precision", this->reduced_precision);
 }
 
 void PartSysBase::write(const int step) {
+  StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                            "PartSysBase::write");
   if (this->h5part) {
     if (this->sycl_target->comm_pair.rank_parent == 0) {
       nprint("Writing particle properties at step", step);
@@ -121,6 +184,48 @@ void PartSysBase::write(const int step) {
   }
 };
 
+void PartSysBase::write_checkpoint(const int step) {
+  if (this->checkpoint_freq <= 0 || (step % this->checkpoint_freq) != 0) {
+    return;
+  }
+  StepProfilerRegion region(this->step_profiler, StepRegion::IO,
+                            "PartSysBase::write_checkpoint");
+  const std::string fname_stem = CHECKPOINT_OUTPUT + "_" + std::to_string(step);
+  const std::string fname = fname_stem + ".h5";
+  if (this->sycl_target->comm_pair.rank_parent == 0) {
+    nprint("Writing particle checkpoint", fname);
+  }
+  IO::ParticleCheckpointWriter writer(fname,
+                                      this->sycl_target->comm_pair.comm_parent);
+  writer.write_particles(this->particle_group);
+  writer.write_value("step", static_cast<INT>(step));
+  this->write_checkpoint_state(writer);
+  writer.close();
+  // Measured element costs are written alongside the checkpoint they
+  // describe, e.g. to inform the partition of a restarted run.
+  if (this->load_metrics_freq > 0) {
+    this->load_metrics->write_element_costs(fname_stem + ELEMENT_COSTS_SUFFIX);
+  }
+}
+
+bool PartSysBase::read_checkpoint() {
+  if (!this->config->session->DefinesSolverInfo(RESTART_FILE_STR)) {
+    return false;
+  }
+  const std::string fname =
+      this->config->session->GetSolverInfo(RESTART_FILE_STR);
+  IO::ParticleCheckpointReader reader(fname,
+                                      this->sycl_target->comm_pair.comm_parent);
+  const INT npart = reader.read_particles(this->particle_group);
+  this->read_checkpoint_state(reader);
+  reader.close();
+  if (this->sycl_target->comm_pair.rank_parent == 0) {
+    nprint("Restored", npart, "particles from checkpoint", fname);
+  }
+  this->restarted = true;
+  return true;
+}
+
 void PartSysBase::init_object() {
   this->config->load_parameter(PART_OUTPUT_FREQ_STR, this->output_freq, 0);
   report_param("Output frequency (steps)", this->output_freq);
@@ -133,7 +238,17 @@ void PartSysBase::init_object() {
   this->cell_id_translation = std::make_shared<CellIDTranslation>(
       this->sycl_target, this->particle_group->cell_id_dat,
       this->particle_mesh_interface);
+  this->load_metrics = std::make_shared<ParticleLoadMetrics>(
+      this->particle_group, this->cell_id_translation);
   this->set_up_particles();
+  if (this->neighbour_transfer_enabled) {
+    this->neighbour_transfer = std::make_shared<NeighbourTransfer>(
+        this->particle_group, this->particle_mesh_interface,
+        this->cell_id_translation,
+        this->neighbour_transfer_stats ? NEIGHBOUR_TRANSFER_STATS_OUTPUT : "");
+    this->neighbour_transfer->set_step_profiler(this->step_profiler);
+  }
+  this->read_checkpoint();
 }
 
 } // namespace NESO::Particles
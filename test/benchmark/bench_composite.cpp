@@ -0,0 +1,57 @@
+#include "nektar_interface/composite_interaction/composite_intersection.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_mesh.hpp"
+
+namespace NESO::Benchmark {
+namespace {
+
+void benchmark_composite(BenchmarkRunner &runner) {
+  for_each_mesh(runner, [&](const BenchmarkMeshCase &mesh_case,
+                            const std::string &conditions, const INT npart,
+                            BenchmarkMesh &bm) {
+    auto params = get_params(mesh_case, conditions, npart);
+    std::map<int, std::vector<int>> boundary_groups;
+    for (const int cx : mesh_case.composites) {
+      boundary_groups[cx] = {cx};
+    }
+    auto composite_intersection = std::make_shared<CompositeIntersection>(
+        bm.sycl_target, bm.mesh, boundary_groups);
+
+    // Each repeat moves the particles from their reference positions along
+    // their velocities for a time long enough for a fraction of the
+    // trajectories to cross the boundary.
+    const int k_ndim = bm.ndim;
+    const REAL k_dt = 0.1 * bm.pbc->global_extent[0];
+    auto setup = [&]() {
+      particle_loop(
+          bm.particle_group,
+          [=](auto P, auto P_ORIG) {
+            for (int dimx = 0; dimx < k_ndim; dimx++) {
+              P.at(dimx) = P_ORIG.at(dimx);
+            }
+          },
+          Access::write(Sym<REAL>("P")), Access::read(Sym<REAL>("P_ORIG")))
+          ->execute();
+    };
+    runner.run("CompositeIntersection", params, setup, [&]() {
+      composite_intersection->pre_integration(bm.particle_group);
+      particle_loop(
+          bm.particle_group,
+          [=](auto P, auto V) {
+            for (int dimx = 0; dimx < k_ndim; dimx++) {
+              P.at(dimx) += k_dt * V.at(dimx);
+            }
+          },
+          Access::write(Sym<REAL>("P")), Access::read(Sym<REAL>("V")))
+          ->execute();
+      composite_intersection->get_intersections(bm.particle_group);
+    });
+    composite_intersection->free();
+  });
+}
+
+BenchmarkRegistration registration("composite", benchmark_composite);
+
+} // namespace
+} // namespace NESO::Benchmark
@@ -0,0 +1,87 @@
+#include "nektar_interface/function_bary_evaluation.hpp"
+#include "nektar_interface/function_evaluation.hpp"
+#include "nektar_interface/function_projection.hpp"
+#include "nektar_interface/reduced_precision.hpp"
+#include <LibUtilities/BasicUtils/Vmath.hpp>
+#include <MultiRegions/DisContField.h>
+
+#include "benchmark.hpp"
+#include "benchmark_mesh.hpp"
+
+using namespace Nektar;
+using namespace Nektar::MultiRegions;
+
+namespace NESO::Benchmark {
+namespace {
+
+/**
+ * Create a field on the mesh with all coefficients set to one.
+ */
+inline std::shared_ptr<DisContField> make_field(BenchmarkMesh &bm) {
+  auto field = std::make_shared<DisContField>(bm.session, bm.graph, "u");
+  Vmath::Fill(field->GetNcoeffs(), 1.0, field->UpdateCoeffs(), 1);
+  field->BwdTrans(field->GetCoeffs(), field->UpdatePhys());
+  return field;
+}
+
+void benchmark_field(BenchmarkRunner &runner) {
+  for_each_mesh(runner, [&](const BenchmarkMeshCase &mesh_case,
+                            const std::string &conditions, const INT npart,
+                            BenchmarkMesh &bm) {
+    auto params = get_params(mesh_case, conditions, npart);
+    auto field = make_field(bm);
+    auto no_setup = []() {};
+
+    auto field_project = std::make_shared<FieldProject<DisContField>>(
+        field, bm.particle_group, bm.cell_id_translation);
+    runner.run("FieldProject", params, no_setup,
+               [&]() { field_project->project(Sym<REAL>("Q")); });
+
+    auto field_evaluate = std::make_shared<FieldEvaluate<DisContField>>(
+        field, bm.particle_group, bm.cell_id_translation);
+    runner.run("FieldEvaluate", params, no_setup,
+               [&]() { field_evaluate->evaluate(Sym<REAL>("E")); });
+
+    auto field_deriv_evaluate = std::make_shared<FieldEvaluate<DisContField>>(
+        field, bm.particle_group, bm.cell_id_translation, true);
+    runner.run("FieldEvaluateDerivative", params, no_setup, [&]() {
+      field_deriv_evaluate->evaluate(Sym<REAL>("DEDX"));
+    });
+
+    auto bary_evaluate = std::make_shared<BaryEvaluateBase<DisContField>>(
+        field, bm.mesh, bm.cell_id_translation);
+    auto phys = field->GetPhys();
+    std::vector<Array<OneD, NekDouble> *> physvals = {&phys};
+    std::vector<Sym<REAL>> syms = {Sym<REAL>("E")};
+    std::vector<int> components = {0};
+    runner.run("BaryEvaluateBase", params, no_setup, [&]() {
+      bary_evaluate->evaluate(bm.particle_group, syms, components, physvals);
+    });
+
+    // Reduced precision reference positions and outputs. The benchmark mapper
+    // stores full precision positions, hence they are packed here. When the
+    // reduced precision ParticleDat exists it is read in place of the full
+    // precision ParticleDat.
+    const auto reduced_sym = ReducedPrecision::get_reference_positions_sym();
+    bm.particle_group->add_particle_dat(
+        reduced_sym, ReducedPrecision::get_ncomp(bm.ndim));
+    bm.particle_group->add_particle_dat(Sym<INT>("E_REDUCED"), 1);
+    bm.particle_group->add_particle_dat(
+        Sym<INT>("DEDX_REDUCED"), ReducedPrecision::get_ncomp(bm.ndim));
+    ReducedPrecision::pack_dat(
+        bm.particle_group->get_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS")),
+        bm.particle_group->get_dat(reduced_sym));
+    runner.run("FieldProjectReduced", params, no_setup,
+               [&]() { field_project->project(Sym<REAL>("Q")); });
+    runner.run("FieldEvaluateReduced", params, no_setup,
+               [&]() { field_evaluate->evaluate(Sym<INT>("E_REDUCED")); });
+    runner.run("FieldEvaluateDerivativeReduced", params, no_setup, [&]() {
+      field_deriv_evaluate->evaluate(Sym<INT>("DEDX_REDUCED"));
+    });
+  });
+}
+
+BenchmarkRegistration registration("field", benchmark_field);
+
+} // namespace
+} // namespace NESO::Benchmark
@@ -0,0 +1,42 @@
+#include "nektar_interface/geometry_transport/halo_extension.hpp"
+#include "nektar_interface/particle_interface.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_mesh.hpp"
+
+namespace NESO::Benchmark {
+namespace {
+
+void benchmark_halo(BenchmarkRunner &runner) {
+  for (auto &mesh_case : get_mesh_cases()) {
+    if (runner.options.quick && !mesh_case.quick) {
+      continue;
+    }
+    // The halo setup does not depend on the polynomial order or particles.
+    const std::string conditions = mesh_case.conditions.at(0);
+    auto params = get_params(mesh_case, conditions, -1);
+    if (!runner.enabled("HaloSetup", params)) {
+      continue;
+    }
+    BenchmarkMesh bm(runner.options.resources_dir, mesh_case.mesh,
+                     conditions);
+    ParticleMeshInterfaceSharedPtr mesh;
+    auto setup = [&]() {
+      if (mesh) {
+        mesh->free();
+        mesh.reset();
+      }
+    };
+    runner.run("HaloSetup", params, setup, [&]() {
+      mesh = std::make_shared<ParticleMeshInterface>(bm.graph);
+      extend_halos_fixed_offset(1, mesh);
+    });
+    setup();
+    bm.free();
+  }
+}
+
+BenchmarkRegistration registration("halo", benchmark_halo);
+
+} // namespace
+} // namespace NESO::Benchmark
@@ -0,0 +1,38 @@
+#include "nektar_interface/particle_cell_mapping/map_particles_2d.hpp"
+#include "nektar_interface/particle_cell_mapping/map_particles_3d.hpp"
+
+#include "benchmark.hpp"
+#include "benchmark_mesh.hpp"
+
+namespace NESO::Benchmark {
+namespace {
+
+void benchmark_mapping(BenchmarkRunner &runner) {
+  for_each_mesh(runner, [&](const BenchmarkMeshCase &mesh_case,
+                            const std::string &conditions, const INT npart,
+                            BenchmarkMesh &bm) {
+    auto params = get_params(mesh_case, conditions, npart);
+    // Mark all particles as unmapped such that each repeat maps every
+    // particle into its owning cell.
+    auto setup = [&]() {
+      reset_mpi_ranks((*bm.particle_group)[Sym<INT>("NESO_MPI_RANK")]);
+    };
+    if (bm.ndim == 2) {
+      MapParticles2D map_particles(bm.sycl_target, bm.mesh);
+      runner.run("MapParticles2D", params, setup,
+                 [&]() { map_particles.map(*bm.particle_group); });
+    } else {
+      MapParticles3D map_particles(bm.sycl_target, bm.mesh);
+      runner.run("MapParticles3D", params, setup,
+                 [&]() { map_particles.map(*bm.particle_group); });
+    }
+    // The move to owning cells, i.e. the mapping and the cell move, where the
+    // mapper writes the cells without a separate pass over the cell ids.
+    runner.run("Transfer", params, setup, [&]() { bm.transfer_particles(); });
+  });
+}
+
+BenchmarkRegistration registration("mapping", benchmark_mapping);
+
+} // namespace
+} // namespace NESO::Benchmark
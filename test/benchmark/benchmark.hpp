@@ -0,0 +1,280 @@
+#ifndef _TEST_BENCHMARK_BENCHMARK_HPP_
+#define _TEST_BENCHMARK_BENCHMARK_HPP_
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mpi.h>
+#include <neso_particles.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace NESO::Particles;
+
+namespace NESO::Benchmark {
+
+/**
+ * Timings of one benchmark case. Each sample is the maximum over all ranks of
+ * the wall time of one repeat.
+ */
+struct BenchmarkResult {
+  /// Name of the benchmarked kernel, e.g. "FieldProject".
+  std::string name;
+  /// Parameters of the case, e.g. mesh, conditions and particle count.
+  std::map<std::string, std::string> params;
+  /// Number of timed repeats.
+  int repeats;
+  /// Minimum time over the repeats in seconds.
+  double time_min;
+  /// Mean time over the repeats in seconds.
+  double time_mean;
+  /// Maximum time over the repeats in seconds.
+  double time_max;
+
+  /**
+   * @returns Key which identifies the case, used to match results against a
+   * baseline.
+   */
+  inline std::string key() const {
+    std::string k = this->name;
+    for (auto &[param, value] : this->params) {
+      k += "/" + param + "=" + value;
+    }
+    return k;
+  }
+};
+
+/**
+ * Options controlling which benchmark cases run and how.
+ */
+struct BenchmarkOptions {
+  /// Number of untimed repeats before the timed repeats.
+  int warmup = 1;
+  /// Number of timed repeats.
+  int repeats = 5;
+  /// Global particle counts to run each particle benchmark with.
+  std::vector<INT> particle_counts = {10000, 100000};
+  /// Only run cases whose key contains this string.
+  std::string filter = "";
+  /// Directory containing the meshes and conditions files.
+  std::string resources_dir = "";
+  /// Only use the meshes with fewer than this many elements if true.
+  bool quick = false;
+};
+
+/**
+ * Runs benchmark cases, collects their timings and compares them against a
+ * baseline.
+ */
+class BenchmarkRunner {
+protected:
+  MPI_Comm comm;
+  int rank;
+  int size;
+  std::vector<BenchmarkResult> results;
+
+public:
+  /// Options for the benchmark run.
+  BenchmarkOptions options;
+
+  /**
+   * Create a runner. Must be called collectively.
+   *
+   * @param comm MPI communicator the benchmarks run on.
+   * @param options Options for the benchmark run.
+   */
+  BenchmarkRunner(MPI_Comm comm, BenchmarkOptions options)
+      : comm(comm), options(options) {
+    MPICHK(MPI_Comm_rank(comm, &this->rank));
+    MPICHK(MPI_Comm_size(comm, &this->size));
+  }
+
+  /**
+   * @param name Name of the kernel.
+   * @param params Parameters of the case.
+   * @returns True if the case is selected by the filter.
+   */
+  inline bool enabled(const std::string &name,
+                      const std::map<std::string, std::string> &params) {
+    BenchmarkResult result{name, params, 0, 0.0, 0.0, 0.0};
+    return result.key().find(this->options.filter) != std::string::npos;
+  }
+
+  /**
+   * Time a benchmark case. Must be called collectively. The setup function
+   * is called before each repeat and is not timed. The body function is
+   * timed and must not return before its device work is complete.
+   *
+   * @param name Name of the kernel.
+   * @param params Parameters of the case.
+   * @param setup Function called before each repeat.
+   * @param body Function to time.
+   */
+  inline void run(const std::string &name,
+                  const std::map<std::string, std::string> &params,
+                  std::function<void()> setup, std::function<void()> body) {
+    if (!this->enabled(name, params)) {
+      return;
+    }
+    for (int wx = 0; wx < this->options.warmup; wx++) {
+      setup();
+      body();
+    }
+
+    std::vector<double> samples;
+    samples.reserve(this->options.repeats);
+    for (int rx = 0; rx < this->options.repeats; rx++) {
+      setup();
+      MPICHK(MPI_Barrier(this->comm));
+      auto t0 = profile_timestamp();
+      body();
+      const double local_time = profile_elapsed(t0, profile_timestamp());
+      double time;
+      MPICHK(MPI_Allreduce(&local_time, &time, 1, MPI_DOUBLE, MPI_MAX,
+                           this->comm));
+      samples.push_back(time);
+    }
+
+    BenchmarkResult result{name, params, this->options.repeats, 0.0, 0.0, 0.0};
+    if (!samples.empty()) {
+      result.time_min = *std::min_element(samples.begin(), samples.end());
+      result.time_max = *std::max_element(samples.begin(), samples.end());
+      double sum = 0.0;
+      for (const double sx : samples) {
+        sum += sx;
+      }
+      result.time_mean = sum / samples.size();
+    }
+    if (this->rank == 0) {
+      nprint(result.key(), "min:", result.time_min,
+             "mean:", result.time_mean);
+    }
+    this->results.push_back(result);
+  }
+
+  /**
+   * @returns Results of the cases run so far.
+   */
+  inline const std::vector<BenchmarkResult> &get_results() const {
+    return this->results;
+  }
+
+  /**
+   * Write the results to a JSON file. Rank 0 writes the file.
+   *
+   * @param filename File to write.
+   */
+  inline void write_json(const std::string &filename) const {
+    if (this->rank != 0) {
+      return;
+    }
+    std::ofstream out(filename);
+    NESOASSERT(out.is_open(), "Could not open benchmark output " + filename);
+    out << std::setprecision(9);
+    out << "{\n  \"num_ranks\": " << this->size << ",\n";
+    out << "  \"benchmarks\": [";
+    const int num_results = this->results.size();
+    for (int ix = 0; ix < num_results; ix++) {
+      auto &result = this->results[ix];
+      out << ((ix == 0) ? "\n" : ",\n");
+      out << "    {\n";
+      out << "      \"key\": \"" << result.key() << "\",\n";
+      out << "      \"name\": \"" << result.name << "\",\n";
+      out << "      \"params\": {";
+      bool first = true;
+      for (auto &[param, value] : result.params) {
+        out << (first ? "" : ", ") << "\"" << param << "\": \"" << value
+            << "\"";
+        first = false;
+      }
+      out << "},\n";
+      out << "      \"repeats\": " << result.repeats << ",\n";
+      out << "      \"time_min\": " << result.time_min << ",\n";
+      out << "      \"time_mean\": " << result.time_mean << ",\n";
+      out << "      \"time_max\": " << result.time_max << "\n";
+      out << "    }";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  /**
+   * Compare the minimum time of each case against a baseline written by
+   * write_json. A case regresses if its time exceeds the baseline time by
+   * more than the tolerance. Cases missing from the baseline are reported
+   * and not counted. Must be called collectively; rank 0 prints the report.
+   *
+   * @param filename Baseline JSON file.
+   * @param tolerance Allowed relative slowdown, e.g. 0.1 for 10%.
+   * @returns Number of regressed cases, identical on all ranks.
+   */
+  inline int compare(const std::string &filename, const double tolerance) {
+    int num_regressions = 0;
+    if (this->rank == 0) {
+      boost::property_tree::ptree tree;
+      boost::property_tree::read_json(filename, tree);
+      std::map<std::string, double> baseline;
+      for (auto &item : tree.get_child("benchmarks")) {
+        baseline[item.second.get<std::string>("key")] =
+            item.second.get<double>("time_min");
+      }
+      const int num_ranks_baseline = tree.get<int>("num_ranks", this->size);
+      if (num_ranks_baseline != this->size) {
+        nprint("Warning: baseline was recorded with", num_ranks_baseline,
+               "ranks, this run uses", this->size);
+      }
+
+      nprint("Comparison against baseline", filename, "tolerance",
+             tolerance);
+      for (auto &result : this->results) {
+        const std::string key = result.key();
+        if (baseline.count(key) == 0) {
+          nprint("  NEW       ", key);
+          continue;
+        }
+        const double base = baseline.at(key);
+        const double ratio = (base > 0.0) ? result.time_min / base : 1.0;
+        const bool regressed = ratio > (1.0 + tolerance);
+        num_regressions += regressed ? 1 : 0;
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3) << ratio;
+        nprint(regressed ? "  REGRESSED " : "  OK        ", key,
+               "ratio:", ss.str());
+      }
+      nprint("Number of regressions:", num_regressions);
+    }
+    MPICHK(MPI_Bcast(&num_regressions, 1, MPI_INT, 0, this->comm));
+    return num_regressions;
+  }
+};
+
+/// Function which runs the cases of one benchmark with a runner.
+typedef std::function<void(BenchmarkRunner &)> BenchmarkFunction;
+
+/**
+ * @returns Registry of all benchmarks, in registration order.
+ */
+inline std::vector<std::pair<std::string, BenchmarkFunction>> &
+get_benchmarks() {
+  static std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+  return benchmarks;
+}
+
+/**
+ * Registers a benchmark when constructed, intended for static instances in
+ * the benchmark source files.
+ */
+struct BenchmarkRegistration {
+  BenchmarkRegistration(const std::string &name, BenchmarkFunction function) {
+    get_benchmarks().push_back({name, function});
+  }
+};
+
+} // namespace NESO::Benchmark
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef _TEST_BENCHMARK_BENCHMARK_MESH_HPP_
+#define _TEST_BENCHMARK_BENCHMARK_MESH_HPP_
+
+#include "nektar_interface/particle_interface.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <filesystem>
+#include <memory>
+#include <neso_particles.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../unit/nektar_interface/test_helper_utilities.hpp"
+#include "benchmark.hpp"
+
+using namespace Nektar;
+using namespace NESO::Particles;
+
+namespace NESO::Benchmark {
+
+/**
+ * A mesh from the test resources and the conditions files, i.e. polynomial
+ * orders, to benchmark it with.
+ */
+struct BenchmarkMeshCase {
+  /// Label used in the benchmark keys.
+  std::string label;
+  /// Mesh file relative to the resources directory.
+  std::string mesh;
+  /// Conditions files relative to the resources directory, empty strings for
+  /// meshes which contain their own conditions.
+  std::vector<std::string> conditions;
+  /// Boundary composites for composite intersection benchmarks.
+  std::vector<int> composites;
+  /// True if the mesh is small enough for a quick run.
+  bool quick;
+};
+
+/**
+ * @returns The meshes to benchmark, from the smallest to the largest.
+ */
+inline std::vector<BenchmarkMeshCase> get_mesh_cases() {
+  return {{"square_triangles_quads",
+           "square_triangles_quads_nummodes_2.xml",
+           {""},
+           {100, 200, 300, 400},
+           true},
+          {"square_triangles_quads",
+           "square_triangles_quads_nummodes_6.xml",
+           {""},
+           {100, 200, 300, 400},
+           true},
+          {"hex_cube_0.5",
+           "reference_hex_cube/hex_cube_0.5.xml",
+           {"reference_hex_cube/conditions_nummodes_2.xml",
+            "reference_hex_cube/conditions_nummodes_4.xml"},
+           {100, 101, 102, 103, 104, 105},
+           true},
+          {"mixed_ref_cube_0.5",
+           "reference_all_types_cube/mixed_ref_cube_0.5.xml",
+           {"reference_all_types_cube/conditions.xml"},
+           {100, 200, 300, 400, 500, 600},
+           false},
+          {"mixed_ref_cube_0.2",
+           "reference_all_types_cube/mixed_ref_cube_0.2.xml",
+           {"reference_all_types_cube/conditions.xml"},
+           {100, 200, 300, 400, 500, 600},
+           false}};
+}
+
+/**
+ * Nektar++ session, mesh interface and ParticleGroup for one mesh and
+ * conditions file. Particles are distributed uniformly over the bounding box
+ * of the domain and moved to their owning cells.
+ */
+class BenchmarkMesh {
+protected:
+  std::unique_ptr<TestUtilities::TestResourceSession> resource_session;
+
+public:
+  LibUtilities::SessionReaderSharedPtr session;
+  SpatialDomains::MeshGraphSharedPtr graph;
+  ParticleMeshInterfaceSharedPtr mesh;
+  SYCLTargetSharedPtr sycl_target;
+  std::shared_ptr<NektarGraphLocalMapper> nektar_graph_local_mapper;
+  DomainSharedPtr domain;
+  ParticleGroupSharedPtr particle_group;
+  std::shared_ptr<CellIDTranslation> cell_id_translation;
+  std::shared_ptr<NektarCartesianPeriodic> pbc;
+  int ndim;
+
+  /**
+   * Load a mesh and conditions file and create a ParticleGroup with the
+   * properties "P", "P_ORIG", "V", "Q", "E", "DEDX" and "ID".
+   *
+   * @param resources_dir Directory containing the test resources.
+   * @param mesh_file Mesh file relative to resources_dir.
+   * @param conditions_file Conditions file relative to resources_dir, empty
+   * if the mesh file contains the conditions.
+   */
+  BenchmarkMesh(const std::string &resources_dir, const std::string &mesh_file,
+                const std::string &conditions_file) {
+    // Absolute paths replace the default test resources directory of
+    // TestResourceSession, hence resources_dir is respected.
+    const auto dir = std::filesystem::absolute(resources_dir);
+    if (conditions_file.size()) {
+      this->resource_session =
+          std::make_unique<TestUtilities::TestResourceSession>(
+              dir / mesh_file, dir / conditions_file);
+    } else {
+      this->resource_session =
+          std::make_unique<TestUtilities::TestResourceSession>(dir /
+                                                               mesh_file);
+    }
+    this->session = this->resource_session->session;
+    this->graph = SpatialDomains::MeshGraphIO::Read(this->session);
+
+    this->mesh = std::make_shared<ParticleMeshInterface>(this->graph);
+    this->sycl_target =
+        std::make_shared<SYCLTarget>(0, this->mesh->get_comm());
+    this->nektar_graph_local_mapper = std::make_shared<NektarGraphLocalMapper>(
+        this->sycl_target, this->mesh);
+    this->domain = std::make_shared<Domain>(this->mesh,
+                                            this->nektar_graph_local_mapper);
+    this->ndim = this->mesh->get_ndim();
+    ParticleSpec particle_spec{
+        ParticleProp(Sym<REAL>("P"), this->ndim, true),
+        ParticleProp(Sym<REAL>("P_ORIG"), this->ndim),
+        ParticleProp(Sym<REAL>("V"), this->ndim),
+        ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+        ParticleProp(Sym<REAL>("Q"), 1),
+        ParticleProp(Sym<REAL>("E"), 1),
+        ParticleProp(Sym<REAL>("DEDX"), this->ndim),
+        ParticleProp(Sym<INT>("ID"), 1)};
+    this->particle_group = std::make_shared<ParticleGroup>(
+        this->domain, particle_spec, this->sycl_target);
+    this->pbc = std::make_shared<NektarCartesianPeriodic>(
+        this->sycl_target, this->graph, this->particle_group->position_dat);
+    this->cell_id_translation = std::make_shared<CellIDTranslation>(
+        this->sycl_target, this->particle_group->cell_id_dat, this->mesh);
+  }
+
+  /**
+   * Add particles uniformly distributed over the bounding box of the domain,
+   * with random velocities of unit scale, and move them to their owning
+   * cells. Must be called collectively.
+   *
+   * @param npart_total Global number of particles to add.
+   */
+  inline void add_particles(const INT npart_total) {
+    const int rank = this->sycl_target->comm_pair.rank_parent;
+    const int size = this->sycl_target->comm_pair.size_parent;
+    INT rstart, rend;
+    get_decomp_1d(size, npart_total, rank, &rstart, &rend);
+    const INT N = rend - rstart;
+    std::mt19937 rng(52234234 + rank);
+    if (N > 0) {
+      auto positions =
+          uniform_within_extents(N, this->ndim, this->pbc->global_extent, rng);
+      auto velocities = normal_distribution(N, this->ndim, 0.0, 1.0, rng);
+      ParticleSet initial_distribution(
+          N, this->particle_group->get_particle_spec());
+      for (int px = 0; px < N; px++) {
+        for (int dimx = 0; dimx < this->ndim; dimx++) {
+          const REAL pos =
+              positions[dimx][px] + this->pbc->global_origin[dimx];
+          initial_distribution[Sym<REAL>("P")][px][dimx] = pos;
+          initial_distribution[Sym<REAL>("P_ORIG")][px][dimx] = pos;
+          initial_distribution[Sym<REAL>("V")][px][dimx] =
+              velocities[dimx][px];
+        }
+        initial_distribution[Sym<INT>("CELL_ID")][px][0] = 0;
+        initial_distribution[Sym<REAL>("Q")][px][0] = 1.0;
+        initial_distribution[Sym<INT>("ID")][px][0] = rstart + px;
+      }
+      this->particle_group->add_particles_local(initial_distribution);
+    }
+    reset_mpi_ranks((*this->particle_group)[Sym<INT>("NESO_MPI_RANK")]);
+    this->transfer_particles();
+
+    // The positions after the move are the reference positions which the
+    // trajectory benchmarks restart from.
+    const int k_ndim = this->ndim;
+    particle_loop(
+        this->particle_group,
+        [=](auto P, auto P_ORIG) {
+          for (int dimx = 0; dimx < k_ndim; dimx++) {
+            P_ORIG.at(dimx) = P.at(dimx);
+          }
+        },
+        Access::read(Sym<REAL>("P")), Access::write(Sym<REAL>("P_ORIG")))
+        ->execute();
+  }
+
+  /**
+   * Apply periodic boundary conditions and move particles to their owning
+   * ranks and cells. Must be called collectively.
+   */
+  inline void transfer_particles() {
+    this->pbc->execute();
+    this->particle_group->hybrid_move();
+    this->particle_group->cell_move();
+  }
+
+  /**
+   * Free the mesh, ParticleGroup and compute target. Must be called
+   * collectively.
+   */
+  inline void free() {
+    this->particle_group->free();
+    this->sycl_target->free();
+    this->mesh->free();
+  }
+};
+
+/**
+ * @returns Parameters identifying a mesh, conditions file and particle count.
+ */
+inline std::map<std::string, std::string>
+get_params(const BenchmarkMeshCase &mesh_case,
+           const std::string &conditions_file, const INT npart) {
+  std::map<std::string, std::string> params;
+  params["mesh"] = mesh_case.label;
+  params["conditions"] = conditions_file.size()
+                             ? std::filesystem::path(conditions_file)
+                                   .filename()
+                                   .string()
+                             : std::filesystem::path(mesh_case.mesh)
+                                   .filename()
+                                   .string();
+  if (npart >= 0) {
+    params["npart"] = std::to_string(npart);
+  }
+  return params;
+}
+
+/**
+ * Call a function for each selected mesh, conditions file and particle count
+ * with a BenchmarkMesh holding that many particles. Must be called
+ * collectively.
+ *
+ * @param runner Runner holding the options.
+ * @param function Function called with the mesh case, conditions file,
+ * particle count and BenchmarkMesh.
+ */
+inline void
+for_each_mesh(BenchmarkRunner &runner,
+              std::function<void(const BenchmarkMeshCase &, const std::string &,
+                                 const INT, BenchmarkMesh &)>
+                  function) {
+  for (auto &mesh_case : get_mesh_cases()) {
+    if (runner.options.quick && !mesh_case.quick) {
+      continue;
+    }
+    for (auto &conditions : mesh_case.conditions) {
+      for (const INT npart : runner.options.particle_counts) {
+        BenchmarkMesh benchmark_mesh(runner.options.resources_dir,
+                                     mesh_case.mesh, conditions);
+        benchmark_mesh.add_particles(npart);
+        function(mesh_case, conditions, npart, benchmark_mesh);
+        benchmark_mesh.free();
+      }
+    }
+  }
+}
+
+} // namespace NESO::Benchmark
+
+#endif
@@ -0,0 +1,112 @@
+#include <cstdlib>
+#include <iostream>
+#include <mpi.h>
+#include <sstream>
+#include <string>
+
+#include "benchmark.hpp"
+
+using namespace NESO::Benchmark;
+
+#ifndef NESO_BENCHMARK_RESOURCES_DIR
+#define NESO_BENCHMARK_RESOURCES_DIR "test_resources"
+#endif
+
+static void print_usage() {
+  std::cout
+      << "Usage: benchmarkSuite [options]\n"
+         "  --output FILE      Write results as JSON to FILE "
+         "(default benchmark_results.json).\n"
+         "  --baseline FILE    Compare results against a JSON baseline.\n"
+         "  --tolerance X      Allowed relative slowdown against the baseline "
+         "(default 0.1).\n"
+         "  --repeats N        Number of timed repeats (default 5).\n"
+         "  --warmup N         Number of untimed repeats (default 1).\n"
+         "  --particles N,M    Global particle counts "
+         "(default 10000,100000).\n"
+         "  --filter S         Only run cases whose key contains S.\n"
+         "  --resources DIR    Directory of the test meshes.\n"
+         "  --quick            Skip the largest meshes.\n"
+         "  --list             List the benchmarks and exit.\n";
+}
+
+int main(int argc, char **argv) {
+  int thread_level_provided;
+  if (MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED,
+                      &thread_level_provided) != MPI_SUCCESS) {
+    std::cout << "ERROR: MPI_Init != MPI_SUCCESS" << std::endl;
+    return -1;
+  }
+  int rank;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+
+  BenchmarkOptions options;
+  options.resources_dir = NESO_BENCHMARK_RESOURCES_DIR;
+  std::string output = "benchmark_results.json";
+  std::string baseline = "";
+  double tolerance = 0.1;
+  bool list = false;
+  for (int ax = 1; ax < argc; ax++) {
+    const std::string arg = argv[ax];
+    auto next = [&]() -> std::string {
+      NESOASSERT(ax + 1 < argc, "Missing value for " + arg);
+      return argv[++ax];
+    };
+    if (arg == "--output") {
+      output = next();
+    } else if (arg == "--baseline") {
+      baseline = next();
+    } else if (arg == "--tolerance") {
+      tolerance = std::stod(next());
+    } else if (arg == "--repeats") {
+      options.repeats = std::stoi(next());
+    } else if (arg == "--warmup") {
+      options.warmup = std::stoi(next());
+    } else if (arg == "--particles") {
+      options.particle_counts.clear();
+      std::stringstream ss(next());
+      std::string count;
+      while (std::getline(ss, count, ',')) {
+        options.particle_counts.push_back(std::stoll(count));
+      }
+    } else if (arg == "--filter") {
+      options.filter = next();
+    } else if (arg == "--resources") {
+      options.resources_dir = next();
+    } else if (arg == "--quick") {
+      options.quick = true;
+    } else if (arg == "--list") {
+      list = true;
+    } else {
+      if (rank == 0) {
+        print_usage();
+      }
+      MPI_Finalize();
+      return (arg == "--help") ? 0 : -1;
+    }
+  }
+
+  int err = 0;
+  if (list) {
+    if (rank == 0) {
+      for (auto &benchmark : get_benchmarks()) {
+        std::cout << benchmark.first << std::endl;
+      }
+    }
+  } else {
+    BenchmarkRunner runner(MPI_COMM_WORLD, options);
+    for (auto &benchmark : get_benchmarks()) {
+      benchmark.second(runner);
+    }
+    runner.write_json(output);
+    if (baseline.size()) {
+      err = (runner.compare(baseline, tolerance) > 0) ? 1 : 0;
+    }
+  }
+
+  if (MPI_Finalize() != MPI_SUCCESS) {
+    std::cout << "ERROR: MPI_Finalize != MPI_SUCCESS" << std::endl;
+    return -1;
+  }
+  return err;
+}
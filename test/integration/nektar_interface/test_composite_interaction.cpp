@@ -74,8 +74,6 @@ TEST(CompositeInteraction, MASTUReflection) {
                              ParticleProp(Sym<INT>("ID"), 1)};
 
   auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
-  auto cell_id_translation =
-      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
 
   const int rank = sycl_target->comm_pair.rank_parent;
   const int size = sycl_target->comm_pair.size_parent;
@@ -127,7 +125,6 @@ TEST(CompositeInteraction, MASTUReflection) {
   // A->add_particles_local(initial_distribution);
 
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   // Uncomment for trajectory writing.
@@ -212,7 +209,6 @@ TEST(CompositeInteraction, MASTUReflection) {
   for (int stepx = 0; stepx < N_steps; stepx++) {
     lambda_apply_timestep(static_particle_sub_group(A));
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
 
     // Uncomment for trajectory writing.
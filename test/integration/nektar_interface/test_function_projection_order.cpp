@@ -118,7 +118,6 @@ TEST(ParticleFunctionProjection, DisContScalarExpQuantity) {
     pbc.execute();
     mesh_hierarchy_global_map.execute();
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
 
     const REAL two_over_sqrt_pi = 1.1283791670955126;
@@ -301,7 +300,6 @@ TEST(ParticleFunctionProjection, ContScalarExpQuantity) {
     pbc.execute();
     mesh_hierarchy_global_map.execute();
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
 
     const REAL two_over_sqrt_pi = 1.1283791670955126;
@@ -486,7 +484,6 @@ TEST(ParticleFunctionProjection, ContScalarExpQuantityMultiple) {
     pbc.execute();
     mesh_hierarchy_global_map.execute();
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
 
     const REAL two_over_sqrt_pi = 1.1283791670955126;
@@ -114,7 +114,6 @@ static inline void projection_wrapper_order_3d(std::string condtions_file_s,
 
     pbc.execute();
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
 
     const REAL reweight = pbc.global_extent[0] * pbc.global_extent[1] *
@@ -136,7 +136,6 @@ TEST(ParticleGeometryInterface, Advection2D) {
 
     pbc.execute();
     A->hybrid_move();
-    cell_id_translation.execute();
     A->cell_move();
     lambda_check_owning_cell();
 
@@ -309,7 +308,6 @@ TEST_P(ParticleAdvection3D, Advection3D) {
   for (int stepx = 0; stepx < Nsteps; stepx++) {
     pbc.execute();
     A->hybrid_move();
-    cell_id_translation.execute();
     A->cell_move();
     lambda_check_owning_cell();
 
@@ -510,7 +508,6 @@ TEST(ParticleAdvection3D, Torus) {
   for (int stepx = 0; stepx < Nsteps; stepx++) {
     boundary_loop->execute();
     A->hybrid_move();
-    cell_id_translation.execute();
     A->cell_move();
     lambda_check_owning_cell();
     lambda_advect();
@@ -145,7 +145,6 @@ TEST(ParticleFunctionBasisEvaluation, DisContFieldScalar) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -279,7 +278,6 @@ TEST(ParticleFunctionBasisEvaluation, ContFieldScalar) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -743,8 +743,6 @@ TEST_P(CompositeInteractionAllD, Intersection) {
 
   auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
   NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
-  auto cell_id_translation =
-      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
 
   const int rank = sycl_target->comm_pair.rank_parent;
   const int size = sycl_target->comm_pair.size_parent;
@@ -774,7 +772,6 @@ TEST_P(CompositeInteractionAllD, Intersection) {
 
   pbc.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   std::map<int, std::vector<int>> boundary_groups;
@@ -1124,8 +1121,6 @@ TEST_P(CompositeInteractionAllD, Reflection) {
 
   auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
   NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
-  auto cell_id_translation =
-      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
 
   const int rank = sycl_target->comm_pair.rank_parent;
   const int size = sycl_target->comm_pair.size_parent;
@@ -1160,7 +1155,6 @@ TEST_P(CompositeInteractionAllD, Reflection) {
 
   pbc.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   std::vector<int> reflection_composite_indices = {100, 200, 300, 400};
@@ -1252,7 +1246,6 @@ TEST_P(CompositeInteractionAllD, Reflection) {
     check_loop->execute();
     EXPECT_TRUE(!error_propagate->get_flag());
     A->hybrid_move();
-    cell_id_translation->execute();
     A->cell_move();
   }
 
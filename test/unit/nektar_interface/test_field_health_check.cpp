@@ -0,0 +1,53 @@
+#include "nektar_interface/field_health_check.hpp"
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+using namespace NESO;
+
+TEST(FieldHealthCheck, FindNonFinite) {
+  // Sizes which are not multiples of the block or lane sizes.
+  for (const std::size_t n : {0, 1, 7, 8, 1023, 1024, 1025, 5000}) {
+    std::vector<double> values(n);
+    for (std::size_t ix = 0; ix < n; ix++) {
+      values[ix] = (ix % 2 ? -1.0 : 1.0) * 1.0e300 / (ix + 1);
+    }
+    ASSERT_EQ(find_non_finite(values.data(), n), -1);
+
+    for (const double bad : {std::numeric_limits<double>::quiet_NaN(),
+                             std::numeric_limits<double>::infinity(),
+                             -std::numeric_limits<double>::infinity()}) {
+      for (const std::size_t index : {std::size_t(0), n / 2, n - 1}) {
+        if (index >= n) {
+          continue;
+        }
+        std::vector<double> tmp = values;
+        tmp[index] = bad;
+        ASSERT_EQ(find_non_finite(tmp.data(), n),
+                  static_cast<std::int64_t>(index));
+        // The first non-finite value is found.
+        tmp[n - 1] = bad;
+        ASSERT_EQ(find_non_finite(tmp.data(), n),
+                  static_cast<std::int64_t>(index));
+      }
+    }
+  }
+}
+
+TEST(FieldHealthCheck, Interval) {
+  FieldHealthCheck every_stage;
+  FieldHealthCheck every_third(3);
+  FieldHealthCheck disabled(0);
+  for (int stage = 0; stage < 10; stage++) {
+    ASSERT_TRUE(every_stage.begin_stage());
+    ASSERT_EQ(every_third.begin_stage(), stage % 3 == 0);
+    ASSERT_FALSE(disabled.begin_stage());
+    ASSERT_EQ(every_third.get_stage(), stage);
+  }
+
+  // Stages which are not checked accept non-finite values.
+  std::vector<double> values = {0.0, std::numeric_limits<double>::quiet_NaN()};
+  every_third.begin_stage();
+  every_third.check("Interval", "u", values.data(), values.size());
+  disabled.check("Interval", "u", values.data(), values.size());
+}
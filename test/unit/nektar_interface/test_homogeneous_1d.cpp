@@ -0,0 +1,285 @@
+#include "nektar_interface/function_homogeneous_1d.hpp"
+#include "test_helper_utilities.hpp"
+#include <MultiRegions/ContField3DHomogeneous1D.h>
+#include <MultiRegions/DisContField3DHomogeneous1D.h>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace NESO;
+
+TEST(Homogeneous1D, InterpolationWeight) {
+  const REAL lhom = 10.0;
+  for (const int num_planes : {2, 4, 8, 16}) {
+    const REAL dz = lhom / num_planes;
+    auto lambda_theta = [&](const REAL z, const int nx) {
+      return 2.0 * M_PI * (z - nx * dz) / lhom;
+    };
+
+    // The interpolant is exact at the planes.
+    for (int px = 0; px < num_planes; px++) {
+      for (int nx = 0; nx < num_planes; nx++) {
+        const REAL w = Homogeneous1D::interpolation_weight(
+            num_planes, lambda_theta(px * dz, nx));
+        ASSERT_NEAR(w, (px == nx) ? 1.0 : 0.0, 1.0e-12);
+      }
+    }
+
+    // Between planes the weights are a partition of unity and interpolate
+    // the resolved Fourier modes exactly, including outside of [0, lhom).
+    const int kmax = num_planes / 2 - 1;
+    for (const REAL z : {0.1, 1.234, 4.9, 9.99, -3.7, 13.3}) {
+      REAL sum = 0.0;
+      std::vector<REAL> interp(2 * kmax + 1, 0.0);
+      for (int nx = 0; nx < num_planes; nx++) {
+        const REAL w = Homogeneous1D::interpolation_weight(
+            num_planes, lambda_theta(z, nx));
+        sum += w;
+        const REAL zn = nx * dz;
+        for (int kx = 1; kx <= kmax; kx++) {
+          interp[2 * kx - 1] += w * std::cos(2.0 * M_PI * kx * zn / lhom);
+          interp[2 * kx] += w * std::sin(2.0 * M_PI * kx * zn / lhom);
+        }
+      }
+      ASSERT_NEAR(sum, 1.0, 1.0e-12);
+      for (int kx = 1; kx <= kmax; kx++) {
+        ASSERT_NEAR(interp[2 * kx - 1], std::cos(2.0 * M_PI * kx * z / lhom),
+                    1.0e-12);
+        ASSERT_NEAR(interp[2 * kx], std::sin(2.0 * M_PI * kx * z / lhom),
+                    1.0e-12);
+      }
+    }
+  }
+}
+
+/*
+ * Basis key of a homogeneous 1D expansion with num_planes planes.
+ */
+static inline LibUtilities::BasisKey get_basis_key(const int num_planes) {
+  LibUtilities::PointsKey points_key(num_planes,
+                                     LibUtilities::eFourierEvenlySpaced);
+  return LibUtilities::BasisKey(LibUtilities::eFourier, num_planes,
+                                points_key);
+}
+
+TEST(Homogeneous1D, DerivZZ) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  const int num_planes = 8;
+  const NekDouble lhom = 3.0;
+  auto field = std::make_shared<MultiRegions::DisContField3DHomogeneous1D>(
+      session, get_basis_key(num_planes), lhom, false, false, graph, "u");
+  ASSERT_EQ(Homogeneous1D::check_field(field), num_planes);
+
+  // Modes 0, 1 and 2 in z are resolved by 8 planes.
+  const NekDouble kz = 2.0 * M_PI / lhom;
+  const int npts = field->GetTotPoints();
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts);
+  field->GetCoords(x, y, z);
+  Array<OneD, NekDouble> f(npts), d2f(npts), d2f_correct(npts);
+  for (int px = 0; px < npts; px++) {
+    const NekDouble fxy = 1.0 + 0.1 * x[px] + 0.2 * y[px];
+    f[px] = fxy * (1.0 + 0.5 * std::cos(kz * z[px]) +
+                   0.25 * std::sin(2.0 * kz * z[px]));
+    d2f_correct[px] = fxy * (-0.5 * kz * kz * std::cos(kz * z[px]) -
+                             kz * kz * std::sin(2.0 * kz * z[px]));
+  }
+  Homogeneous1D::deriv_zz(field, f, d2f);
+  for (int px = 0; px < npts; px++) {
+    ASSERT_NEAR(d2f[px], d2f_correct[px], 1.0e-10);
+  }
+}
+
+/*
+ * The solution of the homogeneous Helmholtz problem for a right hand side
+ * f(x, y) * (a + b * cos(kz * z)) is a * v0 + b * cos(kz * z) * v1 where v0
+ * and v1 solve the 2D problems with lambda and lambda + d22 * kz^2.
+ */
+TEST(Homogeneous1D, HelmSolve) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  const int num_planes = 8;
+  const NekDouble lhom = 3.0;
+  const NekDouble lambda = 1.0;
+  const NekDouble d22 = 0.5;
+  const NekDouble a = 1.0;
+  const NekDouble b = 0.5;
+  const NekDouble kz = 2.0 * M_PI / lhom;
+  auto field = std::make_shared<MultiRegions::ContField3DHomogeneous1D>(
+      session, get_basis_key(num_planes), lhom, false, false, graph, "u");
+  auto field_2d =
+      std::make_shared<MultiRegions::ContField>(session, graph, "u");
+
+  const int npts = field->GetTotPoints();
+  const int plane_npts = field_2d->GetTotPoints();
+  ASSERT_EQ(npts, num_planes * plane_npts);
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts);
+  field->GetCoords(x, y, z);
+  Array<OneD, NekDouble> rhs(npts), rhs_2d(plane_npts);
+  for (int px = 0; px < plane_npts; px++) {
+    rhs_2d[px] = std::sin(x[px]) * std::cos(y[px]) + 1.0;
+  }
+  for (int px = 0; px < npts; px++) {
+    rhs[px] = rhs_2d[px % plane_npts] * (a + b * std::cos(kz * z[px]));
+  }
+
+  StdRegions::ConstFactorMap factors;
+  factors[StdRegions::eFactorLambda] = lambda;
+  Homogeneous1D::helm_solve(field, rhs, field->UpdateCoeffs(), factors, d22);
+  field->BwdTrans(field->GetCoeffs(), field->UpdatePhys());
+
+  auto lambda_solve_2d = [&](const NekDouble factor) {
+    StdRegions::ConstFactorMap factors_2d;
+    factors_2d[StdRegions::eFactorLambda] = factor;
+    Vmath::Zero(field_2d->GetNcoeffs(), field_2d->UpdateCoeffs(), 1);
+    field_2d->HelmSolve(rhs_2d, field_2d->UpdateCoeffs(), factors_2d);
+    Array<OneD, NekDouble> v(plane_npts);
+    field_2d->BwdTrans(field_2d->GetCoeffs(), v);
+    return v;
+  };
+  auto v0 = lambda_solve_2d(lambda);
+  auto v1 = lambda_solve_2d(lambda + d22 * kz * kz);
+
+  NekDouble max_v = 0.0;
+  NekDouble max_err = 0.0;
+  const auto &u = field->GetPhys();
+  for (int px = 0; px < npts; px++) {
+    const int ix = px % plane_npts;
+    const NekDouble u_correct = a * v0[ix] + b * std::cos(kz * z[px]) * v1[ix];
+    max_v = std::max(max_v, std::abs(u_correct));
+    max_err = std::max(max_err, std::abs(u[px] - u_correct));
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &max_v, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &max_err, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  ASSERT_TRUE(max_v > 0.0);
+  EXPECT_TRUE(max_err < 1.0e-6 * max_v);
+}
+
+/*
+ * Evaluate a field in the space of the expansion at particle positions, which
+ * is exact, then project particle weights. The projection is the adjoint of
+ * the evaluation, hence the inner product of the field with the projection
+ * equals the sum of the weights times the evaluations.
+ */
+TEST(Homogeneous1D, EvaluateProject) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  const int num_planes = 8;
+  const NekDouble lhom = 3.0;
+  const NekDouble kz = 2.0 * M_PI / lhom;
+  auto field = std::make_shared<MultiRegions::DisContField3DHomogeneous1D>(
+      session, get_basis_key(num_planes), lhom, false, false, graph, "u");
+  auto rho = std::make_shared<MultiRegions::DisContField3DHomogeneous1D>(
+      session, get_basis_key(num_planes), lhom, false, false, graph, "u");
+
+  auto lambda_f = [&](const NekDouble x, const NekDouble y, const NekDouble z) {
+    return (1.0 + 0.1 * x + 0.2 * y) *
+           (1.0 + 0.5 * std::cos(kz * z) + 0.25 * std::sin(2.0 * kz * z));
+  };
+  const int npts = field->GetTotPoints();
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts);
+  field->GetCoords(x, y, z);
+  for (int px = 0; px < npts; px++) {
+    field->UpdatePhys()[px] = lambda_f(x[px], y[px], z[px]);
+  }
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), 3, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<REAL>("Q"), 1),
+                             ParticleProp(Sym<REAL>("E"), 1)};
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
+  auto cell_id_translation =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int size = sycl_target->comm_pair.size_parent;
+  const int N_total = 2000;
+  std::mt19937 rng_pos(52234234 + rank);
+  std::uniform_real_distribution<REAL> dist_z(0.0, lhom);
+  int rstart, rend;
+  get_decomp_1d(size, N_total, rank, &rstart, &rend);
+  const int N = rend - rstart;
+  if (N > 0) {
+    auto positions = uniform_within_extents(N, 2, pbc.global_extent, rng_pos);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      for (int dimx = 0; dimx < 2; dimx++) {
+        initial_distribution[Sym<REAL>("P")][px][dimx] =
+            positions[dimx][px] + pbc.global_origin[dimx];
+      }
+      initial_distribution[Sym<REAL>("P")][px][2] = dist_z(rng_pos);
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = 0;
+      initial_distribution[Sym<REAL>("Q")][px][0] = 1.0 + 0.01 * (rstart + px);
+    }
+    A->add_particles_local(initial_distribution);
+  }
+  reset_mpi_ranks((*A)[Sym<INT>("NESO_MPI_RANK")]);
+  MeshHierarchyGlobalMap mesh_hierarchy_global_map(
+      sycl_target, A->domain->mesh, A->position_dat, A->cell_id_dat,
+      A->mpi_rank_dat);
+  mesh_hierarchy_global_map.execute();
+  A->hybrid_move();
+  A->cell_move();
+
+  auto evaluate = std::make_shared<
+      FieldEvaluateHomogeneous1D<MultiRegions::DisContField>>(
+      field, A, cell_id_translation);
+  evaluate->evaluate(Sym<REAL>("E"));
+  auto project = std::make_shared<
+      FieldProjectHomogeneous1D<MultiRegions::DisContField>>(
+      rho, A, cell_id_translation);
+  project->project(Sym<REAL>("Q"));
+
+  // The field is in the space of the expansion, hence evaluations are exact.
+  NekDouble sum_qe = 0.0;
+  const int cell_count = mesh->get_cell_count();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto P = A->get_cell(Sym<REAL>("P"), cellx);
+    auto Q = A->get_cell(Sym<REAL>("Q"), cellx);
+    auto E = A->get_cell(Sym<REAL>("E"), cellx);
+    for (int rowx = 0; rowx < P->nrow; rowx++) {
+      const NekDouble e_correct =
+          lambda_f(P->at(rowx, 0), P->at(rowx, 1), P->at(rowx, 2));
+      ASSERT_NEAR(E->at(rowx, 0), e_correct, 1.0e-10);
+      sum_qe += Q->at(rowx, 0) * E->at(rowx, 0);
+    }
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &sum_qe, 1, MPI_DOUBLE, MPI_SUM,
+                       MPI_COMM_WORLD));
+
+  // Inner product of the field with the projection, the planes integrate
+  // Fourier modes exactly.
+  NekDouble inner_product = 0.0;
+  int phys_offset = 0;
+  for (int nx = 0; nx < num_planes; nx++) {
+    auto plane = rho->GetPlane(nx);
+    const int plane_npts = plane->GetTotPoints();
+    Array<OneD, NekDouble> tmp(plane_npts);
+    Vmath::Vmul(plane_npts, field->GetPhys().data() + phys_offset, 1,
+                rho->GetPhys().data() + phys_offset, 1, tmp.data(), 1);
+    inner_product += (lhom / num_planes) * plane->Integral(tmp);
+    phys_offset += plane_npts;
+  }
+  EXPECT_NEAR(inner_product, sum_qe, 1.0e-8 * std::abs(sum_qe));
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+}
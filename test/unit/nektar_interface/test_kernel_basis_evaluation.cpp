@@ -213,3 +213,106 @@ TEST(KernelBasis, Tetrahedron) {
                          ExpansionLooping::Tetrahedron>(P);
   }
 }
+
+template <size_t NDIM, ShapeType SHAPE_TYPE, typename BASIS_TYPE>
+inline void kernel_basis_anisotropic_wrapper(const int P0, const int P1,
+                                             const int P2) {
+
+  int max_alpha, max_n;
+  const int P = std::max(std::max(P0, P1), P2);
+  BasisReference::get_total_num_modes(SHAPE_TYPE, P, &max_n, &max_alpha);
+  JacobiCoeffModBasis jacobi_coeff(max_n, max_alpha);
+
+  const int total_num_modes = (NDIM > 2) ? P0 * P1 * P2 : P0 * P1;
+  std::vector<REAL> dir0(P0);
+  std::vector<REAL> dir1(P1);
+  std::vector<REAL> dir2(P2);
+  std::vector<double> correct(total_num_modes);
+  std::vector<double> coeffs(total_num_modes);
+  for (int modex = 0; modex < total_num_modes; modex++) {
+    coeffs[modex] = 1.0 / (modex + 1);
+  }
+
+  const REAL xi0 = -0.235235;
+  const REAL xi1 = -0.565235;
+  const REAL xi2 = -0.234;
+
+  REAL eta0, eta1, eta2;
+  BASIS_TYPE geom{};
+  geom.loc_coord_to_loc_collapsed(xi0, xi1, xi2, &eta0, &eta1, &eta2);
+
+  geom.evaluate_basis_0(P0, eta0, jacobi_coeff.stride_n,
+                        jacobi_coeff.coeffs_pnm10.data(),
+                        jacobi_coeff.coeffs_pnm11.data(),
+                        jacobi_coeff.coeffs_pnm2.data(), dir0.data());
+  geom.evaluate_basis_1(P1, eta1, jacobi_coeff.stride_n,
+                        jacobi_coeff.coeffs_pnm10.data(),
+                        jacobi_coeff.coeffs_pnm11.data(),
+                        jacobi_coeff.coeffs_pnm2.data(), dir1.data());
+  if (NDIM > 2) {
+    geom.evaluate_basis_2(P2, eta2, jacobi_coeff.stride_n,
+                          jacobi_coeff.coeffs_pnm10.data(),
+                          jacobi_coeff.coeffs_pnm11.data(),
+                          jacobi_coeff.coeffs_pnm2.data(), dir2.data());
+  }
+
+  REAL to_test_evaluate;
+  geom.loop_evaluate(P0, P1, P2, coeffs.data(), dir0.data(), dir1.data(),
+                     dir2.data(), &to_test_evaluate);
+
+  eval_modes(SHAPE_TYPE, P0, P1, P2, eta0, eta1, eta2, correct);
+  const REAL correct_evaluate = local_reduce(correct, coeffs);
+  const REAL err = relative_error(correct_evaluate, to_test_evaluate);
+  EXPECT_TRUE(err < 1.0e-14);
+
+  const REAL value = 7.12235;
+  local_scale(value, correct);
+
+  auto sycl_target = std::make_shared<SYCLTarget>(0, MPI_COMM_WORLD);
+  BufferDeviceHost<REAL> dh_to_test_dofs(sycl_target, total_num_modes);
+  REAL *k_dofs = zero_device_buffer_host(dh_to_test_dofs);
+  BufferDeviceHost<REAL> dh_dir0(sycl_target, dir0.size());
+  BufferDeviceHost<REAL> dh_dir1(sycl_target, dir1.size());
+  BufferDeviceHost<REAL> dh_dir2(sycl_target, dir2.size());
+  REAL *k_dir0 = copy_to_device_buffer_host(dir0, dh_dir0);
+  REAL *k_dir1 = copy_to_device_buffer_host(dir1, dh_dir1);
+  REAL *k_dir2 = copy_to_device_buffer_host(dir2, dh_dir2);
+
+  sycl_target->queue
+      .submit([&](sycl::handler &cgh) {
+        cgh.single_task<>([=]() {
+          BASIS_TYPE k_geom{};
+          k_geom.loop_project(P0, P1, P2, value, k_dir0, k_dir1, k_dir2,
+                              k_dofs);
+        });
+      })
+      .wait_and_throw();
+  dh_to_test_dofs.device_to_host();
+
+  for (int modex = 0; modex < total_num_modes; modex++) {
+    const REAL err =
+        relative_error(correct[modex], dh_to_test_dofs.h_buffer.ptr[modex]);
+    EXPECT_TRUE(err < 1.0e-12);
+  }
+}
+
+TEST(KernelBasis, QuadrilateralAnisotropic) {
+  for (int P0 = 2; P0 < 7; P0++) {
+    for (int P1 = 2; P1 < 7; P1++) {
+      kernel_basis_anisotropic_wrapper<2, ShapeType::eQuadrilateral,
+                                       ExpansionLooping::Quadrilateral>(P0, P1,
+                                                                        1);
+    }
+  }
+}
+TEST(KernelBasis, HexahedronAnisotropic) {
+  for (int P0 = 2; P0 < 6; P0++) {
+    for (int P1 = 2; P1 < 6; P1++) {
+      for (int P2 = 2; P2 < 6; P2++) {
+        kernel_basis_anisotropic_wrapper<3, ShapeType::eHexahedron,
+                                         ExpansionLooping::Hexahedron>(P0, P1,
+                                                                       P2);
+      }
+    }
+  }
+}
@@ -0,0 +1,159 @@
+#include "nektar_interface/neighbour_transfer.hpp"
+#include "nektar_interface/particle_interface.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace Nektar;
+using namespace NESO;
+using namespace NESO::Particles;
+
+/*
+ * Gather the map from particle id to owning Nektar++ geometry id on rank 0.
+ */
+static inline std::map<INT, int>
+gather_owners(ParticleGroupSharedPtr particle_group,
+              std::shared_ptr<CellIDTranslation> cell_id_translation) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+  std::vector<INT> local;
+  const int cell_count = particle_group->domain->mesh->get_cell_count();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto ID = particle_group->get_cell(Sym<INT>("ID"), cellx);
+    auto C = particle_group->get_cell(Sym<INT>("CELL_ID"), cellx);
+    for (int rowx = 0; rowx < ID->nrow; rowx++) {
+      EXPECT_EQ(C->at(rowx, 0), cellx);
+      local.push_back(ID->at(rowx, 0));
+      local.push_back(cell_id_translation->map_to_nektar.at(cellx));
+    }
+  }
+  int num_local = local.size();
+  std::vector<int> counts(size), displs(size);
+  MPICHK(MPI_Gather(&num_local, 1, MPI_INT, counts.data(), 1, MPI_INT, 0,
+                    MPI_COMM_WORLD));
+  int num_total = 0;
+  for (int rx = 0; rx < size; rx++) {
+    displs[rx] = num_total;
+    num_total += counts[rx];
+  }
+  std::vector<INT> global(std::max(num_total, 1));
+  MPICHK(MPI_Gatherv(local.data(), num_local, MPI_INT64_T, global.data(),
+                     counts.data(), displs.data(), MPI_INT64_T, 0,
+                     MPI_COMM_WORLD));
+  std::map<INT, int> owners;
+  if (rank == 0) {
+    for (int ix = 0; ix < num_total; ix += 2) {
+      EXPECT_EQ(owners.count(global[ix]), 0);
+      owners[global[ix]] = global[ix + 1];
+    }
+  }
+  return owners;
+}
+
+TEST(NeighbourTransfer, MatchesHybridMove) {
+  int rank;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+
+  TestUtilities::TestResourceSession resources("square_triangles_quads.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  extend_halos_fixed_offset(1, mesh);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+  const int ndim = mesh->get_ndim();
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<REAL>("V"), ndim),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<INT>("ID"), 1)};
+
+  // A is moved with the neighbour transfer, B with the hybrid move.
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto B = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto pbc_A = std::make_shared<NektarCartesianPeriodic>(sycl_target, graph,
+                                                         A->position_dat);
+  auto pbc_B = std::make_shared<NektarCartesianPeriodic>(sycl_target, graph,
+                                                         B->position_dat);
+  auto cell_id_translation_A =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+  auto cell_id_translation_B =
+      std::make_shared<CellIDTranslation>(sycl_target, B->cell_id_dat, mesh);
+  auto transfer = std::make_shared<NeighbourTransfer>(A, mesh,
+                                                      cell_id_translation_A);
+
+  const int npart_per_cell = 8;
+  std::mt19937 rng(52234232 + rank);
+  std::vector<std::vector<double>> positions;
+  std::vector<int> cells;
+  rng = uniform_within_elements(graph, npart_per_cell, positions, cells,
+                                1.0e-10, rng);
+  const int N = cells.size();
+  auto velocities = normal_distribution(N, ndim, 0.0, 1.0, rng);
+  ParticleSet initial_distribution(N, A->get_particle_spec());
+  for (int px = 0; px < N; px++) {
+    for (int dimx = 0; dimx < ndim; dimx++) {
+      initial_distribution[Sym<REAL>("P")][px][dimx] = positions[dimx][px];
+      initial_distribution[Sym<REAL>("V")][px][dimx] = velocities[dimx][px];
+    }
+    initial_distribution[Sym<INT>("CELL_ID")][px][0] = cells[px];
+    initial_distribution[Sym<INT>("ID")][px][0] = 1000000 * rank + px;
+  }
+  A->add_particles_local(initial_distribution);
+  B->add_particles_local(initial_distribution);
+  const INT npart_global = A->get_npart_global();
+
+  auto lambda_advect = [&](ParticleGroupSharedPtr group, const REAL dt) {
+    particle_loop(
+        group,
+        [=](auto P, auto V) {
+          for (int dimx = 0; dimx < ndim; dimx++) {
+            P.at(dimx) += dt * V.at(dimx);
+          }
+        },
+        Access::write(Sym<REAL>("P")), Access::read(Sym<REAL>("V")))
+        ->execute();
+  };
+
+  // Small steps stay within the halo, the last step jumps across the domain
+  // and requires the global route.
+  const std::vector<REAL> dts = {0.01, 0.01, 0.01, 0.01, 2.0};
+  for (const REAL dt : dts) {
+    lambda_advect(A, dt);
+    pbc_A->execute();
+    transfer->execute();
+
+    lambda_advect(B, dt);
+    pbc_B->execute();
+    B->hybrid_move();
+    B->cell_move();
+
+    ASSERT_EQ(A->get_npart_global(), npart_global);
+    auto stats = transfer->reduce_stats();
+    ASSERT_EQ(stats.num_sent, stats.num_received);
+    if (dt > 1.0) {
+      ASSERT_EQ(stats.num_global_moves, (stats.num_global > 0) ? 1 : 0);
+    }
+
+    auto owners_A = gather_owners(A, cell_id_translation_A);
+    auto owners_B = gather_owners(B, cell_id_translation_B);
+    if (rank == 0) {
+      EXPECT_EQ(static_cast<INT>(owners_A.size()), npart_global);
+      EXPECT_EQ(owners_A, owners_B);
+    }
+  }
+
+  transfer->free();
+  A->free();
+  B->free();
+  sycl_target->free();
+  mesh->free();
+}
@@ -0,0 +1,148 @@
+#include "nektar_interface/particle_interface.hpp"
+#include "nektar_interface/utility_mesh.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Nektar;
+using namespace Nektar::SpatialDomains;
+using namespace NESO;
+using namespace NESO::Particles;
+
+static inline void check_curve(SpatialDomains::CurveSharedPtr curve,
+                               SpatialDomains::CurveSharedPtr new_curve) {
+  ASSERT_EQ(curve == nullptr, new_curve == nullptr);
+  if (curve == nullptr) {
+    return;
+  }
+  ASSERT_EQ(new_curve->m_curveID, curve->m_curveID);
+  ASSERT_EQ(new_curve->m_ptype, curve->m_ptype);
+  const int num_points = curve->m_points.size();
+  ASSERT_EQ(static_cast<int>(new_curve->m_points.size()), num_points);
+  for (int px = 0; px < num_points; px++) {
+    auto point = curve->m_points[px];
+    auto new_point = new_curve->m_points[px];
+    ASSERT_EQ(new_point->GetGlobalID(), point->GetGlobalID());
+    ASSERT_EQ(new_point->GetCoordim(), point->GetCoordim());
+    NekDouble x0, y0, z0, x1, y1, z1;
+    point->GetCoords(x0, y0, z0);
+    new_point->GetCoords(x1, y1, z1);
+    ASSERT_EQ(x0, x1);
+    ASSERT_EQ(y0, y1);
+    ASSERT_EQ(z0, z1);
+  }
+}
+
+template <typename T>
+static inline void check_round_trip(std::map<int, std::shared_ptr<T>> &geoms) {
+  const int rank = 3;
+  PackedGeoms2D packed(rank, geoms);
+
+  // The bulk format stores shared vertices and edges once, so is no larger
+  // than packing each object individually.
+  std::size_t individual_size = sizeof(int);
+  for (auto &geom_item : geoms) {
+    GeometryTransport::PackedGeom2D pg(rank, geom_item.first,
+                                       geom_item.second);
+    individual_size += pg.buf.size();
+  }
+  if (geoms.size() > 1) {
+    ASSERT_TRUE(packed.buf.size() < individual_size);
+  }
+
+  // Pad the buffer as get_all_remote_geoms_2d does.
+  std::vector<unsigned char> buf(packed.buf);
+  buf.resize(buf.size() + 64, 0);
+  PackedGeoms2D unpacker(buf.data(), buf.size());
+  std::vector<std::shared_ptr<RemoteGeom2D<T>>> remote_geoms;
+  unpacker.unpack(remote_geoms);
+  ASSERT_EQ(remote_geoms.size(), geoms.size());
+
+  std::map<int, std::shared_ptr<Geometry1D>> edges;
+  for (auto &remote_geom : remote_geoms) {
+    ASSERT_EQ(remote_geom->rank, rank);
+    auto geom = geoms.at(remote_geom->id);
+    auto new_geom = remote_geom->geom;
+    ASSERT_EQ(new_geom->GetGlobalID(), geom->GetGlobalID());
+    ASSERT_EQ(new_geom->GetShapeType(), geom->GetShapeType());
+    const int num_verts = geom->GetNumVerts();
+    ASSERT_EQ(new_geom->GetNumVerts(), num_verts);
+    for (int vx = 0; vx < num_verts; vx++) {
+      NekDouble x0, y0, z0, x1, y1, z1;
+      geom->GetVertex(vx)->GetCoords(x0, y0, z0);
+      new_geom->GetVertex(vx)->GetCoords(x1, y1, z1);
+      ASSERT_EQ(geom->GetVid(vx), new_geom->GetVid(vx));
+      ASSERT_EQ(x0, x1);
+      ASSERT_EQ(y0, y1);
+      ASSERT_EQ(z0, z1);
+    }
+    auto extern_geom =
+        std::static_pointer_cast<GeometryTransport::GeomExtern<T>>(geom);
+    auto new_extern_geom =
+        std::static_pointer_cast<GeometryTransport::GeomExtern<T>>(new_geom);
+    check_curve(extern_geom->GetCurve(), new_extern_geom->GetCurve());
+    const int num_edges = geom->GetNumEdges();
+    for (int ex = 0; ex < num_edges; ex++) {
+      auto edge = new_geom->GetEdge(ex);
+      ASSERT_EQ(edge->GetGlobalID(), geom->GetEid(ex));
+      ASSERT_EQ(edge->GetCoordim(), geom->GetEdge(ex)->GetCoordim());
+      check_curve(extern_geom->GetSegGeom(ex)->GetCurve(),
+                  new_extern_geom->GetSegGeom(ex)->GetCurve());
+      // Edges shared between objects are unpacked once.
+      auto it = edges.find(edge->GetGlobalID());
+      if (it != edges.end()) {
+        ASSERT_EQ(it->second, edge);
+      } else {
+        edges[edge->GetGlobalID()] = edge;
+      }
+    }
+  }
+}
+
+TEST(PackedGeoms2D, RoundTrip) {
+  TestUtilities::TestResourceSession resources("square_triangles_quads.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto triangles = graph->GetAllTriGeoms();
+  auto quads = graph->GetAllQuadGeoms();
+  check_round_trip(triangles);
+  check_round_trip(quads);
+
+  // An empty set of objects packs and unpacks.
+  std::map<int, std::shared_ptr<TriGeom>> empty;
+  check_round_trip(empty);
+}
+
+TEST(PackedGeoms2D, RoundTripCurved) {
+  // The faces of a hex with a non-linear map are quads with curved edges and
+  // curved interiors.
+  auto xmapx = [&](auto eta) { return eta[0] + 0.1 * std::sin(eta[1]); };
+  auto xmapy = [&](auto eta) { return eta[1] + 0.1 * std::sin(eta[2]); };
+  auto xmapz = [&](auto eta) { return eta[2] + 0.1 * std::sin(eta[0]); };
+  const int num_modes = 4;
+  auto hex = make_hex_geom(num_modes, xmapx, xmapy, xmapz);
+
+  std::map<int, std::shared_ptr<QuadGeom>> quads;
+  for (int fx = 0; fx < hex->GetNumFaces(); fx++) {
+    auto quad = std::dynamic_pointer_cast<QuadGeom>(hex->GetFace(fx));
+    ASSERT_TRUE(quad != nullptr);
+    auto extern_quad =
+        std::static_pointer_cast<GeometryTransport::GeomExtern<QuadGeom>>(
+            quad);
+    ASSERT_TRUE(extern_quad->GetCurve() != nullptr);
+    for (int ex = 0; ex < quad->GetNumEdges(); ex++) {
+      auto curve = extern_quad->GetSegGeom(ex)->GetCurve();
+      ASSERT_TRUE(curve != nullptr);
+      ASSERT_EQ(static_cast<int>(curve->m_points.size()), num_modes);
+    }
+    quads[quad->GetGlobalID()] = quad;
+  }
+  check_round_trip(quads);
+}
@@ -0,0 +1,173 @@
+#include "nektar_interface/particle_cell_set.hpp"
+#include "nektar_interface/particle_interface.hpp"
+#include "nektar_interface/utilities.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <gtest/gtest.h>
+#include <set>
+
+TEST(ParticleCellSet, Iteration) {
+  const int N_total = 4000;
+
+  TestUtilities::TestResourceSession resource_session(
+      "square_triangles_quads_nummodes_6.xml", "conditions_cg.xml");
+  auto session = resource_session.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+
+  const int ndim = 2;
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<INT>("MARK"), 1)};
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+
+  NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int size = sycl_target->comm_pair.size_parent;
+  std::mt19937 rng_pos(52234234 + rank);
+  int rstart, rend;
+  get_decomp_1d(size, N_total, rank, &rstart, &rend);
+  const int N = rend - rstart;
+  const int cell_count = domain->mesh->get_cell_count();
+  if (N > 0) {
+    auto positions =
+        uniform_within_extents(N, ndim, pbc.global_extent, rng_pos);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        initial_distribution[Sym<REAL>("P")][px][dimx] =
+            positions[dimx][px] + pbc.global_origin[dimx];
+      }
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = px % cell_count;
+      initial_distribution[Sym<INT>("MARK")][px][0] = 0;
+    }
+    A->add_particles_local(initial_distribution);
+  }
+  reset_mpi_ranks((*A)[Sym<INT>("NESO_MPI_RANK")]);
+
+  MeshHierarchyGlobalMap mesh_hierarchy_global_map(
+      sycl_target, domain->mesh, A->position_dat, A->cell_id_dat,
+      A->mpi_rank_dat);
+  pbc.execute();
+  mesh_hierarchy_global_map.execute();
+  A->hybrid_move();
+  A->cell_move();
+
+  // Elements with centroids in the lower half of the domain in x.
+  std::vector<REAL> lower = {pbc.global_origin[0], pbc.global_origin[1]};
+  std::vector<REAL> upper = {
+      pbc.global_origin[0] + 0.5 * pbc.global_extent[0],
+      pbc.global_origin[1] + pbc.global_extent[1]};
+  auto box_set = ParticleCellSet::centroid_in_box(sycl_target, mesh, lower,
+                                                  upper);
+
+  auto k_mark = Access::direct_get(Access::write((*A)[Sym<INT>("MARK")]));
+  box_set->execute(A, [=](const int cell, const INT layer) {
+    k_mark[cell][0][layer] += 1;
+  });
+  Access::direct_restore(Access::write((*A)[Sym<INT>("MARK")]), k_mark);
+
+  // Only the particles in the cells of the set are visited, exactly once.
+  INT npart_marked = 0;
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto mark = (*A)[Sym<INT>("MARK")]->cell_dat.get_cell(cellx);
+    const INT expected = box_set->contains(cellx) ? 1 : 0;
+    for (int rowx = 0; rowx < mark->nrow; rowx++) {
+      ASSERT_EQ((*mark)[0][rowx], expected);
+      npart_marked += expected;
+    }
+  }
+  ASSERT_EQ(box_set->get_npart_local(A), npart_marked);
+  ASSERT_EQ(box_set->get_num_launches(), (npart_marked > 0) ? 1 : 0);
+
+  int num_cells_global = box_set->get_num_cells();
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &num_cells_global, 1, MPI_INT, MPI_SUM,
+                       MPI_COMM_WORLD));
+  ASSERT_TRUE(num_cells_global > 0);
+
+  // Elements adjacent to the boundary composites have a boundary edge.
+  std::vector<int> composite_indices = {100, 200, 300, 400};
+  auto wall_set = ParticleCellSet::adjacent_to_composites(sycl_target, mesh,
+                                                          composite_indices);
+  std::set<int> boundary_edges;
+  for (const int cx : composite_indices) {
+    auto &composites = graph->GetComposites();
+    if (composites.count(cx)) {
+      for (auto &geom : composites.at(cx)->m_geomVec) {
+        boundary_edges.insert(geom->GetGlobalID());
+      }
+    }
+  }
+  std::map<int, std::shared_ptr<Geometry2D>> geoms;
+  get_all_elements_2d(graph, geoms);
+  int cellx = 0;
+  int num_wall_cells = 0;
+  for (auto &geom : geoms) {
+    bool on_wall = false;
+    for (int ex = 0; ex < geom.second->GetNumEdges(); ex++) {
+      on_wall = on_wall ||
+                boundary_edges.count(geom.second->GetEdge(ex)->GetGlobalID());
+    }
+    ASSERT_EQ(wall_set->contains(cellx), on_wall);
+    num_wall_cells += on_wall ? 1 : 0;
+    cellx++;
+  }
+  ASSERT_EQ(wall_set->get_num_cells(), num_wall_cells);
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &num_wall_cells, 1, MPI_INT, MPI_SUM,
+                       MPI_COMM_WORLD));
+  ASSERT_TRUE(num_wall_cells > 0);
+
+  // A set of all the cells is iterated with one launch rather than one per
+  // cell.
+  auto all_set = std::make_shared<ParticleCellSet>(
+      sycl_target, mesh,
+      [](const int, std::shared_ptr<Geometry>) -> bool { return true; });
+  ASSERT_EQ(all_set->get_num_cells(), cell_count);
+  const int num_repeats = 10;
+  k_mark = Access::direct_get(Access::write((*A)[Sym<INT>("MARK")]));
+  for (int rx = 0; rx < num_repeats; rx++) {
+    all_set->execute(A, [=](const int cell, const INT layer) {
+      k_mark[cell][0][layer] += 1;
+    });
+  }
+  Access::direct_restore(Access::write((*A)[Sym<INT>("MARK")]), k_mark);
+  const INT npart_local = A->get_npart_local();
+  ASSERT_EQ(all_set->get_npart_local(A), npart_local);
+  ASSERT_EQ(all_set->get_num_launches(),
+            (npart_local > 0) ? num_repeats : 0);
+  INT npart_visited = 0;
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto mark = (*A)[Sym<INT>("MARK")]->cell_dat.get_cell(cellx);
+    const INT expected = (box_set->contains(cellx) ? 1 : 0) + num_repeats;
+    for (int rowx = 0; rowx < mark->nrow; rowx++) {
+      ASSERT_EQ((*mark)[0][rowx], expected);
+      npart_visited++;
+    }
+  }
+  ASSERT_EQ(npart_visited, npart_local);
+
+  // The sub-group of a set is an iteration set for a ParticleLoop and holds
+  // the same particles as execute visits.
+  auto box_sub_group = box_set->get_sub_group(A);
+  ASSERT_EQ(box_sub_group->get_npart_local(), box_set->get_npart_local(A));
+  particle_loop(
+      box_sub_group, [=](auto MARK) { MARK.at(0) += 1; },
+      Access::write(Sym<INT>("MARK")))
+      ->execute();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto mark = (*A)[Sym<INT>("MARK")]->cell_dat.get_cell(cellx);
+    const INT expected = (box_set->contains(cellx) ? 2 : 0) + num_repeats;
+    for (int rowx = 0; rowx < mark->nrow; rowx++) {
+      ASSERT_EQ((*mark)[0][rowx], expected);
+    }
+  }
+
+  A->free();
+  mesh->free();
+}
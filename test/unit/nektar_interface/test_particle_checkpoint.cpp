@@ -0,0 +1,143 @@
+#include "io/particle_checkpoint.hpp"
+#include "nektar_interface/particle_interface.hpp"
+#include "nektar_interface/utilities.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace Nektar;
+using namespace NESO;
+using namespace NESO::Particles;
+
+TEST(ParticleCheckpoint, RoundTrip) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+  TestUtilities::TestResourceSession resources("square_triangles_quads.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+  const int ndim = mesh->get_ndim();
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<INT>("ID"), 1),
+                             ParticleProp(Sym<REAL>("V"), 3)};
+
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto B = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto cell_id_translation_A =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+
+  const int npart_per_cell = 4;
+  std::mt19937 rng(52234231 + rank);
+  std::vector<std::vector<double>> positions;
+  std::vector<int> cells;
+  rng = uniform_within_elements(graph, npart_per_cell, positions, cells,
+                                1.0e-12, rng);
+  const int N = cells.size();
+  ParticleSet initial_distribution(N, A->get_particle_spec());
+  for (int px = 0; px < N; px++) {
+    for (int dimx = 0; dimx < ndim; dimx++) {
+      initial_distribution[Sym<REAL>("P")][px][dimx] = positions[dimx][px];
+    }
+    const INT id = 1000000 * rank + px;
+    initial_distribution[Sym<INT>("CELL_ID")][px][0] = cells[px];
+    initial_distribution[Sym<INT>("ID")][px][0] = id;
+    for (int dimx = 0; dimx < 3; dimx++) {
+      initial_distribution[Sym<REAL>("V")][px][dimx] = (dimx + 1) * id;
+    }
+  }
+  A->add_particles_local(initial_distribution);
+
+  const std::string filename = "test_particle_checkpoint.h5";
+  const double time = 3.25;
+  const std::uint64_t counter = 1000 + rank;
+  {
+    IO::ParticleCheckpointWriter writer(filename, MPI_COMM_WORLD);
+    writer.write_particles(A);
+    writer.write_value("simulation_time", time);
+    writer.write_rank_value("counter", counter);
+    writer.write_rng("rng", rng);
+    writer.close();
+  }
+  const auto next_sample = rng();
+
+  std::mt19937 rng_restored(0);
+  double time_restored = 0.0;
+  std::uint64_t counter_restored = 0;
+  {
+    IO::ParticleCheckpointReader reader(filename, MPI_COMM_WORLD);
+    ASSERT_TRUE(reader.same_num_ranks());
+    const INT npart = reader.read_particles(B);
+    ASSERT_EQ(npart, A->get_npart_global());
+    ASSERT_TRUE(reader.read_value("simulation_time", time_restored));
+    ASSERT_TRUE(reader.read_rank_value("counter", counter_restored));
+    ASSERT_TRUE(reader.read_rng("rng", rng_restored));
+    double missing = -1.0;
+    ASSERT_FALSE(reader.read_value("missing", missing));
+    ASSERT_EQ(missing, -1.0);
+    reader.close();
+  }
+  ASSERT_EQ(time_restored, time);
+  ASSERT_EQ(counter_restored, counter);
+  ASSERT_EQ(rng_restored(), next_sample);
+  ASSERT_EQ(B->get_npart_global(), A->get_npart_global());
+
+  // Each restored particle lies in the cell it was mapped to and carries the
+  // properties it was written with.
+  REAL position_sum_local[2] = {0.0, 0.0};
+  const int cell_count = mesh->get_cell_count();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto P = B->get_cell(Sym<REAL>("P"), cellx);
+    auto C = B->get_cell(Sym<INT>("CELL_ID"), cellx);
+    auto ID = B->get_cell(Sym<INT>("ID"), cellx);
+    auto V = B->get_cell(Sym<REAL>("V"), cellx);
+    for (int rowx = 0; rowx < C->nrow; rowx++) {
+      ASSERT_EQ(C->at(rowx, 0), cellx);
+      const INT id = ID->at(rowx, 0);
+      for (int dimx = 0; dimx < 3; dimx++) {
+        ASSERT_EQ(V->at(rowx, dimx), (dimx + 1) * id);
+      }
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        position_sum_local[dimx] += P->at(rowx, dimx);
+      }
+    }
+  }
+  REAL position_sum[2];
+  MPICHK(MPI_Allreduce(position_sum_local, position_sum, 2, MPI_DOUBLE,
+                       MPI_SUM, MPI_COMM_WORLD));
+  REAL expected_sum_local[2] = {0.0, 0.0};
+  for (int px = 0; px < N; px++) {
+    for (int dimx = 0; dimx < ndim; dimx++) {
+      expected_sum_local[dimx] += positions[dimx][px];
+    }
+  }
+  REAL expected_sum[2];
+  MPICHK(MPI_Allreduce(expected_sum_local, expected_sum, 2, MPI_DOUBLE,
+                       MPI_SUM, MPI_COMM_WORLD));
+  for (int dimx = 0; dimx < ndim; dimx++) {
+    ASSERT_NEAR(position_sum[dimx], expected_sum[dimx],
+                1.0e-10 * std::abs(expected_sum[dimx]) + 1.0e-10);
+  }
+
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+  if (rank == 0) {
+    std::remove(filename.c_str());
+  }
+
+  A->free();
+  B->free();
+  sycl_target->free();
+  mesh->free();
+}
@@ -1,4 +1,5 @@
 #include "nektar_interface/function_evaluation.hpp"
+#include "nektar_interface/function_point_evaluation.hpp"
 #include "nektar_interface/utilities.hpp"
 #include "test_helper_utilities.hpp"
 #include <LibUtilities/BasicUtils/SessionReader.h>
@@ -89,7 +90,6 @@ TEST(ParticleFunctionEvaluation, DisContFieldScalar) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -227,7 +227,6 @@ TEST(ParticleFunctionEvaluation, DisContFieldDerivative) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -374,7 +373,6 @@ TEST(ParticleFunctionEvaluation, ContFieldScalar) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -511,7 +509,6 @@ TEST(ParticleFunctionEvaluation, ContFieldDerivative) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto lambda_f = [&](const NekDouble x, const NekDouble y) {
@@ -902,3 +899,216 @@ TEST(BaryInterpolation, Generic) {
     }
   }
 }
+
+TEST(BaryInterpolation, EvaluatePoints) {
+
+  const int N_total = 2000;
+
+  auto test_session = std::make_shared<TestUtilities::TestResourceSession>(
+      "square_triangles_quads.xml", "conditions.xml");
+  auto session = test_session->session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto dis_cont_field = std::make_shared<DisContField>(session, graph, "u");
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+
+  const int ndim = 2;
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true)};
+
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+
+  NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
+  auto cell_id_translation =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int size = sycl_target->comm_pair.size_parent;
+
+  std::mt19937 rng_pos(52234234 + rank);
+
+  int rstart, rend;
+  get_decomp_1d(size, N_total, rank, &rstart, &rend);
+  const int N = rend - rstart;
+  const int cell_count = domain->mesh->get_cell_count();
+
+  if (N > 0) {
+    auto positions =
+        uniform_within_extents(N, ndim, pbc.global_extent, rng_pos);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        const double pos_orig = positions[dimx][px] + pbc.global_origin[dimx];
+        initial_distribution[Sym<REAL>("P")][px][dimx] = pos_orig;
+      }
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = px % cell_count;
+    }
+    A->add_particles_local(initial_distribution);
+  }
+  reset_mpi_ranks((*A)[Sym<INT>("NESO_MPI_RANK")]);
+
+  MeshHierarchyGlobalMap mesh_hierarchy_global_map(
+      sycl_target, domain->mesh, A->position_dat, A->cell_id_dat,
+      A->mpi_rank_dat);
+
+  pbc.execute();
+  mesh_hierarchy_global_map.execute();
+  A->hybrid_move();
+  A->cell_move();
+
+  auto lambda_f = [&](const NekDouble x, const NekDouble y) {
+    return 2.0 * (x + 0.5) * (x - 0.5) * (y + 0.8) * (y - 0.8);
+  };
+  interpolate_onto_nektar_field_2d(lambda_f, dis_cont_field);
+
+  // Extract the points from the ParticleGroup into flat arrays.
+  std::vector<int> h_cells;
+  std::vector<REAL> h_ref_positions;
+  std::vector<REAL> h_positions;
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto positions = A->position_dat->cell_dat.get_cell(cellx);
+    auto ref_positions = (*A)[Sym<REAL>("NESO_REFERENCE_POSITIONS")]
+                             ->cell_dat.get_cell(cellx);
+    for (int rowx = 0; rowx < positions->nrow; rowx++) {
+      h_cells.push_back(cellx);
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        h_positions.push_back((*positions)[dimx][rowx]);
+        h_ref_positions.push_back((*ref_positions)[dimx][rowx]);
+      }
+    }
+  }
+  const int num_points = h_cells.size();
+  if (num_points > 0) {
+    BufferDevice<int> d_cells(sycl_target, h_cells);
+    BufferDevice<REAL> d_ref_positions(sycl_target, h_ref_positions);
+    BufferDeviceHost<REAL> dh_output(sycl_target, 2 * num_points);
+
+    auto bary_evaluate_base = std::make_shared<BaryEvaluateBase<DisContField>>(
+        dis_cont_field, mesh, cell_id_translation);
+
+    // Evaluate two functions, the field and twice the field.
+    auto phys = dis_cont_field->GetPhys();
+    Array<OneD, NekDouble> phys0(phys.size());
+    Array<OneD, NekDouble> phys1(phys.size());
+    for (int cx = 0; cx < phys.size(); cx++) {
+      phys0[cx] = phys[cx];
+      phys1[cx] = 2.0 * phys[cx];
+    }
+    std::vector<Array<OneD, NekDouble> *> physvals = {&phys0, &phys1};
+    bary_evaluate_base
+        ->evaluate_points(num_points, d_cells.ptr, d_ref_positions.ptr,
+                          physvals, dh_output.d_buffer.ptr)
+        .wait_and_throw();
+    dh_output.device_to_host();
+
+    for (int px = 0; px < num_points; px++) {
+      const double x = h_positions.at(px * ndim);
+      const double y = h_positions.at(px * ndim + 1);
+      const double eval_correct = evaluate_scalar_2d(dis_cont_field, x, y);
+      EXPECT_NEAR(eval_correct, dh_output.h_buffer.ptr[2 * px], 1.0e-8);
+      EXPECT_NEAR(2.0 * eval_correct, dh_output.h_buffer.ptr[2 * px + 1],
+                  2.0e-8);
+    }
+  }
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+}
+
+TEST(FieldPointEvaluate, Batched) {
+
+  auto test_session = std::make_shared<TestUtilities::TestResourceSession>(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = test_session->session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto dis_cont_field = std::make_shared<DisContField>(session, graph, "u");
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+
+  auto lambda_f = [&](const NekDouble x, const NekDouble y) {
+    return 2.0 * (x + 0.5) * (x - 0.5) * (y + 0.8) * (y - 0.8);
+  };
+  auto lambda_dfdx = [&](const NekDouble x, const NekDouble y) {
+    return 4.0 * x * (y + 0.8) * (y - 0.8);
+  };
+  auto lambda_dfdy = [&](const NekDouble x, const NekDouble y) {
+    return 4.0 * y * (x + 0.5) * (x - 0.5);
+  };
+  interpolate_onto_nektar_field_2d(lambda_f, dis_cont_field);
+
+  // Extent of the mesh.
+  double origin[2] = {std::numeric_limits<double>::max(),
+                      std::numeric_limits<double>::max()};
+  double extent[2] = {std::numeric_limits<double>::lowest(),
+                      std::numeric_limits<double>::lowest()};
+  for (auto &vx : graph->GetAllPointGeoms()) {
+    NekDouble x, y, z;
+    vx.second->GetCoords(x, y, z);
+    origin[0] = std::min(origin[0], x);
+    origin[1] = std::min(origin[1], y);
+    extent[0] = std::max(extent[0], x);
+    extent[1] = std::max(extent[1], y);
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, origin, 2, MPI_DOUBLE, MPI_MIN,
+                       MPI_COMM_WORLD));
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, extent, 2, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+
+  // Each rank passes points anywhere in the domain, including points owned
+  // by other ranks.
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int num_points = 1000 + 17 * rank;
+  std::mt19937 rng(3452 + rank);
+  std::uniform_real_distribution<double> uniform(0.001, 0.999);
+  std::vector<REAL> points(2 * num_points);
+  for (int px = 0; px < num_points; px++) {
+    for (int dx = 0; dx < 2; dx++) {
+      points[px * 2 + dx] =
+          origin[dx] + uniform(rng) * (extent[dx] - origin[dx]);
+    }
+  }
+
+  auto field_point_evaluate =
+      std::make_shared<FieldPointEvaluate<DisContField>>(
+          sycl_target, mesh, dis_cont_field, points);
+  ASSERT_EQ(field_point_evaluate->get_num_points(), num_points);
+
+  std::vector<REAL> evaluations;
+  std::vector<REAL> derivatives;
+  field_point_evaluate->evaluate(evaluations);
+  field_point_evaluate->evaluate_derivative(derivatives);
+  ASSERT_EQ(evaluations.size(), num_points);
+  ASSERT_EQ(derivatives.size(), 2 * num_points);
+
+  for (int px = 0; px < num_points; px++) {
+    const double x = points[px * 2];
+    const double y = points[px * 2 + 1];
+    EXPECT_NEAR(evaluations[px], lambda_f(x, y), 1.0e-8);
+    EXPECT_NEAR(derivatives[px * 2], lambda_dfdx(x, y), 1.0e-6);
+    EXPECT_NEAR(derivatives[px * 2 + 1], lambda_dfdy(x, y), 1.0e-6);
+  }
+
+  // The points may be located with reduced precision reference positions,
+  // which only hold single precision.
+  auto config = std::make_shared<ParameterStore>();
+  config->set<INT>("NektarGraphLocalMapper/reduced_precision", 1);
+  auto field_point_evaluate_reduced =
+      std::make_shared<FieldPointEvaluate<DisContField>>(
+          sycl_target, mesh, dis_cont_field, points, config);
+  std::vector<REAL> evaluations_reduced;
+  field_point_evaluate_reduced->evaluate(evaluations_reduced);
+  ASSERT_EQ(evaluations_reduced.size(), num_points);
+  for (int px = 0; px < num_points; px++) {
+    EXPECT_NEAR(evaluations_reduced[px], evaluations[px], 1.0e-5);
+  }
+
+  sycl_target->free();
+  mesh->free();
+}
@@ -78,7 +78,6 @@ inline void make_2d_test_system(const int ncomp, const bool deriv) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto cont_field = std::make_shared<ContField>(session, graph, "u");
@@ -233,7 +232,6 @@ evaluation_wrapper_3d(std::string condtions_file_s, std::string mesh_file_s,
 
   pbc.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto field = std::make_shared<FIELD_TYPE>(session, graph, "u");
@@ -118,7 +118,6 @@ TEST(ParticleFunctionProjection, BasisEvalCorrectnessCG) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   const REAL two_over_sqrt_pi = 1.1283791670955126;
@@ -270,7 +269,6 @@ TEST(ParticleFunctionProjection, BasisEvalCorrectnessDG) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   const REAL two_over_sqrt_pi = 1.1283791670955126;
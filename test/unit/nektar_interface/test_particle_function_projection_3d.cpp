@@ -110,7 +110,6 @@ static inline void projection_wrapper_3d(std::string condtions_file_s,
 
   pbc.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto field = std::make_shared<FIELD_TYPE>(session, graph, "u");
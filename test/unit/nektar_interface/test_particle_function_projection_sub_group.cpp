@@ -95,7 +95,6 @@ static inline void wrapper(const std::string mesh_file,
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation->execute();
   A->cell_move();
 
   auto Aeven = particle_sub_group(
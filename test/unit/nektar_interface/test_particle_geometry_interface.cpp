@@ -12,6 +12,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <set>
 #include <string>
@@ -651,6 +652,76 @@ TEST(ParticleGeometryInterface, PointInSubDomain2D) {
   delete[] argv[1];
 }
 
+TEST(ParticleGeometryInterface, GeomToCellMap2D) {
+  int argc = 2;
+  char *argv[2];
+  copy_to_cstring(std::string("test_particle_geometry_interface"), &argv[0]);
+
+  std::filesystem::path source_file = __FILE__;
+  std::filesystem::path source_dir = source_file.parent_path();
+  std::filesystem::path test_resources_dir =
+      source_dir / "../../test_resources";
+  std::filesystem::path mesh_file =
+      test_resources_dir / "square_triangles_quads.xml";
+  copy_to_cstring(std::string(mesh_file), &argv[1]);
+
+  auto session = LibUtilities::SessionReader::CreateInstance(argc, argv);
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  extend_halos_fixed_offset(1, mesh);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+
+  std::map<int, int> map_geom_to_cell;
+  mesh->get_geom_to_cell_map(map_geom_to_cell);
+
+  // The local elements map to the cells CellIDTranslation uses.
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), 2, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true)};
+  auto domain = std::make_shared<Domain>(mesh);
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  CellIDTranslation cell_id_translation(sycl_target, A->cell_id_dat, mesh);
+  const int cell_count = mesh->get_cell_count();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    const int geom_id = cell_id_translation.map_to_nektar[cellx];
+    ASSERT_EQ(map_geom_to_cell.at(geom_id), cellx);
+  }
+
+  // The remote elements map to the cells on their owning ranks.
+  std::vector<int> local_pairs;
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    local_pairs.push_back(cell_id_translation.map_to_nektar[cellx]);
+    local_pairs.push_back(cellx);
+  }
+  int size;
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+  const int num_local = local_pairs.size();
+  std::vector<int> counts(size);
+  MPICHK(MPI_Allgather(&num_local, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                       MPI_COMM_WORLD));
+  std::vector<int> displs(size);
+  std::exclusive_scan(counts.begin(), counts.end(), displs.begin(), 0);
+  std::vector<int> global_pairs(displs.back() + counts.back());
+  MPICHK(MPI_Allgatherv(local_pairs.data(), num_local, MPI_INT,
+                        global_pairs.data(), counts.data(), displs.data(),
+                        MPI_INT, MPI_COMM_WORLD));
+  std::map<int, int> global_geom_to_cell;
+  for (std::size_t ix = 0; ix < global_pairs.size(); ix += 2) {
+    global_geom_to_cell[global_pairs[ix]] = global_pairs[ix + 1];
+  }
+  for (auto &geom : mesh->remote_triangles) {
+    ASSERT_EQ(map_geom_to_cell.at(geom->id), global_geom_to_cell.at(geom->id));
+  }
+  for (auto &geom : mesh->remote_quads) {
+    ASSERT_EQ(map_geom_to_cell.at(geom->id), global_geom_to_cell.at(geom->id));
+  }
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+  delete[] argv[0];
+  delete[] argv[1];
+}
+
 TEST(ParticleGeometryInterface, CoordinateMapping2D) {
 
   int argc = 2;
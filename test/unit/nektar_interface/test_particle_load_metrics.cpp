@@ -0,0 +1,106 @@
+#include "nektar_interface/particle_interface.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <cmath>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace Nektar;
+using namespace NESO;
+using namespace NESO::Particles;
+
+TEST(ParticleLoadMetrics, ImbalanceMetrics) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+  auto metrics = get_imbalance_metrics(MPI_COMM_WORLD, rank + 1.0);
+  ASSERT_NEAR(metrics.min, 1.0, 1.0e-12);
+  ASSERT_NEAR(metrics.max, static_cast<REAL>(size), 1.0e-12);
+  ASSERT_NEAR(metrics.mean, 0.5 * (size + 1.0), 1.0e-12);
+  ASSERT_NEAR(metrics.imbalance(), 2.0 * size / (size + 1.0), 1.0e-12);
+
+  auto balanced = get_imbalance_metrics(MPI_COMM_WORLD, 4.0);
+  ASSERT_NEAR(balanced.imbalance(), 1.0, 1.0e-12);
+  auto empty = get_imbalance_metrics(MPI_COMM_WORLD, 0.0);
+  ASSERT_NEAR(empty.imbalance(), 1.0, 1.0e-12);
+}
+
+TEST(ParticleLoadMetrics, ParticleCosts) {
+  int rank;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+
+  TestUtilities::TestResourceSession resources("square_triangles_quads.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto domain = std::make_shared<Domain>(mesh);
+  const int ndim = mesh->get_ndim();
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true)};
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  auto cell_id_translation =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+
+  // Put all particles in the first cell on this rank.
+  const int N = 64;
+  const int cell_count = mesh->get_cell_count();
+  ParticleSet initial_distribution(N, A->get_particle_spec());
+  for (int px = 0; px < N; px++) {
+    for (int dimx = 0; dimx < ndim; dimx++) {
+      initial_distribution[Sym<REAL>("P")][px][dimx] = 0.0;
+    }
+    initial_distribution[Sym<INT>("CELL_ID")][px][0] = 0;
+  }
+  A->add_particles_local(initial_distribution);
+
+  ParticleLoadMetrics load_metrics(A, cell_id_translation, 0.5, 1.0);
+  load_metrics.update();
+  auto costs = load_metrics.get_element_costs();
+  ASSERT_EQ(costs.size(), cell_count);
+  const int geom_id_0 = cell_id_translation->map_to_nektar[0];
+  ASSERT_NEAR(costs.at(geom_id_0), N + 1.0, 1.0e-12);
+  for (int cellx = 1; cellx < cell_count; cellx++) {
+    ASSERT_NEAR(costs.at(cell_id_translation->map_to_nektar[cellx]), 1.0,
+                1.0e-12);
+  }
+
+  // Subsequent measurements are smoothed.
+  std::vector<INT> remove_cells(N / 2, 0);
+  std::vector<INT> remove_layers(N / 2);
+  for (int ix = 0; ix < N / 2; ix++) {
+    remove_layers[ix] = ix;
+  }
+  A->remove_particles(N / 2, remove_cells, remove_layers);
+  load_metrics.update();
+  costs = load_metrics.get_element_costs();
+  ASSERT_NEAR(costs.at(geom_id_0), 0.5 * N + 0.5 * (N / 2) + 1.0, 1.0e-12);
+
+  auto particle_metrics = load_metrics.get_particle_metrics();
+  ASSERT_NEAR(particle_metrics.max, N / 2, 1.0e-12);
+  ASSERT_NEAR(particle_metrics.imbalance(), 1.0, 1.0e-12);
+
+  // Round trip the costs through a file.
+  const std::string filename = "test_particle_load_metrics_costs.txt";
+  load_metrics.write_element_costs(filename);
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+  auto read_costs = ParticleLoadMetrics::read_element_costs(filename);
+  for (auto &[id, cost] : costs) {
+    ASSERT_NEAR(read_costs.at(id), cost, 1.0e-12);
+  }
+
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+  if (rank == 0) {
+    std::remove(filename.c_str());
+  }
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+}
@@ -160,7 +160,6 @@ TEST_P(ParticleGeometryInterface2D, LocalMapping2D) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation.execute();
   A->cell_move();
   lambda_check_owning_cell();
 
@@ -381,7 +380,6 @@ TEST_P(ParticleGeometryInterface, LocalMapping3D) {
   pbc.execute();
   mesh_hierarchy_global_map.execute();
   A->hybrid_move();
-  cell_id_translation.execute();
   A->cell_move();
   lambda_check_owning_cell();
 
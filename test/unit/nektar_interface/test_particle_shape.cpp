@@ -0,0 +1,149 @@
+#include "nektar_interface/function_basis_projection.hpp"
+#include "nektar_interface/function_evaluation.hpp"
+#include "nektar_interface/particle_shape.hpp"
+#include "test_helper_utilities.hpp"
+#include <MultiRegions/DisContField.h>
+
+using namespace Nektar::MultiRegions;
+
+TEST(ParticleShape, ModeFactors) {
+  ParticleShape delta;
+  ParticleShape gaussian{ParticleShapeType::Gaussian, 0.3, 2};
+  ParticleShape bspline{ParticleShapeType::BSpline, 0.3, 2};
+
+  for (int n = 1; n < 10; n++) {
+    EXPECT_EQ(delta.mode_factor(n), 1.0);
+  }
+  // Linear modes are not scaled so charge is conserved.
+  EXPECT_NEAR(gaussian.mode_factor(1), 1.0, 1.0e-15);
+  EXPECT_NEAR(bspline.mode_factor(1), 1.0, 1.0e-15);
+  for (int n = 2; n < 10; n++) {
+    EXPECT_TRUE(gaussian.mode_factor(n) < gaussian.mode_factor(n - 1));
+    EXPECT_TRUE(std::abs(bspline.mode_factor(n)) < 1.0);
+  }
+}
+
+TEST(ParticleShape, DepositGatherAdjoint) {
+
+  const int N_total = 2000;
+
+  auto test_session = std::make_shared<TestUtilities::TestResourceSession>(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = test_session->session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  auto dis_cont_field = std::make_shared<DisContField>(session, graph, "u");
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto nektar_graph_local_mapper =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto domain = std::make_shared<Domain>(mesh, nektar_graph_local_mapper);
+
+  const int ndim = 2;
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<REAL>("Q"), 1),
+                             ParticleProp(Sym<REAL>("FUNC_EVALS"), 1)};
+
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+
+  NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
+  auto cell_id_translation =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int size = sycl_target->comm_pair.size_parent;
+
+  std::mt19937 rng_pos(52234234 + rank);
+  std::uniform_real_distribution<REAL> uniform_q(-1.0, 1.0);
+
+  int rstart, rend;
+  get_decomp_1d(size, N_total, rank, &rstart, &rend);
+  const int N = rend - rstart;
+  const int cell_count = domain->mesh->get_cell_count();
+
+  if (N > 0) {
+    auto positions =
+        uniform_within_extents(N, ndim, pbc.global_extent, rng_pos);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        const double pos_orig = positions[dimx][px] + pbc.global_origin[dimx];
+        initial_distribution[Sym<REAL>("P")][px][dimx] = pos_orig;
+      }
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = px % cell_count;
+      initial_distribution[Sym<REAL>("Q")][px][0] = uniform_q(rng_pos);
+    }
+    A->add_particles_local(initial_distribution);
+  }
+  reset_mpi_ranks((*A)[Sym<INT>("NESO_MPI_RANK")]);
+
+  MeshHierarchyGlobalMap mesh_hierarchy_global_map(
+      sycl_target, domain->mesh, A->position_dat, A->cell_id_dat,
+      A->mpi_rank_dat);
+
+  pbc.execute();
+  mesh_hierarchy_global_map.execute();
+  A->hybrid_move();
+  A->cell_move();
+
+  ParticleShape shape{ParticleShapeType::Gaussian, 0.2, 2};
+
+  auto project_basis = std::make_shared<FunctionProjectBasis<DisContField>>(
+      dis_cont_field, mesh, cell_id_translation);
+  auto evaluate_basis = std::make_shared<FunctionEvaluateBasis<DisContField>>(
+      dis_cont_field, mesh, cell_id_translation);
+  project_basis->set_particle_shape(shape);
+  evaluate_basis->set_particle_shape(shape);
+
+  const int ncoeffs = dis_cont_field->GetNcoeffs();
+  Array<OneD, NekDouble> rhs(ncoeffs);
+  Array<OneD, NekDouble> rhs_delta(ncoeffs);
+  Array<OneD, NekDouble> coeffs(ncoeffs);
+  std::mt19937 rng_coeffs(1234);
+  for (int cx = 0; cx < ncoeffs; cx++) {
+    coeffs[cx] = uniform_q(rng_coeffs);
+  }
+
+  project_basis->project(A, Sym<REAL>("Q"), 0, rhs);
+  evaluate_basis->evaluate(A, Sym<REAL>("FUNC_EVALS"), 0, coeffs);
+
+  // Deposition and evaluation are adjoint: sum_p q_p u(x_p) = b . u
+  REAL local_sums[2] = {0.0, 0.0};
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto q = (*A)[Sym<REAL>("Q")]->cell_dat.get_cell(cellx);
+    auto evals = (*A)[Sym<REAL>("FUNC_EVALS")]->cell_dat.get_cell(cellx);
+    for (int rowx = 0; rowx < q->nrow; rowx++) {
+      local_sums[0] += (*q)[0][rowx] * (*evals)[0][rowx];
+    }
+  }
+  for (int cx = 0; cx < ncoeffs; cx++) {
+    local_sums[1] += rhs[cx] * coeffs[cx];
+  }
+  REAL global_sums[2];
+  MPICHK(MPI_Allreduce(local_sums, global_sums, 2, MPI_DOUBLE, MPI_SUM,
+                       sycl_target->comm_pair.comm_parent));
+  EXPECT_NEAR(global_sums[0], global_sums[1],
+              1.0e-10 * std::max(1.0, std::abs(global_sums[0])));
+
+  // The shape does not change the total deposited charge.
+  project_basis->set_particle_shape(ParticleShape{});
+  project_basis->project(A, Sym<REAL>("Q"), 0, rhs_delta);
+  Array<OneD, NekDouble> ones_phys(dis_cont_field->GetTotPoints(), 1.0);
+  Array<OneD, NekDouble> ones_coeffs(ncoeffs);
+  dis_cont_field->FwdTrans(ones_phys, ones_coeffs);
+  REAL local_charge[2] = {0.0, 0.0};
+  for (int cx = 0; cx < ncoeffs; cx++) {
+    local_charge[0] += rhs[cx] * ones_coeffs[cx];
+    local_charge[1] += rhs_delta[cx] * ones_coeffs[cx];
+  }
+  REAL global_charge[2];
+  MPICHK(MPI_Allreduce(local_charge, global_charge, 2, MPI_DOUBLE, MPI_SUM,
+                       sycl_target->comm_pair.comm_parent));
+  EXPECT_NEAR(global_charge[0], global_charge[1], 1.0e-10);
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+}
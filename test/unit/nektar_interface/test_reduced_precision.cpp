@@ -0,0 +1,250 @@
+#include "nektar_interface/function_evaluation.hpp"
+#include "nektar_interface/function_projection.hpp"
+#include "nektar_interface/reduced_precision.hpp"
+#include "nektar_interface/utilities.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <MultiRegions/DisContField.h>
+
+TEST(ReducedPrecision, PackUnpack) {
+  const std::vector<REAL> values = {0.0, 1.0, -1.0, 0.123456789, -0.987654321,
+                                    1.0e-10};
+  for (const REAL v0 : values) {
+    for (const REAL v1 : values) {
+      const INT packed = ReducedPrecision::pack(v0, v1);
+      EXPECT_EQ(ReducedPrecision::unpack(packed, 0),
+                static_cast<REAL>(static_cast<float>(v0)));
+      EXPECT_EQ(ReducedPrecision::unpack(packed, 1),
+                static_cast<REAL>(static_cast<float>(v1)));
+      EXPECT_NEAR(ReducedPrecision::unpack(packed, 0), v0, 1.0e-7);
+      EXPECT_NEAR(ReducedPrecision::unpack(packed, 1), v1, 1.0e-7);
+    }
+  }
+
+  // Storing one value leaves the other unchanged.
+  INT packed = ReducedPrecision::pack(0.25, -0.5);
+  ReducedPrecision::store(packed, 0, 0.75);
+  EXPECT_EQ(ReducedPrecision::unpack(packed, 0), 0.75);
+  EXPECT_EQ(ReducedPrecision::unpack(packed, 1), -0.5);
+  ReducedPrecision::store(packed, 1, 0.125);
+  EXPECT_EQ(ReducedPrecision::unpack(packed, 0), 0.75);
+  EXPECT_EQ(ReducedPrecision::unpack(packed, 1), 0.125);
+
+  EXPECT_EQ(ReducedPrecision::get_ncomp(1), 1);
+  EXPECT_EQ(ReducedPrecision::get_ncomp(2), 1);
+  EXPECT_EQ(ReducedPrecision::get_ncomp(3), 2);
+}
+
+/*
+ * Evaluate a field and its derivative, and project particle values, with full
+ * precision and with reduced precision reference positions, and compare the
+ * two.
+ */
+static inline void evaluate_reduced_precision(const std::string mesh_name,
+                                              const REAL tol) {
+  const int N_total = 2000;
+  TestUtilities::TestResourceSession resources(mesh_name, "conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+  auto dis_cont_field = std::make_shared<DisContField>(session, graph, "u");
+
+  auto mesh = std::make_shared<ParticleMeshInterface>(graph);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto config = std::make_shared<ParameterStore>();
+  config->set<INT>("NektarGraphLocalMapper/reduced_precision", 1);
+  auto mapper_full =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh);
+  auto mapper_reduced =
+      std::make_shared<NektarGraphLocalMapper>(sycl_target, mesh, config);
+  auto domain_full = std::make_shared<Domain>(mesh, mapper_full);
+  auto domain_reduced = std::make_shared<Domain>(mesh, mapper_reduced);
+
+  const int ndim = 2;
+  const int ncomp_reduced = ReducedPrecision::get_ncomp(ndim);
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<REAL>("FUNC_EVALS"), 1),
+                             ParticleProp(Sym<REAL>("DERIV_EVALS"), ndim),
+                             ParticleProp(Sym<INT>("FUNC_EVALS_REDUCED"), 1),
+                             ParticleProp(Sym<INT>("DERIV_EVALS_REDUCED"),
+                                          ncomp_reduced),
+                             ParticleProp(Sym<REAL>("Q"), 1),
+                             ParticleProp(Sym<INT>("ID"), 1)};
+
+  // A holds full precision reference positions, B reduced precision.
+  auto A =
+      std::make_shared<ParticleGroup>(domain_full, particle_spec, sycl_target);
+  auto B = std::make_shared<ParticleGroup>(domain_reduced, particle_spec,
+                                           sycl_target);
+  ASSERT_FALSE(
+      A->contains_dat(ReducedPrecision::get_reference_positions_sym()));
+  ASSERT_TRUE(B->contains_dat(ReducedPrecision::get_reference_positions_sym()));
+  // The reduced precision positions replace the full precision positions.
+  ASSERT_TRUE(A->contains_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS")));
+  ASSERT_FALSE(B->contains_dat(Sym<REAL>("NESO_REFERENCE_POSITIONS")));
+
+  NektarCartesianPeriodic pbc(sycl_target, graph, A->position_dat);
+  auto cell_id_translation_A =
+      std::make_shared<CellIDTranslation>(sycl_target, A->cell_id_dat, mesh);
+  auto cell_id_translation_B =
+      std::make_shared<CellIDTranslation>(sycl_target, B->cell_id_dat, mesh);
+
+  const int rank = sycl_target->comm_pair.rank_parent;
+  const int size = sycl_target->comm_pair.size_parent;
+  std::mt19937 rng_pos(52234234 + rank);
+  int rstart, rend;
+  get_decomp_1d(size, N_total, rank, &rstart, &rend);
+  const int N = rend - rstart;
+  if (N > 0) {
+    auto positions =
+        uniform_within_extents(N, ndim, pbc.global_extent, rng_pos);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      for (int dimx = 0; dimx < ndim; dimx++) {
+        initial_distribution[Sym<REAL>("P")][px][dimx] =
+            positions[dimx][px] + pbc.global_origin[dimx];
+      }
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = 0;
+      initial_distribution[Sym<INT>("ID")][px][0] = rstart + px;
+      initial_distribution[Sym<REAL>("Q")][px][0] =
+          1.0 + 0.5 * positions[0][px];
+    }
+    A->add_particles_local(initial_distribution);
+    B->add_particles_local(initial_distribution);
+  }
+
+  auto lambda_move = [&](auto group) {
+    reset_mpi_ranks((*group)[Sym<INT>("NESO_MPI_RANK")]);
+    MeshHierarchyGlobalMap mesh_hierarchy_global_map(
+        sycl_target, group->domain->mesh, group->position_dat,
+        group->cell_id_dat, group->mpi_rank_dat);
+    mesh_hierarchy_global_map.execute();
+    group->hybrid_move();
+    group->cell_move();
+  };
+  lambda_move(A);
+  lambda_move(B);
+
+  auto lambda_f = [&](const NekDouble x, const NekDouble y) {
+    return std::sin(3.0 * x) * std::cos(2.0 * y);
+  };
+  interpolate_onto_nektar_field_2d(lambda_f, dis_cont_field);
+
+  auto evaluate_A = std::make_shared<FieldEvaluate<DisContField>>(
+      dis_cont_field, A, cell_id_translation_A);
+  auto evaluate_deriv_A = std::make_shared<FieldEvaluate<DisContField>>(
+      dis_cont_field, A, cell_id_translation_A, true);
+  auto evaluate_B = std::make_shared<FieldEvaluate<DisContField>>(
+      dis_cont_field, B, cell_id_translation_B);
+  auto evaluate_deriv_B = std::make_shared<FieldEvaluate<DisContField>>(
+      dis_cont_field, B, cell_id_translation_B, true);
+
+  evaluate_A->evaluate(Sym<REAL>("FUNC_EVALS"));
+  evaluate_deriv_A->evaluate(Sym<REAL>("DERIV_EVALS"));
+  // Full precision outputs from reduced precision reference positions.
+  evaluate_B->evaluate(Sym<REAL>("FUNC_EVALS"));
+  evaluate_deriv_B->evaluate(Sym<REAL>("DERIV_EVALS"));
+  // Reduced precision outputs.
+  evaluate_B->evaluate(Sym<INT>("FUNC_EVALS_REDUCED"));
+  evaluate_deriv_B->evaluate(Sym<INT>("DERIV_EVALS_REDUCED"));
+
+  auto lambda_gather = [&](auto group) {
+    std::map<INT, std::vector<REAL>> evals;
+    const int cell_count = group->domain->mesh->get_cell_count();
+    for (int cellx = 0; cellx < cell_count; cellx++) {
+      auto ID = group->get_cell(Sym<INT>("ID"), cellx);
+      auto F = group->get_cell(Sym<REAL>("FUNC_EVALS"), cellx);
+      auto D = group->get_cell(Sym<REAL>("DERIV_EVALS"), cellx);
+      auto FR = group->get_cell(Sym<INT>("FUNC_EVALS_REDUCED"), cellx);
+      auto DR = group->get_cell(Sym<INT>("DERIV_EVALS_REDUCED"), cellx);
+      for (int rowx = 0; rowx < ID->nrow; rowx++) {
+        auto &v = evals[ID->at(rowx, 0)];
+        v.push_back(F->at(rowx, 0));
+        v.push_back(D->at(rowx, 0));
+        v.push_back(D->at(rowx, 1));
+        v.push_back(ReducedPrecision::unpack(FR->at(rowx, 0), 0));
+        v.push_back(ReducedPrecision::unpack(DR->at(rowx, 0), 0));
+        v.push_back(ReducedPrecision::unpack(DR->at(rowx, 0), 1));
+      }
+    }
+    return evals;
+  };
+  auto evals_A = lambda_gather(A);
+  auto evals_B = lambda_gather(B);
+  ASSERT_EQ(evals_A.size(), evals_B.size());
+
+  // The field and its derivatives are O(1), hence absolute errors.
+  REAL err_positions = 0.0;
+  REAL err_outputs = 0.0;
+  for (auto &[id, a] : evals_A) {
+    ASSERT_EQ(evals_B.count(id), 1);
+    auto &b = evals_B.at(id);
+    for (int ix = 0; ix < 3; ix++) {
+      err_positions = std::max(err_positions, std::abs(a.at(ix) - b.at(ix)));
+      err_outputs = std::max(err_outputs, std::abs(a.at(ix) - b.at(ix + 3)));
+    }
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &err_positions, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &err_outputs, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  EXPECT_TRUE(err_positions < tol);
+  EXPECT_TRUE(err_outputs < tol);
+
+  // Projection, on the device for the whole group and a sub-group, and on the
+  // host, reads the same reference positions.
+  auto project_A = std::make_shared<FieldProject<DisContField>>(
+      dis_cont_field, A, cell_id_translation_A);
+  auto project_B = std::make_shared<FieldProject<DisContField>>(
+      dis_cont_field, B, cell_id_translation_B);
+  project_A->testing_enable();
+  project_B->testing_enable();
+  auto lambda_even = [&](auto group) {
+    return particle_sub_group(
+        group, [=](auto ID) { return ID.at(0) % 2 == 0; },
+        Access::read(Sym<INT>("ID")));
+  };
+  auto A_even = lambda_even(A);
+  auto B_even = lambda_even(B);
+  const std::vector<Sym<REAL>> project_syms = {Sym<REAL>("Q")};
+  const std::vector<int> project_components = {0};
+
+  auto lambda_compare_rhs = [&](const bool host) {
+    double *rhs_host_A, *rhs_device_A, *rhs_host_B, *rhs_device_B;
+    project_A->testing_get_rhs(&rhs_host_A, &rhs_device_A);
+    project_B->testing_get_rhs(&rhs_host_B, &rhs_device_B);
+    const double *rhs_A = host ? rhs_host_A : rhs_device_A;
+    const double *rhs_B = host ? rhs_host_B : rhs_device_B;
+    const int ncoeffs = dis_cont_field->GetNcoeffs();
+    REAL max_rhs = 0.0;
+    REAL err_rhs = 0.0;
+    for (int cx = 0; cx < ncoeffs; cx++) {
+      max_rhs = std::max(max_rhs, std::abs(rhs_A[cx]));
+      err_rhs = std::max(err_rhs, std::abs(rhs_A[cx] - rhs_B[cx]));
+    }
+    EXPECT_TRUE(err_rhs <= tol * max_rhs);
+  };
+
+  project_A->project(A, project_syms, project_components);
+  project_B->project(B, project_syms, project_components);
+  lambda_compare_rhs(false);
+  project_A->project(A_even, project_syms, project_components);
+  project_B->project(B_even, project_syms, project_components);
+  lambda_compare_rhs(false);
+  project_A->project_host(project_syms, project_components);
+  project_B->project_host(project_syms, project_components);
+  lambda_compare_rhs(true);
+
+  A->free();
+  B->free();
+  sycl_target->free();
+  mesh->free();
+}
+
+TEST(ReducedPrecision, EvaluateOrder2) {
+  evaluate_reduced_precision("square_triangles_quads_nummodes_2.xml", 1.0e-5);
+}
+
+TEST(ReducedPrecision, EvaluateOrder6) {
+  evaluate_reduced_precision("square_triangles_quads_nummodes_6.xml", 1.0e-5);
+}
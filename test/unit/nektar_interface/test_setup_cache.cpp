@@ -0,0 +1,141 @@
+#include "nektar_interface/particle_interface.hpp"
+#include "test_helper_utilities.hpp"
+#include <LibUtilities/BasicUtils/SessionReader.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace Nektar;
+using namespace NESO;
+using namespace NESO::Particles;
+
+template <typename T> static inline std::set<int> get_ids(T &remote_geoms) {
+  std::set<int> ids;
+  for (auto &remote_geom : remote_geoms) {
+    ids.insert(remote_geom->id);
+  }
+  return ids;
+}
+
+TEST(SetupCache, ParticleMeshInterface2D) {
+  TestUtilities::TestResourceSession resources("square_triangles_quads.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  int rank;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  const std::filesystem::path cache_dir = "test_setup_cache_dir";
+  if (rank == 0) {
+    std::filesystem::remove_all(cache_dir);
+    std::filesystem::create_directories(cache_dir);
+  }
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+
+  // The first setup computes the state and writes the cache.
+  auto mesh_write = std::make_shared<ParticleMeshInterface>(
+      graph, 0, MPI_COMM_WORLD, cache_dir.string());
+  ASSERT_FALSE(mesh_write->setup_from_cache);
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+
+  // The second setup reads the same state from the cache.
+  auto mesh_read = std::make_shared<ParticleMeshInterface>(
+      graph, 0, MPI_COMM_WORLD, cache_dir.string());
+  ASSERT_TRUE(mesh_read->setup_from_cache);
+
+  ASSERT_EQ(std::set<INT>(mesh_write->owned_mh_cells.begin(),
+                          mesh_write->owned_mh_cells.end()),
+            std::set<INT>(mesh_read->owned_mh_cells.begin(),
+                          mesh_read->owned_mh_cells.end()));
+  ASSERT_EQ(mesh_write->unowned_mh_cells, mesh_read->unowned_mh_cells);
+  ASSERT_EQ(get_ids(mesh_write->remote_triangles),
+            get_ids(mesh_read->remote_triangles));
+  ASSERT_EQ(get_ids(mesh_write->remote_quads),
+            get_ids(mesh_read->remote_quads));
+  ASSERT_EQ(mesh_write->get_local_communication_neighbours(),
+            mesh_read->get_local_communication_neighbours());
+
+  // The MeshHierarchy ownership is reproduced.
+  auto mh_write = mesh_write->get_mesh_hierarchy();
+  auto mh_read = mesh_read->get_mesh_hierarchy();
+  for (auto cellx : mesh_write->owned_mh_cells) {
+    ASSERT_EQ(mh_read->get_owner(cellx), rank);
+  }
+  for (auto cellx : mesh_write->unowned_mh_cells) {
+    ASSERT_EQ(mh_read->get_owner(cellx), mh_write->get_owner(cellx));
+  }
+
+  // Extended halos are written to the cache by the first extension and read
+  // back by the second.
+  extend_halos_fixed_offset(1, mesh_write);
+  ASSERT_FALSE(mesh_write->halo_extension_from_cache);
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+  extend_halos_fixed_offset(1, mesh_read);
+  ASSERT_TRUE(mesh_read->halo_extension_from_cache);
+  ASSERT_EQ(get_ids(mesh_write->remote_triangles),
+            get_ids(mesh_read->remote_triangles));
+  ASSERT_EQ(get_ids(mesh_write->remote_quads),
+            get_ids(mesh_read->remote_quads));
+
+  // A different configuration does not match the cache.
+  auto mesh_offset = std::make_shared<ParticleMeshInterface>(
+      graph, 1, MPI_COMM_WORLD, cache_dir.string());
+  ASSERT_FALSE(mesh_offset->setup_from_cache);
+
+  mesh_offset->free();
+  mesh_read->free();
+  mesh_write->free();
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+  if (rank == 0) {
+    std::filesystem::remove_all(cache_dir);
+  }
+}
+
+TEST(SetupCache, HashCurves) {
+  TestUtilities::TestResourceSession resources(
+      "reference_all_types_cube/mixed_ref_cube_0.5_perturbed.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  std::map<int, std::shared_ptr<Nektar::SpatialDomains::Geometry3D>> geoms_3d;
+  get_all_elements_3d(graph, geoms_3d);
+  auto lambda_hash = [&]() {
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+    SetupCache::hash_geoms(geoms_3d, hash);
+    return hash;
+  };
+  const std::uint64_t hash_original = lambda_hash();
+  ASSERT_EQ(hash_original, lambda_hash());
+
+  // Find a curved edge or face on this rank.
+  SpatialDomains::CurveSharedPtr curve = nullptr;
+  for (auto &geom_item : geoms_3d) {
+    auto geom = geom_item.second;
+    for (int fx = 0; (fx < geom->GetNumFaces()) && (curve == nullptr); fx++) {
+      auto face = geom->GetFace(fx);
+      curve = face->GetCurve();
+      for (int ex = 0; (ex < face->GetNumEdges()) && (curve == nullptr);
+           ex++) {
+        auto edge = std::dynamic_pointer_cast<SpatialDomains::SegGeom>(
+            face->GetEdge(ex));
+        curve = (edge != nullptr) ? edge->GetCurve() : nullptr;
+      }
+    }
+    if (curve != nullptr) {
+      break;
+    }
+  }
+
+  // Moving a curve point, but no vertex, changes the hash.
+  if (curve != nullptr) {
+    auto point = curve->m_points.at(curve->m_points.size() / 2);
+    NekDouble x, y, z;
+    point->GetCoords(x, y, z);
+    point->UpdatePosition(x + 1.0e-3, y, z);
+    ASSERT_NE(hash_original, lambda_hash());
+    point->UpdatePosition(x, y, z);
+    ASSERT_EQ(hash_original, lambda_hash());
+  }
+}
@@ -0,0 +1,110 @@
+#include "nektar_interface/solver_base/species_constants.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <neso_particles.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace NESO;
+using namespace NESO::Particles;
+
+TEST(SpeciesConstants, Table) {
+  SpeciesConstants species_constants(2, {"Q", "M"});
+  ASSERT_EQ(species_constants.get_num_species(), 2);
+  ASSERT_TRUE(species_constants.has_species_dat());
+  ASSERT_EQ(species_constants.get(1, "M"), 0.0);
+
+  species_constants.set(0, "Q", -1.0);
+  species_constants.set(0, "M", 2.0);
+  species_constants.set(1, "Q", 3.0);
+  species_constants.set(1, "M", 4.0);
+  ASSERT_EQ(species_constants.get(0, "Q"), -1.0);
+  ASSERT_EQ(species_constants.get(0, "M"), 2.0);
+  ASSERT_EQ(species_constants.get(1, "Q"), 3.0);
+  ASSERT_EQ(species_constants.get(1, "M"), 4.0);
+
+  SpeciesConstants single(1, {"MASS"});
+  ASSERT_FALSE(single.has_species_dat());
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), 2, true)};
+  single.add_to_spec(particle_spec);
+  ASSERT_EQ(particle_spec.properties_int.size(), 0);
+  species_constants.add_to_spec(particle_spec);
+  ASSERT_EQ(particle_spec.properties_int.size(), 1);
+}
+
+TEST(SpeciesConstants, SubGroups) {
+  const int ndim = 2;
+  std::vector<int> dims(ndim);
+  dims[0] = 4;
+  dims[1] = 4;
+  const double cell_extent = 1.0;
+  const int subdivision_order = 0;
+  auto mesh = std::make_shared<CartesianHMesh>(MPI_COMM_WORLD, ndim, dims,
+                                               cell_extent, subdivision_order);
+  auto sycl_target = std::make_shared<SYCLTarget>(0, mesh->get_comm());
+  auto domain = std::make_shared<Domain>(mesh);
+
+  const int num_species = 3;
+  auto species_constants = std::make_shared<SpeciesConstants>(
+      num_species, std::vector<std::string>{"Q"});
+  for (int sx = 0; sx < num_species; sx++) {
+    species_constants->set(sx, "Q", sx + 1.0);
+  }
+
+  ParticleSpec particle_spec{ParticleProp(Sym<REAL>("P"), ndim, true),
+                             ParticleProp(Sym<INT>("CELL_ID"), 1, true),
+                             ParticleProp(Sym<REAL>("Q"), 1)};
+  species_constants->add_to_spec(particle_spec);
+  auto A = std::make_shared<ParticleGroup>(domain, particle_spec, sycl_target);
+  species_constants->setup_sub_groups(A);
+
+  const int N = 1000;
+  std::vector<INT> counts(num_species);
+  if (sycl_target->comm_pair.rank_parent == 0) {
+    std::mt19937 rng(52234234);
+    std::uniform_int_distribution<int> species_dist(0, num_species - 1);
+    double extents[2] = {4.0, 4.0};
+    auto positions = uniform_within_extents(N, ndim, extents, rng);
+    ParticleSet initial_distribution(N, A->get_particle_spec());
+    for (int px = 0; px < N; px++) {
+      const int species = species_dist(rng);
+      counts[species]++;
+      initial_distribution[Sym<REAL>("P")][px][0] = positions[0][px];
+      initial_distribution[Sym<REAL>("P")][px][1] = positions[1][px];
+      initial_distribution[Sym<INT>("CELL_ID")][px][0] = 0;
+      initial_distribution[species_constants->species_sym][px][0] = species;
+    }
+    A->add_particles_local(initial_distribution);
+  }
+  A->global_move();
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, counts.data(), num_species, MPI_INT64_T,
+                       MPI_SUM, MPI_COMM_WORLD));
+
+  // Each species writes its own constant into the Q ParticleDat.
+  for (int sx = 0; sx < num_species; sx++) {
+    auto sub_group = species_constants->get_sub_group(sx);
+    INT npart = sub_group->get_npart_local();
+    MPICHK(MPI_Allreduce(MPI_IN_PLACE, &npart, 1, MPI_INT64_T, MPI_SUM,
+                         MPI_COMM_WORLD));
+    ASSERT_EQ(npart, counts[sx]);
+    const REAL k_Q = species_constants->get(sx, "Q");
+    particle_loop(
+        sub_group, [=](auto Q) { Q.at(0) = k_Q; },
+        Access::write(Sym<REAL>("Q")))
+        ->execute();
+  }
+
+  const int cell_count = mesh->get_cell_count();
+  for (int cellx = 0; cellx < cell_count; cellx++) {
+    auto Q = A->get_cell(Sym<REAL>("Q"), cellx);
+    auto S = A->get_cell(species_constants->species_sym, cellx);
+    for (int rowx = 0; rowx < Q->nrow; rowx++) {
+      ASSERT_EQ(Q->at(rowx, 0), species_constants->get(S->at(rowx, 0), "Q"));
+    }
+  }
+
+  A->free();
+  sycl_target->free();
+  mesh->free();
+}
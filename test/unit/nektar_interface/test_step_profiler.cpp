@@ -0,0 +1,133 @@
+#include "nektar_interface/step_profiler.hpp"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <map>
+#include <neso_particles.hpp>
+#include <sstream>
+
+using namespace NESO;
+using namespace NESO::Particles;
+
+TEST(StepProfiler, Disabled) {
+  StepProfiler profiler;
+  ASSERT_FALSE(profiler.enabled);
+  profiler.begin_step(0);
+  {
+    StepProfilerRegion region(&profiler, StepRegion::ParticlePush, "push");
+  }
+  profiler.add_duration(StepRegion::Mapping, "map", 1.0);
+  profiler.end_step();
+  ASSERT_TRUE(profiler.reduce().empty());
+  profiler.finalise();
+}
+
+TEST(StepProfiler, Reduce) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+  StepProfiler profiler(true);
+
+  const int num_steps = 3;
+  for (int stepx = 0; stepx < num_steps; stepx++) {
+    profiler.begin_step(stepx);
+    // Calling again with the same step has no effect.
+    profiler.begin_step(stepx);
+    {
+      StepProfilerRegion region(&profiler, StepRegion::ParticlePush, "push");
+    }
+    // Each rank spends (rank + 1) seconds in solve per step.
+    profiler.add_duration(StepRegion::Solve, "solve", rank + 1.0);
+    // Only rank 0 does IO.
+    if (rank == 0) {
+      profiler.add_duration(StepRegion::IO, "write", 1.0);
+    }
+  }
+  profiler.end_step();
+
+  auto stats = profiler.reduce();
+  // step, push, solve and write
+  ASSERT_EQ(stats.size(), 4);
+  ASSERT_EQ(static_cast<int>(stats.at(0).region), -1);
+  ASSERT_EQ(stats.at(0).name, "step");
+  ASSERT_EQ(stats.at(0).count, num_steps * size);
+
+  for (auto &s : stats) {
+    if (s.name == "push") {
+      ASSERT_EQ(s.region, StepRegion::ParticlePush);
+      ASSERT_EQ(s.count, num_steps * size);
+      ASSERT_TRUE(s.min <= s.mean);
+      ASSERT_TRUE(s.mean <= s.max);
+    } else if (s.name == "solve") {
+      ASSERT_EQ(s.region, StepRegion::Solve);
+      ASSERT_NEAR(s.min, num_steps * 1.0, 1.0e-12);
+      ASSERT_NEAR(s.max, num_steps * static_cast<double>(size), 1.0e-12);
+      ASSERT_NEAR(s.mean, num_steps * 0.5 * (size + 1.0), 1.0e-12);
+    } else if (s.name == "write") {
+      ASSERT_EQ(s.region, StepRegion::IO);
+      ASSERT_EQ(s.count, num_steps);
+      ASSERT_NEAR(s.max, num_steps * 1.0, 1.0e-12);
+      ASSERT_NEAR(s.min, (size > 1) ? 0.0 : num_steps * 1.0, 1.0e-12);
+    }
+  }
+}
+
+TEST(StepProfiler, Exclusive) {
+  StepProfiler profiler(true);
+  const int id_transfer = profiler.get_name_id("transfer");
+  const int id_map = profiler.get_name_id("map");
+
+  // transfer: [0, 10] contains map: [1, 4] which contains 0.5 of lookup and
+  // the event halo: [2, 3].
+  profiler.begin_step(0);
+  const auto depth_transfer = profiler.begin_region();
+  const auto depth_map = profiler.begin_region();
+  profiler.add_duration(StepRegion::Mapping, "lookup", 0.5);
+  profiler.add_event(StepRegion::Mapping, "halo", 2.0, 3.0);
+  profiler.end_region(depth_map, StepRegion::Mapping, id_map, 1.0, 4.0);
+  profiler.end_region(depth_transfer, StepRegion::Transfer, id_transfer, 0.0,
+                      10.0);
+  profiler.end_step();
+
+  // Time is only attributed to the innermost region.
+  std::map<std::string, double> times;
+  for (auto &s : profiler.reduce()) {
+    times[s.name] = s.mean;
+  }
+  ASSERT_NEAR(times.at("lookup"), 0.5, 1.0e-12);
+  ASSERT_NEAR(times.at("halo"), 1.0, 1.0e-12);
+  ASSERT_NEAR(times.at("map"), 1.5, 1.0e-12);
+  ASSERT_NEAR(times.at("transfer"), 7.0, 1.0e-12);
+}
+
+TEST(StepProfiler, Trace) {
+  int rank;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  const std::string filename = "test_step_profiler_timeline.json";
+
+  {
+    StepProfiler profiler(true, filename);
+    profiler.begin_step(0);
+    {
+      StepProfilerRegion region(&profiler, StepRegion::Projection,
+                                "deposit\"quoted\"");
+    }
+    profiler.finalise();
+  }
+  MPICHK(MPI_Barrier(MPI_COMM_WORLD));
+
+  if (rank == 0) {
+    std::ifstream trace(filename);
+    ASSERT_TRUE(trace.is_open());
+    std::stringstream contents;
+    contents << trace.rdbuf();
+    const std::string json = contents.str();
+    ASSERT_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+    ASSERT_NE(json.find("\"cat\":\"projection\""), std::string::npos);
+    ASSERT_NE(json.find("deposit\\\"quoted\\\""), std::string::npos);
+    ASSERT_NE(json.find("\"cat\":\"step\""), std::string::npos);
+    trace.close();
+    std::remove(filename.c_str());
+  }
+}
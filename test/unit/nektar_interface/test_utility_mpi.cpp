@@ -0,0 +1,60 @@
+#include "nektar_interface/utility_mpi.hpp"
+#include <gtest/gtest.h>
+#include <neso_particles.hpp>
+#include <set>
+#include <vector>
+
+using namespace NESO;
+using namespace NESO::Particles;
+
+TEST(UtilityMPI, SparseExchangeCounts) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+  // Each rank sends to the next two ranks, excluding itself, the value
+  // 1000 * source + destination.
+  std::set<int> send_set;
+  for (int offset = 1; offset <= 2; offset++) {
+    const int remote_rank = (rank + offset) % size;
+    if (remote_rank != rank) {
+      send_set.insert(remote_rank);
+    }
+  }
+  std::vector<int> send_ranks(send_set.begin(), send_set.end());
+  std::vector<int> send_data;
+  for (const int remote_rank : send_ranks) {
+    send_data.push_back(1000 * rank + remote_rank);
+  }
+
+  // Repeated exchanges must not interfere with each other.
+  for (int testx = 0; testx < 3; testx++) {
+    std::vector<int> recv_ranks;
+    std::vector<int> recv_data;
+    const int num_recv_ranks = sparse_exchange_counts(
+        MPI_COMM_WORLD, send_ranks, send_data, recv_ranks, recv_data);
+
+    std::set<int> expected_set;
+    for (int offset = 1; offset <= 2; offset++) {
+      const int remote_rank = (rank - offset + 2 * size) % size;
+      if (remote_rank != rank) {
+        expected_set.insert(remote_rank);
+      }
+    }
+    std::vector<int> expected_ranks(expected_set.begin(), expected_set.end());
+    ASSERT_EQ(num_recv_ranks, expected_ranks.size());
+    ASSERT_EQ(recv_ranks, expected_ranks);
+    for (int rankx = 0; rankx < num_recv_ranks; rankx++) {
+      ASSERT_EQ(recv_data.at(rankx), 1000 * recv_ranks.at(rankx) + rank);
+    }
+  }
+
+  // No rank sends anything.
+  std::vector<int> empty;
+  std::vector<int> recv_ranks;
+  std::vector<int> recv_data;
+  ASSERT_EQ(sparse_exchange_counts(MPI_COMM_WORLD, empty, empty, recv_ranks,
+                                   recv_data),
+            0);
+  ASSERT_TRUE(recv_ranks.empty());
+}
@@ -0,0 +1,117 @@
+#include "nektar_interface/test_helper_utilities.hpp"
+#include <MultiRegions/DisContField.h>
+#include <gtest/gtest.h>
+#include <solvers/helpers/analytic_source.hpp>
+
+using namespace NESO::Solvers;
+
+TEST(AnalyticSource, DependsOnTime) {
+  ASSERT_TRUE(AnalyticSource::depends_on_time("t"));
+  ASSERT_TRUE(AnalyticSource::depends_on_time("sin(t)*x"));
+  ASSERT_TRUE(AnalyticSource::depends_on_time("exp(-(x*x+y*y))*(1+t)"));
+  ASSERT_TRUE(AnalyticSource::depends_on_time("x+t*2"));
+
+  ASSERT_FALSE(AnalyticSource::depends_on_time(""));
+  ASSERT_FALSE(AnalyticSource::depends_on_time("exp(-(x*x+y*y))"));
+  ASSERT_FALSE(AnalyticSource::depends_on_time("sqrt(x*x+y*y)"));
+  ASSERT_FALSE(AnalyticSource::depends_on_time("t_end*x"));
+  ASSERT_FALSE(AnalyticSource::depends_on_time("x*theta+t0"));
+}
+
+TEST(AnalyticSource, IsDeterministic) {
+  ASSERT_TRUE(AnalyticSource::is_deterministic(""));
+  ASSERT_TRUE(AnalyticSource::is_deterministic("exp(-(x*x+y*y))*(1+t)"));
+  ASSERT_TRUE(AnalyticSource::is_deterministic("awgn_scale*x"));
+
+  ASSERT_FALSE(AnalyticSource::is_deterministic("awgn(0.1)"));
+  ASSERT_FALSE(AnalyticSource::is_deterministic("x*(1+awgn(0.1))"));
+}
+
+namespace {
+
+/*
+ * Evaluate a session function directly at the quadrature points of a field.
+ */
+Array<OneD, NekDouble> evaluate_direct(LU::SessionReaderSharedPtr session,
+                                       MR::ExpListSharedPtr field,
+                                       const std::string &func_name,
+                                       const NekDouble time) {
+  const int npts = field->GetTotPoints();
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts), out(npts);
+  field->GetCoords(x, y, z);
+  session->GetFunction(func_name, 0)->Evaluate(x, y, z, time, out);
+  return out;
+}
+
+} // namespace
+
+TEST(AnalyticSource, CachedValues) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads.xml", "analytic_source_conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+  auto field = std::make_shared<MR::DisContField>(session, graph, "u");
+  const int npts = field->GetTotPoints();
+
+  // Time independent: evaluated once, identical at every time.
+  AnalyticSource static_src(session, field, "static_src", 0);
+  ASSERT_FALSE(static_src.is_time_dependent());
+  ASSERT_TRUE(static_src.is_cached());
+  auto correct = evaluate_direct(session, field, "static_src", 0.0);
+  for (const NekDouble time : {0.0, 0.5, 2.0}) {
+    const auto &values = static_src.get_values(time);
+    ASSERT_EQ(static_cast<int>(values.size()), npts);
+    for (int px = 0; px < npts; px++) {
+      ASSERT_NEAR(values[px], correct[px], 1.0e-14);
+    }
+  }
+
+  // Time dependent: re-evaluated whenever the time changes.
+  AnalyticSource time_src(session, field, "time_src", 0);
+  ASSERT_TRUE(time_src.is_time_dependent());
+  ASSERT_TRUE(time_src.is_cached());
+  for (const NekDouble time : {0.5, 0.5, 1.5, 0.25}) {
+    correct = evaluate_direct(session, field, "time_src", time);
+    const auto &values = time_src.get_values(time);
+    for (int px = 0; px < npts; px++) {
+      ASSERT_NEAR(values[px], correct[px], 1.0e-14);
+    }
+  }
+
+  // add_to accumulates the values at the requested time.
+  Array<OneD, NekDouble> sum(npts, 1.0);
+  time_src.add_to(sum, 1.0);
+  correct = evaluate_direct(session, field, "time_src", 1.0);
+  for (int px = 0; px < npts; px++) {
+    ASSERT_NEAR(sum[px], 1.0 + correct[px], 1.0e-14);
+  }
+
+  session->Finalise();
+}
+
+TEST(AnalyticSource, NonDeterministicNotCached) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads.xml", "analytic_source_conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+  auto field = std::make_shared<MR::DisContField>(session, graph, "u");
+  const int npts = field->GetTotPoints();
+
+  AnalyticSource noise_src(session, field, "noise_src", 0);
+  ASSERT_FALSE(noise_src.is_cached());
+
+  // Two calls at the same time must draw fresh noise.
+  std::vector<NekDouble> first(npts);
+  const auto &values0 = noise_src.get_values(0.0);
+  for (int px = 0; px < npts; px++) {
+    first[px] = values0[px];
+  }
+  const auto &values1 = noise_src.get_values(0.0);
+  int num_differ = 0;
+  for (int px = 0; px < npts; px++) {
+    num_differ += (first[px] != values1[px]) ? 1 : 0;
+  }
+  ASSERT_TRUE(num_differ > 0);
+
+  session->Finalise();
+}
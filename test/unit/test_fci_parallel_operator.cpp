@@ -0,0 +1,105 @@
+#include "nektar_interface/test_helper_utilities.hpp"
+#include <MultiRegions/DisContField3DHomogeneous1D.h>
+#include <gtest/gtest.h>
+#include <solvers/helpers/fci_parallel_operator.hpp>
+
+using namespace NESO::Solvers;
+
+/*
+ * Compute the parallel derivatives of a field periodic in x and z with a
+ * uniform magnetic field tilted in x, and return the maximum relative errors
+ * of the first and second parallel derivatives.
+ */
+static inline std::array<NekDouble, 2>
+fci_parallel_errors(const int num_planes) {
+  TestUtilities::TestResourceSession resources(
+      "square_triangles_quads_nummodes_6.xml", "conditions.xml");
+  auto session = resources.session;
+  auto graph = SpatialDomains::MeshGraphIO::Read(session);
+
+  const NekDouble lhom = 1.0;
+  LibUtilities::PointsKey points_key(num_planes,
+                                     LibUtilities::eFourierEvenlySpaced);
+  LibUtilities::BasisKey basis_key(LibUtilities::eFourier, num_planes,
+                                   points_key);
+  auto field = std::make_shared<MultiRegions::DisContField3DHomogeneous1D>(
+      session, basis_key, lhom, false, false, graph, "u");
+
+  // Extent of the mesh in x, over which the field is periodic.
+  NekDouble x_min = std::numeric_limits<NekDouble>::max();
+  NekDouble x_max = std::numeric_limits<NekDouble>::lowest();
+  for (auto &vx : graph->GetAllPointGeoms()) {
+    NekDouble x, y, z;
+    vx.second->GetCoords(x, y, z);
+    x_min = std::min(x_min, x);
+    x_max = std::max(x_max, x);
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &x_min, 1, MPI_DOUBLE, MPI_MIN,
+                       MPI_COMM_WORLD));
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, &x_max, 1, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  const NekDouble kx = 2.0 * M_PI / (x_max - x_min);
+  const NekDouble kz = 2.0 * M_PI / lhom;
+
+  const std::vector<NekDouble> B = {0.5, 0.0, 1.0};
+  const NekDouble Bmag = std::sqrt(B[0] * B[0] + B[2] * B[2]);
+  const NekDouble bx = B[0] / Bmag;
+  const NekDouble bz = B[2] / Bmag;
+  auto fci = std::make_shared<FCIParallelOperator>(
+      field,
+      [&](const NekDouble, const NekDouble, const NekDouble, NekDouble *Bp) {
+        for (int dx = 0; dx < 3; dx++) {
+          Bp[dx] = B[dx];
+        }
+      },
+      MPI_COMM_WORLD, 8, true);
+
+  const int npts = field->GetTotPoints();
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts);
+  field->GetCoords(x, y, z);
+  Array<OneD, NekDouble> f(npts), grad(npts), grad2(npts);
+  for (int ix = 0; ix < npts; ix++) {
+    f[ix] = std::cos(kx * (x[ix] - x_min)) * std::sin(kz * z[ix]);
+  }
+  fci->grad_par(f, grad);
+  fci->grad2_par(f, grad2);
+
+  NekDouble errors[2] = {0.0, 0.0};
+  NekDouble norms[2] = {0.0, 0.0};
+  for (int ix = 0; ix < npts; ix++) {
+    const NekDouble cx = std::cos(kx * (x[ix] - x_min));
+    const NekDouble sx = std::sin(kx * (x[ix] - x_min));
+    const NekDouble cz = std::cos(kz * z[ix]);
+    const NekDouble sz = std::sin(kz * z[ix]);
+    const NekDouble correct_grad = -bx * kx * sx * sz + bz * kz * cx * cz;
+    const NekDouble correct_grad2 = -bx * bx * kx * kx * cx * sz -
+                                    2.0 * bx * bz * kx * kz * sx * cz -
+                                    bz * bz * kz * kz * cx * sz;
+    errors[0] = std::max(errors[0], std::abs(grad[ix] - correct_grad));
+    errors[1] = std::max(errors[1], std::abs(grad2[ix] - correct_grad2));
+    norms[0] = std::max(norms[0], std::abs(correct_grad));
+    norms[1] = std::max(norms[1], std::abs(correct_grad2));
+  }
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, errors, 2, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+  MPICHK(MPI_Allreduce(MPI_IN_PLACE, norms, 2, MPI_DOUBLE, MPI_MAX,
+                       MPI_COMM_WORLD));
+
+  int size;
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+  if (size == 1) {
+    EXPECT_EQ(fci->get_num_remote_points(), 0);
+  }
+
+  return {errors[0] / norms[0], errors[1] / norms[1]};
+}
+
+TEST(FCIParallelOperator, Convergence) {
+  const auto errors_coarse = fci_parallel_errors(16);
+  const auto errors_fine = fci_parallel_errors(32);
+  EXPECT_TRUE(errors_coarse[0] < 1.0e-1);
+  EXPECT_TRUE(errors_coarse[1] < 1.0e-1);
+  // Centred differences along the field lines are second order.
+  EXPECT_TRUE(errors_fine[0] < errors_coarse[0] / 3.0);
+  EXPECT_TRUE(errors_fine[1] < errors_coarse[1] / 3.0);
+}
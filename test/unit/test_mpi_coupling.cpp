@@ -0,0 +1,131 @@
+#include <MultiRegions/DisContField.h>
+#include <SpatialDomains/MeshGraphIO.h>
+#include <gtest/gtest.h>
+#include <neso_particles.hpp>
+#include <solvers/helpers/mpi_coupling.hpp>
+
+#include <filesystem>
+
+using namespace NESO;
+using namespace NESO::Particles;
+using namespace NESO::Solvers;
+
+TEST(MPICoupling, StripArgs) {
+  std::vector<std::string> strs = {"Diffusion", "--couple", "sender",
+                                   "-v",        "a.xml",    "mesh.xml.gz"};
+  std::vector<char *> argv;
+  for (auto &s : strs) {
+    argv.push_back(s.data());
+  }
+
+  std::string app_name;
+  auto args = CoupledApps::strip_args(argv.size(), argv.data(), app_name);
+  ASSERT_EQ(app_name, "sender");
+  ASSERT_EQ(args.size(), 5);
+  ASSERT_EQ(std::string(args[0]), "Diffusion");
+  ASSERT_EQ(std::string(args[1]), "-v");
+  ASSERT_EQ(args.back(), nullptr);
+
+  auto filenames = CoupledApps::get_session_filenames(args);
+  ASSERT_EQ(filenames.size(), 2);
+  ASSERT_EQ(filenames[0], "a.xml");
+  ASSERT_EQ(filenames[1], "mesh.xml.gz");
+
+  // No flag => no app name and arguments unchanged
+  auto args_no_flag = CoupledApps::strip_args(1, argv.data(), app_name);
+  ASSERT_TRUE(app_name.empty());
+  ASSERT_EQ(args_no_flag.size(), 2);
+}
+
+TEST(MPICoupling, SplitSingleApp) {
+  int size;
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+
+  CoupledApps apps;
+  ASSERT_FALSE(apps.is_split());
+  apps.split("app");
+  ASSERT_TRUE(apps.is_split());
+  ASSERT_EQ(apps.leaders.size(), 1);
+  ASSERT_EQ(apps.leaders.at("app"), 0);
+
+  int app_size;
+  MPICHK(MPI_Comm_size(apps.comm, &app_size));
+  ASSERT_EQ(app_size, size);
+  apps.free();
+  ASSERT_FALSE(apps.is_split());
+}
+
+/*
+ * Split MPI_COMM_WORLD into two applications with different meshes of the
+ * same domain. Application "a" sends a linear field, which is interpolated
+ * exactly, to application "b" every other step. Requires at least two MPI
+ * ranks, e.g. mpirun -np 2.
+ */
+TEST(MPICoupling, TwoAppExchange) {
+  int rank, size;
+  MPICHK(MPI_Comm_rank(MPI_COMM_WORLD, &rank));
+  MPICHK(MPI_Comm_size(MPI_COMM_WORLD, &size));
+  if (size < 2) {
+    GTEST_SKIP() << "Requires at least two MPI ranks.";
+  }
+
+  const bool is_a = rank < size / 2;
+  auto &apps = CoupledApps::get();
+  apps.split(is_a ? "coupling-test-a" : "coupling-test-b");
+
+  std::filesystem::path source_file = __FILE__;
+  std::filesystem::path test_resources_dir =
+      source_file.parent_path() / "../test_resources";
+  std::vector<std::string> filenames = {
+      std::string(test_resources_dir /
+                  (is_a ? "mpi_coupling_a.xml" : "mpi_coupling_b.xml")),
+      std::string(test_resources_dir /
+                  (is_a ? "square_triangles_quads.xml"
+                        : "square_triangles_quads_nummodes_6.xml"))};
+  std::vector<std::string> args_str = {"test_mpi_coupling"};
+  std::vector<char *> args = {args_str[0].data(), nullptr};
+
+  // The session owns (and frees) its communicator, the coupling uses the
+  // registry's.
+  MPI_Comm session_comm;
+  MPICHK(MPI_Comm_dup(apps.comm, &session_comm));
+  LU::CommSharedPtr comm = std::make_shared<CoupledCommMpi>(session_comm);
+  auto session = LU::SessionReader::CreateInstance(1, args.data(), filenames,
+                                                   comm);
+  auto graph = Nektar::SpatialDomains::MeshGraphIO::Read(session);
+  auto field = std::make_shared<MR::DisContField>(session, graph, "u");
+
+  auto coupling = SU::GetCouplingFactory().CreateInstance("MPI", field);
+  auto mpi_coupling = std::dynamic_pointer_cast<MPICoupling>(coupling);
+  ASSERT_TRUE(mpi_coupling != nullptr);
+  ASSERT_EQ(mpi_coupling->get_num_unlocated_points(), 0);
+
+  const int npts = field->GetTotPoints();
+  Array<OneD, NekDouble> x(npts), y(npts), z(npts);
+  field->GetCoords(x, y, z);
+  auto lambda_f = [&](const int step, const int px) {
+    return 1.0 + step + x[px] - 2.0 * y[px];
+  };
+
+  std::vector<std::string> var_names = {"u"};
+  Array<OneD, Array<OneD, NekDouble>> values(1);
+  values[0] = Array<OneD, NekDouble>(npts, -1.0);
+  for (int step = 0; step < 4; step++) {
+    if (is_a) {
+      for (int px = 0; px < npts; px++) {
+        values[0][px] = lambda_f(step, px);
+      }
+      coupling->Send(step, 0.0, values, var_names);
+    } else {
+      coupling->Receive(step, 0.0, values, var_names);
+      // Values only change on exchange steps (ReceiveSteps = 2).
+      const int exchange_step = step - (step % 2);
+      for (int px = 0; px < npts; px++) {
+        ASSERT_NEAR(values[0][px], lambda_f(exchange_step, px), 1.0e-10);
+      }
+    }
+  }
+
+  coupling->Finalize();
+  apps.free();
+}